@@ -67,3 +67,33 @@ end
            | a    | b  | ac,cb,cb | 19.2s |
            | a    | d  | ac,cd,cd | 19.2s |
            | a    | e  | ac,ce    | 20s   |
+
+    Scenario: Turn penalty table with a weight other than duration
+        Given the profile file
+          """
+api_version = 1
+
+properties.weight_name = 'distance'
+
+turn_penalty_table = {
+  angles = { -180, 0, 180 },
+  durations = { 10, 0, 10 }
+}
+
+function way_function(way, result)
+  result.forward_mode = mode.driving
+  result.forward_speed = 36
+end
+          """
+        And the node map
+          """
+            ab
+          """
+        And the ways
+            | nodes  |
+            | ab     |
+        And the data has been saved to disk
+
+        When I try to run "osrm-extract --profile {profile_file} {osm_file}"
+        Then it should exit with an error
+        And stderr should contain "turn_penalty_table needs the profile to use the duration as weight"
@@ -41,7 +41,7 @@ namespace contractor
 
 struct ContractorConfig
 {
-    ContractorConfig() : requested_num_threads(0) {}
+    ContractorConfig() : requested_num_threads(0), customizable(false), memory_bounded(false) {}
 
     // Infer the output names from the path of the .osrm file
     void UseDefaultOutputNames()
@@ -50,6 +50,8 @@ struct ContractorConfig
         core_output_path = osrm_input_path.string() + ".core";
         graph_output_path = osrm_input_path.string() + ".hsgr";
         node_file_path = osrm_input_path.string() + ".enw";
+        hierarchy_path = osrm_input_path.string() + ".cch";
+        partition_path = osrm_input_path.string() + ".partition";
         updater_config.osrm_input_path = osrm_input_path;
         updater_config.UseDefaultOutputNames();
     }
@@ -63,6 +65,8 @@ struct ContractorConfig
     std::string graph_output_path;
 
     std::string node_file_path;
+    std::string hierarchy_path;
+    std::string partition_path;
 
     bool use_cached_priority;
 
@@ -73,6 +77,13 @@ struct ContractorConfig
     // The remaining vertices form the core of the hierarchy
     //(e.g. 0.8 contracts 80 percent of the hierarchy, leaving a core of 20%)
     double core_factor;
+
+    // Contract the graph once into a metric-independent hierarchy (.cch) and only recompute
+    // the weights of the shortcuts on following runs.
+    bool customizable;
+
+    // Compact the remaining graph every time half of its nodes are contracted
+    bool memory_bounded;
 };
 }
 }
@@ -0,0 +1,96 @@
+#ifndef OSRM_CONTRACTOR_CUSTOMIZABLE_HIERARCHY_HPP
+#define OSRM_CONTRACTOR_CUSTOMIZABLE_HIERARCHY_HPP
+
+#include "contractor/query_edge.hpp"
+
+#include "extractor/edge_based_edge.hpp"
+
+#include "storage/io_fwd.hpp"
+
+#include "util/deallocating_vector.hpp"
+#include "util/typedefs.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace osrm
+{
+namespace contractor
+{
+class CustomizableHierarchy;
+
+namespace serialization
+{
+inline void read(storage::io::FileReader &reader, CustomizableHierarchy &hierarchy);
+inline void write(storage::io::FileWriter &writer, const CustomizableHierarchy &hierarchy);
+}
+
+/**
+ * Customizable contraction hierarchy (CCH).
+ *
+ * The hierarchy only depends on the topology of the edge-based graph: all nodes are
+ * contracted in a metric-independent order without witness searches, so every possible
+ * shortcut is present. Each shortcut stores its lower triangles, the pairs of arcs to a
+ * lower node it can be composed of.
+ *
+ * Customize() then computes the weights of all arcs for a given set of edge weights by
+ * relaxing the lower triangles of all arcs bottom-up, which is much faster than a new
+ * contraction. The result is a regular CH query graph.
+ */
+class CustomizableHierarchy
+{
+  public:
+    using ArcID = std::uint32_t;
+
+    CustomizableHierarchy() = default;
+
+    // Contracts the graph of the edges.
+    // Nodes with a higher priority are contracted after all nodes of a lower priority,
+    // inside of a priority nodes are contracted by the minimum degree heuristic.
+    CustomizableHierarchy(const NodeID number_of_nodes,
+                          const std::vector<extractor::EdgeBasedEdge> &edges,
+                          const std::vector<std::uint8_t> &node_priorities);
+
+    // Computes the weights of all arcs from the edge weights and returns the query graph edges.
+    // The edges need to have the same topology as the ones the hierarchy was built from,
+    // edges with an invalid weight are ignored.
+    util::DeallocatingVector<QueryEdge>
+    Customize(const std::vector<extractor::EdgeBasedEdge> &edges,
+              const std::vector<EdgeWeight> &node_weights) const;
+
+    NodeID GetNumberOfNodes() const { return rank_to_node.size(); }
+    std::size_t GetNumberOfArcs() const { return arc_head.size(); }
+    std::size_t GetNumberOfTriangles() const { return triangle_first_arc.size(); }
+
+    friend void serialization::read(storage::io::FileReader &reader,
+                                    CustomizableHierarchy &hierarchy);
+    friend void serialization::write(storage::io::FileWriter &writer,
+                                     const CustomizableHierarchy &hierarchy);
+
+  private:
+    // Returns the arc from the lower rank `tail` to the higher rank `head`
+    ArcID FindArc(const NodeID tail, const NodeID head) const;
+
+    std::vector<NodeID> rank_to_node;
+    std::vector<NodeID> node_to_rank;
+
+    // arcs from a rank to higher ranks: [first_arc[rank], first_arc[rank + 1]) sorted by head
+    std::vector<ArcID> first_arc;
+    std::vector<NodeID> arc_tail;
+    std::vector<NodeID> arc_head;
+
+    // lower triangles of an arc (tail, head) via a lower rank w:
+    // triangle_first_arc is the arc (w, tail) and triangle_second_arc is the arc (w, head)
+    std::vector<std::uint64_t> first_triangle;
+    std::vector<ArcID> triangle_first_arc;
+    std::vector<ArcID> triangle_second_arc;
+
+    // ranks grouped by their depth in the elimination tree, the arcs of all ranks of the
+    // same depth only depend on arcs of lower depths and can be customized in parallel
+    std::vector<std::uint32_t> first_depth_rank;
+    std::vector<NodeID> depth_ranks;
+};
+}
+}
+
+#endif
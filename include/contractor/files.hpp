@@ -1,7 +1,9 @@
 #ifndef OSRM_CONTRACTOR_FILES_HPP
 #define OSRM_CONTRACTOR_FILES_HPP
 
+#include "contractor/customizable_hierarchy.hpp"
 #include "contractor/query_graph.hpp"
+#include "contractor/serialization.hpp"
 
 #include "util/serialization.hpp"
 
@@ -66,6 +68,25 @@ writeGraph(const boost::filesystem::path &path, unsigned checksum, const QueryGr
     util::serialization::write(writer, graph);
 }
 
+// reads .osrm.cch file
+inline void readHierarchy(const boost::filesystem::path &path, CustomizableHierarchy &hierarchy)
+{
+    const auto fingerprint = storage::io::FileReader::VerifyFingerprint;
+    storage::io::FileReader reader{path, fingerprint};
+
+    serialization::read(reader, hierarchy);
+}
+
+// writes .osrm.cch file
+inline void writeHierarchy(const boost::filesystem::path &path,
+                           const CustomizableHierarchy &hierarchy)
+{
+    const auto fingerprint = storage::io::FileWriter::GenerateFingerprint;
+    storage::io::FileWriter writer{path, fingerprint};
+
+    serialization::write(writer, hierarchy);
+}
+
 // reads .levels file
 inline void readLevels(const boost::filesystem::path &path, std::vector<float> &node_levels)
 {
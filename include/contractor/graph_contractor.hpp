@@ -99,7 +99,9 @@ class GraphContractor
                                             std::vector<RemainingNodeData> &remaining_nodes,
                                             std::vector<float> &node_priorities);
 
-    void Run(double core_factor = 1.0);
+    // With memory_bounded set the remaining graph is compacted repeatedly during contraction,
+    // which lowers the peak memory usage at the cost of additional flushes.
+    void Run(double core_factor = 1.0, bool memory_bounded = false);
 
     std::vector<bool> GetCoreMarker();
 
@@ -173,6 +175,9 @@ class GraphContractor
     }
 
   private:
+    // don't flush the last rounds of the memory bounded mode, their graphs are tiny
+    static constexpr NodeID MIN_FLUSH_NODES = 1000;
+
     float EvaluateNodePriority(ContractorThreadData *const data,
                                const NodeDepth node_depth,
                                const NodeID node);
@@ -0,0 +1,47 @@
+#ifndef OSRM_CONTRACTOR_SERIALIZATION_HPP
+#define OSRM_CONTRACTOR_SERIALIZATION_HPP
+
+#include "contractor/customizable_hierarchy.hpp"
+
+#include "storage/io.hpp"
+#include "storage/serialization.hpp"
+
+namespace osrm
+{
+namespace contractor
+{
+namespace serialization
+{
+
+inline void read(storage::io::FileReader &reader, CustomizableHierarchy &hierarchy)
+{
+    storage::serialization::read(reader, hierarchy.rank_to_node);
+    storage::serialization::read(reader, hierarchy.node_to_rank);
+    storage::serialization::read(reader, hierarchy.first_arc);
+    storage::serialization::read(reader, hierarchy.arc_tail);
+    storage::serialization::read(reader, hierarchy.arc_head);
+    storage::serialization::read(reader, hierarchy.first_triangle);
+    storage::serialization::read(reader, hierarchy.triangle_first_arc);
+    storage::serialization::read(reader, hierarchy.triangle_second_arc);
+    storage::serialization::read(reader, hierarchy.first_depth_rank);
+    storage::serialization::read(reader, hierarchy.depth_ranks);
+}
+
+inline void write(storage::io::FileWriter &writer, const CustomizableHierarchy &hierarchy)
+{
+    storage::serialization::write(writer, hierarchy.rank_to_node);
+    storage::serialization::write(writer, hierarchy.node_to_rank);
+    storage::serialization::write(writer, hierarchy.first_arc);
+    storage::serialization::write(writer, hierarchy.arc_tail);
+    storage::serialization::write(writer, hierarchy.arc_head);
+    storage::serialization::write(writer, hierarchy.first_triangle);
+    storage::serialization::write(writer, hierarchy.triangle_first_arc);
+    storage::serialization::write(writer, hierarchy.triangle_second_arc);
+    storage::serialization::write(writer, hierarchy.first_depth_rank);
+    storage::serialization::write(writer, hierarchy.depth_ranks);
+}
+}
+}
+}
+
+#endif
@@ -3,19 +3,32 @@
 
 #include "partition/cell_storage.hpp"
 #include "partition/multi_level_partition.hpp"
+#include "storage/shared_memory_ownership.hpp"
+#include "util/integer_range.hpp"
 #include "util/query_heap.hpp"
 
 #include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <unordered_set>
+#include <vector>
 
 namespace osrm
 {
 namespace customizer
 {
+namespace detail
+{
 
-class CellCustomizer
+// Customizes the cells of a container, or of a view on a dataset that is already in memory
+template <storage::Ownership Ownership> class CellCustomizerImpl
 {
+    using MultiLevelPartition = partition::detail::MultiLevelPartitionImpl<Ownership>;
+    using CellStorage = partition::detail::CellStorageImpl<Ownership>;
+
   private:
     struct HeapData
     {
@@ -26,12 +39,26 @@ class CellCustomizer
     using Heap =
         util::QueryHeap<NodeID, NodeID, EdgeWeight, HeapData, util::ArrayStorage<NodeID, int>>;
     using HeapPtr = tbb::enumerable_thread_specific<Heap>;
+    // cell_mask[level - 1][cell_id] is true if the cell should be customized
+    using CellMask = std::vector<std::vector<bool>>;
+
+    // Buffers of the dense kernel that are reused between cells
+    struct DenseCell
+    {
+        std::vector<NodeID> nodes;
+        std::vector<EdgeWeight> weights;
+    };
+    using DenseCellPtr = tbb::enumerable_thread_specific<DenseCell>;
+
+    // Level 1 cells with at most this many nodes reachable from their sources are
+    // customized with the dense kernel, see src/benchmarks/customizer.cpp
+    static constexpr std::size_t MAX_DENSE_CELL_SIZE = 128;
 
-    CellCustomizer(const partition::MultiLevelPartition &partition) : partition(partition) {}
+    CellCustomizerImpl(const MultiLevelPartition &partition) : partition(partition) {}
 
     template <typename GraphT>
     void Customize(
-        const GraphT &graph, Heap &heap, partition::CellStorage &cells, LevelID level, CellID id)
+        const GraphT &graph, Heap &heap, CellStorage &cells, LevelID level, CellID id)
     {
         auto cell = cells.GetCell(level, id);
         auto destinations = cell.GetDestinationNodes();
@@ -69,28 +96,248 @@ class CellCustomizer
         }
     }
 
-    template <typename GraphT> void Customize(const GraphT &graph, partition::CellStorage &cells)
+    // Customizes a level 1 cell by computing the shortest paths between all nodes that are
+    // reachable from its sources inside of the cell. The paths are computed with
+    // Floyd-Warshall on a dense weight matrix, which avoids the heap and hash set overhead
+    // of one Dijkstra search per source node for small cells.
+    //
+    // Returns false without changing the cell if more than max_nodes nodes are reachable.
+    template <typename GraphT>
+    bool CustomizeDense(const GraphT &graph,
+                        DenseCell &dense,
+                        CellStorage &cells,
+                        CellID id,
+                        const std::size_t max_nodes = MAX_DENSE_CELL_SIZE) const
+    {
+        // large enough to never be a path weight in a small cell, small enough to never
+        // overflow when adding two of them
+        const constexpr EdgeWeight INFINITE_WEIGHT = INVALID_EDGE_WEIGHT / 2;
+        const constexpr LevelID level = 1;
+
+        auto cell = cells.GetCell(level, id);
+        const auto sources = cell.GetSourceNodes();
+        const auto destinations = cell.GetDestinationNodes();
+
+        if (sources.size() > max_nodes)
+            return false;
+
+        // collect the nodes reachable from the sources, sources come first
+        auto &nodes = dense.nodes;
+        nodes.assign(sources.begin(), sources.end());
+        const auto local_index = [&nodes](const NodeID node) {
+            return std::find(nodes.begin(), nodes.end(), node) - nodes.begin();
+        };
+        for (std::size_t index = 0; index < nodes.size(); ++index)
+        {
+            for (auto edge : graph.GetInternalEdgeRange(level, nodes[index]))
+            {
+                const NodeID to = graph.GetTarget(edge);
+                if (graph.GetEdgeData(edge).forward &&
+                    local_index(to) == static_cast<std::ptrdiff_t>(nodes.size()))
+                {
+                    if (nodes.size() >= max_nodes)
+                        return false;
+                    nodes.push_back(to);
+                }
+            }
+        }
+
+        const auto num_nodes = nodes.size();
+        auto &weights = dense.weights;
+        weights.assign(num_nodes * num_nodes, INFINITE_WEIGHT);
+        for (std::size_t from = 0; from < num_nodes; ++from)
+        {
+            weights[from * num_nodes + from] = 0;
+            for (auto edge : graph.GetInternalEdgeRange(level, nodes[from]))
+            {
+                const auto &data = graph.GetEdgeData(edge);
+                if (data.forward && data.weight < INFINITE_WEIGHT)
+                {
+                    auto &weight = weights[from * num_nodes + local_index(graph.GetTarget(edge))];
+                    weight = std::min(weight, data.weight);
+                }
+            }
+        }
+
+        // the inner loop is a branch-free min-plus over rows that the compiler vectorizes
+        for (std::size_t via = 0; via < num_nodes; ++via)
+        {
+            const EdgeWeight *const via_row = &weights[via * num_nodes];
+            for (std::size_t from = 0; from < num_nodes; ++from)
+            {
+                EdgeWeight *const from_row = &weights[from * num_nodes];
+                const EdgeWeight to_via = from_row[via];
+                if (to_via == INFINITE_WEIGHT)
+                    continue;
+                for (std::size_t to = 0; to < num_nodes; ++to)
+                {
+                    from_row[to] = std::min(from_row[to], to_via + via_row[to]);
+                }
+            }
+        }
+
+        std::size_t source_index = 0;
+        for (auto source : sources)
+        {
+            BOOST_ASSERT(nodes[source_index] == source);
+            const EdgeWeight *const source_row = &weights[source_index++ * num_nodes];
+            auto destination_iter = destinations.begin();
+            for (auto &weight : cell.GetOutWeight(source))
+            {
+                BOOST_ASSERT(destination_iter != destinations.end());
+                const auto destination_index = local_index(*destination_iter++);
+                weight = static_cast<std::size_t>(destination_index) < num_nodes &&
+                                 source_row[destination_index] < INFINITE_WEIGHT
+                             ? source_row[destination_index]
+                             : INVALID_EDGE_WEIGHT;
+            }
+        }
+
+        return true;
+    }
+
+    template <typename GraphT> void Customize(const GraphT &graph, CellStorage &cells)
     {
+        Customize(graph, cells, MakeCellMask(true));
+    }
+
+    // Only customizes the cells selected by the mask, all other cells keep their weights.
+    // Since the cliques of a level are computed from the cliques of the level below, every
+    // parent of a selected cell needs to be selected as well.
+    template <typename GraphT>
+    void Customize(const GraphT &graph, CellStorage &cells, const CellMask &cell_mask)
+    {
+        BOOST_ASSERT(cell_mask.size() + 1 == partition.GetNumberOfLevels());
+
         Heap heap_exemplar(graph.GetNumberOfNodes());
         HeapPtr heaps(heap_exemplar);
+        DenseCellPtr dense_cells;
 
         for (std::size_t level = 1; level < partition.GetNumberOfLevels(); ++level)
         {
+            const auto &level_mask = cell_mask[level - 1];
             tbb::parallel_for(tbb::blocked_range<std::size_t>(0, partition.GetNumberOfCells(level)),
                               [&](const tbb::blocked_range<std::size_t> &range) {
                                   auto &heap = heaps.local();
+                                  auto &dense = dense_cells.local();
                                   for (auto id = range.begin(), end = range.end(); id != end; ++id)
                                   {
+                                      if (!level_mask[id])
+                                          continue;
+                                      if (level == 1 && CustomizeDense(graph, dense, cells, id))
+                                          continue;
                                       Customize(graph, heap, cells, level, id);
                                   }
                               });
         }
     }
 
+    CellMask MakeCellMask(const bool value) const
+    {
+        CellMask cell_mask(partition.GetNumberOfLevels() - 1);
+        for (std::size_t level = 1; level < partition.GetNumberOfLevels(); ++level)
+        {
+            cell_mask[level - 1].resize(partition.GetNumberOfCells(level), value);
+        }
+        return cell_mask;
+    }
+
+    // Selects all cells that contain the edge from node to target.
+    //
+    // An edge is part of the cell of its source node on all levels on which its target
+    // is in the same cell. This includes all parent cells, so the mask stays closed upwards.
+    void MarkEdge(CellMask &cell_mask, const NodeID node, const NodeID target) const
+    {
+        for (LevelID level = partition.GetHighestDifferentLevel(node, target) + 1;
+             level < partition.GetNumberOfLevels();
+             ++level)
+        {
+            cell_mask[level - 1][partition.GetCell(level, node)] = true;
+        }
+    }
+
+    // Selects all cells that contain an edge that differs between both graphs.
+    template <typename GraphT>
+    CellMask GetChangedCells(const GraphT &graph, const GraphT &previous_graph) const
+    {
+        BOOST_ASSERT(graph.GetNumberOfNodes() == previous_graph.GetNumberOfNodes());
+
+        std::vector<std::uint8_t> changed_nodes(graph.GetNumberOfNodes());
+        tbb::parallel_for(tbb::blocked_range<NodeID>(0, graph.GetNumberOfNodes()),
+                          [&](const tbb::blocked_range<NodeID> &range) {
+                              for (auto node = range.begin(), end = range.end(); node != end;
+                                   ++node)
+                              {
+                                  changed_nodes[node] =
+                                      !HasEqualEdges(graph, previous_graph, node);
+                              }
+                          });
+
+        auto cell_mask = MakeCellMask(false);
+        const auto mark_edge = [&](const NodeID node, const NodeID target) {
+            MarkEdge(cell_mask, node, target);
+        };
+
+        for (NodeID node = 0; node < graph.GetNumberOfNodes(); ++node)
+        {
+            if (!changed_nodes[node])
+                continue;
+
+            const auto edges = graph.GetAdjacentEdgeRange(node);
+            const auto previous_edges = previous_graph.GetAdjacentEdgeRange(node);
+            const bool same_structure = edges.size() == previous_edges.size();
+            for (auto index : util::irange<EdgeID>(0, edges.size()))
+            {
+                const EdgeID edge = *edges.begin() + index;
+                const EdgeID previous_edge = *previous_edges.begin() + index;
+                if (!same_structure || !IsEqualEdge(graph, previous_graph, edge, previous_edge))
+                {
+                    mark_edge(node, graph.GetTarget(edge));
+                    if (same_structure)
+                        mark_edge(node, previous_graph.GetTarget(previous_edge));
+                }
+            }
+            if (!same_structure)
+            {
+                for (auto edge : previous_edges)
+                    mark_edge(node, previous_graph.GetTarget(edge));
+            }
+        }
+
+        return cell_mask;
+    }
+
   private:
+    template <typename GraphT>
+    static bool IsEqualEdge(const GraphT &graph,
+                            const GraphT &previous_graph,
+                            const EdgeID edge,
+                            const EdgeID previous_edge)
+    {
+        const auto &data = graph.GetEdgeData(edge);
+        const auto &previous_data = previous_graph.GetEdgeData(previous_edge);
+        return graph.GetTarget(edge) == previous_graph.GetTarget(previous_edge) &&
+               data.weight == previous_data.weight && data.forward == previous_data.forward &&
+               data.backward == previous_data.backward;
+    }
+
+    template <typename GraphT>
+    static bool HasEqualEdges(const GraphT &graph, const GraphT &previous_graph, const NodeID node)
+    {
+        const auto edges = graph.GetAdjacentEdgeRange(node);
+        const auto previous_edges = previous_graph.GetAdjacentEdgeRange(node);
+        return edges.size() == previous_edges.size() &&
+               std::equal(edges.begin(),
+                          edges.end(),
+                          previous_edges.begin(),
+                          [&](const EdgeID edge, const EdgeID previous_edge) {
+                              return IsEqualEdge(graph, previous_graph, edge, previous_edge);
+                          });
+    }
+
     template <bool first_level, typename GraphT>
     void RelaxNode(const GraphT &graph,
-                   const partition::CellStorage &cells,
+                   const CellStorage &cells,
                    Heap &heap,
                    LevelID level,
                    NodeID node,
@@ -158,9 +405,13 @@ class CellCustomizer
         }
     }
 
-    const partition::MultiLevelPartition &partition;
+    const MultiLevelPartition &partition;
 };
 }
+
+using CellCustomizer = detail::CellCustomizerImpl<storage::Ownership::Container>;
+using CellCustomizerView = detail::CellCustomizerImpl<storage::Ownership::View>;
+}
 }
 
 #endif // OSRM_CELLS_CUSTOMIZER_HPP
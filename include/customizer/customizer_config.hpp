@@ -15,7 +15,7 @@ namespace customizer
 
 struct CustomizationConfig
 {
-    CustomizationConfig() : requested_num_threads(0) {}
+    CustomizationConfig() : requested_num_threads(0), incremental(true) {}
 
     void UseDefaults()
     {
@@ -49,6 +49,8 @@ struct CustomizationConfig
     boost::filesystem::path mld_graph_path;
 
     unsigned requested_num_threads;
+    // only customize cells that changed since the last customization
+    bool incremental;
 
     updater::UpdaterConfig updater_config;
 };
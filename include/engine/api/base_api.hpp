@@ -5,6 +5,7 @@
 #include "engine/datafacade/datafacade_base.hpp"
 
 #include "engine/api/json_factory.hpp"
+#include "engine/compact_hint.hpp"
 #include "engine/hint.hpp"
 
 #include <boost/assert.hpp>
@@ -48,7 +49,16 @@ class BaseAPI
     // protected:
     util::json::Object MakeWaypoint(const PhantomNode &phantom) const
     {
-        if (parameters.generate_hints)
+        if (parameters.generate_hints &&
+            parameters.hint_format == BaseParameters::HintFormat::Compact)
+        {
+            // TODO: check forward/reverse
+            return json::makeWaypoint(
+                phantom.location,
+                facade.GetNameForID(facade.GetNameIndex(phantom.forward_segment_id.id)).to_string(),
+                CompactHint::FromPhantomNode(phantom, facade));
+        }
+        else if (parameters.generate_hints)
         {
             // TODO: check forward/reverse
             return json::makeWaypoint(
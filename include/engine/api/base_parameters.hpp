@@ -30,6 +30,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "engine/approach.hpp"
 #include "engine/bearing.hpp"
+#include "engine/compact_hint.hpp"
 #include "engine/hint.hpp"
 #include "util/coordinate.hpp"
 
@@ -52,6 +53,8 @@ namespace api
  *  - coordinates: for specifying location(s) to services
  *  - hints: hint for the service to derive the position(s) in the road network more efficiently,
  *           optional per coordinate
+ *  - compact_hints: like hints, but only identify the segment and stay valid across traffic
+ *                   updates, optional per coordinate
  *  - radiuses: limits the search for segments in the road network to given radius(es) in meter,
  *              optional per coordinate
  *  - bearings: limits the search for segments in the road network to given bearing(s) in degree
@@ -65,6 +68,7 @@ struct BaseParameters
 {
     std::vector<util::Coordinate> coordinates;
     std::vector<boost::optional<Hint>> hints;
+    std::vector<boost::optional<CompactHint>> compact_hints;
     std::vector<boost::optional<double>> radiuses;
     std::vector<boost::optional<Bearing>> bearings;
     std::vector<boost::optional<Approach>> approaches;
@@ -72,6 +76,14 @@ struct BaseParameters
     // Adds hints to response which can be included in subsequent requests, see `hints` above.
     bool generate_hints = true;
 
+    enum class HintFormat
+    {
+        Full,
+        Compact
+    };
+    // Format of the generated hints, compact hints do not depend on the dataset checksum
+    HintFormat hint_format = HintFormat::Full;
+
     BaseParameters(const std::vector<util::Coordinate> coordinates_ = {},
                    const std::vector<boost::optional<Hint>> hints_ = {},
                    std::vector<boost::optional<double>> radiuses_ = {},
@@ -87,6 +99,7 @@ struct BaseParameters
     bool IsValid() const
     {
         return (hints.empty() || hints.size() == coordinates.size()) &&
+               (compact_hints.empty() || compact_hints.size() == coordinates.size()) &&
                (bearings.empty() || bearings.size() == coordinates.size()) &&
                (radiuses.empty() || radiuses.size() == coordinates.size()) &&
                (approaches.empty() || approaches.size() == coordinates.size()) &&
@@ -25,6 +25,7 @@ namespace engine
 {
 
 struct Hint;
+struct CompactHint;
 
 namespace api
 {
@@ -97,6 +98,10 @@ util::json::Object makeWaypoint(const util::Coordinate location, std::string nam
 util::json::Object
 makeWaypoint(const util::Coordinate location, std::string name, const Hint &hint);
 
+// Creates a Waypoint with a CompactHint that stays valid across traffic updates
+util::json::Object
+makeWaypoint(const util::Coordinate location, std::string name, const CompactHint &hint);
+
 util::json::Object makeRouteLeg(guidance::RouteLeg leg, util::json::Array steps);
 
 util::json::Array makeRouteLegs(std::vector<guidance::RouteLeg> legs,
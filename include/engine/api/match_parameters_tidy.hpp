@@ -64,6 +64,9 @@ inline Result keep_all(const MatchParameters &params)
             if (!params.hints.empty())
                 result.parameters.hints.push_back(params.hints[i]);
 
+            if (!params.compact_hints.empty())
+                result.parameters.compact_hints.push_back(params.compact_hints[i]);
+
             if (!params.radiuses.empty())
                 result.parameters.radiuses.push_back(params.radiuses[i]);
 
@@ -148,6 +151,9 @@ inline Result tidy(const MatchParameters &params, Thresholds cfg = {15., 5})
             if (!params.hints.empty())
                 result.parameters.hints.push_back(params.hints[i]);
 
+            if (!params.compact_hints.empty())
+                result.parameters.compact_hints.push_back(params.compact_hints[i]);
+
             if (!params.radiuses.empty())
                 result.parameters.radiuses.push_back(params.radiuses[i]);
 
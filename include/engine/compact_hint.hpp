@@ -0,0 +1,71 @@
+#ifndef ENGINE_COMPACT_HINT_HPP
+#define ENGINE_COMPACT_HINT_HPP
+
+#include "engine/phantom_node.hpp"
+
+#include "util/coordinate.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/optional.hpp>
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+namespace osrm
+{
+namespace engine
+{
+
+// Fwd. decls.
+namespace datafacade
+{
+class BaseDataFacade;
+}
+
+// Identifies a snapped coordinate by its segment instead of a full phantom node. Unlike Hint it
+// does not store weights and is not tied to the dataset checksum: the phantom node is rebuilt
+// from the current weights, so it stays valid across traffic updates as long as the segment
+// ids and the coordinates of its end points do not change. A hint is only used for the same
+// input coordinate it was created for.
+struct CompactHint
+{
+    SegmentID forward_segment_id{SPECIAL_SEGMENTID, false};
+    SegmentID reverse_segment_id{SPECIAL_SEGMENTID, false};
+    std::uint16_t fwd_segment_position = 0;
+    // detects input coordinates that differ from the one the hint was created for, this is only
+    // a 16 bit hash so the snapping distance is checked as well
+    std::uint16_t coordinate_fingerprint = 0;
+    // detects segments that got different end points in another dataset
+    std::uint32_t segment_checksum = 0;
+
+    static CompactHint FromPhantomNode(const PhantomNode &phantom,
+                                       const datafacade::BaseDataFacade &facade);
+
+    // Snaps the input coordinate to the hinted segment without searching the R-tree. Returns
+    // none if the segment does not exist in this dataset, its end points moved, the input
+    // coordinate is not the one the hint was created for or it snaps further than max_distance.
+    boost::optional<PhantomNode> ToPhantomNode(const util::Coordinate input_coordinate,
+                                               const double max_distance,
+                                               const datafacade::BaseDataFacade &facade) const;
+
+    std::string ToBase64() const;
+    static CompactHint FromBase64(const std::string &base64Hint);
+
+    friend bool operator==(const CompactHint &, const CompactHint &);
+    friend std::ostream &operator<<(std::ostream &, const CompactHint &);
+};
+
+// Snapping distance in meters up to which a compact hint is used for a coordinate without a
+// radius. Further away the coordinate is snapped through the R-tree again, since its fingerprint
+// may just collide with the one of the coordinate the hint was created for.
+constexpr double DEFAULT_COMPACT_HINT_MAX_DISTANCE = 1000.;
+
+static_assert(sizeof(CompactHint) == 16, "CompactHint is bigger than expected");
+constexpr std::size_t ENCODED_COMPACT_HINT_SIZE = 24;
+static_assert(ENCODED_COMPACT_HINT_SIZE / 4 * 3 >= sizeof(CompactHint),
+              "ENCODED_COMPACT_HINT_SIZE does not match size of CompactHint");
+}
+}
+
+#endif
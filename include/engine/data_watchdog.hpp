@@ -3,6 +3,7 @@
 
 #include "engine/datafacade/contiguous_internalmem_datafacade.hpp"
 #include "engine/datafacade/shared_memory_allocator.hpp"
+#include "engine/warmup.hpp"
 
 #include "storage/shared_datatype.hpp"
 #include "storage/shared_memory.hpp"
@@ -13,6 +14,7 @@
 #include <boost/thread/locks.hpp>
 #include <boost/thread/shared_mutex.hpp>
 
+#include <functional>
 #include <memory>
 #include <thread>
 
@@ -24,13 +26,19 @@ namespace engine
 // This class monitors the shared memory region that contains the pointers to
 // the data and layout regions that should be used. This region is updated
 // once a new dataset arrives.
+//
+// Before a new dataset is made visible its hot blocks are prefaulted and
+// the optional warm-up function is run against the new facade.
 template <typename AlgorithmT> class DataWatchdog final
 {
     using mutex_type = typename storage::SharedMonitor<storage::SharedDataTimestamp>::mutex_type;
     using FacadeT = datafacade::ContiguousInternalMemoryDataFacade<AlgorithmT>;
 
   public:
-    DataWatchdog() : active(true), timestamp(0)
+    using WarmupFunction = std::function<void(const FacadeT &)>;
+
+    DataWatchdog(WarmupFunction warmup_ = {})
+        : active(true), timestamp(0), warmup(std::move(warmup_))
     {
         // create the initial facade before launching the watchdog thread
         {
@@ -68,9 +76,28 @@ template <typename AlgorithmT> class DataWatchdog final
             if (timestamp != barrier.data().timestamp)
             {
                 auto region = barrier.data().region;
-                facade = std::make_shared<const FacadeT>(
-                    std::make_unique<datafacade::SharedMemoryAllocator>(region));
+                auto allocator = std::make_unique<datafacade::SharedMemoryAllocator>(region);
                 timestamp = barrier.data().timestamp;
+
+                // We are attached to the new region now, so osrm-datastore can't remove it
+                // and we don't need to block other processes while warming up.
+                current_region_lock.unlock();
+
+                prefaultHotBlocks(*allocator);
+                auto new_facade = std::make_shared<const FacadeT>(std::move(allocator));
+                if (warmup)
+                {
+                    try
+                    {
+                        warmup(*new_facade);
+                    }
+                    catch (const std::exception &e)
+                    {
+                        util::Log(logWARNING) << "warm-up failed: " << e.what();
+                    }
+                }
+
+                facade = std::move(new_facade);
                 util::Log() << "updated facade to region " << region << " with timestamp "
                             << timestamp;
             }
@@ -83,6 +110,7 @@ template <typename AlgorithmT> class DataWatchdog final
     std::thread watcher;
     bool active;
     unsigned timestamp;
+    WarmupFunction warmup;
     std::shared_ptr<const FacadeT> facade;
 };
 }
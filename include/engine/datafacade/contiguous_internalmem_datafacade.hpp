@@ -37,6 +37,7 @@
 #include "util/guidance/turn_lanes.hpp"
 #include "util/log.hpp"
 #include "util/name_table.hpp"
+#include "util/packed_coordinate_vector.hpp"
 #include "util/packed_vector.hpp"
 #include "util/range_table.hpp"
 #include "util/rectangle.hpp"
@@ -47,7 +48,9 @@
 #include <boost/assert.hpp>
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <iterator>
 #include <limits>
 #include <memory>
@@ -217,7 +220,7 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
     extractor::Datasources *m_datasources;
 
     unsigned m_check_sum;
-    util::vector_view<util::Coordinate> m_coordinate_list;
+    util::PackedCoordinateVectorView m_coordinate_list;
     extractor::PackedOSMIDsView m_osmnodeid_list;
     util::vector_view<std::uint32_t> m_lane_description_offsets;
     util::vector_view<extractor::guidance::TurnLaneType::Mask> m_lane_description_masks;
@@ -246,6 +249,15 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
     // allocator that keeps the allocation data
     std::shared_ptr<ContiguousBlockAllocator> allocator;
 
+    // identifies the dataset of this facade within the process
+    const std::uint64_t data_version;
+
+    static std::uint64_t NextDataVersion()
+    {
+        static std::atomic<std::uint64_t> next_data_version{0};
+        return ++next_data_version;
+    }
+
     void InitializeProfilePropertiesPointer(storage::DataLayout &data_layout, char *memory_block)
     {
         m_profile_properties = data_layout.GetBlockPtr<extractor::ProfileProperties>(
@@ -300,10 +312,17 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
 
     void InitializeNodeInformationPointers(storage::DataLayout &layout, char *memory_ptr)
     {
-        const auto coordinate_list_ptr =
-            layout.GetBlockPtr<util::Coordinate>(memory_ptr, storage::DataLayout::COORDINATE_LIST);
-        m_coordinate_list.reset(coordinate_list_ptr,
-                                layout.num_entries[storage::DataLayout::COORDINATE_LIST]);
+        const auto coordinate_blocks_ptr =
+            layout.GetBlockPtr<util::PackedCoordinateVectorView::BlockHeader>(
+                memory_ptr, storage::DataLayout::COORDINATE_BLOCKS);
+        const auto coordinate_words_ptr =
+            layout.GetBlockPtr<util::PackedCoordinateVectorView::block_type>(
+                memory_ptr, storage::DataLayout::COORDINATE_LIST);
+        m_coordinate_list = util::PackedCoordinateVectorView(
+            util::vector_view<util::PackedCoordinateVectorView::BlockHeader>(
+                coordinate_blocks_ptr, layout.num_entries[storage::DataLayout::COORDINATE_BLOCKS]),
+            util::vector_view<util::PackedCoordinateVectorView::block_type>(
+                coordinate_words_ptr, layout.num_entries[storage::DataLayout::COORDINATE_LIST]));
 
         const auto osmnodeid_ptr = layout.GetBlockPtr<extractor::PackedOSMIDsView::block_type>(
             memory_ptr, storage::DataLayout::OSM_NODE_ID_LIST);
@@ -312,7 +331,7 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
                 osmnodeid_ptr, layout.num_entries[storage::DataLayout::OSM_NODE_ID_LIST]),
             // We (ab)use the number of coordinates here because we know we have the same amount of
             // ids
-            layout.num_entries[storage::DataLayout::COORDINATE_LIST]);
+            m_coordinate_list.size());
     }
 
     void InitializeEdgeBasedNodeDataInformationPointers(storage::DataLayout &layout,
@@ -545,7 +564,7 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
     // allows switching between process_memory/shared_memory datafacade, based on the type of
     // allocator
     ContiguousInternalMemoryDataFacadeBase(std::shared_ptr<ContiguousBlockAllocator> allocator_)
-        : allocator(std::move(allocator_))
+        : allocator(std::move(allocator_)), data_version(NextDataVersion())
     {
         InitializeInternalPointers(allocator->GetLayout(), allocator->GetMemory());
     }
@@ -766,6 +785,14 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
             input_coordinate, bearing, bearing_range, approach);
     }
 
+    PhantomNode NearestPhantomNodeOnSegment(const util::Coordinate input_coordinate,
+                                            const RTreeLeaf &segment) const override final
+    {
+        BOOST_ASSERT(m_geospatial_query.get());
+
+        return m_geospatial_query->NearestPhantomNodeOnSegment(input_coordinate, segment);
+    }
+
     unsigned GetCheckSum() const override final { return m_check_sum; }
 
     GeometryID GetGeometryIndex(const NodeID id) const override final
@@ -778,6 +805,11 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
         return edge_based_node_data.GetComponentID(id);
     }
 
+    std::size_t GetNumberOfEdgeBasedNodes() const override final
+    {
+        return edge_based_node_data.GetNumberOfNodes();
+    }
+
     extractor::TravelMode GetTravelMode(const NodeID id) const override final
     {
         return edge_based_node_data.GetTravelMode(id);
@@ -815,6 +847,10 @@ class ContiguousInternalMemoryDataFacadeBase : public BaseDataFacade
 
     std::string GetTimestamp() const override final { return m_timestamp; }
 
+    // Unlike the timestamp of the OSM data this changes with every loaded dataset, e.g. after
+    // a traffic update. Can be used as key for caches of derived data.
+    std::uint64_t GetDataVersion() const { return data_version; }
+
     bool GetContinueStraightDefault() const override final
     {
         return m_profile_properties->continue_straight_at_waypoint;
@@ -56,6 +56,8 @@ class BaseDataFacade
 
     virtual ComponentID GetComponentID(const NodeID id) const = 0;
 
+    virtual std::size_t GetNumberOfEdgeBasedNodes() const = 0;
+
     virtual std::vector<NodeID> GetUncompressedForwardGeometry(const EdgeID id) const = 0;
 
     virtual std::vector<NodeID> GetUncompressedReverseGeometry(const EdgeID id) const = 0;
@@ -143,6 +145,10 @@ class BaseDataFacade
                                                       const int bearing_range,
                                                       const Approach approach) const = 0;
 
+    // Snaps the input coordinate to the given segment without searching the R-tree
+    virtual PhantomNode NearestPhantomNodeOnSegment(const util::Coordinate input_coordinate,
+                                                    const RTreeLeaf &segment) const = 0;
+
     virtual bool HasLaneData(const EdgeID id) const = 0;
     virtual util::guidance::LaneTupleIdPair GetLaneData(const EdgeID id) const = 0;
     virtual extractor::guidance::TurnLaneDescription
@@ -4,6 +4,7 @@
 #include "storage/storage_config.hpp"
 #include "engine/datafacade/contiguous_block_allocator.hpp"
 
+#include <cstdint>
 #include <memory>
 
 namespace osrm
@@ -30,6 +31,9 @@ class ProcessMemoryAllocator : public ContiguousBlockAllocator
     storage::DataLayout &GetLayout() override final;
     char *GetMemory() override final;
 
+    // size of the memory block that will be allocated for the given dataset
+    static std::uint64_t GetRequiredMemory(const storage::StorageConfig &config);
+
   private:
     std::unique_ptr<char[]> internal_memory;
     std::unique_ptr<storage::DataLayout> internal_layout;
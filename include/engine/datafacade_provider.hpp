@@ -2,6 +2,7 @@
 #define OSRM_ENGINE_DATAFACADE_PROVIDER_HPP
 
 #include "engine/data_watchdog.hpp"
+#include "engine/file_watchdog.hpp"
 #include "engine/datafacade/contiguous_internalmem_datafacade.hpp"
 #include "engine/datafacade/process_memory_allocator.hpp"
 
@@ -37,12 +38,35 @@ template <typename AlgorithmT> class ImmutableProvider final : public DataFacade
     std::shared_ptr<const FacadeT> immutable_data_facade;
 };
 
+template <typename AlgorithmT>
+class FileWatchingProvider final : public DataFacadeProvider<AlgorithmT>
+{
+    using FacadeT = datafacade::ContiguousInternalMemoryDataFacade<AlgorithmT>;
+    FileWatchdog<FacadeT> watchdog;
+
+  public:
+    using WarmupFunction = typename FileWatchdog<FacadeT>::WarmupFunction;
+
+    FileWatchingProvider(const storage::StorageConfig &config,
+                         const std::uint64_t max_memory,
+                         WarmupFunction warmup = {})
+        : watchdog(config, max_memory, std::move(warmup))
+    {
+    }
+
+    std::shared_ptr<const FacadeT> Get() const override final { return watchdog.Get(); }
+};
+
 template <typename AlgorithmT> class WatchingProvider final : public DataFacadeProvider<AlgorithmT>
 {
     using FacadeT = datafacade::ContiguousInternalMemoryDataFacade<AlgorithmT>;
     DataWatchdog<AlgorithmT> watchdog;
 
   public:
+    using WarmupFunction = typename DataWatchdog<AlgorithmT>::WarmupFunction;
+
+    WatchingProvider(WarmupFunction warmup = {}) : watchdog(std::move(warmup)) {}
+
     std::shared_ptr<const FacadeT> Get() const override final
     {
         // We need a singleton here because multiple instances of DataWatchdog
@@ -20,13 +20,21 @@
 #include "engine/plugins/viaroute.hpp"
 #include "engine/routing_algorithms.hpp"
 #include "engine/status.hpp"
+#include "engine/warmup.hpp"
+#include "storage/manifest.hpp"
 #include "util/exception.hpp"
 #include "util/exception_utils.hpp"
 #include "util/fingerprint.hpp"
 #include "util/json_container.hpp"
+#include "util/timing_util.hpp"
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace osrm
 {
@@ -54,25 +62,47 @@ template <typename Algorithm> class Engine final : public EngineInterface
 {
   public:
     explicit Engine(const EngineConfig &config)
-        : route_plugin(config.max_locations_viaroute),       //
-          table_plugin(config.max_locations_distance_table), //
-          nearest_plugin(config.max_results_nearest),        //
-          trip_plugin(config.max_locations_trip),            //
-          match_plugin(config.max_locations_map_matching),   //
-          tile_plugin()                                      //
+        : route_plugin(config.max_locations_viaroute),                               //
+          table_plugin(config.max_locations_distance_table),                         //
+          nearest_plugin(config.max_results_nearest),                                //
+          trip_plugin(config.max_locations_trip, config.max_trip_optimization_time), //
+          match_plugin(config.max_locations_map_matching),                           //
+          tile_plugin(static_cast<std::size_t>(std::max(config.max_tile_cache_memory, 0)) << 20),
+          max_parallel_legs(static_cast<std::size_t>(std::max(config.max_parallel_legs, 1)))
 
     {
+        if (!config.warmup_queries_path.empty() && config.max_warmup_queries > 0)
+        {
+            warmup_queries =
+                loadWarmupQueries(config.warmup_queries_path, config.max_warmup_queries);
+        }
+
         if (config.use_shared_memory)
         {
             util::Log(logDEBUG) << "Using shared memory with algorithm "
                                 << routing_algorithms::name<Algorithm>();
-            facade_provider = std::make_unique<WatchingProvider<Algorithm>>();
+            facade_provider = std::make_unique<WatchingProvider<Algorithm>>(
+                [this](const FacadeT &facade) { Warmup(facade); });
         }
         else
         {
             util::Log(logDEBUG) << "Using internal memory with algorithm "
                                 << routing_algorithms::name<Algorithm>();
-            facade_provider = std::make_unique<ImmutableProvider<Algorithm>>(config.storage_config);
+            if (config.reload_on_change)
+            {
+                const auto max_memory = config.max_reload_memory < 0
+                                            ? std::numeric_limits<std::uint64_t>::max()
+                                            : std::uint64_t(config.max_reload_memory) << 20;
+                facade_provider = std::make_unique<FileWatchingProvider<Algorithm>>(
+                    config.storage_config, max_memory, [this](const FacadeT &facade) {
+                        Warmup(facade);
+                    });
+            }
+            else
+            {
+                facade_provider =
+                    std::make_unique<ImmutableProvider<Algorithm>>(config.storage_config);
+            }
         }
     }
 
@@ -81,13 +111,17 @@ template <typename Algorithm> class Engine final : public EngineInterface
 
     Engine(const Engine &) = delete;
     Engine &operator=(const Engine &) = delete;
-    virtual ~Engine() = default;
+    virtual ~Engine()
+    {
+        // stop the data watchdog before the plugins used for the warm-up are destroyed
+        facade_provider.reset();
+    }
 
     Status Route(const api::RouteParameters &params,
                  util::json::Object &result) const override final
     {
         auto facade = facade_provider->Get();
-        auto algorithms = RoutingAlgorithms<Algorithm>{heaps, *facade};
+        auto algorithms = RoutingAlgorithms<Algorithm>{heaps, *facade, max_parallel_legs};
         return route_plugin.HandleRequest(*facade, algorithms, params, result);
     }
 
@@ -95,7 +129,7 @@ template <typename Algorithm> class Engine final : public EngineInterface
                  util::json::Object &result) const override final
     {
         auto facade = facade_provider->Get();
-        auto algorithms = RoutingAlgorithms<Algorithm>{heaps, *facade};
+        auto algorithms = RoutingAlgorithms<Algorithm>{heaps, *facade, max_parallel_legs};
         return table_plugin.HandleRequest(*facade, algorithms, params, result);
     }
 
@@ -103,14 +137,14 @@ template <typename Algorithm> class Engine final : public EngineInterface
                    util::json::Object &result) const override final
     {
         auto facade = facade_provider->Get();
-        auto algorithms = RoutingAlgorithms<Algorithm>{heaps, *facade};
+        auto algorithms = RoutingAlgorithms<Algorithm>{heaps, *facade, max_parallel_legs};
         return nearest_plugin.HandleRequest(*facade, algorithms, params, result);
     }
 
     Status Trip(const api::TripParameters &params, util::json::Object &result) const override final
     {
         auto facade = facade_provider->Get();
-        auto algorithms = RoutingAlgorithms<Algorithm>{heaps, *facade};
+        auto algorithms = RoutingAlgorithms<Algorithm>{heaps, *facade, max_parallel_legs};
         return trip_plugin.HandleRequest(*facade, algorithms, params, result);
     }
 
@@ -118,20 +152,41 @@ template <typename Algorithm> class Engine final : public EngineInterface
                  util::json::Object &result) const override final
     {
         auto facade = facade_provider->Get();
-        auto algorithms = RoutingAlgorithms<Algorithm>{heaps, *facade};
+        auto algorithms = RoutingAlgorithms<Algorithm>{heaps, *facade, max_parallel_legs};
         return match_plugin.HandleRequest(*facade, algorithms, params, result);
     }
 
     Status Tile(const api::TileParameters &params, std::string &result) const override final
     {
         auto facade = facade_provider->Get();
-        auto algorithms = RoutingAlgorithms<Algorithm>{heaps, *facade};
+        auto algorithms = RoutingAlgorithms<Algorithm>{heaps, *facade, max_parallel_legs};
         return tile_plugin.HandleRequest(*facade, algorithms, params, result);
     }
 
     static bool CheckCompability(const EngineConfig &config);
 
   private:
+    using FacadeT = datafacade::ContiguousInternalMemoryDataFacade<Algorithm>;
+
+    // Replays recorded queries to pull the pages of a new dataset into the cache
+    void Warmup(const FacadeT &facade) const
+    {
+        if (warmup_queries.empty())
+            return;
+
+        TIMER_START(warmup);
+        auto algorithms = RoutingAlgorithms<Algorithm>{heaps, facade, max_parallel_legs};
+        for (const auto &parameters : warmup_queries)
+        {
+            util::json::Object result;
+            route_plugin.HandleRequest(facade, algorithms, parameters, result);
+        }
+        TIMER_STOP(warmup);
+        util::Log() << "Replayed " << warmup_queries.size() << " warm-up queries in "
+                    << TIMER_MSEC(warmup) << "ms";
+    }
+
+    std::vector<api::RouteParameters> warmup_queries;
     std::unique_ptr<DataFacadeProvider<Algorithm>> facade_provider;
     mutable SearchEngineData<Algorithm> heaps;
 
@@ -141,6 +196,7 @@ template <typename Algorithm> class Engine final : public EngineInterface
     const plugins::TripPlugin trip_plugin;
     const plugins::MatchPlugin match_plugin;
     const plugins::TilePlugin tile_plugin;
+    const std::size_t max_parallel_legs;
 };
 
 template <>
@@ -159,6 +215,10 @@ bool Engine<routing_algorithms::ch::Algorithm>::CheckCompability(const EngineCon
     }
     else
     {
+        if (boost::filesystem::exists(config.storage_config.manifest_path))
+            return storage::manifest::readManifest(config.storage_config.manifest_path)
+                .HasCapability(storage::Manifest::CH);
+
         if (!boost::filesystem::exists(config.storage_config.hsgr_data_path))
             return false;
         storage::io::FileReader in(config.storage_config.hsgr_data_path,
@@ -190,6 +250,10 @@ bool Engine<routing_algorithms::corech::Algorithm>::CheckCompability(const Engin
     }
     else
     {
+        if (boost::filesystem::exists(config.storage_config.manifest_path))
+            return storage::manifest::readManifest(config.storage_config.manifest_path)
+                .HasCapability(storage::Manifest::CORE_CH);
+
         if (!boost::filesystem::exists(config.storage_config.core_data_path))
             return false;
         storage::io::FileReader in(config.storage_config.core_data_path,
@@ -215,6 +279,10 @@ bool Engine<routing_algorithms::mld::Algorithm>::CheckCompability(const EngineCo
     }
     else
     {
+        if (boost::filesystem::exists(config.storage_config.manifest_path))
+            return storage::manifest::readManifest(config.storage_config.manifest_path)
+                .HasCapability(storage::Manifest::MLD);
+
         if (!boost::filesystem::exists(config.storage_config.mld_partition_path))
             return false;
         storage::io::FileReader in(config.storage_config.mld_partition_path,
@@ -54,6 +54,21 @@ namespace engine
  *  - Nearest
  *
  * In addition, shared memory can be used for datasets loaded with osrm-datastore.
+ * When a new dataset is loaded into shared memory, up to max_warmup_queries recorded route
+ * queries from warmup_queries_path are replayed before the dataset is used for requests.
+ *
+ * Without shared memory the dataset can be reloaded in the background once the pipeline
+ * tools completed it by setting reload_on_change. The old dataset serves requests until the
+ * new one is loaded. If keeping both in memory would exceed max_reload_memory (in MiB, -1 for
+ * unlimited), the reload is skipped.
+ *
+ * Rendered debug tiles are cached in up to max_tile_cache_memory MiB (0 disables the cache).
+ *
+ * Trips with too many locations for a brute force search are improved by a local search for
+ * up to max_trip_optimization_time milliseconds (0 disables the local search).
+ *
+ * The legs of a via route are searched on up to max_parallel_legs threads (1 searches them one
+ * after another).
  *
  * You can chose between three algorithms:
  *  - Algorithm::CH
@@ -89,6 +104,13 @@ struct EngineConfig final
     int max_results_nearest = -1;
     bool use_shared_memory = true;
     Algorithm algorithm = Algorithm::CH;
+    boost::filesystem::path warmup_queries_path;
+    int max_warmup_queries = 100;
+    bool reload_on_change = false;
+    int max_reload_memory = -1;
+    int max_tile_cache_memory = 0;
+    int max_trip_optimization_time = 0;
+    int max_parallel_legs = 1;
 };
 }
 }
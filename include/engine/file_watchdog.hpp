@@ -0,0 +1,236 @@
+#ifndef OSRM_ENGINE_FILE_WATCHDOG_HPP
+#define OSRM_ENGINE_FILE_WATCHDOG_HPP
+
+#include "engine/datafacade/process_memory_allocator.hpp"
+
+#include "storage/manifest.hpp"
+#include "storage/storage_config.hpp"
+#include "util/log.hpp"
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace osrm
+{
+namespace engine
+{
+
+// This class monitors the dataset files that are loaded into process memory.
+// Once the manifest changes and marks a dataset that the pipeline tools completed,
+// the new dataset is verified against the manifest, loaded in the background and
+// swapped in. Datasets without a manifest are never reloaded.
+//
+// The old dataset keeps serving requests until the new one is loaded. If holding
+// both would exceed max_memory bytes, or loading fails, the reload is skipped.
+template <typename FacadeT> class FileWatchdog final
+{
+  public:
+    using WarmupFunction = std::function<void(const FacadeT &)>;
+    using LoadFunction =
+        std::function<std::shared_ptr<const FacadeT>(const storage::StorageConfig &)>;
+    using MemoryFunction = std::function<std::uint64_t(const storage::StorageConfig &)>;
+
+    FileWatchdog(const storage::StorageConfig &config_,
+                 const std::uint64_t max_memory_,
+                 WarmupFunction warmup_ = {},
+                 LoadFunction load_ = &LoadProcessMemory,
+                 MemoryFunction required_memory_ = &GetRequiredProcessMemory,
+                 const std::chrono::milliseconds poll_interval_ = std::chrono::seconds{1})
+        : config(config_),
+          base_path(boost::filesystem::path{config.manifest_path}.replace_extension()),
+          max_memory(max_memory_), poll_interval(poll_interval_), active(true),
+          cancel(false), warmup(std::move(warmup_)), load(std::move(load_)),
+          required_memory(std::move(required_memory_))
+    {
+        if (!boost::filesystem::exists(config.manifest_path))
+        {
+            util::Log(logWARNING) << "Dataset has no manifest, it will only be reloaded once the "
+                                     "pre-processing tools wrote one";
+        }
+
+        // create the initial facade before launching the watchdog thread
+        last_modified = GetLastModified();
+        last_manifest_contents = GetManifestContents();
+        facade = load(config);
+        facade_memory = required_memory(config);
+
+        watcher = std::thread(&FileWatchdog::Run, this);
+    }
+
+    ~FileWatchdog()
+    {
+        {
+            std::lock_guard<std::mutex> active_lock(active_mutex);
+            active = false;
+            cancel = true;
+        }
+        active_condition.notify_all();
+        watcher.join();
+    }
+
+    std::shared_ptr<const FacadeT> Get() const
+    {
+        std::lock_guard<std::mutex> lock(facade_mutex);
+        return facade;
+    }
+
+  private:
+    static std::shared_ptr<const FacadeT> LoadProcessMemory(const storage::StorageConfig &config)
+    {
+        return std::make_shared<const FacadeT>(
+            std::make_shared<datafacade::ProcessMemoryAllocator>(config));
+    }
+
+    static std::uint64_t GetRequiredProcessMemory(const storage::StorageConfig &config)
+    {
+        return datafacade::ProcessMemoryAllocator::GetRequiredMemory(config);
+    }
+
+    std::time_t GetLastModified() const
+    {
+        boost::system::error_code error;
+        const auto last_modified = boost::filesystem::last_write_time(config.manifest_path, error);
+        return error ? 0 : last_modified;
+    }
+
+    std::string GetManifestContents() const
+    {
+        boost::filesystem::ifstream manifest(config.manifest_path, std::ios::binary);
+        return {std::istreambuf_iterator<char>(manifest), std::istreambuf_iterator<char>()};
+    }
+
+    void Run()
+    {
+        while (active)
+        {
+            {
+                std::unique_lock<std::mutex> active_lock(active_mutex);
+                active_condition.wait_for(active_lock, poll_interval, [this] { return !active; });
+            }
+            if (!active)
+                break;
+
+            // The modification time only has a resolution of a second, so the next pipeline tool
+            // can rewrite the manifest without changing it. The manifest is small and replaced
+            // atomically, comparing its contents catches these rewrites.
+            const auto modified = GetLastModified();
+            auto manifest_contents = GetManifestContents();
+            if (modified == last_modified && manifest_contents == last_manifest_contents)
+                continue;
+
+            // Files that are rewritten while we verify them can make the check throw, in this
+            // case it is repeated on the next poll
+            bool complete = false;
+            try
+            {
+                complete = storage::manifest::isDatasetComplete(base_path, &cancel);
+            }
+            catch (const std::exception &e)
+            {
+                util::Log(logWARNING) << "Dataset changed but can't be verified yet: " << e.what();
+                continue;
+            }
+            last_modified = modified;
+            last_manifest_contents = std::move(manifest_contents);
+
+            // Every pipeline tool rewrites the manifest, we retry once the next one did
+            if (!complete)
+            {
+                if (active)
+                    util::Log(logWARNING) << "Dataset changed but is incomplete, not reloading";
+                continue;
+            }
+
+            try
+            {
+                Reload(modified);
+            }
+            catch (const std::exception &e)
+            {
+                util::Log(logWARNING) << "Reloading the dataset failed, keeping the old one: "
+                                      << e.what();
+            }
+        }
+
+        util::Log() << "FileWatchdog thread stopped";
+    }
+
+    void Reload(const std::time_t modified)
+    {
+        const auto new_memory = required_memory(config);
+        if (facade_memory + new_memory > max_memory)
+        {
+            util::Log(logERROR) << "Not reloading the dataset, holding the old and the new one "
+                                   "needs "
+                                << ((facade_memory + new_memory) >> 20) << " MiB but only "
+                                << (max_memory >> 20) << " MiB are allowed";
+            return;
+        }
+
+        auto new_facade = load(config);
+        if (!new_facade)
+        {
+            util::Log(logERROR) << "Loading the new dataset failed, keeping the old one";
+            return;
+        }
+
+        // A new pipeline run could have started while loading
+        if (GetLastModified() != modified ||
+            !storage::manifest::checkManifest(
+                base_path, storage::manifest::readManifest(config.manifest_path)))
+        {
+            util::Log(logWARNING) << "Dataset changed while reloading, discarding it";
+            return;
+        }
+
+        if (warmup)
+        {
+            warmup(*new_facade);
+        }
+
+        {
+            std::lock_guard<std::mutex> facade_lock(facade_mutex);
+            facade = std::move(new_facade);
+            facade_memory = new_memory;
+        }
+
+        util::Log() << "reloaded dataset with " << (new_memory >> 20) << " MiB";
+    }
+
+    const storage::StorageConfig config;
+    const boost::filesystem::path base_path;
+    const std::uint64_t max_memory;
+    const std::chrono::milliseconds poll_interval;
+
+    std::mutex active_mutex;
+    std::condition_variable active_condition;
+    std::thread watcher;
+    std::atomic<bool> active;
+    std::atomic<bool> cancel;
+    std::time_t last_modified;
+    std::string last_manifest_contents;
+
+    WarmupFunction warmup;
+    LoadFunction load;
+    MemoryFunction required_memory;
+
+    mutable std::mutex facade_mutex;
+    std::shared_ptr<const FacadeT> facade;
+    std::uint64_t facade_memory;
+};
+}
+}
+
+#endif
@@ -393,6 +393,13 @@ template <typename RTreeT, typename DataFacadeT> class GeospatialQuery
                               MakePhantomNode(input_coordinate, results.back()).phantom_node);
     }
 
+    // Snaps to a known segment, e.g. of a compact hint, without searching the R-tree
+    PhantomNode NearestPhantomNodeOnSegment(const util::Coordinate input_coordinate,
+                                            const EdgeData &segment) const
+    {
+        return MakePhantomNode(input_coordinate, segment).phantom_node;
+    }
+
   private:
     std::vector<PhantomNodeWithDistance>
     MakePhantomNodes(const util::Coordinate input_coordinate,
@@ -11,7 +11,10 @@
 #include "util/integer_range.hpp"
 #include "util/json_container.hpp"
 
+#include <boost/optional.hpp>
+
 #include <algorithm>
+#include <cstddef>
 #include <iterator>
 #include <string>
 #include <vector>
@@ -108,6 +111,29 @@ class BasePlugin
         return snapped_phantoms;
     }
 
+    // Returns the phantom node of a valid hint for the coordinate at the given index, so that
+    // the coordinate does not need to be snapped
+    boost::optional<PhantomNode> GetHintedPhantomNode(const datafacade::BaseDataFacade &facade,
+                                                      const api::BaseParameters &parameters,
+                                                      const std::size_t index) const
+    {
+        if (!parameters.hints.empty() && parameters.hints[index] &&
+            parameters.hints[index]->IsValid(parameters.coordinates[index], facade))
+        {
+            return parameters.hints[index]->phantom;
+        }
+        if (!parameters.compact_hints.empty() && parameters.compact_hints[index])
+        {
+            const auto max_distance =
+                !parameters.radiuses.empty() && parameters.radiuses[index]
+                    ? *parameters.radiuses[index]
+                    : DEFAULT_COMPACT_HINT_MAX_DISTANCE;
+            return parameters.compact_hints[index]->ToPhantomNode(
+                parameters.coordinates[index], max_distance, facade);
+        }
+        return boost::none;
+    }
+
     // Falls back to default_radius for non-set radii
     std::vector<std::vector<PhantomNodeWithDistance>>
     GetPhantomNodesInRange(const datafacade::BaseDataFacade &facade,
@@ -118,7 +144,6 @@ class BasePlugin
             parameters.coordinates.size());
         BOOST_ASSERT(radiuses.size() == parameters.coordinates.size());
 
-        const bool use_hints = !parameters.hints.empty();
         const bool use_bearings = !parameters.bearings.empty();
         const bool use_approaches = !parameters.approaches.empty();
 
@@ -128,13 +153,12 @@ class BasePlugin
             if (use_approaches && parameters.approaches[i])
                 approach = parameters.approaches[i].get();
 
-            if (use_hints && parameters.hints[i] &&
-                parameters.hints[i]->IsValid(parameters.coordinates[i], facade))
+            if (const auto hinted_phantom = GetHintedPhantomNode(facade, parameters, i))
             {
                 phantom_nodes[i].push_back(PhantomNodeWithDistance{
-                    parameters.hints[i]->phantom,
-                    util::coordinate_calculation::haversineDistance(
-                        parameters.coordinates[i], parameters.hints[i]->phantom.location),
+                    *hinted_phantom,
+                    util::coordinate_calculation::haversineDistance(parameters.coordinates[i],
+                                                                    hinted_phantom->location),
                 });
                 continue;
             }
@@ -165,7 +189,6 @@ class BasePlugin
         std::vector<std::vector<PhantomNodeWithDistance>> phantom_nodes(
             parameters.coordinates.size());
 
-        const bool use_hints = !parameters.hints.empty();
         const bool use_bearings = !parameters.bearings.empty();
         const bool use_radiuses = !parameters.radiuses.empty();
         const bool use_approaches = !parameters.approaches.empty();
@@ -177,13 +200,12 @@ class BasePlugin
             if (use_approaches && parameters.approaches[i])
                 approach = parameters.approaches[i].get();
 
-            if (use_hints && parameters.hints[i] &&
-                parameters.hints[i]->IsValid(parameters.coordinates[i], facade))
+            if (const auto hinted_phantom = GetHintedPhantomNode(facade, parameters, i))
             {
                 phantom_nodes[i].push_back(PhantomNodeWithDistance{
-                    parameters.hints[i]->phantom,
-                    util::coordinate_calculation::haversineDistance(
-                        parameters.coordinates[i], parameters.hints[i]->phantom.location),
+                    *hinted_phantom,
+                    util::coordinate_calculation::haversineDistance(parameters.coordinates[i],
+                                                                    hinted_phantom->location),
                 });
                 continue;
             }
@@ -238,7 +260,6 @@ class BasePlugin
     {
         std::vector<PhantomNodePair> phantom_node_pairs(parameters.coordinates.size());
 
-        const bool use_hints = !parameters.hints.empty();
         const bool use_bearings = !parameters.bearings.empty();
         const bool use_radiuses = !parameters.radiuses.empty();
         const bool use_approaches = !parameters.approaches.empty();
@@ -250,10 +271,9 @@ class BasePlugin
             if (use_approaches && parameters.approaches[i])
                 approach = parameters.approaches[i].get();
 
-            if (use_hints && parameters.hints[i] &&
-                parameters.hints[i]->IsValid(parameters.coordinates[i], facade))
+            if (const auto hinted_phantom = GetHintedPhantomNode(facade, parameters, i))
             {
-                phantom_node_pairs[i].first = parameters.hints[i]->phantom;
+                phantom_node_pairs[i].first = *hinted_phantom;
                 // we don't set the second one - it will be marked as invalid
                 continue;
             }
@@ -4,7 +4,10 @@
 #include "engine/api/tile_parameters.hpp"
 #include "engine/plugins/plugin_base.hpp"
 #include "engine/routing_algorithms.hpp"
+#include "engine/tile_cache.hpp"
 
+#include <cstddef>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -26,10 +29,16 @@ namespace plugins
 class TilePlugin final : public BasePlugin
 {
   public:
+    // Caches up to max_cache_size bytes of rendered tiles, 0 disables the cache
+    explicit TilePlugin(std::size_t max_cache_size = 0);
+
     Status HandleRequest(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
                          const RoutingAlgorithmsInterface &algorithms,
                          const api::TileParameters &parameters,
                          std::string &pbf_buffer) const;
+
+  private:
+    std::unique_ptr<TileCache> cache;
 };
 }
 }
@@ -29,6 +29,8 @@ class TripPlugin final : public BasePlugin
 {
   private:
     const int max_locations_trip;
+    // time in ms to improve trips that are too large for the brute force search, 0 disables it
+    const int max_trip_optimization_time;
 
     InternalRouteResult ComputeRoute(const RoutingAlgorithmsInterface &algorithms,
                                      const std::vector<PhantomNode> &phantom_node_list,
@@ -36,7 +38,11 @@ class TripPlugin final : public BasePlugin
                                      const bool roundtrip) const;
 
   public:
-    explicit TripPlugin(const int max_locations_trip_) : max_locations_trip(max_locations_trip_) {}
+    explicit TripPlugin(const int max_locations_trip_, const int max_trip_optimization_time_ = 0)
+        : max_locations_trip(max_locations_trip_),
+          max_trip_optimization_time(max_trip_optimization_time_)
+    {
+    }
 
     Status HandleRequest(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
                          const RoutingAlgorithmsInterface &algorithms,
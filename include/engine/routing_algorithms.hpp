@@ -58,8 +58,9 @@ template <typename Algorithm> class RoutingAlgorithms final : public RoutingAlgo
 {
   public:
     RoutingAlgorithms(SearchEngineData<Algorithm> &heaps,
-                      const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade)
-        : heaps(heaps), facade(facade)
+                      const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+                      const std::size_t max_parallel_legs = 1)
+        : heaps(heaps), facade(facade), max_parallel_legs(max_parallel_legs)
     {
     }
 
@@ -126,6 +127,9 @@ template <typename Algorithm> class RoutingAlgorithms final : public RoutingAlgo
 
     // Owned by shared-ptr passed to the query
     const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade;
+
+    // Max. number of legs of a via route that are searched at the same time
+    const std::size_t max_parallel_legs;
 };
 
 template <typename Algorithm>
@@ -141,7 +145,7 @@ InternalRouteResult RoutingAlgorithms<Algorithm>::ShortestPathSearch(
     const boost::optional<bool> continue_straight_at_waypoint) const
 {
     return routing_algorithms::shortestPathSearch(
-        heaps, facade, phantom_node_pair, continue_straight_at_waypoint);
+        heaps, facade, phantom_node_pair, continue_straight_at_waypoint, max_parallel_legs);
 }
 
 template <typename Algorithm>
@@ -0,0 +1,68 @@
+#ifndef OSRM_ENGINE_TILE_CACHE_HPP
+#define OSRM_ENGINE_TILE_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace osrm
+{
+namespace engine
+{
+
+/**
+ * Thread-safe LRU cache of encoded vector tiles with a limit on the total size of the tiles.
+ *
+ * A tile is identified by its z/x/y coordinates and the version of the dataset it was
+ * rendered from, so tiles of an updated dataset are rendered again and the stale tiles are
+ * evicted eventually.
+ */
+class TileCache
+{
+  public:
+    struct Key
+    {
+        std::uint64_t data_version;
+        unsigned z;
+        unsigned x;
+        unsigned y;
+
+        bool operator==(const Key &other) const
+        {
+            return data_version == other.data_version && z == other.z && x == other.x &&
+                   y == other.y;
+        }
+    };
+
+    explicit TileCache(std::size_t max_size);
+
+    // Returns false if the tile is not cached
+    bool Get(const Key &key, std::string &tile);
+    // Tiles larger than the maximum size of the cache are not cached
+    void Put(const Key &key, const std::string &tile);
+
+    std::size_t GetSize() const;
+
+  private:
+    struct KeyHash
+    {
+        std::size_t operator()(const Key &key) const;
+    };
+
+    using Entry = std::pair<Key, std::shared_ptr<const std::string>>;
+
+    const std::size_t max_size;
+    mutable std::mutex mutex;
+    // ordered from the most to the least recently used tile
+    std::list<Entry> entries;
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+    std::size_t size = 0;
+};
+}
+}
+
+#endif
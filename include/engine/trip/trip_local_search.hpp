@@ -0,0 +1,432 @@
+#ifndef TRIP_LOCAL_SEARCH_HPP
+#define TRIP_LOCAL_SEARCH_HPP
+
+#include "util/dist_table_wrapper.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_scheduler_init.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+namespace trip
+{
+
+// 64 bit, so legs with INVALID_EDGE_WEIGHT sum up without overflow and are never chosen
+using TripCost = std::int64_t;
+
+inline TripCost GetTripCost(const std::vector<NodeID> &trip,
+                            const util::DistTableWrapper<EdgeWeight> &dist_table)
+{
+    TripCost cost = 0;
+    for (std::size_t index = 0; index < trip.size(); ++index)
+        cost += dist_table(trip[index], trip[(index + 1) % trip.size()]);
+    return cost;
+}
+
+// Visits the nearest unvisited location next, starting at the first location. Unlike
+// NearestNeighbourTrip this tries only one start, so it is O(n^2).
+inline std::vector<NodeID> NearestNeighbourTour(const std::size_t number_of_locations,
+                                                const util::DistTableWrapper<EdgeWeight> &dist_table)
+{
+    std::vector<NodeID> trip;
+    trip.reserve(number_of_locations);
+    std::vector<bool> visited(number_of_locations, false);
+
+    NodeID current = 0;
+    visited[current] = true;
+    trip.push_back(current);
+    for (std::size_t added_nodes = 1; added_nodes < number_of_locations; ++added_nodes)
+    {
+        NodeID next = SPECIAL_NODEID;
+        for (NodeID candidate = 0; candidate < number_of_locations; ++candidate)
+        {
+            if (!visited[candidate] &&
+                (next == SPECIAL_NODEID ||
+                 dist_table(current, candidate) < dist_table(current, next)))
+            {
+                next = candidate;
+            }
+        }
+        BOOST_ASSERT(next != SPECIAL_NODEID);
+        visited[next] = true;
+        trip.push_back(next);
+        current = next;
+    }
+    return trip;
+}
+
+namespace detail
+{
+
+// A round trip that supports 2-opt and Or-opt moves on an asymmetric distance table. The prefix
+// sums of the forward and backward leg costs give the cost of a reversed segment in O(1).
+class LocalSearchTour
+{
+  public:
+    LocalSearchTour(std::vector<NodeID> trip_,
+                    const util::DistTableWrapper<EdgeWeight> &dist_table_,
+                    const std::vector<std::vector<NodeID>> &neighbours_)
+        : trip(std::move(trip_)), dist_table(dist_table_), neighbours(neighbours_),
+          position(trip.size()), forward(trip.size() + 1), backward(trip.size() + 1),
+          is_active(trip.size(), false)
+    {
+        Update();
+    }
+
+    const std::vector<NodeID> &GetTrip() const { return trip; }
+
+    TripCost GetCost() const { return forward.back(); }
+
+    void SetTrip(const std::vector<NodeID> &new_trip)
+    {
+        trip = new_trip;
+        Update();
+    }
+
+    // Applies improving moves of active locations until there are none or the deadline passed
+    template <typename Clock> void Optimize(const typename Clock::time_point deadline)
+    {
+        while (!active.empty() && Clock::now() < deadline)
+        {
+            const auto node = active.front();
+            active.pop_front();
+            is_active[node] = false;
+
+            if (TryTwoOpt(node) || TryOrOpt(node))
+                Activate(node);
+        }
+    }
+
+    void ActivateAll()
+    {
+        for (const auto node : trip)
+            Activate(node);
+    }
+
+    // Reconnects four random segments A B C D as A C B D. This kick can not be undone by 2-opt
+    // or Or-opt moves and keeps the direction of all segments.
+    template <typename Generator> void DoubleBridge(Generator &generator)
+    {
+        const auto size = trip.size();
+        BOOST_ASSERT(size >= 8);
+        std::uniform_int_distribution<std::size_t> cut(1, size - 1);
+        std::size_t cuts[3];
+        do
+        {
+            cuts[0] = cut(generator);
+            cuts[1] = cut(generator);
+            cuts[2] = cut(generator);
+            std::sort(std::begin(cuts), std::end(cuts));
+        } while (cuts[0] == cuts[1] || cuts[1] == cuts[2]);
+
+        std::vector<NodeID> kicked;
+        kicked.reserve(size);
+        kicked.insert(kicked.end(), trip.begin(), trip.begin() + cuts[0]);
+        kicked.insert(kicked.end(), trip.begin() + cuts[1], trip.begin() + cuts[2]);
+        kicked.insert(kicked.end(), trip.begin() + cuts[0], trip.begin() + cuts[1]);
+        kicked.insert(kicked.end(), trip.begin() + cuts[2], trip.end());
+
+        for (const auto cut_position : cuts)
+        {
+            Activate(trip[cut_position - 1]);
+            Activate(trip[cut_position]);
+        }
+        Activate(trip.front());
+        Activate(trip.back());
+
+        SetTrip(kicked);
+    }
+
+  private:
+    TripCost Cost(const NodeID from, const NodeID to) const { return dist_table(from, to); }
+
+    std::size_t Next(const std::size_t index) const { return (index + 1) % trip.size(); }
+
+    void Update()
+    {
+        const auto size = trip.size();
+        for (std::size_t index = 0; index < size; ++index)
+        {
+            position[trip[index]] = index;
+            const auto next = trip[Next(index)];
+            forward[index + 1] = forward[index] + Cost(trip[index], next);
+            backward[index + 1] = backward[index] + Cost(next, trip[index]);
+        }
+    }
+
+    void Activate(const NodeID node)
+    {
+        if (!is_active[node])
+        {
+            is_active[node] = true;
+            active.push_back(node);
+        }
+    }
+
+    // Cost change of reversing trip[first + 1..last], which replaces the legs
+    // (trip[first], trip[first + 1]) and (trip[last], trip[last + 1])
+    TripCost TwoOptDelta(const std::size_t first, const std::size_t last) const
+    {
+        BOOST_ASSERT(first + 1 < last && last < trip.size());
+        const auto a = trip[first], b = trip[first + 1];
+        const auto c = trip[last], d = trip[Next(last)];
+        const auto reversed = backward[last] - backward[first + 1];
+        const auto kept = forward[last] - forward[first + 1];
+        return Cost(a, c) + Cost(b, d) + reversed - Cost(a, b) - Cost(c, d) - kept;
+    }
+
+    // Moves that make node and one of its nearest neighbours adjacent
+    bool TryTwoOpt(const NodeID node)
+    {
+        const auto size = trip.size();
+        const auto index = position[node];
+
+        TripCost best_delta = 0;
+        std::size_t best_first = 0, best_last = 0;
+        const auto consider = [&](const std::size_t first, const std::size_t last) {
+            if (first + 1 < last && last < size)
+            {
+                const auto delta = TwoOptDelta(first, last);
+                if (delta < best_delta)
+                {
+                    best_delta = delta;
+                    best_first = first;
+                    best_last = last;
+                }
+            }
+        };
+
+        for (const auto neighbour : neighbours[node])
+        {
+            const auto first = std::min(index, position[neighbour]);
+            const auto last = std::max(index, position[neighbour]);
+            consider(first, last);
+            if (first > 0)
+                consider(first - 1, last - 1);
+        }
+
+        if (best_delta >= 0)
+            return false;
+
+        for (const auto moved : {trip[best_first],
+                                 trip[best_first + 1],
+                                 trip[best_last],
+                                 trip[Next(best_last)]})
+            Activate(moved);
+        std::reverse(trip.begin() + best_first + 1, trip.begin() + best_last + 1);
+        Update();
+        return true;
+    }
+
+    // Moves a segment of up to three locations that starts or ends with node between one of
+    // the nearest neighbours of its ends and their neighbour in the trip, optionally reversed
+    bool TryOrOpt(const NodeID node)
+    {
+        const auto size = trip.size();
+        const auto index = position[node];
+
+        TripCost best_delta = 0;
+        std::size_t best_start = 0, best_end = 0, best_after = 0;
+        bool best_reversed = false;
+
+        for (std::size_t length = 1; length <= 3 && length + 3 <= size; ++length)
+        {
+            for (const auto start : {index, index + 1 - length})
+            {
+                // segments that wrap around the end of the trip are skipped
+                const auto end = start + length - 1;
+                if (start > index || end >= size)
+                    continue;
+
+                const auto before = trip[(start + size - 1) % size];
+                const auto after = trip[Next(end)];
+                const auto first = trip[start], last = trip[end];
+                const auto removed = Cost(before, first) + Cost(last, after) - Cost(before, after);
+                const auto kept = forward[end] - forward[start];
+                const auto reversed = backward[end] - backward[start];
+
+                const auto consider = [&](const std::size_t insert_after) {
+                    // the leg (trip[insert_after], trip[insert_after + 1]) must not touch
+                    // the segment
+                    const auto distance = (insert_after + size - start) % size;
+                    if (distance < length || distance == size - 1)
+                        return;
+
+                    const auto x = trip[insert_after], y = trip[Next(insert_after)];
+                    const auto forward_delta =
+                        Cost(x, first) + Cost(last, y) - Cost(x, y) - removed;
+                    const auto reversed_delta =
+                        Cost(x, last) + Cost(first, y) - Cost(x, y) + reversed - kept - removed;
+                    if (forward_delta < best_delta)
+                    {
+                        best_delta = forward_delta;
+                        best_start = start;
+                        best_end = end;
+                        best_after = insert_after;
+                        best_reversed = false;
+                    }
+                    if (reversed_delta < best_delta)
+                    {
+                        best_delta = reversed_delta;
+                        best_start = start;
+                        best_end = end;
+                        best_after = insert_after;
+                        best_reversed = true;
+                    }
+                };
+
+                for (const auto end_node : {first, last})
+                {
+                    for (const auto neighbour : neighbours[end_node])
+                    {
+                        consider(position[neighbour]);
+                        consider((position[neighbour] + size - 1) % size);
+                    }
+                }
+            }
+        }
+
+        if (best_delta >= 0)
+            return false;
+
+        Activate(trip[(best_start + size - 1) % size]);
+        Activate(trip[Next(best_end)]);
+        Activate(trip[best_after]);
+        Activate(trip[Next(best_after)]);
+
+        std::vector<NodeID> segment(trip.begin() + best_start, trip.begin() + best_end + 1);
+        if (best_reversed)
+            std::reverse(segment.begin(), segment.end());
+        const auto insert_after_node = trip[best_after];
+
+        trip.erase(trip.begin() + best_start, trip.begin() + best_end + 1);
+        const auto insert_position =
+            std::find(trip.begin(), trip.end(), insert_after_node) - trip.begin() + 1;
+        trip.insert(trip.begin() + insert_position, segment.begin(), segment.end());
+        Update();
+        return true;
+    }
+
+    std::vector<NodeID> trip;
+    const util::DistTableWrapper<EdgeWeight> &dist_table;
+    const std::vector<std::vector<NodeID>> &neighbours;
+
+    std::vector<std::size_t> position;
+    // forward[i] is the cost of the legs up to trip[i], backward[i] of the reversed legs
+    std::vector<TripCost> forward;
+    std::vector<TripCost> backward;
+
+    // locations whose moves are evaluated, the others are at a local optimum
+    std::deque<NodeID> active;
+    std::vector<bool> is_active;
+};
+
+// The locations with the cheapest legs from every location
+inline std::vector<std::vector<NodeID>>
+GetNearestNeighbours(const util::DistTableWrapper<EdgeWeight> &dist_table,
+                     const std::size_t number_of_neighbours)
+{
+    const auto number_of_locations = dist_table.GetNumberOfNodes();
+    std::vector<std::vector<NodeID>> neighbours(number_of_locations);
+    std::vector<NodeID> candidates;
+    for (NodeID node = 0; node < number_of_locations; ++node)
+    {
+        candidates.resize(number_of_locations);
+        std::iota(candidates.begin(), candidates.end(), 0);
+        candidates.erase(candidates.begin() + node);
+        const auto count = std::min(number_of_neighbours, candidates.size());
+        std::partial_sort(candidates.begin(),
+                          candidates.begin() + count,
+                          candidates.end(),
+                          [&](const NodeID lhs, const NodeID rhs) {
+                              return dist_table(node, lhs) < dist_table(node, rhs);
+                          });
+        neighbours[node].assign(candidates.begin(), candidates.begin() + count);
+    }
+    return neighbours;
+}
+}
+
+// Improves a round trip with 2-opt and Or-opt moves between nearby locations until it reaches
+// a local optimum. The rest of the time budget is spent on iterated local search on all
+// threads: every thread kicks the best trip it knows with a double bridge move and optimizes
+// it again. The given trip is only replaced by a strictly shorter one, so the result is never
+// worse than the first local optimum. The number of kicks depends on the time budget, the
+// machine load and the scheduling of the threads though, so the result is only deterministic
+// for a fixed number of iterations and can differ between runs of the same request.
+inline std::vector<NodeID> LocalSearchTrip(std::vector<NodeID> trip,
+                                           const util::DistTableWrapper<EdgeWeight> &dist_table,
+                                           const std::chrono::milliseconds time_budget)
+{
+    using Clock = std::chrono::steady_clock;
+    const auto deadline = Clock::now() + time_budget;
+
+    const constexpr std::size_t NUMBER_OF_NEIGHBOURS = 10;
+    const auto neighbours = detail::GetNearestNeighbours(dist_table, NUMBER_OF_NEIGHBOURS);
+
+    detail::LocalSearchTour tour(std::move(trip), dist_table, neighbours);
+    tour.ActivateAll();
+    tour.Optimize<Clock>(deadline);
+
+    // smaller trips can not be kicked and are found by the first local search anyway
+    const constexpr std::size_t MIN_LOCATIONS_FOR_KICKS = 8;
+    const auto number_of_locations = tour.GetTrip().size();
+    if (number_of_locations < MIN_LOCATIONS_FOR_KICKS || Clock::now() >= deadline)
+        return tour.GetTrip();
+
+    // stop early if kicks do not find better trips anymore, e.g. for small trips
+    const auto max_failed_kicks = 50 * number_of_locations;
+
+    const auto number_of_searches = tbb::task_scheduler_init::default_num_threads();
+    std::vector<std::vector<NodeID>> best_trips(number_of_searches, tour.GetTrip());
+    std::vector<TripCost> best_costs(number_of_searches, tour.GetCost());
+    tbb::parallel_for(
+        tbb::blocked_range<std::size_t>(0, number_of_searches, 1),
+        [&](const tbb::blocked_range<std::size_t> &range) {
+            for (auto search = range.begin(); search < range.end(); ++search)
+            {
+                std::mt19937 generator(search);
+                detail::LocalSearchTour search_tour(best_trips[search], dist_table, neighbours);
+                std::size_t failed_kicks = 0;
+                while (failed_kicks < max_failed_kicks && Clock::now() < deadline)
+                {
+                    search_tour.DoubleBridge(generator);
+                    search_tour.Optimize<Clock>(deadline);
+                    if (search_tour.GetCost() < best_costs[search])
+                    {
+                        best_costs[search] = search_tour.GetCost();
+                        best_trips[search] = search_tour.GetTrip();
+                        failed_kicks = 0;
+                    }
+                    else
+                    {
+                        search_tour.SetTrip(best_trips[search]);
+                        ++failed_kicks;
+                    }
+                }
+            }
+        });
+
+    const auto best_search =
+        std::min_element(best_costs.begin(), best_costs.end()) - best_costs.begin();
+    return best_costs[best_search] < tour.GetCost() ? best_trips[best_search] : tour.GetTrip();
+}
+}
+}
+}
+
+#endif // TRIP_LOCAL_SEARCH_HPP
@@ -0,0 +1,38 @@
+#ifndef OSRM_ENGINE_WARMUP_HPP
+#define OSRM_ENGINE_WARMUP_HPP
+
+#include "engine/api/route_parameters.hpp"
+#include "engine/datafacade/contiguous_block_allocator.hpp"
+
+#include <boost/filesystem/path.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace osrm
+{
+namespace engine
+{
+
+/**
+ * Prefaults the blocks of a freshly attached dataset that are touched by every query
+ * (search graph, r-tree, coordinates and geometries).
+ *
+ * This avoids page faults and TLB misses on the first requests after a data update.
+ */
+void prefaultHotBlocks(datafacade::ContiguousBlockAllocator &allocator);
+
+/**
+ * Reads up to `max_queries` recorded route queries from a file with one query per line.
+ *
+ * Lines can either be request paths like they are generated by scripts/osrm-runner.js
+ * (e.g. /route/v1/driving/13.38,52.51;13.39,52.52?overview=false) or plain coordinate lists
+ * (e.g. 13.38,52.51;13.39,52.52). Only the coordinates are used. If the file contains
+ * more queries than requested an evenly spaced sample is returned.
+ */
+std::vector<api::RouteParameters> loadWarmupQueries(const boost::filesystem::path &path,
+                                                    const std::size_t max_queries);
+}
+}
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef OSRM_EXTRACTOR_CONDITIONAL_TURN_INDEX_HPP
+#define OSRM_EXTRACTOR_CONDITIONAL_TURN_INDEX_HPP
+
+#include "extractor/restriction.hpp"
+
+#include "util/integer_range.hpp"
+#include "util/std_hash.hpp"
+#include "util/typedefs.hpp"
+
+#include <boost/assert.hpp>
+#include <boost/range/iterator_range.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace extractor
+{
+
+// Maps every conditional turn restriction to the edge-based turns that it forbids while its
+// condition holds. The turns of restriction i are turns[offsets[i]] to turns[offsets[i + 1]].
+struct ConditionalTurnIndex
+{
+    std::vector<std::uint64_t> offsets;
+    std::vector<std::uint64_t> turns;
+
+    std::size_t GetNumberOfRestrictions() const
+    {
+        return offsets.empty() ? 0 : offsets.size() - 1;
+    }
+
+    auto GetTurns(const std::size_t restriction) const
+    {
+        BOOST_ASSERT(restriction < GetNumberOfRestrictions());
+        return boost::make_iterator_range(turns.begin() + offsets[restriction],
+                                          turns.begin() + offsets[restriction + 1]);
+    }
+};
+
+// A no_* restriction forbids the turn from its from to its to node, an only_* restriction all
+// other turns from its from node at the via node. The turn index of the .osrm.turn_penalties_index
+// file is scanned once in parallel.
+template <typename TurnIndexT>
+ConditionalTurnIndex buildConditionalTurnIndex(const std::vector<TurnRestriction> &restrictions,
+                                               const TurnIndexT &turn_index)
+{
+    std::unordered_map<std::pair<NodeID, NodeID>, std::vector<std::uint32_t>> from_via_restrictions;
+    for (const auto restriction : util::irange<std::uint32_t>(0, restrictions.size()))
+    {
+        const auto &turn = restrictions[restriction];
+        from_via_restrictions[std::make_pair(turn.from.node, turn.via.node)].push_back(
+            restriction);
+    }
+
+    using RestrictedTurns = std::vector<std::pair<std::uint32_t, std::uint64_t>>;
+    tbb::enumerable_thread_specific<RestrictedTurns> thread_restricted_turns;
+    tbb::parallel_for(tbb::blocked_range<std::uint64_t>(0, turn_index.size()),
+                      [&](const tbb::blocked_range<std::uint64_t> &range) {
+                          auto &restricted_turns = thread_restricted_turns.local();
+                          for (auto turn = range.begin(); turn < range.end(); ++turn)
+                          {
+                              const auto &block = turn_index[turn];
+                              const auto candidates = from_via_restrictions.find(
+                                  std::make_pair(block.from_id, block.via_id));
+                              if (candidates == from_via_restrictions.end())
+                                  continue;
+
+                              for (const auto restriction : candidates->second)
+                              {
+                                  const auto &restricted = restrictions[restriction];
+                                  const bool is_restricted_turn =
+                                      restricted.to.node == block.to_id;
+                                  if (restricted.flags.is_only != is_restricted_turn)
+                                      restricted_turns.emplace_back(restriction, turn);
+                              }
+                          }
+                      });
+
+    RestrictedTurns restricted_turns;
+    for (const auto &local_restricted_turns : thread_restricted_turns)
+    {
+        restricted_turns.insert(
+            restricted_turns.end(), local_restricted_turns.begin(), local_restricted_turns.end());
+    }
+    std::sort(restricted_turns.begin(), restricted_turns.end());
+
+    ConditionalTurnIndex index;
+    index.offsets.reserve(restrictions.size() + 1);
+    index.turns.reserve(restricted_turns.size());
+    auto restricted_turn = restricted_turns.begin();
+    for (const auto restriction : util::irange<std::uint32_t>(0, restrictions.size()))
+    {
+        index.offsets.push_back(index.turns.size());
+        for (; restricted_turn != restricted_turns.end() && restricted_turn->first == restriction;
+             ++restricted_turn)
+        {
+            index.turns.push_back(restricted_turn->second);
+        }
+    }
+    index.offsets.push_back(index.turns.size());
+
+    return index;
+}
+}
+}
+
+#endif
@@ -6,6 +6,8 @@
 #include "util/typedefs.hpp"
 
 #include <cstdint>
+#include <limits>
+#include <tuple>
 
 namespace osrm
 {
@@ -54,6 +56,36 @@ struct ExternalMemoryNodeSTXXLCompare
         return left.node_id < right.node_id;
     }
 };
+
+// A node with the Hilbert code of its coordinate, used to number nodes along the curve
+struct HilbertOrderedNode
+{
+    std::uint64_t hilbert_code;
+    ExternalMemoryNode node;
+
+    static HilbertOrderedNode min_value()
+    {
+        return {std::numeric_limits<std::uint64_t>::min(), ExternalMemoryNode::min_value()};
+    }
+
+    static HilbertOrderedNode max_value()
+    {
+        return {std::numeric_limits<std::uint64_t>::max(), ExternalMemoryNode::max_value()};
+    }
+};
+
+// Breaks ties by the OSM id, the order in which the nodes are collected
+struct HilbertOrderedNodeSTXXLCompare
+{
+    using value_type = HilbertOrderedNode;
+    value_type max_value() { return value_type::max_value(); }
+    value_type min_value() { return value_type::min_value(); }
+    bool operator()(const value_type &left, const value_type &right) const
+    {
+        return std::tie(left.hilbert_code, left.node.node_id) <
+               std::tie(right.hilbert_code, right.node.node_id);
+    }
+};
 }
 }
 
@@ -13,6 +13,7 @@
 #include <cstdint>
 #include <stxxl/vector>
 #include <unordered_map>
+#include <vector>
 
 namespace osrm
 {
@@ -44,9 +45,12 @@ class ExtractionContainers
     void WriteEdges(storage::io::FileWriter &file_out) const;
     void WriteCharData(const std::string &file_name);
 
+    const std::uint64_t sort_memory;
+
   public:
     using STXXLNodeIDVector = stxxl::vector<OSMNodeID>;
     using STXXLNodeVector = stxxl::vector<ExternalMemoryNode>;
+    using STXXLHilbertOrderedNodeVector = stxxl::vector<HilbertOrderedNode>;
     using STXXLEdgeVector = stxxl::vector<InternalExtractorEdge>;
     using RestrictionsVector = std::vector<InputRestrictionContainer>;
     using STXXLWayIDStartEndVector = stxxl::vector<FirstAndLastSegmentOfWay>;
@@ -61,11 +65,14 @@ class ExtractionContainers
     // an adjacency array containing all turn lane masks
     RestrictionsVector restrictions_list;
     STXXLWayIDStartEndVector way_start_end_id_list;
+    // nodes that are referenced by ways, indexed by their internal id
+    STXXLHilbertOrderedNodeVector used_nodes_list;
     std::unordered_map<OSMNodeID, NodeID> external_to_internal_node_id_map;
     unsigned max_internal_node_id;
     std::vector<TurnRestriction> unconditional_turn_restrictions;
 
-    ExtractionContainers();
+    // Data that fits twice into sort_memory bytes is sorted in memory
+    explicit ExtractionContainers(const std::uint64_t sort_memory = 0);
 
     void PrepareData(ScriptingEnvironment &scripting_environment,
                      const std::string &output_file_name,
@@ -1,14 +1,20 @@
 #ifndef EXTRACTOR_CALLBACKS_HPP
 #define EXTRACTOR_CALLBACKS_HPP
 
+#include "extractor/external_memory_node.hpp"
+#include "extractor/first_and_last_segment_of_way.hpp"
 #include "extractor/guidance/turn_lane_types.hpp"
+#include "extractor/internal_extractor_edge.hpp"
+#include "extractor/restriction.hpp"
 #include "util/typedefs.hpp"
 
 #include <boost/functional/hash.hpp>
 #include <boost/optional/optional_fwd.hpp>
 
 #include <string>
+#include <tuple>
 #include <unordered_map>
+#include <vector>
 
 namespace osmium
 {
@@ -40,24 +46,50 @@ namespace extractor
 {
 
 class ExtractionContainers;
-struct InputRestrictionContainer;
 struct ExtractionNode;
 struct ExtractionWay;
 struct ProfileProperties;
 
+/**
+ * The extracted data of one block of OSM objects.
+ *
+ * Edges refer to names and turn lane descriptions by their index into the local tables of
+ * the buffer, the global ids are only assigned once the buffer is stored.
+ */
+struct ExtractionBuffer
+{
+    // street name, destinations, ref and pronunciation
+    using NameKey = std::tuple<std::string, std::string, std::string, std::string>;
+
+    std::vector<ExternalMemoryNode> nodes;
+    std::vector<OSMNodeID> used_node_ids;
+    std::vector<InternalExtractorEdge> edges;
+    std::vector<FirstAndLastSegmentOfWay> way_start_end_ids;
+    std::vector<InputRestrictionContainer> restrictions;
+
+    std::vector<NameKey> names;
+    std::unordered_map<NameKey, NameID> name_ids;
+    std::vector<guidance::TurnLaneDescription> lane_descriptions;
+    std::unordered_map<guidance::TurnLaneDescription,
+                       LaneDescriptionID,
+                       guidance::TurnLaneDescription_hash>
+        lane_description_ids;
+};
+
 /**
  * This class is used by the extractor with the results of the
  * osmium based parsing and the customization through the lua profile.
  *
- * It mediates between the multi-threaded extraction process and the external memory containers.
- * Thus the synchronization is handled inside of the extractor.
+ * The Process* functions only write to the given buffer and can be called from
+ * multiple threads at once with different buffers. StoreBuffer assigns the global
+ * name and turn lane ids and appends a buffer to the external memory containers.
  */
 class ExtractorCallbacks
 {
   private:
     // used to deduplicate street names, refs, destinations, pronunciation: actually maps to name
     // ids
-    using MapKey = std::tuple<std::string, std::string, std::string, std::string>;
+    using MapKey = ExtractionBuffer::NameKey;
     using MapVal = unsigned;
     std::unordered_map<MapKey, MapVal> string_map;
     guidance::LaneDescriptionMap lane_description_map;
@@ -72,14 +104,20 @@ class ExtractorCallbacks
     ExtractorCallbacks(const ExtractorCallbacks &) = delete;
     ExtractorCallbacks &operator=(const ExtractorCallbacks &) = delete;
 
-    // warning: caller needs to take care of synchronization!
-    void ProcessNode(const osmium::Node &current_node, const ExtractionNode &result_node);
+    void ProcessNode(const osmium::Node &current_node,
+                     const ExtractionNode &result_node,
+                     ExtractionBuffer &buffer) const;
 
-    // warning: caller needs to take care of synchronization!
-    void ProcessRestriction(const boost::optional<InputRestrictionContainer> &restriction);
+    void ProcessRestriction(const boost::optional<InputRestrictionContainer> &restriction,
+                            ExtractionBuffer &buffer) const;
+
+    void ProcessWay(const osmium::Way &current_way,
+                    const ExtractionWay &result_way,
+                    ExtractionBuffer &buffer) const;
 
     // warning: caller needs to take care of synchronization!
-    void ProcessWay(const osmium::Way &current_way, const ExtractionWay &result_way);
+    // Buffers need to be stored in the order of the input to get deterministic ids.
+    void StoreBuffer(ExtractionBuffer &buffer);
 
     // destroys the internal laneDescriptionMap
     guidance::LaneDescriptionMap &&moveOutLaneDescriptionMap();
@@ -40,7 +40,7 @@ namespace extractor
 
 struct ExtractorConfig
 {
-    ExtractorConfig() noexcept : requested_num_threads(0) {}
+    ExtractorConfig() noexcept : requested_num_threads(0), sort_memory(4096) {}
     void UseDefaultOutputNames()
     {
         std::string basepath = input_path.string();
@@ -60,6 +60,7 @@ struct ExtractorConfig
 
         output_file_name = basepath + ".osrm";
         restriction_file_name = basepath + ".osrm.restrictions";
+        restriction_turns_file_name = basepath + ".osrm.restriction_turns";
         names_file_name = basepath + ".osrm.names";
         turn_lane_descriptions_file_name = basepath + ".osrm.tls";
         turn_lane_data_file_name = basepath + ".osrm.tld";
@@ -86,6 +87,7 @@ struct ExtractorConfig
 
     std::string output_file_name;
     std::string restriction_file_name;
+    std::string restriction_turns_file_name;
     std::string names_file_name;
     std::string turn_lane_data_file_name;
     std::string turn_lane_descriptions_file_name;
@@ -107,6 +109,8 @@ struct ExtractorConfig
 
     unsigned requested_num_threads;
     unsigned small_component_size;
+    // memory in MiB for sorting the parsed data in memory instead of stxxl
+    unsigned sort_memory;
 
     bool generate_edge_lookup;
     std::string turn_penalties_index_path;
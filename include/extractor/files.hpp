@@ -1,6 +1,7 @@
 #ifndef OSRM_EXTRACTOR_FILES_HPP
 #define OSRM_EXTRACTOR_FILES_HPP
 
+#include "extractor/conditional_turn_index.hpp"
 #include "extractor/edge_based_edge.hpp"
 #include "extractor/guidance/turn_lane_types.hpp"
 #include "extractor/node_data_container.hpp"
@@ -11,6 +12,8 @@
 #include "util/coordinate.hpp"
 #include "util/guidance/bearing_class.hpp"
 #include "util/guidance/entry_class.hpp"
+#include "util/integer_range.hpp"
+#include "util/packed_coordinate_vector.hpp"
 #include "util/packed_vector.hpp"
 #include "util/range_table.hpp"
 #include "util/serialization.hpp"
@@ -102,7 +105,29 @@ void readEdgeBasedGraph(const boost::filesystem::path &path,
     storage::serialization::read(reader, edge_based_edge_list);
 }
 
-// reads .osrm.nodes
+namespace detail
+{
+inline void readCoordinates(storage::io::FileReader &reader,
+                            util::PackedCoordinateVectorView &coordinates)
+{
+    util::serialization::read(reader, coordinates);
+}
+
+inline void readCoordinates(storage::io::FileReader &reader,
+                            std::vector<util::Coordinate> &coordinates)
+{
+    util::PackedCoordinateVector packed_coordinates;
+    util::serialization::read(reader, packed_coordinates);
+
+    coordinates.resize(packed_coordinates.size());
+    for (auto index : util::irange<std::size_t>(0, packed_coordinates.size()))
+    {
+        coordinates[index] = packed_coordinates[index];
+    }
+}
+}
+
+// reads .osrm.nbg_nodes
 template <typename CoordinatesT, typename PackedOSMIDsT>
 inline void readNodes(const boost::filesystem::path &path,
                       CoordinatesT &coordinates,
@@ -114,23 +139,22 @@ inline void readNodes(const boost::filesystem::path &path,
     const auto fingerprint = storage::io::FileReader::VerifyFingerprint;
     storage::io::FileReader reader{path, fingerprint};
 
-    storage::serialization::read(reader, coordinates);
+    detail::readCoordinates(reader, coordinates);
     util::serialization::read(reader, osm_node_ids);
 }
 
-// writes .osrm.nodes
-template <typename CoordinatesT, typename PackedOSMIDsT>
+// writes .osrm.nbg_nodes
+template <typename PackedOSMIDsT>
 inline void writeNodes(const boost::filesystem::path &path,
-                       const CoordinatesT &coordinates,
+                       const std::vector<util::Coordinate> &coordinates,
                        const PackedOSMIDsT &osm_node_ids)
 {
-    static_assert(std::is_same<typename CoordinatesT::value_type, util::Coordinate>::value, "");
     static_assert(std::is_same<typename PackedOSMIDsT::value_type, OSMNodeID>::value, "");
 
     const auto fingerprint = storage::io::FileWriter::GenerateFingerprint;
     storage::io::FileWriter writer{path, fingerprint};
 
-    storage::serialization::write(writer, coordinates);
+    util::serialization::write(writer, util::PackedCoordinateVector{coordinates});
     util::serialization::write(writer, osm_node_ids);
 }
 
@@ -153,6 +177,28 @@ inline void writeNBGMapping(const boost::filesystem::path &path,
     storage::serialization::write(writer, mapping);
 }
 
+// reads .osrm.restriction_turns
+inline void readConditionalTurnIndex(const boost::filesystem::path &path,
+                                     ConditionalTurnIndex &index)
+{
+    const auto fingerprint = storage::io::FileReader::VerifyFingerprint;
+    storage::io::FileReader reader{path, fingerprint};
+
+    storage::serialization::read(reader, index.offsets);
+    storage::serialization::read(reader, index.turns);
+}
+
+// writes .osrm.restriction_turns
+inline void writeConditionalTurnIndex(const boost::filesystem::path &path,
+                                      const ConditionalTurnIndex &index)
+{
+    const auto fingerprint = storage::io::FileWriter::GenerateFingerprint;
+    storage::io::FileWriter writer{path, fingerprint};
+
+    storage::serialization::write(writer, index.offsets);
+    storage::serialization::write(writer, index.turns);
+}
+
 // reads .osrm.datasource_names
 inline void readDatasources(const boost::filesystem::path &path, Datasources &sources)
 {
@@ -0,0 +1,201 @@
+/*
+ * C interface of compiled routing profiles.
+ *
+ * A native profile is a shared library that exports the functions declared below and is passed
+ * to osrm-extract instead of a Lua profile. Nodes, ways, turns and segments are handed over in
+ * batches of plain structs, so the library can be written in any language that can export C
+ * functions and does not need to link against OSRM.
+ *
+ * Required exports:  osrm_profile_api_version, osrm_profile_setup,
+ *                    osrm_profile_create_context, osrm_profile_destroy_context,
+ *                    osrm_profile_process_nodes, osrm_profile_process_ways
+ * Optional exports:  osrm_profile_process_turns, osrm_profile_process_segments,
+ *                    osrm_profile_name_suffixes, osrm_profile_restrictions
+ *
+ * The extractor calls the processing functions from multiple threads at once, each thread with
+ * its own context. Strings returned in a result must stay valid until the next call with the same
+ * context.
+ */
+
+#ifndef OSRM_EXTRACTOR_NATIVE_PROFILE_H
+#define OSRM_EXTRACTOR_NATIVE_PROFILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OSRM_NATIVE_PROFILE_API_VERSION 1
+
+#if defined(_WIN32)
+#define OSRM_PROFILE_EXPORT __declspec(dllexport)
+#else
+#define OSRM_PROFILE_EXPORT __attribute__((visibility("default")))
+#endif
+
+/* travel modes, same values as in travel_mode.hpp */
+#define OSRM_MODE_INACCESSIBLE 0
+#define OSRM_MODE_DRIVING 1
+#define OSRM_MODE_CYCLING 2
+#define OSRM_MODE_WALKING 3
+#define OSRM_MODE_FERRY 4
+#define OSRM_MODE_TRAIN 5
+#define OSRM_MODE_PUSHING_BIKE 6
+
+/* road priority classes, same values as guidance::RoadPriorityClass */
+#define OSRM_ROAD_PRIORITY_MOTORWAY 0
+#define OSRM_ROAD_PRIORITY_TRUNK 2
+#define OSRM_ROAD_PRIORITY_PRIMARY 4
+#define OSRM_ROAD_PRIORITY_SECONDARY 6
+#define OSRM_ROAD_PRIORITY_TERTIARY 8
+#define OSRM_ROAD_PRIORITY_MAIN_RESIDENTIAL 10
+#define OSRM_ROAD_PRIORITY_SIDE_RESIDENTIAL 11
+#define OSRM_ROAD_PRIORITY_LINK_ROAD 14
+#define OSRM_ROAD_PRIORITY_BIKE_PATH 16
+#define OSRM_ROAD_PRIORITY_FOOT_PATH 18
+#define OSRM_ROAD_PRIORITY_CONNECTIVITY 31
+
+/* the turn types and direction modifiers a profile usually looks at */
+#define OSRM_TURN_TYPE_INVALID 0
+#define OSRM_TURN_TYPE_NEW_NAME 1
+#define OSRM_TURN_TYPE_CONTINUE 2
+#define OSRM_TURN_TYPE_TURN 3
+#define OSRM_TURN_TYPE_NO_TURN 17
+
+#define OSRM_DIRECTION_MODIFIER_U_TURN 0
+#define OSRM_DIRECTION_MODIFIER_SHARP_RIGHT 1
+#define OSRM_DIRECTION_MODIFIER_RIGHT 2
+#define OSRM_DIRECTION_MODIFIER_SLIGHT_RIGHT 3
+#define OSRM_DIRECTION_MODIFIER_STRAIGHT 4
+#define OSRM_DIRECTION_MODIFIER_SLIGHT_LEFT 5
+#define OSRM_DIRECTION_MODIFIER_LEFT 6
+#define OSRM_DIRECTION_MODIFIER_SHARP_LEFT 7
+
+typedef struct osrm_tag
+{
+    const char *key;
+    const char *value;
+} osrm_tag;
+
+/* Filled with the defaults by the extractor and changed by osrm_profile_setup */
+typedef struct osrm_profile_properties
+{
+    char weight_name[256];
+    uint32_t weight_precision;
+    /* seconds */
+    double traffic_signal_penalty;
+    double u_turn_penalty;
+    /* meters per second */
+    double max_speed_for_map_matching;
+    int32_t continue_straight_at_waypoint;
+    int32_t use_turn_restrictions;
+    int32_t left_hand_driving;
+    int32_t force_split_edges;
+    int32_t call_tagless_node_function;
+    /* set by the extractor after the setup, the weight that makes a turn unusable */
+    double max_turn_weight;
+} osrm_profile_properties;
+
+typedef struct osrm_node
+{
+    /* input */
+    int64_t id;
+    double lon;
+    double lat;
+    const osrm_tag *tags;
+    uint32_t num_tags;
+
+    /* result, initialized to 0 */
+    int32_t barrier;
+    int32_t traffic_lights;
+} osrm_node;
+
+typedef struct osrm_way
+{
+    /* input */
+    int64_t id;
+    const osrm_tag *tags;
+    uint32_t num_tags;
+    uint32_t num_nodes;
+
+    /* result, initialized like the result of a Lua way_function */
+    /* km/h, -1 if not set */
+    double forward_speed;
+    double backward_speed;
+    /* weight per meter, -1 if not set */
+    double forward_rate;
+    double backward_rate;
+    /* duration and weight of the whole way, -1 if not set */
+    double duration;
+    double weight;
+    uint8_t forward_mode;
+    uint8_t backward_mode;
+    uint8_t roundabout;
+    uint8_t circular;
+    uint8_t is_startpoint;
+    uint8_t forward_restricted;
+    uint8_t backward_restricted;
+    /* NULL for an empty string */
+    const char *name;
+    const char *ref;
+    const char *pronunciation;
+    const char *destinations;
+    const char *turn_lanes_forward;
+    const char *turn_lanes_backward;
+    /* road classification used for guidance */
+    uint8_t motorway_class;
+    uint8_t link_class;
+    uint8_t may_be_ignored;
+    uint8_t road_priority_class;
+    uint8_t num_lanes;
+} osrm_way;
+
+typedef struct osrm_turn
+{
+    /* input, the angle is in (-180, 180] with 0 for going straight */
+    double angle;
+    uint8_t turn_type;
+    uint8_t direction_modifier;
+    uint8_t has_traffic_light;
+    uint8_t source_restricted;
+    uint8_t target_restricted;
+
+    /* result, initialized to 0, in seconds */
+    double weight;
+    double duration;
+} osrm_turn;
+
+typedef struct osrm_segment
+{
+    /* input, coordinates in degrees and distance in meters */
+    double source_lon;
+    double source_lat;
+    double target_lon;
+    double target_lat;
+    double distance;
+
+    /* result, initialized to the values computed from the way */
+    double weight;
+    double duration;
+} osrm_segment;
+
+typedef int (*osrm_profile_api_version_fn)(void);
+typedef void (*osrm_profile_setup_fn)(osrm_profile_properties *properties);
+typedef void *(*osrm_profile_create_context_fn)(const osrm_profile_properties *properties);
+typedef void (*osrm_profile_destroy_context_fn)(void *context);
+typedef void (*osrm_profile_process_nodes_fn)(void *context, osrm_node *nodes, size_t count);
+typedef void (*osrm_profile_process_ways_fn)(void *context, osrm_way *ways, size_t count);
+typedef void (*osrm_profile_process_turns_fn)(void *context, osrm_turn *turns, size_t count);
+typedef void (*osrm_profile_process_segments_fn)(void *context,
+                                                 osrm_segment *segments,
+                                                 size_t count);
+/* NULL terminated list that stays valid as long as the library is loaded */
+typedef const char *const *(*osrm_profile_string_list_fn)(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSRM_EXTRACTOR_NATIVE_PROFILE_H */
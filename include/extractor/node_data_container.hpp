@@ -62,6 +62,8 @@ template <storage::Ownership Ownership> class EdgeBasedNodeDataContainerImpl
 
     ComponentID GetComponentID(const NodeID node_id) const { return component_ids[node_id]; }
 
+    std::size_t GetNumberOfNodes() const { return geometry_ids.size(); }
+
     // Used by EdgeBasedGraphFactory to fill data structure
     template <typename = std::enable_if<Ownership == storage::Ownership::Container>>
     void SetData(NodeID node_id, GeometryID geometry_id, NameID name_id, TravelMode travel_mode)
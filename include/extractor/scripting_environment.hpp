@@ -57,6 +57,10 @@ class ScriptingEnvironment
     virtual void SetupSources() = 0;
     virtual void ProcessTurn(ExtractionTurn &turn) = 0;
     virtual void ProcessSegment(ExtractionSegment &segment) = 0;
+    // Same as calling ProcessTurn and ProcessSegment for each element,
+    // but a profile can handle the whole batch at once
+    virtual void ProcessTurns(std::vector<ExtractionTurn> &turns) = 0;
+    virtual void ProcessSegments(std::vector<ExtractionSegment> &segments) = 0;
 
     virtual void ProcessElements(
         const osmium::memory::Buffer &buffer,
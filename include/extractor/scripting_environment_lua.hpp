@@ -3,6 +3,9 @@
 
 #include "extractor/raster_source.hpp"
 #include "extractor/scripting_environment.hpp"
+#include "extractor/turn_penalty_table.hpp"
+
+#include <boost/optional.hpp>
 
 #include <tbb/enumerable_thread_specific.h>
 
@@ -21,6 +24,8 @@ struct LuaScriptingContext final
 {
     void ProcessNode(const osmium::Node &, ExtractionNode &result);
     void ProcessWay(const osmium::Way &, ExtractionWay &result);
+    void ProcessTurn(ExtractionTurn &turn);
+    void ProcessSegment(ExtractionSegment &segment);
 
     ProfileProperties properties;
     SourceContainer sources;
@@ -30,11 +35,18 @@ struct LuaScriptingContext final
     bool has_node_function;
     bool has_way_function;
     bool has_segment_function;
+    bool has_turns_function;
+    bool has_segments_function;
 
     sol::function turn_function;
     sol::function way_function;
     sol::function node_function;
     sol::function segment_function;
+    sol::function turns_function;
+    sol::function segments_function;
+
+    // turn penalties computed without calling into lua
+    boost::optional<TurnPenaltyTable> turn_penalty_table;
 
     int api_version;
 };
@@ -64,6 +76,8 @@ class Sol2ScriptingEnvironment final : public ScriptingEnvironment
     void SetupSources() override;
     void ProcessTurn(ExtractionTurn &turn) override;
     void ProcessSegment(ExtractionSegment &segment) override;
+    void ProcessTurns(std::vector<ExtractionTurn> &turns) override;
+    void ProcessSegments(std::vector<ExtractionSegment> &segments) override;
 
     void ProcessElements(
         const osmium::memory::Buffer &buffer,
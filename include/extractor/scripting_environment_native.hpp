@@ -0,0 +1,83 @@
+#ifndef SCRIPTING_ENVIRONMENT_NATIVE_HPP
+#define SCRIPTING_ENVIRONMENT_NATIVE_HPP
+
+#include "extractor/native_profile.h"
+#include "extractor/scripting_environment.hpp"
+
+#include <tbb/enumerable_thread_specific.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace extractor
+{
+
+struct NativeProfileLibrary;
+
+struct NativeScriptingContext final
+{
+    NativeScriptingContext(const NativeProfileLibrary &library,
+                           const osrm_profile_properties &properties);
+    ~NativeScriptingContext();
+
+    const NativeProfileLibrary &library;
+    void *handle;
+
+    // batches that are handed to the profile, reused between calls
+    std::vector<osrm_tag> tags;
+    std::vector<osrm_node> nodes;
+    std::vector<osrm_way> ways;
+    std::vector<osrm_turn> turns;
+    std::vector<osrm_segment> segments;
+};
+
+/**
+ * Runs a profile compiled into a shared library that implements the C interface in
+ * native_profile.h.
+ *
+ * Nodes and ways of a buffer, turns and segments are passed to the profile in batches.
+ * Each thread has its own profile context. Raster sources are not supported.
+ */
+class NativeScriptingEnvironment final : public ScriptingEnvironment
+{
+  public:
+    explicit NativeScriptingEnvironment(const std::string &file_name);
+    ~NativeScriptingEnvironment() override;
+
+    // true if the file looks like a shared library instead of a Lua script
+    static bool IsNativeProfile(const std::string &file_name);
+
+    const ProfileProperties &GetProfileProperties() override;
+
+    std::vector<std::string> GetNameSuffixList() override;
+    std::vector<std::string> GetRestrictions() override;
+    void SetupSources() override;
+    void ProcessTurn(ExtractionTurn &turn) override;
+    void ProcessSegment(ExtractionSegment &segment) override;
+    void ProcessTurns(std::vector<ExtractionTurn> &turns) override;
+    void ProcessSegments(std::vector<ExtractionSegment> &segments) override;
+
+    void ProcessElements(
+        const osmium::memory::Buffer &buffer,
+        const RestrictionParser &restriction_parser,
+        std::vector<std::pair<const osmium::Node &, ExtractionNode>> &resulting_nodes,
+        std::vector<std::pair<const osmium::Way &, ExtractionWay>> &resulting_ways,
+        std::vector<boost::optional<InputRestrictionContainer>> &resulting_restrictions) override;
+
+  private:
+    NativeScriptingContext &GetContext();
+    void ProcessTurns(ExtractionTurn *turns, std::size_t count);
+    void ProcessSegments(ExtractionSegment *segments, std::size_t count);
+
+    std::unique_ptr<NativeProfileLibrary> library;
+    ProfileProperties properties;
+    osrm_profile_properties native_properties;
+    tbb::enumerable_thread_specific<std::unique_ptr<NativeScriptingContext>> contexts;
+};
+}
+}
+
+#endif /* SCRIPTING_ENVIRONMENT_NATIVE_HPP */
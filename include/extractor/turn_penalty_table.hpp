@@ -0,0 +1,73 @@
+#ifndef OSRM_EXTRACTOR_TURN_PENALTY_TABLE_HPP
+#define OSRM_EXTRACTOR_TURN_PENALTY_TABLE_HPP
+
+#include "extractor/extraction_turn.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <vector>
+
+namespace osrm
+{
+namespace extractor
+{
+
+/**
+ * Turn penalties that a profile declares as a table instead of computing them in Lua.
+ *
+ * The duration of a turn is interpolated linearly between the durations of the given angles,
+ * with the angle of a turn in (-180, 180] and 0 for going straight. The u-turn penalty is added
+ * to u-turns, turns that are no actual turn only get the traffic light penalty.
+ * The weight of a turn is its duration, profiles with another weight can't use the table.
+ */
+struct TurnPenaltyTable
+{
+    std::vector<double> angles;
+    std::vector<double> durations;
+    double u_turn_penalty = 0.;
+    double traffic_light_penalty = 0.;
+
+    bool IsValid() const
+    {
+        return !angles.empty() && angles.size() == durations.size() &&
+               std::adjacent_find(angles.begin(), angles.end(), std::greater_equal<double>()) ==
+                   angles.end();
+    }
+
+    double GetAngleDuration(const double angle) const
+    {
+        BOOST_ASSERT(IsValid());
+
+        const auto upper = std::upper_bound(angles.begin(), angles.end(), angle);
+        if (upper == angles.begin())
+            return durations.front();
+        if (upper == angles.end())
+            return durations.back();
+
+        const auto index = std::distance(angles.begin(), upper);
+        const auto ratio = (angle - angles[index - 1]) / (angles[index] - angles[index - 1]);
+        return durations[index - 1] + ratio * (durations[index] - durations[index - 1]);
+    }
+
+    void Apply(ExtractionTurn &turn) const
+    {
+        turn.duration = turn.has_traffic_light ? traffic_light_penalty : 0.;
+
+        if (turn.turn_type != guidance::TurnType::NoTurn)
+        {
+            turn.duration += GetAngleDuration(turn.angle);
+
+            if (turn.direction_modifier == guidance::DirectionModifier::UTurn)
+                turn.duration += u_turn_penalty;
+        }
+
+        turn.weight = turn.duration;
+    }
+};
+}
+}
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef OSRM_BINDINGS_NODE_HPP
 #define OSRM_BINDINGS_NODE_HPP
 
+#include "nodejs/worker_pool.hpp"
+
 #include "osrm/osrm_fwd.hpp"
 
 #include <nan.h>
@@ -10,6 +12,8 @@
 namespace node_osrm
 {
 
+struct WorkerPoolConfig;
+
 struct Engine final : public Nan::ObjectWrap
 {
     using Base = Nan::ObjectWrap;
@@ -25,13 +29,16 @@ struct Engine final : public Nan::ObjectWrap
     static NAN_METHOD(match);
     static NAN_METHOD(trip);
 
-    Engine(osrm::EngineConfig &config);
+    Engine(osrm::EngineConfig &config, const WorkerPoolConfig &pool_config);
 
     // Thread-safe singleton accessor
     static Nan::Persistent<v8::Function> &constructor();
 
     // Ref-counted OSRM alive even after shutdown until last callback is done
     std::shared_ptr<osrm::OSRM> this_;
+
+    // Runs the requests instead of the libuv thread pool, stays alive until they are done
+    std::shared_ptr<WorkerPool> pool;
 };
 
 } // ns node_osrm
@@ -18,6 +18,8 @@
 #include "osrm/tile_parameters.hpp"
 #include "osrm/trip_parameters.hpp"
 
+#include "util/json_renderer.hpp"
+
 #include <boost/assert.hpp>
 #include <boost/optional.hpp>
 
@@ -25,6 +27,7 @@
 #include <iostream>
 #include <iterator>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <exception>
@@ -78,6 +81,73 @@ inline void ParseResult(const osrm::Status &result_status, osrm::json::Object &r
 
 inline void ParseResult(const osrm::Status & /*result_status*/, const std::string & /*unused*/) {}
 
+// Options of the binding itself, given as optional object between the parameters and the callback
+struct PluginParameters
+{
+    // serialize the result to JSON on the worker thread and return it as Buffer
+    bool renderJSONToBuffer = false;
+};
+
+inline void renderToBuffer(const osrm::json::Object &result, std::vector<char> &buffer)
+{
+    osrm::util::json::render(buffer, result);
+}
+
+inline void renderToBuffer(const std::string &result, std::vector<char> &buffer)
+{
+    buffer.assign(result.begin(), result.end());
+}
+
+// Hands the bytes over to a Buffer without copying them, V8 frees them with the Buffer
+inline v8::Local<v8::Value> renderBuffer(std::vector<char> &&buffer)
+{
+    auto *const bytes = new std::vector<char>(std::move(buffer));
+    const auto free_bytes = [](char *, void *hint) {
+        delete static_cast<std::vector<char> *>(hint);
+    };
+    return Nan::NewBuffer(bytes->data(), bytes->size(), free_bytes, bytes).ToLocalChecked();
+}
+
+inline bool argumentsToPluginParameters(const Nan::FunctionCallbackInfo<v8::Value> &args,
+                                        PluginParameters &parameters)
+{
+    if (args.Length() < 3 || !args[1]->IsObject())
+    {
+        return true;
+    }
+
+    v8::Local<v8::Object> obj = Nan::To<v8::Object>(args[1]).ToLocalChecked();
+    v8::Local<v8::Value> format = obj->Get(Nan::New("format").ToLocalChecked());
+    if (format.IsEmpty())
+        return false;
+
+    if (format->IsUndefined())
+        return true;
+
+    if (!format->IsString())
+    {
+        Nan::ThrowError("format must be a string: \"object\" or \"json_buffer\"");
+        return false;
+    }
+
+    const std::string format_str = *v8::String::Utf8Value(format);
+    if (format_str == "object")
+    {
+        parameters.renderJSONToBuffer = false;
+    }
+    else if (format_str == "json_buffer")
+    {
+        parameters.renderJSONToBuffer = true;
+    }
+    else
+    {
+        Nan::ThrowError("format must be a string: \"object\" or \"json_buffer\"");
+        return false;
+    }
+
+    return true;
+}
+
 inline engine_config_ptr argumentsToEngineConfig(const Nan::FunctionCallbackInfo<v8::Value> &args)
 {
     Nan::HandleScope scope;
@@ -179,6 +249,56 @@ inline engine_config_ptr argumentsToEngineConfig(const Nan::FunctionCallbackInfo
     return engine_config;
 }
 
+// Threads and queue of the worker pool that runs the requests of an OSRM object
+struct WorkerPoolConfig
+{
+    std::size_t num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    // 0 does not limit the number of queued requests
+    std::size_t max_queue_size = 0;
+};
+
+inline boost::optional<WorkerPoolConfig>
+argumentsToWorkerPoolConfig(const Nan::FunctionCallbackInfo<v8::Value> &args)
+{
+    Nan::HandleScope scope;
+    WorkerPoolConfig pool_config;
+
+    if (args.Length() != 1 || !args[0]->IsObject())
+        return pool_config;
+
+    auto params = Nan::To<v8::Object>(args[0]).ToLocalChecked();
+
+    auto threads = params->Get(Nan::New("threads").ToLocalChecked());
+    if (threads.IsEmpty())
+        return boost::none;
+
+    auto max_queue_size = params->Get(Nan::New("max_queue_size").ToLocalChecked());
+    if (max_queue_size.IsEmpty())
+        return boost::none;
+
+    if (!threads->IsUndefined())
+    {
+        if (!threads->IsUint32() || threads->Uint32Value() == 0)
+        {
+            Nan::ThrowError("threads option must be a positive integer");
+            return boost::none;
+        }
+        pool_config.num_threads = threads->Uint32Value();
+    }
+
+    if (!max_queue_size->IsUndefined())
+    {
+        if (!max_queue_size->IsUint32())
+        {
+            Nan::ThrowError("max_queue_size option must be an unsigned integer");
+            return boost::none;
+        }
+        pool_config.max_queue_size = max_queue_size->Uint32Value();
+    }
+
+    return pool_config;
+}
+
 inline boost::optional<std::vector<osrm::Coordinate>>
 parseCoordinateArray(const v8::Local<v8::Array> &coordinates_array)
 {
@@ -455,12 +575,23 @@ inline bool argumentsToParameter(const Nan::FunctionCallbackInfo<v8::Value> &arg
                     return false;
                 }
 
-                params->hints.push_back(
-                    osrm::engine::Hint::FromBase64(*v8::String::Utf8Value(hint)));
+                const std::string hint_string = *v8::String::Utf8Value(hint);
+                if (hint_string.size() == osrm::engine::ENCODED_COMPACT_HINT_SIZE)
+                {
+                    params->hints.emplace_back();
+                    params->compact_hints.push_back(
+                        osrm::engine::CompactHint::FromBase64(hint_string));
+                }
+                else
+                {
+                    params->hints.push_back(osrm::engine::Hint::FromBase64(hint_string));
+                    params->compact_hints.emplace_back();
+                }
             }
             else if (hint->IsNull())
             {
                 params->hints.emplace_back();
+                params->compact_hints.emplace_back();
             }
             else
             {
@@ -527,6 +658,37 @@ inline bool argumentsToParameter(const Nan::FunctionCallbackInfo<v8::Value> &arg
         params->generate_hints = generate_hints->BooleanValue();
     }
 
+    if (obj->Has(Nan::New("hint_format").ToLocalChecked()))
+    {
+        v8::Local<v8::Value> hint_format = obj->Get(Nan::New("hint_format").ToLocalChecked());
+        if (hint_format.IsEmpty())
+            return false;
+
+        if (!hint_format->IsString())
+        {
+            Nan::ThrowError("hint_format must be a string: [full, compact]");
+            return false;
+        }
+
+        const Nan::Utf8String hint_format_utf8str(hint_format);
+        std::string hint_format_str{*hint_format_utf8str,
+                                    *hint_format_utf8str + hint_format_utf8str.length()};
+
+        if (hint_format_str == "full")
+        {
+            params->hint_format = osrm::engine::api::BaseParameters::HintFormat::Full;
+        }
+        else if (hint_format_str == "compact")
+        {
+            params->hint_format = osrm::engine::api::BaseParameters::HintFormat::Compact;
+        }
+        else
+        {
+            Nan::ThrowError("hint_format must be a string: [full, compact]");
+            return false;
+        }
+    }
+
     return true;
 }
 
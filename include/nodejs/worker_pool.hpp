@@ -0,0 +1,173 @@
+#ifndef OSRM_BINDINGS_NODE_WORKER_POOL_HPP
+#define OSRM_BINDINGS_NODE_WORKER_POOL_HPP
+
+#include <nan.h>
+
+#include <boost/assert.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace node_osrm
+{
+
+// Runs the requests of an OSRM object on its own threads instead of the libuv thread pool, so
+// routing does not compete with the fs, dns and zlib work of the process. Workers are executed
+// like Nan::AsyncQueueWorker does: Execute() on a pool thread, WorkComplete() and Destroy() on
+// the main thread, which is woken up with an uv_async_t handle.
+//
+// Queue, Complete and the destructor must be called on the main thread.
+class WorkerPool final : public std::enable_shared_from_this<WorkerPool>
+{
+  public:
+    // A max_queue_size of 0 does not limit the number of queued requests
+    static std::shared_ptr<WorkerPool> Create(std::size_t num_threads, std::size_t max_queue_size)
+    {
+        return std::shared_ptr<WorkerPool>(new WorkerPool(num_threads, max_queue_size));
+    }
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    ~WorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        queued_condition.notify_all();
+        for (auto &thread : threads)
+            thread.join();
+
+        uv_close(reinterpret_cast<uv_handle_t *>(async), [](uv_handle_t *handle) {
+            delete reinterpret_cast<uv_async_t *>(handle);
+        });
+    }
+
+    // Returns false without taking the worker if the queue is full
+    bool Queue(Nan::AsyncWorker *worker)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (max_queue_size > 0 && queued.size() >= max_queue_size)
+                return false;
+            queued.push_back(worker);
+        }
+        Acquire();
+        queued_condition.notify_one();
+        return true;
+    }
+
+    // Completes a worker without executing it, e.g. after its request was rejected
+    void Complete(Nan::AsyncWorker *worker)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            completed.push_back(worker);
+        }
+        Acquire();
+        uv_async_send(async);
+    }
+
+    std::size_t GetNumberOfThreads() const { return threads.size(); }
+
+  private:
+    WorkerPool(std::size_t num_threads, std::size_t max_queue_size)
+        : async(new uv_async_t), max_queue_size(max_queue_size)
+    {
+        BOOST_ASSERT(num_threads > 0);
+
+        uv_async_init(uv_default_loop(), async, [](uv_async_t *handle) {
+            static_cast<WorkerPool *>(handle->data)->CompleteWorkers();
+        });
+        async->data = this;
+        // an idle pool must not keep the process alive
+        uv_unref(reinterpret_cast<uv_handle_t *>(async));
+
+        threads.reserve(num_threads);
+        for (std::size_t thread = 0; thread < num_threads; ++thread)
+            threads.emplace_back([this] { Run(); });
+    }
+
+    void Run()
+    {
+        while (true)
+        {
+            Nan::AsyncWorker *worker;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                queued_condition.wait(lock, [this] { return stopping || !queued.empty(); });
+                if (queued.empty())
+                    return;
+                worker = queued.front();
+                queued.pop_front();
+            }
+
+            worker->Execute();
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                completed.push_back(worker);
+            }
+            uv_async_send(async);
+        }
+    }
+
+    // Keeps the event loop and the pool alive while requests are pending, even if the OSRM
+    // object was garbage collected in the meantime
+    void Acquire()
+    {
+        if (num_pending++ == 0)
+        {
+            self = shared_from_this();
+            uv_ref(reinterpret_cast<uv_handle_t *>(async));
+        }
+    }
+
+    void CompleteWorkers()
+    {
+        std::vector<Nan::AsyncWorker *> workers;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            workers.assign(completed.begin(), completed.end());
+            completed.clear();
+        }
+
+        for (auto *worker : workers)
+        {
+            worker->WorkComplete();
+            worker->Destroy();
+        }
+
+        BOOST_ASSERT(num_pending >= workers.size());
+        num_pending -= workers.size();
+        if (num_pending == 0 && self)
+        {
+            uv_unref(reinterpret_cast<uv_handle_t *>(async));
+            // might destroy the pool, so nothing may touch it afterwards
+            const auto last_reference = std::move(self);
+        }
+    }
+
+    uv_async_t *const async;
+    const std::size_t max_queue_size;
+    std::vector<std::thread> threads;
+
+    std::mutex mutex;
+    std::condition_variable queued_condition;
+    std::deque<Nan::AsyncWorker *> queued;
+    std::deque<Nan::AsyncWorker *> completed;
+    bool stopping = false;
+
+    // only used on the main thread
+    std::size_t num_pending = 0;
+    std::shared_ptr<WorkerPool> self;
+};
+}
+
+#endif
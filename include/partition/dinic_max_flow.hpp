@@ -5,7 +5,7 @@
 
 #include <cstdint>
 #include <functional>
-#include <set>
+#include <iterator>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -44,9 +44,46 @@ class DinicMaxFlow
     // the level of each node in the graph (==hops in BFS from source)
     using LevelGraph = std::vector<Level>;
 
-    // this is actually faster than using an unordered_set<Edge>, stores all edges that have
-    // capacity grouped by node
-    using FlowEdges = std::vector<std::set<NodeID>>;
+    // marks the source or sink nodes, faster to check than the SourceSinkNodes in inner loops
+    using NodeFlags = std::vector<bool>;
+
+    // Flow on the undirected edges of a view, indexed by the position of an edge in the view.
+    // Each pair of nodes has a capacity of one in both directions, parallel edges share the
+    // flow of the first of them. Compared to a set of flow edges per node this only needs
+    // array lookups in the inner loops of the level graph and augmenting path searches.
+    class FlowEdges
+    {
+      public:
+        explicit FlowEdges(const GraphView &view);
+
+        // flow id of the edge at `edge_iterator` from `node`
+        EdgeID GetEdge(const NodeID node,
+                       const BisectionGraph::ConstEdgeIterator edge_iterator,
+                       const GraphView &view) const
+        {
+            return flow_id[first_edge[node] + std::distance(view.BeginEdges(node), edge_iterator)];
+        }
+
+        // flow id of the same edge in the opposite direction
+        EdgeID Reverse(const EdgeID edge) const { return reverse[edge]; }
+
+        bool HasFlow(const EdgeID edge) const { return flow[edge]; }
+
+        // sends one unit of flow over the edge, cancelling the flow in the opposite direction
+        void Augment(const EdgeID edge)
+        {
+            if (flow[reverse[edge]])
+                flow[reverse[edge]] = false;
+            else
+                flow[edge] = true;
+        }
+
+      private:
+        std::vector<EdgeID> first_edge;
+        std::vector<EdgeID> flow_id;
+        std::vector<EdgeID> reverse;
+        std::vector<bool> flow;
+    };
 
     // The level graph (see [1]) is based on a BFS computation. We assign a level to all nodes
     // (starting with 0 for all source nodes) and assign the hop distance in the residual graph as
@@ -59,8 +96,8 @@ class DinicMaxFlow
     // would assign s = 0, a,b = 1, t=2
     LevelGraph ComputeLevelGraph(const GraphView &view,
                                  const std::vector<NodeID> &border_source_nodes,
-                                 const SourceSinkNodes &source_nodes,
-                                 const SourceSinkNodes &sink_nodes,
+                                 const NodeFlags &is_source,
+                                 const NodeFlags &is_sink,
                                  const FlowEdges &flow) const;
 
     // Using the above levels (see ComputeLevelGraph), we can use multiple DFS (that can now be
@@ -69,18 +106,19 @@ class DinicMaxFlow
     std::size_t BlockingFlow(FlowEdges &flow,
                              LevelGraph &levels,
                              const GraphView &view,
-                             const SourceSinkNodes &source_nodes,
+                             const NodeFlags &is_source,
                              const std::vector<NodeID> &border_sink_nodes) const;
 
     // Finds a single augmenting path from a node to the sink side following levels in the level
     // graph. We don't actually remove the edges, so we have to check for increasing level values.
     // Since we know which sinks have been reached, we actually search for these paths starting at
     // sink nodes, instead of the source, so we can save a few dfs runs
-    std::vector<NodeID> GetAugmentingPath(LevelGraph &levels,
+    // The path is returned as the flow ids of its edges from the source to the sink.
+    std::vector<EdgeID> GetAugmentingPath(LevelGraph &levels,
                                           const NodeID from,
                                           const GraphView &view,
                                           const FlowEdges &flow,
-                                          const SourceSinkNodes &source_nodes) const;
+                                          const NodeFlags &is_source) const;
 
     // Builds an actual cut result from a level graph
     MinCut
@@ -113,6 +113,9 @@ template <storage::Ownership Ownership> class MultiLevelPartitionImpl final
 
     std::uint8_t GetNumberOfLevels() const { return level_data->num_level; }
 
+    // the partition contains a sentinel node at the end
+    NodeID GetNumberOfNodes() const { return GetSenitileNode(); }
+
     std::uint32_t GetNumberOfCells(LevelID level) const
     {
         return GetCell(level, GetSenitileNode());
@@ -43,6 +43,7 @@ struct PartitionConfig
         storage_path = basepath + ".osrm.cells";
         node_data_path = basepath + ".osrm.ebg_nodes";
         hsgr_path = basepath + ".osrm.hsgr";
+        mld_graph_path = basepath + ".osrm.mldgr";
     }
 
     // might be changed to the node based graph at some point
@@ -55,6 +56,7 @@ struct PartitionConfig
     boost::filesystem::path storage_path;
     boost::filesystem::path node_data_path;
     boost::filesystem::path hsgr_path;
+    boost::filesystem::path mld_graph_path;
 
     unsigned requested_num_threads;
 
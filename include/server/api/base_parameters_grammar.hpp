@@ -4,6 +4,7 @@
 #include "engine/api/base_parameters.hpp"
 
 #include "engine/bearing.hpp"
+#include "engine/compact_hint.hpp"
 #include "engine/hint.hpp"
 #include "engine/polyline_compressor.hpp"
 
@@ -77,13 +78,22 @@ struct BaseParametersGrammar : boost::spirit::qi::grammar<Iterator, Signature>
     {
         const auto add_hint = [](engine::api::BaseParameters &base_parameters,
                                  const boost::optional<std::string> &hint_string) {
-            if (hint_string)
+            // both hint lists stay aligned with the coordinates, the length tells the formats apart
+            if (hint_string && hint_string->size() == engine::ENCODED_COMPACT_HINT_SIZE)
+            {
+                base_parameters.hints.emplace_back(boost::none);
+                base_parameters.compact_hints.emplace_back(
+                    engine::CompactHint::FromBase64(hint_string.get()));
+            }
+            else if (hint_string)
             {
                 base_parameters.hints.emplace_back(engine::Hint::FromBase64(hint_string.get()));
+                base_parameters.compact_hints.emplace_back(boost::none);
             }
             else
             {
                 base_parameters.hints.emplace_back(boost::none);
+                base_parameters.compact_hints.emplace_back(boost::none);
             }
         };
 
@@ -143,15 +153,23 @@ struct BaseParametersGrammar : boost::spirit::qi::grammar<Iterator, Signature>
                         (-(qi::double_ | unlimited_rule) %
                          ';')[ph::bind(&engine::api::BaseParameters::radiuses, qi::_r1) = qi::_1];
 
-        hints_rule = qi::lit("hints=") >
-                     (-qi::as_string[qi::repeat(engine::ENCODED_HINT_SIZE)[base64_char]])[ph::bind(
-                         add_hint, qi::_r1, qi::_1)] %
-                         ';';
+        hints_rule =
+            qi::lit("hints=") >
+            (-qi::as_string[qi::hold[qi::repeat(engine::ENCODED_HINT_SIZE)[base64_char]] |
+                            qi::repeat(engine::ENCODED_COMPACT_HINT_SIZE)[base64_char]])[ph::bind(
+                add_hint, qi::_r1, qi::_1)] %
+                ';';
 
         generate_hints_rule =
             qi::lit("generate_hints=") >
             qi::bool_[ph::bind(&engine::api::BaseParameters::generate_hints, qi::_r1) = qi::_1];
 
+        hint_format_type.add("full", engine::api::BaseParameters::HintFormat::Full)(
+            "compact", engine::api::BaseParameters::HintFormat::Compact);
+        hint_format_rule =
+            qi::lit("hint_format=") >
+            hint_format_type[ph::bind(&engine::api::BaseParameters::hint_format, qi::_r1) = qi::_1];
+
         bearings_rule =
             qi::lit("bearings=") >
             (-(qi::short_ > ',' > qi::short_))[ph::bind(add_bearing, qi::_r1, qi::_1)] % ';';
@@ -165,7 +183,8 @@ struct BaseParametersGrammar : boost::spirit::qi::grammar<Iterator, Signature>
         base_rule = radiuses_rule(qi::_r1)   //
                     | hints_rule(qi::_r1)    //
                     | bearings_rule(qi::_r1) //
-                    | generate_hints_rule(qi::_r1) | approach_rule(qi::_r1);
+                    | generate_hints_rule(qi::_r1) | hint_format_rule(qi::_r1) |
+                    approach_rule(qi::_r1);
     }
 
   protected:
@@ -178,6 +197,7 @@ struct BaseParametersGrammar : boost::spirit::qi::grammar<Iterator, Signature>
     qi::rule<Iterator, Signature> hints_rule;
 
     qi::rule<Iterator, Signature> generate_hints_rule;
+    qi::rule<Iterator, Signature> hint_format_rule;
     qi::rule<Iterator, Signature> approach_rule;
 
     qi::rule<Iterator, osrm::engine::Bearing()> bearing_rule;
@@ -191,6 +211,7 @@ struct BaseParametersGrammar : boost::spirit::qi::grammar<Iterator, Signature>
     qi::real_parser<double, json_policy> double_;
 
     qi::symbols<char, engine::Approach> approach_type;
+    qi::symbols<char, engine::api::BaseParameters::HintFormat> hint_format_type;
 };
 }
 }
@@ -0,0 +1,420 @@
+#ifndef OSRM_STORAGE_MANIFEST_HPP
+#define OSRM_STORAGE_MANIFEST_HPP
+
+#include "storage/io.hpp"
+#include "storage/serialization.hpp"
+
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+#include "util/fingerprint.hpp"
+#include "util/log.hpp"
+
+#include <boost/crc.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+
+namespace osrm
+{
+namespace storage
+{
+
+/**
+ * Small summary of a dataset that is written by the pipeline tools next to the .osrm file.
+ *
+ * It records the size, modification time and per-block checksums of every file that is needed
+ * to serve requests, as well as the routing algorithms the dataset can be used with.
+ * This allows checking a dataset for consistency without opening every file and moves the
+ * expensive full checksum verification to an optional step that can run in parallel.
+ */
+struct Manifest
+{
+    enum Capability : std::uint8_t
+    {
+        CH = 1 << 0,
+        CORE_CH = 1 << 1,
+        MLD = 1 << 2
+    };
+
+    struct FileEntry
+    {
+        // suffix relative to the .osrm base path, e.g. ".hsgr"
+        std::string suffix;
+        std::uint64_t size;
+        std::int64_t modification_time;
+        std::uint64_t block_size;
+        // CRC32 of every block_size bytes of the file
+        std::vector<std::uint32_t> checksums;
+    };
+
+    bool HasCapability(const Capability capability) const
+    {
+        return (capabilities & capability) != 0;
+    }
+
+    const FileEntry *GetFile(const std::string &suffix) const
+    {
+        const auto iter = std::find_if(files.begin(), files.end(), [&](const FileEntry &entry) {
+            return entry.suffix == suffix;
+        });
+        return iter == files.end() ? nullptr : &*iter;
+    }
+
+    std::uint8_t capabilities = 0;
+    // set by the last tool of the pipeline, the dataset is only complete after it ran
+    bool complete = false;
+    std::vector<FileEntry> files;
+};
+
+namespace manifest
+{
+// 16 MiB per checksum block allows verifying big files on all cores
+const constexpr std::uint64_t BLOCK_SIZE = 16 * 1024 * 1024;
+
+// files that are needed by osrm-routed and osrm-datastore
+const constexpr std::array<const char *, 20> FILE_SUFFIXES = {
+    {".ramIndex", ".fileIndex", ".hsgr", ".nbg_nodes", ".ebg_nodes",
+     ".edges", ".core", ".geometry", ".timestamp", ".turn_weight_penalties",
+     ".turn_duration_penalties", ".datasource_names", ".names", ".properties", ".icd",
+     ".tld", ".tls", ".partition", ".cells", ".mldgr"}};
+
+// files that the updater rewrites when osrm-contract or osrm-customize apply traffic data
+const constexpr std::array<const char *, 4> UPDATED_FILE_SUFFIXES = {
+    {".geometry", ".turn_weight_penalties", ".turn_duration_penalties", ".datasource_names"}};
+
+inline boost::filesystem::path getManifestPath(const boost::filesystem::path &base)
+{
+    return base.string() + ".manifest";
+}
+
+namespace detail
+{
+inline std::uint32_t computeBlockChecksum(const boost::filesystem::path &path,
+                                          const std::uint64_t offset,
+                                          const std::uint64_t length)
+{
+    boost::filesystem::ifstream stream(path, std::ios::binary);
+    stream.seekg(offset);
+
+    boost::crc_32_type crc;
+    std::vector<char> buffer(std::min<std::uint64_t>(length, 1024 * 1024));
+    std::uint64_t remaining = length;
+    while (remaining > 0 && stream)
+    {
+        const auto chunk = std::min<std::uint64_t>(remaining, buffer.size());
+        stream.read(buffer.data(), chunk);
+        crc.process_bytes(buffer.data(), stream.gcount());
+        remaining -= chunk;
+    }
+
+    if (remaining > 0)
+    {
+        throw util::exception("Unexpected end of file while checksumming " + path.string() +
+                              SOURCE_REF);
+    }
+
+    return crc.checksum();
+}
+
+struct BlockRef
+{
+    std::size_t file_index;
+    std::size_t block_index;
+};
+
+// Runs `callback(block, checksum)` for all blocks of the given files in parallel
+template <typename Callback>
+inline void forEachBlockChecksum(const boost::filesystem::path &base,
+                                 const std::vector<Manifest::FileEntry> &files,
+                                 const std::vector<BlockRef> &blocks,
+                                 const std::atomic<bool> *cancel,
+                                 Callback &&callback)
+{
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, blocks.size(), 1),
+                      [&](const tbb::blocked_range<std::size_t> &range) {
+                          for (auto index = range.begin(); index != range.end(); ++index)
+                          {
+                              if (cancel != nullptr && cancel->load())
+                                  return;
+
+                              const auto &block = blocks[index];
+                              const auto &file = files[block.file_index];
+                              const auto offset = block.block_index * file.block_size;
+                              const auto length =
+                                  std::min<std::uint64_t>(file.block_size, file.size - offset);
+                              callback(block,
+                                       computeBlockChecksum(
+                                           base.string() + file.suffix, offset, length));
+                          }
+                      });
+}
+
+inline std::uint8_t detectCapabilities(const boost::filesystem::path &base)
+{
+    const auto fileSize = [&](const char *suffix) -> std::uint64_t {
+        const boost::filesystem::path path = base.string() + suffix;
+        if (!boost::filesystem::exists(path))
+            return 0;
+        const auto size = boost::filesystem::file_size(path);
+        return size > sizeof(util::FingerPrint) ? size - sizeof(util::FingerPrint) : 0;
+    };
+
+    // mirrors the checks done in Engine::CheckCompability
+    std::uint8_t capabilities = 0;
+    if (fileSize(".hsgr") > 0)
+    {
+        capabilities |= Manifest::CH;
+        if (fileSize(".core") > sizeof(std::uint64_t))
+            capabilities |= Manifest::CORE_CH;
+    }
+    if (fileSize(".partition") > 0 && fileSize(".cells") > 0 && fileSize(".mldgr") > 0)
+    {
+        capabilities |= Manifest::MLD;
+    }
+    return capabilities;
+}
+}
+
+inline Manifest readManifest(const boost::filesystem::path &path)
+{
+    io::FileReader reader{path, io::FileReader::VerifyFingerprint};
+
+    Manifest manifest;
+    reader.ReadInto(manifest.capabilities);
+    std::uint8_t complete;
+    reader.ReadInto(complete);
+    manifest.complete = complete != 0;
+    manifest.files.resize(reader.ReadElementCount64());
+    for (auto &file : manifest.files)
+    {
+        std::vector<char> suffix;
+        serialization::read(reader, suffix);
+        file.suffix.assign(suffix.begin(), suffix.end());
+        reader.ReadInto(file.size);
+        reader.ReadInto(file.modification_time);
+        reader.ReadInto(file.block_size);
+        serialization::read(reader, file.checksums);
+    }
+
+    return manifest;
+}
+
+// Replaces the manifest atomically, so that osrm-routed never reads a partially written one
+inline void writeManifest(const boost::filesystem::path &path, const Manifest &manifest)
+{
+    const boost::filesystem::path temporary_path = path.string() + ".tmp";
+    {
+        io::FileWriter writer{temporary_path, io::FileWriter::GenerateFingerprint};
+
+        writer.WriteOne(manifest.capabilities);
+        writer.WriteOne(static_cast<std::uint8_t>(manifest.complete));
+        writer.WriteElementCount64(manifest.files.size());
+        for (const auto &file : manifest.files)
+        {
+            serialization::write(writer,
+                                 std::vector<char>(file.suffix.begin(), file.suffix.end()));
+            writer.WriteOne(file.size);
+            writer.WriteOne(file.modification_time);
+            writer.WriteOne(file.block_size);
+            serialization::write(writer, file.checksums);
+        }
+    }
+    boost::filesystem::rename(temporary_path, path);
+}
+
+/**
+ * Rewrites the manifest of the dataset at `base` (e.g. france.osrm).
+ *
+ * The files in `written_suffixes` are always checksummed again, since a tool can rewrite a file
+ * with the same size within the resolution of the modification time. The checksums of all
+ * other files are only recomputed if their size or modification time changed.
+ *
+ * `complete` marks the dataset as ready to be served, it is only set by the last tool of the
+ * pipeline (osrm-contract or osrm-customize).
+ */
+inline void updateManifest(const boost::filesystem::path &base,
+                           const std::vector<std::string> &written_suffixes,
+                           const bool complete)
+{
+    const auto manifest_path = getManifestPath(base);
+
+    Manifest previous;
+    if (boost::filesystem::exists(manifest_path))
+    {
+        try
+        {
+            previous = readManifest(manifest_path);
+        }
+        catch (const util::exception &)
+        {
+            util::Log(logWARNING) << "Discarding invalid manifest " << manifest_path.string();
+        }
+    }
+
+    Manifest manifest;
+    manifest.capabilities = detail::detectCapabilities(base);
+    manifest.complete = complete;
+
+    std::vector<detail::BlockRef> dirty_blocks;
+    for (const auto suffix : FILE_SUFFIXES)
+    {
+        const boost::filesystem::path path = base.string() + suffix;
+        if (!boost::filesystem::exists(path))
+            continue;
+
+        Manifest::FileEntry entry;
+        entry.suffix = suffix;
+        entry.size = boost::filesystem::file_size(path);
+        entry.modification_time = boost::filesystem::last_write_time(path);
+        entry.block_size = BLOCK_SIZE;
+
+        const auto was_written =
+            std::find(written_suffixes.begin(), written_suffixes.end(), suffix) !=
+            written_suffixes.end();
+        const auto old_entry = previous.GetFile(suffix);
+        if (!was_written && old_entry != nullptr && old_entry->size == entry.size &&
+            old_entry->modification_time == entry.modification_time &&
+            old_entry->block_size == entry.block_size)
+        {
+            entry.checksums = old_entry->checksums;
+        }
+        else
+        {
+            entry.checksums.resize((entry.size + BLOCK_SIZE - 1) / BLOCK_SIZE);
+            for (std::size_t block = 0; block < entry.checksums.size(); ++block)
+            {
+                dirty_blocks.push_back({manifest.files.size(), block});
+            }
+        }
+
+        manifest.files.push_back(std::move(entry));
+    }
+
+    detail::forEachBlockChecksum(
+        base,
+        manifest.files,
+        dirty_blocks,
+        nullptr,
+        [&](const detail::BlockRef &block, const std::uint32_t checksum) {
+            manifest.files[block.file_index].checksums[block.block_index] = checksum;
+        });
+
+    writeManifest(manifest_path, manifest);
+}
+
+/**
+ * Cheap consistency check of the dataset at `base` against its manifest.
+ *
+ * Only compares file sizes, since copying a dataset usually does not preserve
+ * modification times. Returns false and logs the offending files on mismatch.
+ */
+inline bool checkManifest(const boost::filesystem::path &base, const Manifest &manifest)
+{
+    bool valid = true;
+    for (const auto &file : manifest.files)
+    {
+        const boost::filesystem::path path = base.string() + file.suffix;
+        if (!boost::filesystem::exists(path))
+        {
+            util::Log(logERROR) << "Missing File: " << path.string();
+            valid = false;
+        }
+        else if (boost::filesystem::file_size(path) != file.size)
+        {
+            util::Log(logERROR) << "File " << path.string()
+                                << " does not match the size recorded in the dataset manifest";
+            valid = false;
+        }
+    }
+    return valid;
+}
+
+/**
+ * Verifies the checksums of all blocks recorded in the manifest in parallel.
+ *
+ * Can be stopped early by setting `cancel`, in which case the result only covers the
+ * blocks checked so far. Returns false and logs the offending files on mismatch.
+ */
+inline bool verifyManifest(const boost::filesystem::path &base,
+                           const Manifest &manifest,
+                           const std::atomic<bool> *cancel = nullptr)
+{
+    if (!checkManifest(base, manifest))
+        return false;
+
+    std::vector<detail::BlockRef> blocks;
+    for (std::size_t file_index = 0; file_index < manifest.files.size(); ++file_index)
+    {
+        for (std::size_t block = 0; block < manifest.files[file_index].checksums.size(); ++block)
+        {
+            blocks.push_back({file_index, block});
+        }
+    }
+
+    std::vector<std::atomic<bool>> file_valid(manifest.files.size());
+    for (auto &valid : file_valid)
+        valid = true;
+
+    detail::forEachBlockChecksum(
+        base,
+        manifest.files,
+        blocks,
+        cancel,
+        [&](const detail::BlockRef &block, const std::uint32_t checksum) {
+            if (manifest.files[block.file_index].checksums[block.block_index] != checksum)
+                file_valid[block.file_index] = false;
+        });
+
+    bool valid = true;
+    for (std::size_t file_index = 0; file_index < manifest.files.size(); ++file_index)
+    {
+        if (!file_valid[file_index])
+        {
+            util::Log(logERROR) << "Checksum mismatch in " << base.string()
+                                << manifest.files[file_index].suffix;
+            valid = false;
+        }
+    }
+    return valid;
+}
+
+/**
+ * Checks if the dataset at `base` can be loaded: the last tool of the pipeline finished and
+ * all files still match its checksums. Files of an unfinished pipeline run fail this check.
+ */
+inline bool isDatasetComplete(const boost::filesystem::path &base,
+                              const std::atomic<bool> *cancel = nullptr)
+{
+    const auto manifest_path = getManifestPath(base);
+    if (!boost::filesystem::exists(manifest_path))
+        return false;
+
+    Manifest manifest;
+    try
+    {
+        manifest = readManifest(manifest_path);
+    }
+    catch (const util::exception &)
+    {
+        return false;
+    }
+
+    return manifest.complete && verifyManifest(base, manifest, cancel) &&
+           (cancel == nullptr || !cancel->load());
+}
+}
+}
+}
+
+#endif
@@ -26,6 +26,7 @@ const constexpr char *block_id_to_name[] = {"NAME_CHAR_DATA",
                                             "CH_GRAPH_NODE_LIST",
                                             "CH_GRAPH_EDGE_LIST",
                                             "COORDINATE_LIST",
+                                            "COORDINATE_BLOCKS",
                                             "OSM_NODE_ID_LIST",
                                             "TURN_INSTRUCTION",
                                             "ENTRY_CLASSID",
@@ -81,6 +82,7 @@ struct DataLayout
         CH_GRAPH_NODE_LIST,
         CH_GRAPH_EDGE_LIST,
         COORDINATE_LIST,
+        COORDINATE_BLOCKS,
         OSM_NODE_ID_LIST,
         TURN_INSTRUCTION,
         ENTRY_CLASSID,
@@ -33,6 +33,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <boost/filesystem/path.hpp>
 
+#include <functional>
 #include <string>
 
 namespace osrm
@@ -46,6 +47,11 @@ class Storage
 
     int Run(int max_wait);
 
+    // Copies the dataset that is in use into the other shared memory region, lets update
+    // change the copy in place and switches all clients to it like Run does.
+    using UpdateFunction = std::function<void(const DataLayout &layout, char *memory_ptr)>;
+    static int Update(int max_wait, const UpdateFunction &update);
+
     void PopulateLayout(DataLayout &layout);
     void PopulateData(const DataLayout &layout, char *memory_ptr);
 
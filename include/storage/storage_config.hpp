@@ -73,6 +73,7 @@ struct StorageConfig final
     boost::filesystem::path mld_partition_path;
     boost::filesystem::path mld_storage_path;
     boost::filesystem::path mld_graph_path;
+    boost::filesystem::path manifest_path;
 };
 }
 }
@@ -0,0 +1,75 @@
+#ifndef OSRM_UPDATER_BINARY_SOURCE_HPP
+#define OSRM_UPDATER_BINARY_SOURCE_HPP
+
+#include "updater/source.hpp"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace updater
+{
+namespace binary
+{
+
+// Binary alternative to the segment speed and turn penalty CSV files.
+//
+// A file is a header followed by fixed-width little-endian records that are sorted by key
+// without duplicates, so it can be used without parsing or sorting.
+struct Header
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t record_size;
+    std::uint64_t num_records;
+};
+static_assert(sizeof(Header) == 24, "Header is not packed");
+
+// from,to,speed[,rate]
+struct SegmentSpeedRecord
+{
+    std::uint64_t from;
+    std::uint64_t to;
+    // NaN if the rate is not set
+    double rate;
+    std::uint32_t speed;
+    std::uint32_t reserved;
+};
+static_assert(sizeof(SegmentSpeedRecord) == 32, "SegmentSpeedRecord is not packed");
+
+// from,via,to,duration[,weight]
+struct TurnPenaltyRecord
+{
+    std::uint64_t from;
+    std::uint64_t via;
+    std::uint64_t to;
+    double duration;
+    // NaN if the weight is not set
+    double weight;
+};
+static_assert(sizeof(TurnPenaltyRecord) == 40, "TurnPenaltyRecord is not packed");
+
+// True if the file starts with the header of a binary segment speed or turn penalty file
+bool isBinaryFile(const std::string &path);
+
+// Read a binary file, the values get the given source index
+void readValues(const std::string &path,
+                const std::uint8_t source,
+                std::vector<std::pair<Segment, SpeedSource>> &values);
+void readValues(const std::string &path,
+                const std::uint8_t source,
+                std::vector<std::pair<Turn, PenaltySource>> &values);
+
+// Write values that are sorted by key without duplicates
+void writeValues(const std::string &path,
+                 const std::vector<std::pair<Segment, SpeedSource>> &values);
+void writeValues(const std::string &path,
+                 const std::vector<std::pair<Turn, PenaltySource>> &values);
+}
+}
+}
+
+#endif
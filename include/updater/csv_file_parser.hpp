@@ -1,11 +1,13 @@
 #ifndef OSRM_UPDATER_CSV_FILE_PARSER_HPP
 #define OSRM_UPDATER_CSV_FILE_PARSER_HPP
 
+#include "updater/binary_source.hpp"
 #include "updater/source.hpp"
 
 #include "util/exception.hpp"
 #include "util/exception_utils.hpp"
 #include "util/log.hpp"
+#include "util/timing_util.hpp"
 
 #include <tbb/parallel_for.h>
 #include <tbb/spin_mutex.h>
@@ -16,6 +18,7 @@
 #include <boost/spirit/include/phoenix.hpp>
 #include <boost/spirit/include/qi.hpp>
 
+#include <algorithm>
 #include <vector>
 
 namespace osrm
@@ -24,6 +27,7 @@ namespace updater
 {
 
 // Functor to parse a list of CSV files using "key,value,comment" grammar.
+// Files that start with a binary header (see binary_source.hpp) are mapped instead of parsed.
 // Key and Value structures must be a model of Random Access Sequence.
 // Also the Value structure must have source member that will be filled
 // with the corresponding file index in the CSV filenames vector.
@@ -43,41 +47,53 @@ template <typename Key, typename Value> struct CSVFilesParser
     {
         try
         {
-            tbb::spin_mutex mutex;
-            std::vector<std::pair<Key, Value>> lookup;
-            tbb::parallel_for(std::size_t{0},
-                              csv_filenames.size(),
-                              [&](const std::size_t idx) {
-                                  auto local = ParseCSVFile(csv_filenames[idx], start_index + idx);
-
-                                  { // Merge local CSV results into a flat global vector
-                                      tbb::spin_mutex::scoped_lock _{mutex};
-                                      lookup.insert(end(lookup),
-                                                    std::make_move_iterator(begin(local)),
-                                                    std::make_move_iterator(end(local)));
-                                  }
-                              });
-
-            // With flattened map-ish view of all the files, make a stable sort on key and source
-            // and unique them on key to keep only the value with the largest file index
-            // and the largest line number in a file.
-            // The operands order is swapped to make descending ordering on (key, source)
-            std::stable_sort(begin(lookup), end(lookup), [](const auto &lhs, const auto &rhs) {
-                return rhs.first < lhs.first ||
-                       (rhs.first == lhs.first && rhs.second.source < lhs.second.source);
+            // Every file yields a run that is sorted on key without duplicates
+            TIMER_START(parse);
+            std::vector<std::vector<std::pair<Key, Value>>> runs(csv_filenames.size());
+            tbb::parallel_for(std::size_t{0}, csv_filenames.size(), [&](const std::size_t idx) {
+                runs[idx] = ParseFile(csv_filenames[idx], start_index + idx);
             });
+            TIMER_STOP(parse);
 
-            // Unique only on key to take the source precedence into account and remove duplicates.
-            const auto it =
-                std::unique(begin(lookup), end(lookup), [](const auto &lhs, const auto &rhs) {
-                    return lhs.first == rhs.first;
-                });
-            lookup.erase(it, end(lookup));
+            // Merge the runs in file order so a value from a file with a larger index
+            // takes precedence over the same key in the files before it
+            TIMER_START(merge);
+            std::vector<std::pair<Key, Value>> lookup;
+            for (auto &run : runs)
+            {
+                if (lookup.empty())
+                {
+                    lookup = std::move(run);
+                    continue;
+                }
+
+                std::vector<std::pair<Key, Value>> merged;
+                merged.reserve(lookup.size() + run.size());
+                auto lhs = lookup.begin(), rhs = run.begin();
+                while (lhs != lookup.end() && rhs != run.end())
+                {
+                    if (lhs->first < rhs->first)
+                        merged.push_back(*lhs++);
+                    else if (rhs->first < lhs->first)
+                        merged.push_back(*rhs++);
+                    else
+                    {
+                        merged.push_back(*rhs++);
+                        ++lhs;
+                    }
+                }
+                merged.insert(merged.end(), lhs, lookup.end());
+                merged.insert(merged.end(), rhs, run.end());
+                lookup = std::move(merged);
+                std::vector<std::pair<Key, Value>>().swap(run);
+            }
+            TIMER_STOP(merge);
 
             util::Log() << "In total loaded " << csv_filenames.size() << " file(s) with a total of "
-                        << lookup.size() << " unique values";
+                        << lookup.size() << " unique values in " << TIMER_SEC(parse)
+                        << "s, merged in " << TIMER_SEC(merge) << "s";
 
-            return LookupTable<Key, Value>{lookup};
+            return LookupTable<Key, Value>{std::move(lookup)};
         }
         catch (const tbb::captured_exception &e)
         {
@@ -86,8 +102,39 @@ template <typename Key, typename Value> struct CSVFilesParser
     }
 
   private:
+    // Read a single binary or CSV file and return its values sorted on key without duplicates
+    std::vector<std::pair<Key, Value>> ParseFile(const std::string &filename,
+                                                 std::size_t file_id) const
+    {
+        BOOST_ASSERT(file_id <= std::numeric_limits<std::uint8_t>::max());
+
+        std::vector<std::pair<Key, Value>> result;
+        if (binary::isBinaryFile(filename))
+        {
+            // Binary files are written sorted and without duplicates
+            binary::readValues(filename, file_id, result);
+            return result;
+        }
+
+        result = ParseCSVFile(filename, file_id);
+
+        // Sort the reversed lines so the last line in the file wins when dropping duplicates
+        std::reverse(result.begin(), result.end());
+        std::stable_sort(result.begin(), result.end(), [](const auto &lhs, const auto &rhs) {
+            return lhs.first < rhs.first;
+        });
+        const auto it =
+            std::unique(result.begin(), result.end(), [](const auto &lhs, const auto &rhs) {
+                return lhs.first == rhs.first;
+            });
+        result.erase(it, result.end());
+
+        return result;
+    }
+
     // Parse a single CSV file and return result as a vector<Key, Value>
-    auto ParseCSVFile(const std::string &filename, std::size_t file_id) const
+    std::vector<std::pair<Key, Value>> ParseCSVFile(const std::string &filename,
+                                                    std::size_t file_id) const
     {
         namespace qi = boost::spirit::qi;
 
@@ -100,7 +147,6 @@ template <typename Key, typename Value> struct CSVFilesParser
             boost::iostreams::mapped_file_source mmap(filename);
             auto first = mmap.begin(), last = mmap.end();
 
-            BOOST_ASSERT(file_id <= std::numeric_limits<std::uint8_t>::max());
             ValueRule value_source =
                 value_rule[qi::_val = qi::_1, bind(&Value::source, qi::_val) = file_id];
             qi::rule<Iterator, std::pair<Key, Value>()> csv_line =
@@ -121,7 +167,7 @@ template <typename Key, typename Value> struct CSVFilesParser
 
             util::Log() << "Loaded " << filename << " with " << result.size() << "values";
 
-            return std::move(result);
+            return result;
         }
         catch (const boost::exception &e)
         {
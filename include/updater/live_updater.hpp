@@ -0,0 +1,96 @@
+#ifndef OSRM_UPDATER_LIVE_UPDATER_HPP
+#define OSRM_UPDATER_LIVE_UPDATER_HPP
+
+#include "updater/source.hpp"
+
+#include "storage/shared_datatype.hpp"
+
+#include "util/typedefs.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace osrm
+{
+namespace updater
+{
+
+// Change of the weight and duration of an edge-based node
+struct NodeWeightUpdate
+{
+    EdgeWeight weight;
+    EdgeWeight duration;
+    // a segment of the node is closed, so it can not be traversed anymore
+    bool closed;
+};
+using NodeWeightUpdates = std::unordered_map<NodeID, NodeWeightUpdate>;
+
+// Applies changed node weights to the edges of an MLD graph and selects all cells that
+// contain a changed edge in the cell mask of the customizer.
+//
+// The weight of an edge from n to m starts with the weight of n. An edge of n that is only
+// backward is the reversed edge from m to n and starts with the weight of m. Edges that are
+// forward and backward keep the weight of the forward direction, since they can not be split.
+//
+// Returns the number of changed edges.
+template <typename GraphT, typename CustomizerT>
+std::size_t updateEdgeWeights(GraphT &graph,
+                              const CustomizerT &customizer,
+                              const NodeWeightUpdates &updates,
+                              typename CustomizerT::CellMask &cell_mask)
+{
+    // the edges of all changed nodes and the reversed edges that point to them
+    std::vector<NodeID> nodes;
+    for (const auto &update : updates)
+    {
+        nodes.push_back(update.first);
+        for (auto edge : graph.GetAdjacentEdgeRange(update.first))
+            nodes.push_back(graph.GetTarget(edge));
+    }
+    std::sort(nodes.begin(), nodes.end());
+    nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+
+    std::size_t num_changed_edges = 0;
+    for (const auto node : nodes)
+    {
+        for (auto edge : graph.GetAdjacentEdgeRange(node))
+        {
+            const NodeID target = graph.GetTarget(edge);
+            auto &data = graph.GetEdgeData(edge);
+            const auto forward_update = data.forward ? updates.find(node) : updates.end();
+            const auto backward_update = data.backward ? updates.find(target) : updates.end();
+            if (forward_update == updates.end() && backward_update == updates.end())
+                continue;
+
+            if (forward_update != updates.end() && forward_update->second.closed)
+                data.forward = false;
+            if (backward_update != updates.end() && backward_update->second.closed)
+                data.backward = false;
+
+            const auto update = data.forward ? forward_update : backward_update;
+            if (update != updates.end() && !update->second.closed)
+            {
+                data.weight = std::max<EdgeWeight>(data.weight + update->second.weight, 1);
+                data.duration = std::max<EdgeWeight>(data.duration + update->second.duration, 0);
+            }
+
+            customizer.MarkEdge(cell_mask, node, target);
+            ++num_changed_edges;
+        }
+    }
+
+    return num_changed_edges;
+}
+
+// Applies segment speeds to an MLD dataset that is loaded into memory: the segment weights
+// and durations are patched in place, the edges of the graph get the new node weights and
+// only the cells that contain changed edges are customized again.
+void applySegmentSpeeds(const SegmentLookupTable &segment_speed_lookup,
+                        const storage::DataLayout &layout,
+                        char *memory_ptr);
+}
+}
+
+#endif
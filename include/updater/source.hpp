@@ -1,10 +1,16 @@
 #ifndef OSRM_UPDATER_SOURCE_HPP
 #define OSRM_UPDATER_SOURCE_HPP
 
+#include "util/std_hash.hpp"
 #include "util/typedefs.hpp"
 
+#include <boost/assert.hpp>
 #include <boost/optional.hpp>
 
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <tuple>
 #include <vector>
 
 namespace osrm
@@ -12,21 +18,81 @@ namespace osrm
 namespace updater
 {
 
+// Lookup in values that are sorted on key without duplicates.
+// An open addressing hash index over the positions of the values avoids a binary search
+// per lookup, the updater looks up every segment and turn of the graph.
 template <typename Key, typename Value> struct LookupTable
 {
+    LookupTable() = default;
+    explicit LookupTable(std::vector<std::pair<Key, Value>> lookup_) : lookup(std::move(lookup_))
+    {
+        BuildIndex();
+    }
+
     boost::optional<Value> operator()(const Key &key) const
     {
         using Result = boost::optional<Value>;
-        const auto it = std::lower_bound(
-            lookup.begin(), lookup.end(), key, [](const auto &lhs, const auto &rhs) {
-                return rhs < lhs.first;
-            });
-        return it != std::end(lookup) && !(it->first < key) ? Result(it->second) : Result();
+        if (index.empty())
+        {
+            const auto it = std::lower_bound(
+                lookup.begin(), lookup.end(), key, [](const auto &lhs, const auto &rhs) {
+                    return lhs.first < rhs;
+                });
+            return it != std::end(lookup) && !(key < it->first) ? Result(it->second) : Result();
+        }
+
+        for (auto slot = Slot(key);; slot = (slot + 1) & (index.size() - 1))
+        {
+            const auto position = index[slot];
+            if (position == EMPTY_SLOT)
+                return Result();
+            if (lookup[position].first == key)
+                return Result(lookup[position].second);
+        }
+    }
+
+    // Has to be called again after lookup was modified
+    void BuildIndex()
+    {
+        index.clear();
+        if (lookup.empty())
+            return;
+        BOOST_ASSERT(lookup.size() < EMPTY_SLOT);
+
+        // keep the load factor between 1/4 and 1/2 so probe sequences stay short
+        index_bits = 1;
+        while ((std::size_t{1} << index_bits) < 2 * lookup.size())
+            ++index_bits;
+        index.resize(std::size_t{1} << index_bits, EMPTY_SLOT);
+
+        for (std::uint32_t position = 0; position < lookup.size(); ++position)
+        {
+            auto slot = Slot(lookup[position].first);
+            while (index[slot] != EMPTY_SLOT)
+                slot = (slot + 1) & (index.size() - 1);
+            index[slot] = position;
+        }
     }
 
     std::vector<std::pair<Key, Value>> lookup;
+
+  private:
+    static constexpr std::uint32_t EMPTY_SLOT = std::numeric_limits<std::uint32_t>::max();
+
+    // Fibonacci hashing takes the high bits, consecutive OSM node ids don't collide
+    std::size_t Slot(const Key &key) const
+    {
+        const std::uint64_t hash = std::hash<Key>()(key);
+        return (hash * 0x9E3779B97F4A7C15ull) >> (64 - index_bits);
+    }
+
+    std::vector<std::uint32_t> index;
+    unsigned index_bits = 0;
 };
 
+template <typename Key, typename Value>
+constexpr std::uint32_t LookupTable<Key, Value>::EMPTY_SLOT;
+
 struct Segment final
 {
     std::uint64_t from, to;
@@ -91,4 +157,23 @@ using TurnLookupTable = LookupTable<Turn, PenaltySource>;
 }
 }
 
+namespace std
+{
+template <> struct hash<osrm::updater::Segment>
+{
+    std::size_t operator()(const osrm::updater::Segment &segment) const
+    {
+        return hash_val(segment.from, segment.to);
+    }
+};
+
+template <> struct hash<osrm::updater::Turn>
+{
+    std::size_t operator()(const osrm::updater::Turn &turn) const
+    {
+        return hash_val(turn.from, turn.via, turn.to);
+    }
+};
+}
+
 #endif
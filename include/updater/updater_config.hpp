@@ -55,6 +55,7 @@ struct UpdaterConfig final
         datasource_names_path = osrm_input_path.string() + ".datasource_names";
         profile_properties_path = osrm_input_path.string() + ".properties";
         turn_restrictions_path = osrm_input_path.string() + ".restrictions";
+        restriction_turns_path = osrm_input_path.string() + ".restriction_turns";
     }
 
     boost::filesystem::path osrm_input_path;
@@ -78,6 +79,7 @@ struct UpdaterConfig final
     std::string datasource_names_path;
     std::string profile_properties_path;
     std::string turn_restrictions_path;
+    std::string restriction_turns_path;
     std::string tz_file_path;
 };
 }
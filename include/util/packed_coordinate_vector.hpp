@@ -0,0 +1,256 @@
+#ifndef OSRM_UTIL_PACKED_COORDINATE_VECTOR_HPP
+#define OSRM_UTIL_PACKED_COORDINATE_VECTOR_HPP
+
+#include "util/coordinate.hpp"
+#include "util/integer_range.hpp"
+#include "util/vector_view.hpp"
+
+#include "storage/io_fwd.hpp"
+#include "storage/shared_memory_ownership.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+namespace detail
+{
+template <storage::Ownership Ownership> class PackedCoordinateVector;
+}
+
+namespace serialization
+{
+template <storage::Ownership Ownership>
+inline void read(storage::io::FileReader &reader,
+                 detail::PackedCoordinateVector<Ownership> &coordinates);
+
+template <storage::Ownership Ownership>
+inline void write(storage::io::FileWriter &writer,
+                  const detail::PackedCoordinateVector<Ownership> &coordinates);
+}
+
+namespace detail
+{
+
+/**
+ * Stores coordinates in blocks of BLOCK_SIZE elements using a frame-of-reference encoding.
+ *
+ * Every block saves the minimal longitude and latitude of its coordinates and the bit widths
+ * needed to store the offsets to these minima. The offsets of a coordinate are stored
+ * next to each other in a shared bit stream of 64 bit words.
+ *
+ * Node ids that are close to each other are usually close in space, so most blocks need
+ * far less than 2x32 bits per coordinate. In the worst case a block falls back to the
+ * full width, which only adds the block header as overhead.
+ *
+ * Random access is O(1): one header lookup and at most two word reads.
+ */
+template <storage::Ownership Ownership> class PackedCoordinateVector
+{
+    template <typename T> using Vector = util::ViewOrVector<T, Ownership>;
+
+    using WordT = std::uint64_t;
+    static constexpr std::size_t WORD_BITS = sizeof(WordT) * CHAR_BIT;
+
+  public:
+    static constexpr std::size_t BLOCK_SIZE = 64;
+
+    struct BlockHeader
+    {
+        std::int32_t base_lon;
+        std::int32_t base_lat;
+        // index of the first word of the block in the bit stream
+        std::uint32_t word_offset;
+        std::uint8_t lon_bits;
+        std::uint8_t lat_bits;
+        // number of coordinates in the block, only the last block can be partial
+        std::uint8_t num_elements;
+        std::uint8_t padding;
+    };
+    static_assert(sizeof(BlockHeader) == 16, "BlockHeader should be 16 bytes");
+
+    using value_type = util::Coordinate;
+    using block_type = WordT;
+
+    PackedCoordinateVector() = default;
+
+    PackedCoordinateVector(Vector<BlockHeader> blocks_, Vector<WordT> words_)
+        : blocks(std::move(blocks_)), words(std::move(words_))
+    {
+    }
+
+    template <bool enabled = (Ownership == storage::Ownership::Container)>
+    explicit PackedCoordinateVector(
+        const typename std::enable_if<enabled, std::vector<util::Coordinate>>::type &coordinates)
+    {
+        const auto num_blocks = (coordinates.size() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        blocks.reserve(num_blocks);
+
+        for (auto block_index : util::irange<std::size_t>(0, num_blocks))
+        {
+            const auto begin = coordinates.begin() + block_index * BLOCK_SIZE;
+            const auto end =
+                coordinates.begin() + std::min((block_index + 1) * BLOCK_SIZE, coordinates.size());
+            EncodeBlock(begin, end);
+        }
+
+        // sentinel word, so we can always read the word following the one we access
+        words.push_back(0);
+    }
+
+    util::Coordinate operator[](const std::size_t index) const
+    {
+        BOOST_ASSERT(index / BLOCK_SIZE < blocks.size());
+        const auto &block = blocks[index / BLOCK_SIZE];
+
+        const std::uint64_t entry_bits = block.lon_bits + block.lat_bits;
+        const std::uint64_t bit_offset =
+            block.word_offset * WORD_BITS + (index % BLOCK_SIZE) * entry_bits;
+        const auto entry = ReadBits(bit_offset, entry_bits);
+
+        const auto lon_offset = entry & Mask(block.lon_bits);
+        const auto lat_offset = (entry >> block.lon_bits) & Mask(block.lat_bits);
+
+        return util::Coordinate{
+            FixedLongitude{static_cast<std::int32_t>(block.base_lon + lon_offset)},
+            FixedLatitude{static_cast<std::int32_t>(block.base_lat + lat_offset)}};
+    }
+
+    util::Coordinate at(const std::size_t index) const
+    {
+        if (index >= size())
+            throw std::out_of_range(std::to_string(index) + " is bigger then container size " +
+                                    std::to_string(size()));
+        return operator[](index);
+    }
+
+    std::size_t size() const
+    {
+        if (blocks.empty())
+            return 0;
+        return (blocks.size() - 1) * BLOCK_SIZE + blocks.back().num_elements;
+    }
+
+    bool empty() const { return blocks.empty(); }
+
+    // number of bytes used by the encoded coordinates
+    std::size_t GetSizeInBytes() const
+    {
+        return blocks.size() * sizeof(BlockHeader) + words.size() * sizeof(WordT);
+    }
+
+    friend void serialization::read<Ownership>(storage::io::FileReader &reader,
+                                               PackedCoordinateVector &coordinates);
+    friend void serialization::write<Ownership>(storage::io::FileWriter &writer,
+                                                const PackedCoordinateVector &coordinates);
+
+  private:
+    static WordT Mask(const std::uint64_t bits)
+    {
+        return bits >= WORD_BITS ? std::numeric_limits<WordT>::max() : (WordT{1} << bits) - 1;
+    }
+
+    static std::uint8_t BitWidth(std::uint64_t value)
+    {
+        std::uint8_t bits = 0;
+        while (value > 0)
+        {
+            value >>= 1;
+            bits++;
+        }
+        return bits;
+    }
+
+    inline WordT ReadBits(const std::uint64_t bit_offset, const std::uint64_t num_bits) const
+    {
+        const auto word_index = bit_offset / WORD_BITS;
+        const auto local_offset = bit_offset % WORD_BITS;
+
+        auto value = words[word_index] >> local_offset;
+        if (local_offset != 0 && local_offset + num_bits > WORD_BITS)
+        {
+            value |= words[word_index + 1] << (WORD_BITS - local_offset);
+        }
+        return value & Mask(num_bits);
+    }
+
+    template <typename Iter> void EncodeBlock(const Iter begin, const Iter end)
+    {
+        BOOST_ASSERT(std::distance(begin, end) > 0);
+        BOOST_ASSERT(std::distance(begin, end) <= static_cast<std::ptrdiff_t>(BLOCK_SIZE));
+        BOOST_ASSERT_MSG(words.size() <= std::numeric_limits<std::uint32_t>::max(),
+                         "word offset overflow");
+
+        std::int32_t min_lon = std::numeric_limits<std::int32_t>::max();
+        std::int32_t max_lon = std::numeric_limits<std::int32_t>::min();
+        std::int32_t min_lat = std::numeric_limits<std::int32_t>::max();
+        std::int32_t max_lat = std::numeric_limits<std::int32_t>::min();
+        for (auto iter = begin; iter != end; ++iter)
+        {
+            min_lon = std::min(min_lon, static_cast<std::int32_t>(iter->lon));
+            max_lon = std::max(max_lon, static_cast<std::int32_t>(iter->lon));
+            min_lat = std::min(min_lat, static_cast<std::int32_t>(iter->lat));
+            max_lat = std::max(max_lat, static_cast<std::int32_t>(iter->lat));
+        }
+
+        BlockHeader header;
+        header.base_lon = min_lon;
+        header.base_lat = min_lat;
+        header.word_offset = words.size();
+        header.lon_bits = BitWidth(static_cast<std::int64_t>(max_lon) - min_lon);
+        header.lat_bits = BitWidth(static_cast<std::int64_t>(max_lat) - min_lat);
+        header.num_elements = std::distance(begin, end);
+        header.padding = 0;
+
+        const std::uint64_t entry_bits = header.lon_bits + header.lat_bits;
+        const auto num_words = (entry_bits * header.num_elements + WORD_BITS - 1) / WORD_BITS;
+        words.resize(words.size() + num_words, 0);
+
+        std::uint64_t bit_offset = header.word_offset * WORD_BITS;
+        for (auto iter = begin; iter != end; ++iter, bit_offset += entry_bits)
+        {
+            const WordT lon_offset =
+                static_cast<std::int64_t>(static_cast<std::int32_t>(iter->lon)) - min_lon;
+            const WordT lat_offset =
+                static_cast<std::int64_t>(static_cast<std::int32_t>(iter->lat)) - min_lat;
+            WriteBits(bit_offset, lon_offset | (lat_offset << header.lon_bits));
+        }
+
+        blocks.push_back(header);
+    }
+
+    void WriteBits(const std::uint64_t bit_offset, const WordT value)
+    {
+        // blocks of identical coordinates don't allocate any words
+        if (value == 0)
+            return;
+
+        const auto word_index = bit_offset / WORD_BITS;
+        const auto local_offset = bit_offset % WORD_BITS;
+
+        words[word_index] |= value << local_offset;
+        if (local_offset != 0)
+        {
+            const auto upper = value >> (WORD_BITS - local_offset);
+            if (upper != 0)
+                words[word_index + 1] |= upper;
+        }
+    }
+
+    Vector<BlockHeader> blocks;
+    Vector<WordT> words;
+};
+}
+
+using PackedCoordinateVector = detail::PackedCoordinateVector<storage::Ownership::Container>;
+using PackedCoordinateVectorView = detail::PackedCoordinateVector<storage::Ownership::View>;
+}
+}
+
+#endif
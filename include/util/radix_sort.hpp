@@ -0,0 +1,98 @@
+#ifndef OSRM_UTIL_RADIX_SORT_HPP
+#define OSRM_UTIL_RADIX_SORT_HPP
+
+#include "util/integer_range.hpp"
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
+
+#include <boost/assert.hpp>
+
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace osrm
+{
+namespace util
+{
+
+/**
+ * Stable parallel LSD radix sort of values by a 64 bit key with 8 bit digits.
+ *
+ * Digits that are the same for all keys are skipped, e.g. OSM ids need five passes.
+ * Uses a second buffer of the size of the input.
+ */
+template <typename T, typename KeyFunctionT>
+void radixSort(std::vector<T> &values, const KeyFunctionT &key)
+{
+    const constexpr std::size_t DIGIT_BITS = 8;
+    const constexpr std::size_t NUM_BUCKETS = 1 << DIGIT_BITS;
+    const constexpr std::size_t CHUNK_SIZE = 1 << 16;
+    using Histogram = std::array<std::size_t, NUM_BUCKETS>;
+
+    if (values.size() < 2)
+        return;
+
+    // bits in which at least two keys differ
+    const std::uint64_t first_key = key(values.front());
+    const auto varying_bits = tbb::parallel_reduce(
+        tbb::blocked_range<std::size_t>(0, values.size(), CHUNK_SIZE),
+        std::uint64_t{0},
+        [&](const tbb::blocked_range<std::size_t> &range, std::uint64_t bits) {
+            for (auto index = range.begin(); index != range.end(); ++index)
+                bits |= key(values[index]) ^ first_key;
+            return bits;
+        },
+        [](const std::uint64_t lhs, const std::uint64_t rhs) { return lhs | rhs; });
+
+    const auto num_chunks = (values.size() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    std::vector<Histogram> offsets(num_chunks);
+    std::vector<T> buffer(values.size());
+
+    for (std::size_t shift = 0; shift < 64; shift += DIGIT_BITS)
+    {
+        if (((varying_bits >> shift) & (NUM_BUCKETS - 1)) == 0)
+            continue;
+
+        const auto digit = [&key, shift](const T &value) {
+            return (static_cast<std::uint64_t>(key(value)) >> shift) & (NUM_BUCKETS - 1);
+        };
+
+        tbb::parallel_for(std::size_t{0}, num_chunks, [&](const std::size_t chunk) {
+            auto &histogram = offsets[chunk];
+            histogram.fill(0);
+            const auto end = std::min(values.size(), (chunk + 1) * CHUNK_SIZE);
+            for (auto index = chunk * CHUNK_SIZE; index < end; ++index)
+                histogram[digit(values[index])]++;
+        });
+
+        // turn the counts into the output position of each chunk and bucket
+        std::size_t position = 0;
+        for (const auto bucket : util::irange<std::size_t>(0, NUM_BUCKETS))
+        {
+            for (auto &histogram : offsets)
+            {
+                const auto count = histogram[bucket];
+                histogram[bucket] = position;
+                position += count;
+            }
+        }
+        BOOST_ASSERT(position == values.size());
+
+        tbb::parallel_for(std::size_t{0}, num_chunks, [&](const std::size_t chunk) {
+            auto &histogram = offsets[chunk];
+            const auto end = std::min(values.size(), (chunk + 1) * CHUNK_SIZE);
+            for (auto index = chunk * CHUNK_SIZE; index < end; ++index)
+                buffer[histogram[digit(values[index])]++] = std::move(values[index]);
+        });
+
+        values.swap(buffer);
+    }
+}
+}
+}
+
+#endif
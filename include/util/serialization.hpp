@@ -2,6 +2,7 @@
 #define OSMR_UTIL_SERIALIZATION_HPP
 
 #include "util/dynamic_graph.hpp"
+#include "util/packed_coordinate_vector.hpp"
 #include "util/packed_vector.hpp"
 #include "util/range_table.hpp"
 #include "util/static_graph.hpp"
@@ -46,6 +47,22 @@ inline void write(storage::io::FileWriter &writer,
     storage::serialization::write(writer, vec.vec);
 }
 
+template <storage::Ownership Ownership>
+inline void read(storage::io::FileReader &reader,
+                 detail::PackedCoordinateVector<Ownership> &coordinates)
+{
+    storage::serialization::read(reader, coordinates.blocks);
+    storage::serialization::read(reader, coordinates.words);
+}
+
+template <storage::Ownership Ownership>
+inline void write(storage::io::FileWriter &writer,
+                  const detail::PackedCoordinateVector<Ownership> &coordinates)
+{
+    storage::serialization::write(writer, coordinates.blocks);
+    storage::serialization::write(writer, coordinates.words);
+}
+
 template <typename EdgeDataT, storage::Ownership Ownership>
 inline void read(storage::io::FileReader &reader, StaticGraph<EdgeDataT, Ownership> &graph)
 {
@@ -9,6 +9,7 @@
 #include "util/hilbert_value.hpp"
 #include "util/integer_range.hpp"
 #include "util/mmap_file.hpp"
+#include "util/packed_coordinate_vector.hpp"
 #include "util/rectangle.hpp"
 #include "util/typedefs.hpp"
 #include "util/vector_view.hpp"
@@ -136,7 +137,10 @@ class StaticRTree
   public:
     using Rectangle = RectangleInt2D;
     using EdgeData = EdgeDataT;
-    using CoordinateList = Vector<util::Coordinate>;
+    // Views are backed by the compressed coordinates in shared memory
+    using CoordinateList = typename std::conditional<Ownership == storage::Ownership::View,
+                                                     PackedCoordinateVectorView,
+                                                     Vector<util::Coordinate>>::type;
 
     static_assert(LEAF_PAGE_SIZE >= sizeof(EdgeDataT), "page size is too small");
     static_assert(((LEAF_PAGE_SIZE - 1) & LEAF_PAGE_SIZE) == 0, "page size is not a power of 2");
@@ -243,7 +247,7 @@ class StaticRTree
     TreeViewType m_search_tree;
 
     // Reference to the actual lon/lat data we need for doing math
-    const Vector<Coordinate> &m_coordinate_list;
+    const CoordinateList &m_coordinate_list;
 
     // Holds the number of TreeNodes in each level.
     // We always start with the root node, so
@@ -266,7 +270,7 @@ class StaticRTree
     explicit StaticRTree(const std::vector<EdgeDataT> &input_data_vector,
                          const std::string &tree_node_filename,
                          const std::string &leaf_node_filename,
-                         const Vector<Coordinate> &coordinate_list)
+                         const CoordinateList &coordinate_list)
         : m_coordinate_list(coordinate_list)
     {
         const auto element_count = input_data_vector.size();
@@ -467,7 +471,7 @@ class StaticRTree
      */
     explicit StaticRTree(const boost::filesystem::path &node_file,
                          const boost::filesystem::path &leaf_file,
-                         const Vector<Coordinate> &coordinate_list)
+                         const CoordinateList &coordinate_list)
         : m_coordinate_list(coordinate_list)
     {
         storage::io::FileReader tree_node_file(node_file,
@@ -502,7 +506,7 @@ class StaticRTree
                          const std::uint64_t *level_sizes_ptr,
                          const std::size_t number_of_levels,
                          const boost::filesystem::path &leaf_file,
-                         const Vector<Coordinate> &coordinate_list)
+                         const CoordinateList &coordinate_list)
         : m_search_tree(tree_node_ptr, number_of_nodes), m_coordinate_list(coordinate_list),
           m_tree_level_sizes(level_sizes_ptr, level_sizes_ptr + number_of_levels)
     {
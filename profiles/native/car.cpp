@@ -0,0 +1,985 @@
+// Car profile compiled into a shared library, a port of car.lua and the handlers it uses.
+//
+// Build it with the osrm_car_profile target and pass the library to osrm-extract:
+//   osrm-extract -p profiles/car.so map.osm.pbf
+
+#include "extractor/extraction_helper_functions.hpp"
+#include "extractor/native_profile.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <utility>
+
+namespace
+{
+using osrm::extractor::applyAccessTokens;
+using osrm::extractor::canonicalizeStringList;
+using osrm::extractor::durationIsValid;
+using osrm::extractor::parseDuration;
+using osrm::extractor::trimLaneString;
+
+using Entry = std::pair<const char *, double>;
+
+const constexpr double DEFAULT_SPEED = 10;
+const constexpr double SIDE_ROAD_MULTIPLIER = 0.8;
+const constexpr double TURN_PENALTY = 7.5;
+const constexpr double SPEED_REDUCTION = 0.8;
+const constexpr double TRAFFIC_LIGHT_PENALTY = 2;
+const constexpr double U_TURN_PENALTY = 20;
+
+const char *const SUFFIX_LIST[] = {
+    "N", "NE", "E", "SE", "S", "SW", "W", "NW", "North", "South", "West", "East", nullptr};
+
+const char *const RESTRICTIONS[] = {"motorcar", "motor_vehicle", "vehicle", nullptr};
+
+const char *const BARRIER_WHITELIST[] = {"cattle_grid",
+                                         "border_control",
+                                         "checkpoint",
+                                         "toll_booth",
+                                         "sally_port",
+                                         "gate",
+                                         "lift_gate",
+                                         "no",
+                                         "entrance",
+                                         nullptr};
+
+const char *const ACCESS_TAG_WHITELIST[] = {
+    "yes", "motorcar", "motor_vehicle", "vehicle", "permissive", "designated", "hov", nullptr};
+
+const char *const ACCESS_TAG_BLACKLIST[] = {"no",
+                                            "agricultural",
+                                            "forestry",
+                                            "emergency",
+                                            "psv",
+                                            "customers",
+                                            "private",
+                                            "delivery",
+                                            "destination",
+                                            nullptr};
+
+const char *const RESTRICTED_ACCESS_TAG_LIST[] = {
+    "private", "delivery", "destination", "customers", nullptr};
+
+const char *const ACCESS_TAGS_HIERARCHY[] = {
+    "motorcar", "motor_vehicle", "vehicle", "access", nullptr};
+
+const char *const SERVICE_TAG_FORBIDDEN[] = {"emergency_access", nullptr};
+
+const char *const RESTRICTED_HIGHWAY_WHITELIST[] = {"motorway",
+                                                    "motorway_link",
+                                                    "trunk",
+                                                    "trunk_link",
+                                                    "primary",
+                                                    "primary_link",
+                                                    "secondary",
+                                                    "secondary_link",
+                                                    "tertiary",
+                                                    "tertiary_link",
+                                                    "residential",
+                                                    "living_street",
+                                                    nullptr};
+
+const char *const MOTORWAY_TYPES[] = {"motorway", "motorway_link", "trunk", "trunk_link", nullptr};
+
+const char *const LINK_TYPES[] = {
+    "motorway_link", "trunk_link", "primary_link", "secondary_link", "tertiary_link", nullptr};
+
+const char *const ROAD_TYPES[] = {"motorway",
+                                  "motorway_link",
+                                  "trunk",
+                                  "trunk_link",
+                                  "primary",
+                                  "primary_link",
+                                  "secondary",
+                                  "secondary_link",
+                                  "tertiary",
+                                  "tertiary_link",
+                                  "unclassified",
+                                  "residential",
+                                  "living_street",
+                                  nullptr};
+
+const Entry HIGHWAY_SPEEDS[] = {{"motorway", 90},
+                                {"motorway_link", 45},
+                                {"trunk", 85},
+                                {"trunk_link", 40},
+                                {"primary", 65},
+                                {"primary_link", 30},
+                                {"secondary", 55},
+                                {"secondary_link", 25},
+                                {"tertiary", 40},
+                                {"tertiary_link", 20},
+                                {"unclassified", 25},
+                                {"residential", 25},
+                                {"living_street", 10},
+                                {"service", 15},
+                                {nullptr, 0}};
+
+const Entry SERVICE_PENALTIES[] = {{"alley", 0.5},
+                                   {"parking", 0.5},
+                                   {"parking_aisle", 0.5},
+                                   {"driveway", 0.5},
+                                   {"drive-through", 0.5},
+                                   {"drive-thru", 0.5},
+                                   {nullptr, 0}};
+
+const Entry ROUTE_SPEEDS[] = {{"ferry", 5}, {"shuttle_train", 10}, {nullptr, 0}};
+
+const Entry BRIDGE_SPEEDS[] = {{"movable", 5}, {nullptr, 0}};
+
+const Entry SURFACE_SPEEDS[] = {{"cement", 80},
+                                {"compacted", 80},
+                                {"fine_gravel", 80},
+                                {"paving_stones", 60},
+                                {"metal", 60},
+                                {"bricks", 60},
+                                {"grass", 40},
+                                {"wood", 40},
+                                {"sett", 40},
+                                {"grass_paver", 40},
+                                {"gravel", 40},
+                                {"unpaved", 40},
+                                {"ground", 40},
+                                {"dirt", 40},
+                                {"pebblestone", 40},
+                                {"tartan", 40},
+                                {"cobblestone", 30},
+                                {"clay", 30},
+                                {"earth", 20},
+                                {"stone", 20},
+                                {"rocky", 20},
+                                {"sand", 20},
+                                {"mud", 10},
+                                {nullptr, 0}};
+
+const Entry TRACKTYPE_SPEEDS[] = {
+    {"grade1", 60}, {"grade2", 40}, {"grade3", 30}, {"grade4", 25}, {"grade5", 20}, {nullptr, 0}};
+
+const Entry SMOOTHNESS_SPEEDS[] = {{"intermediate", 80},
+                                   {"bad", 40},
+                                   {"very_bad", 20},
+                                   {"horrible", 10},
+                                   {"very_horrible", 5},
+                                   {"impassable", 0},
+                                   {nullptr, 0}};
+
+const Entry MAXSPEED_TABLE_DEFAULT[] = {
+    {"urban", 50}, {"rural", 90}, {"trunk", 110}, {"motorway", 130}, {nullptr, 0}};
+
+const Entry MAXSPEED_TABLE[] = {{"ch:rural", 80},
+                                {"ch:trunk", 100},
+                                {"ch:motorway", 120},
+                                {"de:living_street", 7},
+                                {"ru:living_street", 20},
+                                {"ru:urban", 60},
+                                {"ua:urban", 60},
+                                {"at:rural", 100},
+                                {"de:rural", 100},
+                                {"at:trunk", 100},
+                                {"cz:trunk", 0},
+                                {"ro:trunk", 100},
+                                {"cz:motorway", 0},
+                                {"de:motorway", 0},
+                                {"ru:motorway", 110},
+                                {"gb:nsl_single", (60 * 1609) / 1000.},
+                                {"gb:nsl_dual", (70 * 1609) / 1000.},
+                                {"gb:motorway", (70 * 1609) / 1000.},
+                                {"uk:nsl_single", (60 * 1609) / 1000.},
+                                {"uk:nsl_dual", (70 * 1609) / 1000.},
+                                {"uk:motorway", (70 * 1609) / 1000.},
+                                {"nl:rural", 80},
+                                {"nl:trunk", 100},
+                                {"none", 140},
+                                {nullptr, 0}};
+
+const std::pair<const char *, std::uint8_t> HIGHWAY_CLASSES[] = {
+    {"motorway", OSRM_ROAD_PRIORITY_MOTORWAY},
+    {"motorway_link", OSRM_ROAD_PRIORITY_LINK_ROAD},
+    {"trunk", OSRM_ROAD_PRIORITY_TRUNK},
+    {"trunk_link", OSRM_ROAD_PRIORITY_LINK_ROAD},
+    {"primary", OSRM_ROAD_PRIORITY_PRIMARY},
+    {"primary_link", OSRM_ROAD_PRIORITY_LINK_ROAD},
+    {"secondary", OSRM_ROAD_PRIORITY_SECONDARY},
+    {"secondary_link", OSRM_ROAD_PRIORITY_LINK_ROAD},
+    {"tertiary", OSRM_ROAD_PRIORITY_TERTIARY},
+    {"tertiary_link", OSRM_ROAD_PRIORITY_LINK_ROAD},
+    {"unclassified", OSRM_ROAD_PRIORITY_SIDE_RESIDENTIAL},
+    {"residential", OSRM_ROAD_PRIORITY_SIDE_RESIDENTIAL},
+    {"service", OSRM_ROAD_PRIORITY_CONNECTIVITY},
+    {"living_street", OSRM_ROAD_PRIORITY_MAIN_RESIDENTIAL},
+    {"track", OSRM_ROAD_PRIORITY_BIKE_PATH},
+    {"path", OSRM_ROAD_PRIORITY_BIKE_PATH},
+    {"footway", OSRM_ROAD_PRIORITY_FOOT_PATH},
+    {"pedestrian", OSRM_ROAD_PRIORITY_FOOT_PATH},
+    {"steps", OSRM_ROAD_PRIORITY_FOOT_PATH},
+    {nullptr, 0}};
+
+bool equals(const char *lhs, const char *rhs)
+{
+    return lhs && rhs && std::strcmp(lhs, rhs) == 0;
+}
+
+bool contains(const char *const *set, const char *value)
+{
+    if (!value)
+        return false;
+    for (; *set; ++set)
+    {
+        if (std::strcmp(*set, value) == 0)
+            return true;
+    }
+    return false;
+}
+
+template <typename EntryT> const EntryT *find(const EntryT *table, const char *key)
+{
+    if (!key)
+        return nullptr;
+    for (; table->first; ++table)
+    {
+        if (std::strcmp(table->first, key) == 0)
+            return table;
+    }
+    return nullptr;
+}
+
+// like tonumber in Lua: the whole string has to be a number
+bool toNumber(const char *value, double &number)
+{
+    if (!value || !*value)
+        return false;
+    char *end = nullptr;
+    number = std::strtod(value, &end);
+    while (std::isspace(static_cast<unsigned char>(*end)))
+        ++end;
+    return end != value && *end == '\0';
+}
+
+// like tonumber(value:match("%d*")): the leading digits of a string
+bool leadingNumber(const char *value, double &number)
+{
+    if (!value || !std::isdigit(static_cast<unsigned char>(*value)))
+        return false;
+    number = 0;
+    for (; std::isdigit(static_cast<unsigned char>(*value)); ++value)
+        number = number * 10 + (*value - '0');
+    return true;
+}
+
+class Tags
+{
+  public:
+    Tags(const osrm_tag *tags, const std::uint32_t num_tags) : begin(tags), end(tags + num_tags) {}
+
+    const char *Get(const char *key) const
+    {
+        const auto tag = std::find_if(
+            begin, end, [key](const osrm_tag &tag) { return std::strcmp(tag.key, key) == 0; });
+        return tag == end ? nullptr : tag->value;
+    }
+
+    const char *Get(const std::string &key) const { return Get(key.c_str()); }
+
+    // forward and backward value of a key, e.g. maxspeed:forward or maxspeed
+    std::pair<const char *, const char *> GetForwardBackward(const std::string &key) const
+    {
+        const auto forward = Get(key + ":forward");
+        const auto backward = Get(key + ":backward");
+        if (forward && backward)
+            return {forward, backward};
+
+        const auto common = Get(key);
+        return {forward ? forward : common, backward ? backward : common};
+    }
+
+    // forward and backward values of the first keys of a sequence that are set
+    std::pair<const char *, const char *> GetForwardBackward(const char *const *keys) const
+    {
+        const char *forward = nullptr;
+        const char *backward = nullptr;
+        for (; *keys; ++keys)
+        {
+            const std::string key = *keys;
+            if (!forward)
+                forward = Get(key + ":forward");
+            if (!backward)
+                backward = Get(key + ":backward");
+            if (!forward || !backward)
+            {
+                const auto common = Get(key);
+                forward = forward ? forward : common;
+                backward = backward ? backward : common;
+            }
+            if (forward && backward)
+                break;
+        }
+        return {forward, backward};
+    }
+
+  private:
+    const osrm_tag *begin;
+    const osrm_tag *end;
+};
+
+struct Context
+{
+    explicit Context(const osrm_profile_properties &properties)
+        : properties(properties),
+          routability(std::strcmp(properties.weight_name, "routability") == 0),
+          distance(std::strcmp(properties.weight_name, "distance") == 0),
+          turn_bias(properties.left_hand_driving ? 1 / 1.075 : 1.075)
+    {
+    }
+
+    // strings of a result stay valid until the next batch
+    const char *Store(std::string value)
+    {
+        strings.push_back(std::move(value));
+        return strings.back().c_str();
+    }
+
+    const osrm_profile_properties properties;
+    const bool routability;
+    const bool distance;
+    const double turn_bias;
+    std::deque<std::string> strings;
+};
+
+// intermediate values of the way handlers
+struct WayData
+{
+    const char *highway;
+    const char *bridge;
+    const char *route;
+    const char *oneway = nullptr;
+    const char *forward_access = nullptr;
+    const char *backward_access = nullptr;
+    bool is_forward_oneway = false;
+    bool is_reverse_oneway = false;
+};
+
+void processNode(osrm_node &node)
+{
+    const Tags tags(node.tags, node.num_tags);
+
+    const char *access = nullptr;
+    for (auto key = ACCESS_TAGS_HIERARCHY; *key && !access; ++key)
+        access = tags.Get(*key);
+
+    if (access)
+    {
+        if (contains(ACCESS_TAG_BLACKLIST, access) && !contains(RESTRICTED_ACCESS_TAG_LIST, access))
+            node.barrier = true;
+    }
+    else if (const auto barrier = tags.Get("barrier"))
+    {
+        // make an exception for rising bollard barriers
+        const auto rising_bollard = equals(tags.Get("bollard"), "rising");
+        if (!contains(BARRIER_WHITELIST, barrier) && !rising_bollard)
+            node.barrier = true;
+    }
+
+    if (equals(tags.Get("highway"), "traffic_signals"))
+        node.traffic_lights = true;
+}
+
+bool handleBlockedWays(const Tags &tags, const WayData &data)
+{
+    return !equals(tags.Get("area"), "yes") && !equals(data.highway, "steps") &&
+           !equals(tags.Get("oneway"), "reversible") && !equals(tags.Get("impassable"), "yes") &&
+           !equals(tags.Get("status"), "impassable");
+}
+
+bool handleAccess(const Tags &tags, osrm_way &result, WayData &data)
+{
+    std::tie(data.forward_access, data.backward_access) =
+        tags.GetForwardBackward(ACCESS_TAGS_HIERARCHY);
+
+    // only allow a subset of roads that are marked as restricted
+    if (contains(RESTRICTED_HIGHWAY_WHITELIST, data.highway))
+    {
+        if (contains(RESTRICTED_ACCESS_TAG_LIST, data.forward_access))
+            result.forward_restricted = true;
+        if (contains(RESTRICTED_ACCESS_TAG_LIST, data.backward_access))
+            result.backward_restricted = true;
+    }
+
+    if (contains(ACCESS_TAG_BLACKLIST, data.forward_access) && !result.forward_restricted)
+        result.forward_mode = OSRM_MODE_INACCESSIBLE;
+    if (contains(ACCESS_TAG_BLACKLIST, data.backward_access) && !result.backward_restricted)
+        result.backward_mode = OSRM_MODE_INACCESSIBLE;
+
+    return result.forward_mode != OSRM_MODE_INACCESSIBLE ||
+           result.backward_mode != OSRM_MODE_INACCESSIBLE;
+}
+
+void handleOneway(const Tags &tags, osrm_way &result, WayData &data)
+{
+    const char *oneway = nullptr;
+    for (auto key = RESTRICTIONS; *key && !oneway; ++key)
+        oneway = tags.Get(std::string("oneway:") + *key);
+    if (!oneway)
+        oneway = tags.Get("oneway");
+    data.oneway = oneway;
+
+    if (equals(oneway, "-1"))
+    {
+        data.is_reverse_oneway = true;
+        result.forward_mode = OSRM_MODE_INACCESSIBLE;
+    }
+    else if (equals(oneway, "yes") || equals(oneway, "1") || equals(oneway, "true"))
+    {
+        data.is_forward_oneway = true;
+        result.backward_mode = OSRM_MODE_INACCESSIBLE;
+    }
+    else
+    {
+        const auto junction = tags.Get("junction");
+        if (equals(data.highway, "motorway") || equals(junction, "roundabout") ||
+            equals(junction, "circular"))
+        {
+            if (!equals(oneway, "no"))
+            {
+                // implied oneway
+                data.is_forward_oneway = true;
+                result.backward_mode = OSRM_MODE_INACCESSIBLE;
+            }
+        }
+    }
+}
+
+std::string getDirectionalTag(const Tags &tags, const bool is_forward, const std::string &key)
+{
+    auto value = tags.Get(key + (is_forward ? ":forward" : ":backward"));
+    if (!value)
+        value = tags.Get(key);
+    if (!value)
+        return {};
+
+    std::string result = value;
+    boost::replace_all(result, ";", ", ");
+    return result;
+}
+
+// Assemble destination as: "A59: Düsseldorf, Köln"
+void handleDestinations(const Tags &tags, osrm_way &result, const WayData &data, Context &context)
+{
+    if (!data.is_forward_oneway && !data.is_reverse_oneway)
+        return;
+
+    const auto ref = getDirectionalTag(tags, data.is_forward_oneway, "destination:ref");
+    const auto destination = getDirectionalTag(tags, data.is_forward_oneway, "destination");
+    const auto street = getDirectionalTag(tags, data.is_forward_oneway, "destination:street");
+
+    std::string destinations;
+    if (!ref.empty() && !destination.empty())
+        destinations = ref + ": " + destination;
+    else if (!ref.empty())
+        destinations = ref;
+    else if (!destination.empty())
+        destinations = destination;
+    else
+        destinations = street;
+
+    if (!destinations.empty())
+        result.destinations = context.Store(canonicalizeStringList(destinations, ","));
+}
+
+void setDuration(const Tags &tags, osrm_way &result)
+{
+    const auto duration = tags.Get("duration");
+    if (duration && durationIsValid(duration))
+        result.duration = std::max<double>(parseDuration(duration), 1);
+}
+
+void handleFerries(const Tags &tags, osrm_way &result, const WayData &data)
+{
+    const auto route_speed = find(ROUTE_SPEEDS, data.route);
+    if (route_speed && route_speed->second > 0)
+    {
+        setDuration(tags, result);
+        result.forward_mode = OSRM_MODE_FERRY;
+        result.backward_mode = OSRM_MODE_FERRY;
+        result.forward_speed = route_speed->second;
+        result.backward_speed = route_speed->second;
+    }
+}
+
+void handleMovables(const Tags &tags, osrm_way &result, const WayData &data)
+{
+    const auto bridge_speed = find(BRIDGE_SPEEDS, data.bridge);
+    if (bridge_speed && bridge_speed->second > 0)
+    {
+        result.forward_mode = OSRM_MODE_DRIVING;
+        result.backward_mode = OSRM_MODE_DRIVING;
+        const auto duration = tags.Get("duration");
+        if (duration && durationIsValid(duration))
+        {
+            result.duration = std::max<double>(parseDuration(duration), 1);
+        }
+        else
+        {
+            result.forward_speed = bridge_speed->second;
+            result.backward_speed = bridge_speed->second;
+        }
+    }
+}
+
+bool handleService(const Tags &tags, osrm_way &result)
+{
+    if (contains(SERVICE_TAG_FORBIDDEN, tags.Get("service")))
+    {
+        result.forward_mode = OSRM_MODE_INACCESSIBLE;
+        result.backward_mode = OSRM_MODE_INACCESSIBLE;
+        return false;
+    }
+    return true;
+}
+
+// all lanes restricted to hov vehicles?
+bool hasAllDesignatedHovLanes(const char *lanes)
+{
+    if (!lanes)
+        return false;
+
+    const char *lane = lanes;
+    while (true)
+    {
+        const auto separator = std::strchr(lane, '|');
+        const auto length =
+            separator ? static_cast<std::size_t>(separator - lane) : std::strlen(lane);
+        if (length != std::strlen("designated") || std::strncmp(lane, "designated", length) != 0)
+            return false;
+        if (!separator)
+            return true;
+        lane = separator + 1;
+    }
+}
+
+void handleHov(const Tags &tags, osrm_way &result, const Context &context)
+{
+    if (equals(tags.Get("hov"), "designated"))
+    {
+        result.forward_restricted = true;
+        result.backward_restricted = true;
+    }
+
+    const auto hov_lanes = tags.GetForwardBackward(std::string("hov:lanes"));
+    const auto all_hov_forward = hasAllDesignatedHovLanes(hov_lanes.first);
+    const auto all_hov_backward = hasAllDesignatedHovLanes(hov_lanes.second);
+
+    // in this case we will use turn penalties instead of filtering out
+    if (context.routability)
+    {
+        if (all_hov_forward)
+            result.forward_restricted = true;
+        if (all_hov_backward)
+            result.backward_restricted = true;
+        return;
+    }
+
+    // filter out ways where all lanes are hov only
+    if (all_hov_forward)
+        result.forward_mode = OSRM_MODE_INACCESSIBLE;
+    if (all_hov_backward)
+        result.backward_mode = OSRM_MODE_INACCESSIBLE;
+}
+
+// speed of one direction without a speed for the highway type
+void setAccessSpeed(const char *access,
+                    const char *opposite_access,
+                    double &speed,
+                    std::uint8_t &mode)
+{
+    if (contains(ACCESS_TAG_WHITELIST, access))
+        speed = DEFAULT_SPEED;
+    else if (access && !contains(ACCESS_TAG_BLACKLIST, access))
+        // fallback to the avg speed if access tag is not blacklisted
+        speed = DEFAULT_SPEED;
+    else if (!access && opposite_access)
+        mode = OSRM_MODE_INACCESSIBLE;
+}
+
+bool handleSpeed(osrm_way &result, const WayData &data)
+{
+    // abort if already set, eg. by a route
+    if (result.forward_speed != -1)
+        return true;
+
+    if (const auto speed = find(HIGHWAY_SPEEDS, data.highway))
+    {
+        result.forward_speed = speed->second;
+        result.backward_speed = speed->second;
+    }
+    else
+    {
+        setAccessSpeed(
+            data.forward_access, data.backward_access, result.forward_speed, result.forward_mode);
+        setAccessSpeed(data.backward_access,
+                       data.forward_access,
+                       result.backward_speed,
+                       result.backward_mode);
+    }
+
+    return result.forward_speed != -1 || result.backward_speed != -1 || result.duration > 0;
+}
+
+// reduce speed on bad surfaces
+void handleSurface(const Tags &tags, osrm_way &result)
+{
+    const auto limit = [&result](const Entry *speed) {
+        if (speed)
+        {
+            result.forward_speed = std::min(speed->second, result.forward_speed);
+            result.backward_speed = std::min(speed->second, result.backward_speed);
+        }
+    };
+    limit(find(SURFACE_SPEEDS, tags.Get("surface")));
+    limit(find(TRACKTYPE_SPEEDS, tags.Get("tracktype")));
+    limit(find(SMOOTHNESS_SPEEDS, tags.Get("smoothness")));
+}
+
+double parseMaxspeed(const char *source)
+{
+    if (!source)
+        return 0;
+
+    double speed;
+    if (leadingNumber(source, speed))
+    {
+        if (std::strstr(source, "mph") || std::strstr(source, "mp/h"))
+            speed = (speed * 1609) / 1000;
+        return speed;
+    }
+
+    // parse maxspeed like FR:urban
+    std::string lower = source;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](const unsigned char c) {
+        return std::tolower(c);
+    });
+    if (const auto entry = find(MAXSPEED_TABLE, lower.c_str()))
+        return entry->second;
+
+    // the letters after the first "%a%a:"
+    for (std::size_t index = 0; index + 3 < lower.size(); ++index)
+    {
+        if (std::isalpha(static_cast<unsigned char>(lower[index])) &&
+            std::isalpha(static_cast<unsigned char>(lower[index + 1])) && lower[index + 2] == ':' &&
+            std::isalpha(static_cast<unsigned char>(lower[index + 3])))
+        {
+            auto end = index + 3;
+            while (end < lower.size() && std::isalpha(static_cast<unsigned char>(lower[end])))
+                ++end;
+            const auto highway_type = lower.substr(index + 3, end - index - 3);
+            const auto entry = find(MAXSPEED_TABLE_DEFAULT, highway_type.c_str());
+            return entry ? entry->second : 0;
+        }
+    }
+    return 0;
+}
+
+// maxspeed and advisory maxspeed
+void handleMaxspeed(const Tags &tags, osrm_way &result)
+{
+    static const char *const keys[] = {"maxspeed:advisory", "maxspeed", nullptr};
+    const auto maxspeed = tags.GetForwardBackward(keys);
+    const auto forward = parseMaxspeed(maxspeed.first);
+    const auto backward = parseMaxspeed(maxspeed.second);
+
+    if (forward > 0)
+        result.forward_speed = forward * SPEED_REDUCTION;
+    if (backward > 0)
+        result.backward_speed = backward * SPEED_REDUCTION;
+}
+
+// scale speeds to get better average driving times
+void handlePenalties(const Tags &tags,
+                     osrm_way &result,
+                     const WayData &data,
+                     const Context &context)
+{
+    double service_penalty = 1.0;
+    if (const auto penalty = find(SERVICE_PENALTIES, tags.Get("service")))
+        service_penalty = penalty->second;
+
+    double width = std::numeric_limits<double>::infinity();
+    double lanes = std::numeric_limits<double>::infinity();
+    leadingNumber(tags.Get("width"), width);
+    leadingNumber(tags.Get("lanes"), lanes);
+
+    const auto is_bidirectional = result.forward_mode != OSRM_MODE_INACCESSIBLE &&
+                                  result.backward_mode != OSRM_MODE_INACCESSIBLE;
+
+    double width_penalty = 1.0;
+    if (width <= 3 || (lanes <= 1 && is_bidirectional))
+        width_penalty = 0.5;
+
+    // Handle high frequency reversible oneways (think traffic signal controlled, changing
+    // direction every 15 minutes). Scaling speed to take average waiting time into account plus
+    // some more for start / stop.
+    double alternating_penalty = 1.0;
+    if (equals(data.oneway, "alternating"))
+        alternating_penalty = 0.4;
+
+    double sideroad_penalty = 1.0;
+    const auto sideroad = tags.Get("side_road");
+    if (equals(sideroad, "yes") || equals(sideroad, "rotary"))
+        sideroad_penalty = SIDE_ROAD_MULTIPLIER;
+
+    const auto penalty =
+        std::min({service_penalty, width_penalty, alternating_penalty, sideroad_penalty});
+
+    if (context.routability)
+    {
+        if (result.forward_speed > 0)
+            result.forward_rate = (result.forward_speed * penalty) / 3.6;
+        if (result.backward_speed > 0)
+            result.backward_rate = (result.backward_speed * penalty) / 3.6;
+        if (result.duration > 0)
+            result.weight = result.duration / penalty;
+    }
+}
+
+// trims lane string with regard to supported lanes
+const char *processLanes(const char *turn_lanes,
+                         const char *vehicle_lanes,
+                         const int first_count,
+                         const int second_count,
+                         Context &context)
+{
+    if (!turn_lanes)
+        return nullptr;
+    if (vehicle_lanes)
+        return context.Store(applyAccessTokens(turn_lanes, vehicle_lanes));
+    if (first_count != 0 || second_count != 0)
+        return context.Store(trimLaneString(turn_lanes, first_count, second_count));
+    return turn_lanes;
+}
+
+void handleTurnLanes(const Tags &tags, osrm_way &result, Context &context)
+{
+    const auto psv = tags.GetForwardBackward(std::string("lanes:psv"));
+    double psv_forward = 0;
+    double psv_backward = 0;
+    if (!toNumber(psv.first, psv_forward))
+        psv_forward = 0;
+    if (!toNumber(psv.second, psv_backward))
+        psv_backward = 0;
+
+    const auto turn_lanes = tags.GetForwardBackward(std::string("turn:lanes"));
+    const auto vehicle_lanes = tags.GetForwardBackward(std::string("vehicle:lanes"));
+
+    // backward lanes swap the psv counts
+    if (const auto forward = processLanes(turn_lanes.first,
+                                          vehicle_lanes.first,
+                                          static_cast<int>(psv_backward),
+                                          static_cast<int>(psv_forward),
+                                          context))
+        result.turn_lanes_forward = forward;
+    if (const auto backward = processLanes(turn_lanes.second,
+                                           vehicle_lanes.second,
+                                           static_cast<int>(psv_forward),
+                                           static_cast<int>(psv_backward),
+                                           context))
+        result.turn_lanes_backward = backward;
+}
+
+void handleClassification(const Tags &tags, osrm_way &result, const WayData &data)
+{
+    if (contains(MOTORWAY_TYPES, data.highway))
+        result.motorway_class = true;
+    if (contains(LINK_TYPES, data.highway))
+        result.link_class = true;
+
+    const auto highway_class = find(HIGHWAY_CLASSES, data.highway);
+    result.road_priority_class =
+        highway_class ? highway_class->second : OSRM_ROAD_PRIORITY_CONNECTIVITY;
+    result.may_be_ignored = !contains(ROAD_TYPES, data.highway);
+
+    double lanes = 0;
+    if (const auto lane_count = tags.Get("lanes"))
+    {
+        if (toNumber(lane_count, lanes))
+            result.num_lanes = static_cast<std::uint8_t>(lanes);
+    }
+    else
+    {
+        double forward = 0;
+        double backward = 0;
+        if (!toNumber(tags.Get("lanes:forward"), forward))
+            forward = 0;
+        if (!toNumber(tags.Get("lanes:backward"), backward))
+            backward = 0;
+        if (forward + backward != 0)
+            result.num_lanes = static_cast<std::uint8_t>(forward + backward);
+    }
+}
+
+void handleRoundabouts(const Tags &tags, osrm_way &result)
+{
+    const auto junction = tags.Get("junction");
+    if (equals(junction, "roundabout"))
+        result.roundabout = true;
+
+    // See Issue 3361: roundabout-shaped not following roundabout rules.
+    if (equals(junction, "circular"))
+        result.circular = true;
+}
+
+void handleNames(const Tags &tags, osrm_way &result, Context &context)
+{
+    if (const auto name = tags.Get("name"))
+        result.name = name;
+    if (const auto ref = tags.Get("ref"))
+        result.ref = context.Store(canonicalizeStringList(ref, ";"));
+    if (const auto pronunciation = tags.Get("name:pronunciation"))
+        result.pronunciation = pronunciation;
+}
+
+void handleWeights(osrm_way &result, const Context &context)
+{
+    if (!context.distance)
+        return;
+
+    // set weight rates to 1 for the distance weight, edge weights are distance / rate
+    result.weight = -1;
+    if (result.forward_mode != OSRM_MODE_INACCESSIBLE && result.forward_speed > 0)
+        result.forward_rate = 1;
+    if (result.backward_mode != OSRM_MODE_INACCESSIBLE && result.backward_speed > 0)
+        result.backward_rate = 1;
+}
+
+// the handlers of car.lua in the same order, aborting where a Lua handler returns false
+void processWay(osrm_way &result, Context &context)
+{
+    const Tags tags(result.tags, result.num_tags);
+
+    WayData data;
+    data.highway = tags.Get("highway");
+    data.bridge = tags.Get("bridge");
+    data.route = tags.Get("route");
+
+    // perform an quick initial check and abort if the way is obviously not routable
+    if (!data.highway && !data.route)
+        return;
+
+    result.forward_mode = OSRM_MODE_DRIVING;
+    result.backward_mode = OSRM_MODE_DRIVING;
+
+    if (!handleBlockedWays(tags, data) || !handleAccess(tags, result, data))
+        return;
+
+    handleOneway(tags, result, data);
+    handleDestinations(tags, result, data, context);
+    handleFerries(tags, result, data);
+    handleMovables(tags, result, data);
+
+    if (!handleService(tags, result))
+        return;
+
+    handleHov(tags, result, context);
+
+    if (!handleSpeed(result, data))
+        return;
+
+    handleSurface(tags, result);
+    handleMaxspeed(tags, result);
+    handlePenalties(tags, result, data, context);
+    handleTurnLanes(tags, result, context);
+    handleClassification(tags, result, data);
+    handleRoundabouts(tags, result);
+
+    result.is_startpoint =
+        result.forward_mode == OSRM_MODE_DRIVING || result.backward_mode == OSRM_MODE_DRIVING;
+
+    handleNames(tags, result, context);
+    handleWeights(result, context);
+}
+
+// Use a sigmoid function to return a penalty that maxes out at turn_penalty over the space of
+// 0-180 degrees. Values here were chosen by fitting the function to some turn penalty samples
+// from real driving.
+void processTurn(osrm_turn &turn, const Context &context)
+{
+    const auto turn_bias = context.turn_bias;
+
+    if (turn.has_traffic_light)
+        turn.duration = TRAFFIC_LIGHT_PENALTY;
+
+    if (turn.turn_type != OSRM_TURN_TYPE_NO_TURN)
+    {
+        if (turn.angle >= 0)
+            turn.duration += TURN_PENALTY / (1 + std::exp(-((13 / turn_bias) * turn.angle / 180 -
+                                                            6.5 * turn_bias)));
+        else
+            turn.duration += TURN_PENALTY / (1 + std::exp(-((13 * turn_bias) * -turn.angle / 180 -
+                                                            6.5 / turn_bias)));
+
+        if (turn.direction_modifier == OSRM_DIRECTION_MODIFIER_U_TURN)
+            turn.duration += U_TURN_PENALTY;
+
+        // for distance based routing we don't want to have penalties based on turn angle
+        turn.weight = context.distance ? 0 : turn.duration;
+    }
+
+    // penalize turns from non-local access only segments onto local access only tags
+    if (context.routability && !turn.source_restricted && turn.target_restricted)
+        turn.weight = context.properties.max_turn_weight;
+}
+}
+
+extern "C" {
+
+OSRM_PROFILE_EXPORT int osrm_profile_api_version(void) { return OSRM_NATIVE_PROFILE_API_VERSION; }
+
+OSRM_PROFILE_EXPORT void osrm_profile_setup(osrm_profile_properties *properties)
+{
+    properties->max_speed_for_map_matching = 180 / 3.6;
+    properties->use_turn_restrictions = true;
+    properties->continue_straight_at_waypoint = true;
+    properties->left_hand_driving = false;
+    // for routing based on duration, but weighted for preferring certain roads
+    std::strcpy(properties->weight_name, "routability");
+    properties->call_tagless_node_function = false;
+}
+
+OSRM_PROFILE_EXPORT void *osrm_profile_create_context(const osrm_profile_properties *properties)
+{
+    return new Context(*properties);
+}
+
+OSRM_PROFILE_EXPORT void osrm_profile_destroy_context(void *context)
+{
+    delete static_cast<Context *>(context);
+}
+
+OSRM_PROFILE_EXPORT void osrm_profile_process_nodes(void *, osrm_node *nodes, size_t count)
+{
+    std::for_each(nodes, nodes + count, processNode);
+}
+
+OSRM_PROFILE_EXPORT void osrm_profile_process_ways(void *context, osrm_way *ways, size_t count)
+{
+    auto &car_context = *static_cast<Context *>(context);
+    car_context.strings.clear();
+    std::for_each(ways, ways + count, [&](osrm_way &way) { processWay(way, car_context); });
+}
+
+OSRM_PROFILE_EXPORT void osrm_profile_process_turns(void *context, osrm_turn *turns, size_t count)
+{
+    const auto &car_context = *static_cast<const Context *>(context);
+    std::for_each(turns, turns + count, [&](osrm_turn &turn) { processTurn(turn, car_context); });
+}
+
+OSRM_PROFILE_EXPORT const char *const *osrm_profile_name_suffixes(void) { return SUFFIX_LIST; }
+
+OSRM_PROFILE_EXPORT const char *const *osrm_profile_restrictions(void) { return RESTRICTIONS; }
+}
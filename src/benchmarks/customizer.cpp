@@ -0,0 +1,119 @@
+#include "customizer/cell_customizer.hpp"
+#include "partition/cell_storage.hpp"
+#include "partition/multi_level_graph.hpp"
+#include "partition/multi_level_partition.hpp"
+#include "util/integer_range.hpp"
+#include "util/log.hpp"
+#include "util/timing_util.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace osrm;
+
+namespace
+{
+const constexpr std::uint32_t GRID_SIZE = 192;
+
+struct EdgeData
+{
+    EdgeWeight weight;
+    bool forward;
+    bool backward;
+};
+using Graph = partition::MultiLevelGraph<EdgeData, storage::Ownership::Container>;
+
+// Grid with one level of square cells of the given size and a top level cell
+partition::MultiLevelPartition makePartition(const std::uint32_t cell_size)
+{
+    std::vector<CellID> l1(GRID_SIZE * GRID_SIZE);
+    std::vector<CellID> l2(GRID_SIZE * GRID_SIZE, 0);
+    const auto cells_per_row = GRID_SIZE / cell_size;
+    for (auto y : util::irange(0u, GRID_SIZE))
+    {
+        for (auto x : util::irange(0u, GRID_SIZE))
+        {
+            l1[y * GRID_SIZE + x] = y / cell_size * cells_per_row + x / cell_size;
+        }
+    }
+    return partition::MultiLevelPartition({l1, l2}, {cells_per_row * cells_per_row, 1});
+}
+
+Graph makeGraph(const partition::MultiLevelPartition &mlp)
+{
+    using Edge = util::static_graph_details::SortableEdgeWithData<EdgeData>;
+    std::mt19937 generator(1337);
+    std::uniform_int_distribution<EdgeWeight> weight(10, 100);
+
+    std::vector<Edge> edges;
+    const auto add_edge = [&](const NodeID from, const NodeID to) {
+        const auto forward_weight = weight(generator);
+        const auto backward_weight = weight(generator);
+        edges.push_back(Edge{from, to, forward_weight, true, false});
+        edges.push_back(Edge{to, from, forward_weight, false, true});
+        edges.push_back(Edge{to, from, backward_weight, true, false});
+        edges.push_back(Edge{from, to, backward_weight, false, true});
+    };
+    for (auto y : util::irange(0u, GRID_SIZE))
+    {
+        for (auto x : util::irange(0u, GRID_SIZE))
+        {
+            if (x + 1 < GRID_SIZE)
+                add_edge(y * GRID_SIZE + x, y * GRID_SIZE + x + 1);
+            if (y + 1 < GRID_SIZE)
+                add_edge(y * GRID_SIZE + x, (y + 1) * GRID_SIZE + x);
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+    return Graph(mlp, GRID_SIZE * GRID_SIZE, edges);
+}
+}
+
+int main(int, char **)
+{
+    util::LogPolicy::GetInstance().Unmute();
+
+    for (const std::uint32_t cell_size : {4, 6, 8, 12, 16})
+    {
+        const auto mlp = makePartition(cell_size);
+        const auto graph = makeGraph(mlp);
+        const auto num_cells = mlp.GetNumberOfCells(1);
+
+        customizer::CellCustomizer customizer(mlp);
+        customizer::CellCustomizer::Heap heap(graph.GetNumberOfNodes());
+        customizer::CellCustomizer::DenseCell dense;
+
+        partition::CellStorage dijkstra_storage(mlp, graph);
+        TIMER_START(dijkstra);
+        for (auto id : util::irange<CellID>(0, num_cells))
+        {
+            customizer.Customize(graph, heap, dijkstra_storage, 1, id);
+        }
+        TIMER_STOP(dijkstra);
+
+        partition::CellStorage dense_storage(mlp, graph);
+        std::size_t dense_cells = 0;
+        TIMER_START(dense);
+        for (auto id : util::irange<CellID>(0, num_cells))
+        {
+            dense_cells += customizer.CustomizeDense(
+                graph, dense, dense_storage, id, cell_size * cell_size);
+        }
+        TIMER_STOP(dense);
+
+        if (dense_cells != num_cells)
+        {
+            util::Log(logERROR) << "Dense kernel failed for " << (num_cells - dense_cells)
+                                << " cells";
+            return EXIT_FAILURE;
+        }
+
+        util::Log() << cell_size * cell_size << " nodes per cell: Dijkstra "
+                    << TIMER_MSEC(dijkstra) / num_cells * 1000 << " us, dense "
+                    << TIMER_MSEC(dense) / num_cells * 1000 << " us per cell. "
+                    << TIMER_MSEC(dense) / TIMER_MSEC(dijkstra);
+    }
+
+    return EXIT_SUCCESS;
+}
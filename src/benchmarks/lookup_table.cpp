@@ -0,0 +1,88 @@
+#include "updater/source.hpp"
+#include "util/log.hpp"
+#include "util/timing_util.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace osrm;
+
+#ifdef _WIN32
+#pragma optimize("", off)
+template <class T> void dont_optimize_away(T &&datum) { T local = datum; }
+#pragma optimize("", on)
+#else
+template <class T> void dont_optimize_away(T &&datum) { asm volatile("" : "+r"(datum)); }
+#endif
+
+// Looks up both directions of every segment like updateSegmentData does
+template <typename Table>
+double measure_lookups(const Table &table, const std::vector<updater::Segment> &segments)
+{
+    TIMER_START(lookup);
+    std::size_t hits = 0;
+    for (const auto &segment : segments)
+    {
+        if (auto value = table({segment.from, segment.to}))
+            hits += value->speed;
+        if (auto value = table({segment.to, segment.from}))
+            hits += value->speed;
+    }
+    dont_optimize_away(hits);
+    TIMER_STOP(lookup);
+    return TIMER_MSEC(lookup);
+}
+
+int main(int, char **)
+{
+    util::LogPolicy::GetInstance().Unmute();
+
+    // A dense city: ways of ten nodes with recent, widely spread OSM node ids
+    const constexpr std::size_t NUM_WAYS = 1000000;
+    const constexpr std::size_t NODES_PER_WAY = 10;
+    std::mt19937_64 generator(1337);
+    std::uniform_int_distribution<std::uint64_t> node_id(1000000000, 5000000000);
+    std::vector<updater::Segment> segments;
+    for (std::size_t way = 0; way < NUM_WAYS; ++way)
+    {
+        auto from = node_id(generator);
+        for (std::size_t node = 1; node < NODES_PER_WAY; ++node)
+        {
+            const auto to = node_id(generator);
+            segments.emplace_back(from, to);
+            from = to;
+        }
+    }
+
+    // The feed has speeds for every second segment in one direction
+    std::vector<std::pair<updater::Segment, updater::SpeedSource>> values;
+    for (std::size_t index = 0; index < segments.size(); index += 2)
+    {
+        updater::SpeedSource source;
+        source.speed = index % 120;
+        source.source = 1;
+        values.emplace_back(segments[index], source);
+    }
+    std::sort(values.begin(), values.end(), [](const auto &lhs, const auto &rhs) {
+        return lhs.first < rhs.first;
+    });
+
+    updater::SegmentLookupTable sorted_table;
+    sorted_table.lookup = values;
+
+    TIMER_START(build);
+    const updater::SegmentLookupTable hashed_table(values);
+    TIMER_STOP(build);
+
+    const auto sorted_ms = measure_lookups(sorted_table, segments);
+    const auto hashed_ms = measure_lookups(hashed_table, segments);
+
+    util::Log() << values.size() << " speeds, " << 2 * segments.size() << " lookups";
+    util::Log() << "binary search: " << sorted_ms << " ms, hash index: " << hashed_ms
+                << " ms (built in " << TIMER_MSEC(build) << " ms). "
+                << sorted_ms / hashed_ms << "x";
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,159 @@
+#include "extractor/extraction_node.hpp"
+#include "extractor/extraction_turn.hpp"
+#include "extractor/extraction_way.hpp"
+#include "extractor/restriction_parser.hpp"
+#include "extractor/scripting_environment_lua.hpp"
+#include "extractor/scripting_environment_native.hpp"
+#include "util/log.hpp"
+#include "util/timing_util.hpp"
+
+#include <osmium/io/any_input.hpp>
+
+#include <tbb/parallel_for.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace osrm;
+
+namespace
+{
+using ResultWays = std::vector<std::pair<const osmium::Way &, extractor::ExtractionWay>>;
+
+// Runs the way and node functions of a profile on all buffers, like the extractor does
+std::vector<ResultWays> processElements(extractor::ScriptingEnvironment &environment,
+                                        const std::vector<osmium::memory::Buffer> &buffers,
+                                        const std::size_t num_ways)
+{
+    auto restrictions = environment.GetRestrictions();
+    const extractor::RestrictionParser restriction_parser(
+        environment.GetProfileProperties().use_turn_restrictions, false, restrictions);
+
+    std::vector<ResultWays> results(buffers.size());
+    TIMER_START(elements);
+    tbb::parallel_for(std::size_t{0}, buffers.size(), [&](const std::size_t index) {
+        std::vector<std::pair<const osmium::Node &, extractor::ExtractionNode>> nodes;
+        std::vector<boost::optional<extractor::InputRestrictionContainer>> restrictions;
+        environment.ProcessElements(
+            buffers[index], restriction_parser, nodes, results[index], restrictions);
+    });
+    TIMER_STOP(elements);
+
+    std::cout << "  elements: " << TIMER_SEC(elements) << "s, "
+              << static_cast<std::uint64_t>(num_ways / TIMER_SEC(elements)) << " ways/sec"
+              << std::endl;
+    return results;
+}
+
+void processTurns(extractor::ScriptingEnvironment &environment)
+{
+    const constexpr std::size_t NUM_TURNS = 1000000;
+    const constexpr std::size_t BATCH_SIZE = 1024;
+
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> angle(0., 360.);
+    std::vector<extractor::ExtractionTurn> turns;
+    for (std::size_t index = 0; index < NUM_TURNS; ++index)
+    {
+        const extractor::guidance::IntersectionViewData view({0, 0., 10.}, true, angle(generator));
+        turns.emplace_back(
+            extractor::guidance::ConnectedRoad{view, {extractor::guidance::TurnType::Turn, {}}, 0},
+            index % 10 == 0);
+    }
+
+    TIMER_START(turns);
+    tbb::parallel_for(std::size_t{0}, NUM_TURNS / BATCH_SIZE, [&](const std::size_t batch) {
+        std::vector<extractor::ExtractionTurn> batch_turns(turns.begin() + batch * BATCH_SIZE,
+                                                           turns.begin() +
+                                                               (batch + 1) * BATCH_SIZE);
+        environment.ProcessTurns(batch_turns);
+    });
+    TIMER_STOP(turns);
+
+    std::cout << "  turns: " << TIMER_SEC(turns) << "s, "
+              << static_cast<std::uint64_t>(NUM_TURNS / TIMER_SEC(turns)) << " turns/sec"
+              << std::endl;
+}
+
+bool sameResult(const extractor::ExtractionWay &lhs, const extractor::ExtractionWay &rhs)
+{
+    const auto same_value = [](const double a, const double b) { return std::abs(a - b) < 1e-6; };
+    return same_value(lhs.forward_speed, rhs.forward_speed) &&
+           same_value(lhs.backward_speed, rhs.backward_speed) &&
+           same_value(lhs.forward_rate, rhs.forward_rate) &&
+           same_value(lhs.backward_rate, rhs.backward_rate) &&
+           same_value(lhs.duration, rhs.duration) && same_value(lhs.weight, rhs.weight) &&
+           lhs.forward_travel_mode == rhs.forward_travel_mode &&
+           lhs.backward_travel_mode == rhs.backward_travel_mode && lhs.name == rhs.name &&
+           lhs.ref == rhs.ref && lhs.destinations == rhs.destinations &&
+           lhs.turn_lanes_forward == rhs.turn_lanes_forward &&
+           lhs.turn_lanes_backward == rhs.turn_lanes_backward &&
+           lhs.road_classification == rhs.road_classification;
+}
+}
+
+int main(int argc, const char *argv[]) try
+{
+    if (argc < 4)
+    {
+        std::cerr << "Usage: " << argv[0] << " data.osm.pbf profile.lua profile.so\n";
+        return EXIT_FAILURE;
+    }
+
+    util::LogPolicy::GetInstance().Mute();
+
+    std::vector<osmium::memory::Buffer> buffers;
+    std::size_t num_ways = 0;
+    {
+        osmium::io::Reader reader(argv[1],
+                                  osmium::osm_entity_bits::node | osmium::osm_entity_bits::way |
+                                      osmium::osm_entity_bits::relation);
+        while (auto buffer = reader.read())
+        {
+            num_ways += std::distance(buffer.select<osmium::Way>().begin(),
+                                      buffer.select<osmium::Way>().end());
+            buffers.push_back(std::move(buffer));
+        }
+    }
+    std::cout << "Read " << buffers.size() << " buffers with " << num_ways << " ways"
+              << std::endl;
+
+    extractor::Sol2ScriptingEnvironment lua_environment(argv[2]);
+    std::cout << "Lua profile " << argv[2] << std::endl;
+    const auto lua_ways = processElements(lua_environment, buffers, num_ways);
+    processTurns(lua_environment);
+
+    extractor::NativeScriptingEnvironment native_environment(argv[3]);
+    std::cout << "Native profile " << argv[3] << std::endl;
+    const auto native_ways = processElements(native_environment, buffers, num_ways);
+    processTurns(native_environment);
+
+    std::size_t differences = 0;
+    for (std::size_t buffer = 0; buffer < buffers.size(); ++buffer)
+    {
+        for (std::size_t way = 0; way < lua_ways[buffer].size(); ++way)
+        {
+            if (!sameResult(lua_ways[buffer][way].second, native_ways[buffer][way].second))
+            {
+                if (differences < 10)
+                {
+                    std::cout << "  way " << lua_ways[buffer][way].first.id()
+                              << " has different results" << std::endl;
+                }
+                ++differences;
+            }
+        }
+    }
+    std::cout << differences << " of " << num_ways << " ways have different results" << std::endl;
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}
@@ -1,5 +1,6 @@
 #include "contractor/contractor.hpp"
 #include "contractor/crc32_processor.hpp"
+#include "contractor/customizable_hierarchy.hpp"
 #include "contractor/files.hpp"
 #include "contractor/graph_contractor.hpp"
 #include "contractor/graph_contractor_adaptors.hpp"
@@ -8,7 +9,11 @@
 #include "extractor/edge_based_graph_factory.hpp"
 #include "extractor/node_based_edge.hpp"
 
+#include "partition/files.hpp"
+#include "partition/multi_level_partition.hpp"
+
 #include "storage/io.hpp"
+#include "storage/manifest.hpp"
 
 #include "updater/updater.hpp"
 
@@ -22,12 +27,15 @@
 #include "util/timing_util.hpp"
 #include "util/typedefs.hpp"
 
+#include <boost/filesystem/operations.hpp>
+
 #include <algorithm>
 #include <bitset>
 #include <cstdint>
 #include <fstream>
 #include <iterator>
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace osrm
@@ -35,6 +43,72 @@ namespace osrm
 namespace contractor
 {
 
+namespace
+{
+// Contract nodes at the border of large cells last, which approximates a nested dissection order
+// and keeps the number of shortcuts of the customizable hierarchy small.
+std::vector<std::uint8_t> getNodePriorities(const ContractorConfig &config,
+                                            const NodeID number_of_nodes,
+                                            const std::vector<extractor::EdgeBasedEdge> &edges)
+{
+    if (!boost::filesystem::exists(config.partition_path))
+    {
+        util::Log(logWARNING) << "No .partition file found, the customizable hierarchy will be "
+                                 "much larger. Run osrm-partition before osrm-contract.";
+        return {};
+    }
+
+    partition::MultiLevelPartition mlp;
+    partition::files::readPartition(config.partition_path, mlp);
+    if (mlp.GetNumberOfNodes() != number_of_nodes)
+    {
+        util::Log(logWARNING) << "The .partition file does not match the graph, ignoring it.";
+        return {};
+    }
+
+    std::vector<std::uint8_t> node_priorities(number_of_nodes, 0);
+    for (const auto &edge : edges)
+    {
+        const auto level = mlp.GetHighestDifferentLevel(edge.source, edge.target);
+        node_priorities[edge.source] = std::max<std::uint8_t>(node_priorities[edge.source], level);
+        node_priorities[edge.target] = std::max<std::uint8_t>(node_priorities[edge.target], level);
+    }
+    return node_priorities;
+}
+
+// The hierarchy only depends on the topology of the edge-based graph, which only changes
+// when osrm-extract or osrm-partition write a new .ebg file.
+CustomizableHierarchy loadOrContractHierarchy(const ContractorConfig &config,
+                                              const NodeID number_of_nodes,
+                                              const std::vector<extractor::EdgeBasedEdge> &edges)
+{
+    const auto &graph_path = config.updater_config.edge_based_graph_path;
+    if (boost::filesystem::exists(config.hierarchy_path) &&
+        boost::filesystem::last_write_time(config.hierarchy_path) >=
+            boost::filesystem::last_write_time(graph_path))
+    {
+        CustomizableHierarchy hierarchy;
+        files::readHierarchy(config.hierarchy_path, hierarchy);
+        if (hierarchy.GetNumberOfNodes() == number_of_nodes)
+        {
+            util::Log() << "Loaded customizable hierarchy from " << config.hierarchy_path;
+            return hierarchy;
+        }
+        util::Log(logWARNING) << "The .cch file does not match the graph, contracting again.";
+    }
+
+    TIMER_START(contraction);
+    CustomizableHierarchy hierarchy(
+        number_of_nodes, edges, getNodePriorities(config, number_of_nodes, edges));
+    files::writeHierarchy(config.hierarchy_path, hierarchy);
+    TIMER_STOP(contraction);
+    util::Log() << "Contracting the customizable hierarchy took " << TIMER_SEC(contraction)
+                << " sec";
+
+    return hierarchy;
+}
+}
+
 int Contractor::Run()
 {
     if (config.core_factor > 1.0 || config.core_factor < 0)
@@ -42,6 +116,11 @@ int Contractor::Run()
         throw util::exception("Core factor must be between 0.0 to 1.0 (inclusive)" + SOURCE_REF);
     }
 
+    if (config.customizable && config.core_factor < 1.0)
+    {
+        throw util::exception("The customizable hierarchy does not support a core" + SOURCE_REF);
+    }
+
     TIMER_START(preparing);
 
     util::Log() << "Reading node weights.";
@@ -71,12 +150,24 @@ int Contractor::Run()
     }
 
     util::DeallocatingVector<QueryEdge> contracted_edge_list;
+    if (config.customizable)
+    {
+        const auto hierarchy =
+            loadOrContractHierarchy(config, max_edge_id + 1, edge_based_edge_list);
+
+        TIMER_START(customization);
+        contracted_edge_list = hierarchy.Customize(edge_based_edge_list, node_weights);
+        TIMER_STOP(customization);
+        util::Log() << "Customizing " << hierarchy.GetNumberOfArcs() << " arcs took "
+                    << TIMER_SEC(customization) << " sec";
+    }
+    else
     { // own scope to not keep the contractor around
         GraphContractor graph_contractor(max_edge_id + 1,
                                          adaptToContractorInput(std::move(edge_based_edge_list)),
                                          std::move(node_levels),
                                          std::move(node_weights));
-        graph_contractor.Run(config.core_factor);
+        graph_contractor.Run(config.core_factor, config.memory_bounded);
 
         contracted_edge_list = graph_contractor.GetEdges<QueryEdge>();
         is_core_node = graph_contractor.GetCoreMarker();
@@ -96,11 +187,17 @@ int Contractor::Run()
     }
 
     files::writeCoreMarker(config.core_output_path, is_core_node);
-    if (!config.use_cached_priority)
+    if (!config.use_cached_priority && !config.customizable)
     {
         files::writeLevels(config.level_output_path, node_levels);
     }
 
+    std::vector<std::string> written_suffixes{".hsgr", ".core"};
+    written_suffixes.insert(written_suffixes.end(),
+                            storage::manifest::UPDATED_FILE_SUFFIXES.begin(),
+                            storage::manifest::UPDATED_FILE_SUFFIXES.end());
+    storage::manifest::updateManifest(config.osrm_input_path, written_suffixes, true);
+
     TIMER_STOP(preparing);
 
     util::Log() << "Preprocessing : " << TIMER_SEC(preparing) << " seconds";
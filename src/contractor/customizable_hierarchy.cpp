@@ -0,0 +1,346 @@
+#include "contractor/customizable_hierarchy.hpp"
+
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+#include "util/integer_range.hpp"
+#include "util/log.hpp"
+
+#include <boost/assert.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <queue>
+#include <string>
+#include <tuple>
+
+namespace osrm
+{
+namespace contractor
+{
+
+namespace
+{
+struct ArcData
+{
+    EdgeWeight weight;
+    EdgeWeight duration;
+    // turn id for original edges, middle node for shortcuts
+    NodeID id;
+    bool shortcut;
+};
+
+const ArcData INVALID_ARC{INVALID_EDGE_WEIGHT, 0, SPECIAL_NODEID, false};
+
+inline void relax(ArcData &arc, const ArcData &candidate)
+{
+    if (candidate.weight < arc.weight)
+        arc = candidate;
+}
+
+inline bool isValid(const ArcData &arc) { return arc.weight != INVALID_EDGE_WEIGHT; }
+
+inline ArcData concatenate(const ArcData &first, const ArcData &second, const NodeID middle)
+{
+    return ArcData{first.weight + second.weight, first.duration + second.duration, middle, true};
+}
+}
+
+CustomizableHierarchy::CustomizableHierarchy(const NodeID number_of_nodes,
+                                             const std::vector<extractor::EdgeBasedEdge> &edges,
+                                             const std::vector<std::uint8_t> &node_priorities)
+{
+    BOOST_ASSERT(node_priorities.empty() || node_priorities.size() == number_of_nodes);
+
+    // undirected graph of the nodes that are not contracted yet
+    std::vector<std::vector<NodeID>> adjacency(number_of_nodes);
+    for (const auto &edge : edges)
+    {
+        if (edge.source == edge.target)
+            continue;
+        adjacency[edge.source].push_back(edge.target);
+        adjacency[edge.target].push_back(edge.source);
+    }
+    tbb::parallel_for(tbb::blocked_range<NodeID>(0, number_of_nodes),
+                      [&](const tbb::blocked_range<NodeID> &range) {
+                          for (auto node = range.begin(), end = range.end(); node != end; ++node)
+                          {
+                              auto &neighbours = adjacency[node];
+                              std::sort(neighbours.begin(), neighbours.end());
+                              neighbours.erase(std::unique(neighbours.begin(), neighbours.end()),
+                                               neighbours.end());
+                          }
+                      });
+
+    // Contract the node with the lowest (priority, degree) next. Degrees change while
+    // contracting, outdated queue entries are skipped.
+    using QueueEntry = std::tuple<std::uint8_t, std::size_t, NodeID>;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+    const auto priority = [&node_priorities](const NodeID node) -> std::uint8_t {
+        return node_priorities.empty() ? 0 : node_priorities[node];
+    };
+    for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+    {
+        queue.emplace(priority(node), adjacency[node].size(), node);
+    }
+
+    // neighbours of a node at the time of its contraction, these all have a higher rank
+    std::vector<std::vector<NodeID>> upward_neighbours(number_of_nodes);
+    node_to_rank.resize(number_of_nodes, SPECIAL_NODEID);
+    rank_to_node.reserve(number_of_nodes);
+    std::vector<NodeID> merged;
+    std::size_t max_degree = 0;
+    while (!queue.empty())
+    {
+        const auto node = std::get<2>(queue.top());
+        const auto degree = std::get<1>(queue.top());
+        queue.pop();
+        if (node_to_rank[node] != SPECIAL_NODEID || degree != adjacency[node].size())
+            continue;
+
+        node_to_rank[node] = rank_to_node.size();
+        rank_to_node.push_back(node);
+        max_degree = std::max(max_degree, degree);
+
+        // without witness searches all neighbours are connected by shortcuts
+        const auto &neighbours = adjacency[node];
+        for (const auto neighbour : neighbours)
+        {
+            auto &neighbour_adjacency = adjacency[neighbour];
+            merged.clear();
+            std::set_union(neighbour_adjacency.begin(),
+                           neighbour_adjacency.end(),
+                           neighbours.begin(),
+                           neighbours.end(),
+                           std::back_inserter(merged));
+            merged.erase(std::remove_if(merged.begin(),
+                                        merged.end(),
+                                        [node, neighbour](const NodeID other) {
+                                            return other == node || other == neighbour;
+                                        }),
+                         merged.end());
+            neighbour_adjacency.swap(merged);
+            queue.emplace(priority(neighbour), neighbour_adjacency.size(), neighbour);
+        }
+
+        upward_neighbours[node] = std::move(adjacency[node]);
+        adjacency[node] = {};
+    }
+    BOOST_ASSERT(rank_to_node.size() == number_of_nodes);
+
+    // arcs in rank space, sorted by tail and head
+    first_arc.reserve(number_of_nodes + 1);
+    for (const auto rank : util::irange<NodeID>(0, number_of_nodes))
+    {
+        first_arc.push_back(arc_head.size());
+        auto &neighbours = upward_neighbours[rank_to_node[rank]];
+        const auto begin = arc_head.size();
+        for (const auto neighbour : neighbours)
+        {
+            arc_tail.push_back(rank);
+            arc_head.push_back(node_to_rank[neighbour]);
+        }
+        std::sort(arc_head.begin() + begin, arc_head.end());
+        neighbours = {};
+    }
+    first_arc.push_back(arc_head.size());
+
+    // every pair of upward arcs (w, u) and (w, v) of a rank w is a lower triangle of (u, v)
+    const auto for_each_triangle = [this](const auto &callback) {
+        for (const auto rank : util::irange<NodeID>(0, rank_to_node.size()))
+        {
+            for (auto first = first_arc[rank]; first < first_arc[rank + 1]; ++first)
+            {
+                for (auto second = first + 1; second < first_arc[rank + 1]; ++second)
+                {
+                    callback(FindArc(arc_head[first], arc_head[second]), first, second);
+                }
+            }
+        }
+    };
+    first_triangle.resize(arc_head.size() + 1, 0);
+    for_each_triangle([this](const ArcID arc, const ArcID, const ArcID) {
+        first_triangle[arc + 1]++;
+    });
+    std::partial_sum(first_triangle.begin(), first_triangle.end(), first_triangle.begin());
+    triangle_first_arc.resize(first_triangle.back());
+    triangle_second_arc.resize(first_triangle.back());
+    std::vector<std::uint64_t> next_triangle(first_triangle.begin(), first_triangle.end() - 1);
+    for_each_triangle([&](const ArcID arc, const ArcID first, const ArcID second) {
+        const auto triangle = next_triangle[arc]++;
+        triangle_first_arc[triangle] = first;
+        triangle_second_arc[triangle] = second;
+    });
+
+    // group ranks by their depth in the elimination tree
+    std::vector<std::uint32_t> depth(number_of_nodes, 0);
+    std::uint32_t max_depth = 0;
+    for (const auto rank : util::irange<NodeID>(0, number_of_nodes))
+    {
+        max_depth = std::max(max_depth, depth[rank]);
+        for (auto arc = first_arc[rank]; arc < first_arc[rank + 1]; ++arc)
+        {
+            depth[arc_head[arc]] = std::max(depth[arc_head[arc]], depth[rank] + 1);
+        }
+    }
+    first_depth_rank.resize(max_depth + 2, 0);
+    for (const auto rank : util::irange<NodeID>(0, number_of_nodes))
+    {
+        first_depth_rank[depth[rank] + 1]++;
+    }
+    std::partial_sum(first_depth_rank.begin(), first_depth_rank.end(), first_depth_rank.begin());
+    depth_ranks.resize(number_of_nodes);
+    std::vector<std::uint32_t> next_depth_rank(first_depth_rank.begin(),
+                                               first_depth_rank.end() - 1);
+    for (const auto rank : util::irange<NodeID>(0, number_of_nodes))
+    {
+        depth_ranks[next_depth_rank[depth[rank]]++] = rank;
+    }
+
+    util::Log() << "Customizable hierarchy with " << arc_head.size() << " arcs, "
+                << triangle_first_arc.size() << " triangles, maximal degree " << max_degree
+                << " and depth " << max_depth;
+}
+
+CustomizableHierarchy::ArcID CustomizableHierarchy::FindArc(const NodeID tail,
+                                                            const NodeID head) const
+{
+    BOOST_ASSERT(tail < head);
+    const auto begin = arc_head.begin() + first_arc[tail];
+    const auto end = arc_head.begin() + first_arc[tail + 1];
+    const auto iter = std::lower_bound(begin, end, head);
+    if (iter == end || *iter != head)
+    {
+        throw util::exception("The customizable hierarchy does not contain the arc " +
+                              std::to_string(tail) + " -> " + std::to_string(head) +
+                              ", it does not match the graph" + SOURCE_REF);
+    }
+    return std::distance(arc_head.begin(), iter);
+}
+
+util::DeallocatingVector<QueryEdge>
+CustomizableHierarchy::Customize(const std::vector<extractor::EdgeBasedEdge> &edges,
+                                 const std::vector<EdgeWeight> &node_weights) const
+{
+    // weights of the arcs from the tail to the head and from the head to the tail
+    std::vector<ArcData> upward(arc_head.size(), INVALID_ARC);
+    std::vector<ArcData> downward(arc_head.size(), INVALID_ARC);
+
+    for (const auto &edge : edges)
+    {
+        if (edge.data.weight == INVALID_EDGE_WEIGHT || edge.source == edge.target)
+            continue;
+
+        const auto source_rank = node_to_rank[edge.source];
+        const auto target_rank = node_to_rank[edge.target];
+        const bool source_is_tail = source_rank < target_rank;
+        const auto arc = source_is_tail ? FindArc(source_rank, target_rank)
+                                        : FindArc(target_rank, source_rank);
+        const ArcData data{
+            std::max(edge.data.weight, 1), edge.data.duration, edge.data.turn_id, false};
+
+        if (edge.data.forward)
+            relax(source_is_tail ? upward[arc] : downward[arc], data);
+        if (edge.data.backward)
+            relax(source_is_tail ? downward[arc] : upward[arc], data);
+    }
+
+    // Lower triangles only consist of arcs of lower ranks, which have a lower depth.
+    for (const auto depth : util::irange<std::size_t>(0, first_depth_rank.size() - 1))
+    {
+        tbb::parallel_for(
+            tbb::blocked_range<std::uint32_t>(first_depth_rank[depth], first_depth_rank[depth + 1]),
+            [&](const tbb::blocked_range<std::uint32_t> &range) {
+                for (auto index = range.begin(), end = range.end(); index != end; ++index)
+                {
+                    const auto rank = depth_ranks[index];
+                    for (auto arc = first_arc[rank]; arc < first_arc[rank + 1]; ++arc)
+                    {
+                        for (auto triangle = first_triangle[arc];
+                             triangle < first_triangle[arc + 1];
+                             ++triangle)
+                        {
+                            const auto to_tail = triangle_first_arc[triangle];
+                            const auto to_head = triangle_second_arc[triangle];
+                            const auto middle = rank_to_node[arc_tail[to_tail]];
+
+                            // tail -> middle -> head
+                            if (isValid(downward[to_tail]) && isValid(upward[to_head]))
+                                relax(upward[arc],
+                                      concatenate(downward[to_tail], upward[to_head], middle));
+
+                            // head -> middle -> tail
+                            if (isValid(downward[to_head]) && isValid(upward[to_tail]))
+                                relax(downward[arc],
+                                      concatenate(downward[to_head], upward[to_tail], middle));
+                        }
+                    }
+                }
+            });
+    }
+
+    // Loops that only use lower nodes need to be explicit shortcuts like in the regular
+    // contraction, but only if they are cheaper than the node itself.
+    std::vector<ArcData> loops(rank_to_node.size(), INVALID_ARC);
+    for (const auto arc : util::irange<ArcID>(0, arc_head.size()))
+    {
+        if (isValid(downward[arc]) && isValid(upward[arc]))
+            relax(loops[arc_head[arc]],
+                  concatenate(downward[arc], upward[arc], rank_to_node[arc_tail[arc]]));
+    }
+
+    util::DeallocatingVector<QueryEdge> query_edges;
+    const auto add_edge = [&query_edges](const NodeID source,
+                                         const NodeID target,
+                                         const ArcData &data,
+                                         const bool forward,
+                                         const bool backward) {
+        QueryEdge edge;
+        edge.source = source;
+        edge.target = target;
+        edge.data.turn_id = data.id;
+        edge.data.shortcut = data.shortcut;
+        edge.data.weight = data.weight;
+        edge.data.duration = data.duration;
+        edge.data.forward = forward;
+        edge.data.backward = backward;
+        query_edges.push_back(edge);
+    };
+
+    for (const auto arc : util::irange<ArcID>(0, arc_head.size()))
+    {
+        const auto source = rank_to_node[arc_tail[arc]];
+        const auto target = rank_to_node[arc_head[arc]];
+        const auto &up = upward[arc];
+        const auto &down = downward[arc];
+        if (isValid(up) && isValid(down) && up.weight == down.weight &&
+            up.duration == down.duration && up.id == down.id && up.shortcut == down.shortcut)
+        {
+            add_edge(source, target, up, true, true);
+            continue;
+        }
+        if (isValid(up))
+            add_edge(source, target, up, true, false);
+        if (isValid(down))
+            add_edge(source, target, down, false, true);
+    }
+
+    for (const auto rank : util::irange<NodeID>(0, rank_to_node.size()))
+    {
+        const auto node = rank_to_node[rank];
+        if (isValid(loops[rank]) &&
+            (node_weights.empty() || loops[rank].weight < node_weights[node]))
+            add_edge(node, node, loops[rank], true, false);
+    }
+
+    tbb::parallel_sort(query_edges.begin(), query_edges.end());
+
+    return query_edges;
+}
+}
+}
@@ -1,5 +1,7 @@
 #include "contractor/graph_contractor.hpp"
 
+#include "util/meminfo.hpp"
+
 namespace osrm
 {
 namespace contractor
@@ -102,6 +104,12 @@ void GraphContractor::FlushDataAndRebuildContractorGraph(
     // Create new priority array
     std::vector<float> new_node_priority(remaining_nodes.size());
     std::vector<EdgeWeight> new_node_weights(remaining_nodes.size());
+    // ids of the current graph are already renumbered if this is not the first flush
+    std::vector<NodeID> previous_orig_node_id_map;
+    previous_orig_node_id_map.swap(orig_node_id_from_new_node_id_map);
+    const auto to_orig_node_id = [&previous_orig_node_id_map](const NodeID node) {
+        return previous_orig_node_id_map.empty() ? node : previous_orig_node_id_map[node];
+    };
     // this map gives the old IDs from the new ones, necessary to get a consistent graph
     // at the end of contraction
     orig_node_id_from_new_node_id_map.resize(remaining_nodes.size());
@@ -122,20 +130,30 @@ void GraphContractor::FlushDataAndRebuildContractorGraph(
     {
         auto &node = remaining_nodes[new_node_id];
         // create renumbering maps in both directions
-        orig_node_id_from_new_node_id_map[new_node_id] = node.id;
+        orig_node_id_from_new_node_id_map[new_node_id] = to_orig_node_id(node.id);
         new_node_id_from_orig_id_map[node.id] = new_node_id;
         node.id = new_node_id;
     }
     // walk over all nodes
+    std::size_t number_of_flushed_edges = 0;
     for (const auto source : util::irange<NodeID>(0UL, contractor_graph->GetNumberOfNodes()))
     {
         for (auto current_edge : contractor_graph->GetAdjacentEdgeRange(source))
         {
             ContractorGraph::EdgeData &data = contractor_graph->GetEdgeData(current_edge);
             const NodeID target = contractor_graph->GetTarget(current_edge);
+            // shortcuts added since the last flush still reference the middle node by its
+            // renumbered id, the external edges and the new graph only use original ids
+            if (!data.is_original_via_node_ID)
+            {
+                data.id = to_orig_node_id(data.id);
+                data.is_original_via_node_ID = true;
+            }
             if (SPECIAL_NODEID == new_node_id_from_orig_id_map[source])
             {
-                external_edge_list.push_back({source, target, data});
+                external_edge_list.push_back(
+                    {to_orig_node_id(source), to_orig_node_id(target), data});
+                ++number_of_flushed_edges;
             }
             else
             {
@@ -144,7 +162,6 @@ void GraphContractor::FlushDataAndRebuildContractorGraph(
                 ContractorEdge new_edge = {new_node_id_from_orig_id_map[source],
                                            new_node_id_from_orig_id_map[target],
                                            data};
-                new_edge.data.is_original_via_node_ID = true;
                 BOOST_ASSERT_MSG(SPECIAL_NODEID != new_node_id_from_orig_id_map[source],
                                  "new source id not resolveable");
                 BOOST_ASSERT_MSG(SPECIAL_NODEID != new_node_id_from_orig_id_map[target],
@@ -166,9 +183,13 @@ void GraphContractor::FlushDataAndRebuildContractorGraph(
     // INFO: MAKE SURE THIS IS THE LAST OPERATION OF THE FLUSH!
     // reinitialize heaps and ThreadData objects with appropriate size
     thread_data_list.number_of_nodes = contractor_graph->GetNumberOfNodes();
+
+    util::Log() << "flushed " << number_of_flushed_edges << " edges, " << remaining_nodes.size()
+                << " nodes and " << contractor_graph->GetNumberOfEdges() << " edges remaining";
+    util::DumpMemoryStats();
 }
 
-void GraphContractor::Run(double core_factor)
+void GraphContractor::Run(double core_factor, bool memory_bounded)
 {
     // for the preperation we can use a big grain size, which is much faster (probably cache)
     const constexpr size_t InitGrainSize = 100000;
@@ -240,8 +261,16 @@ void GraphContractor::Run(double core_factor)
     while (remaining_nodes.size() > 1 &&
            number_of_contracted_nodes < static_cast<NodeID>(number_of_nodes * core_factor))
     {
-        if (!flushed_contractor && (number_of_contracted_nodes >
-                                    static_cast<NodeID>(number_of_nodes * 0.65 * core_factor)))
+        // The memory bounded mode flushes again every time half of the nodes of the current
+        // graph are contracted. This keeps the graph small when the remaining nodes get denser.
+        const bool flush =
+            flushed_contractor
+                ? memory_bounded &&
+                      remaining_nodes.size() < contractor_graph->GetNumberOfNodes() / 2 &&
+                      remaining_nodes.size() > MIN_FLUSH_NODES
+                : number_of_contracted_nodes >
+                      static_cast<NodeID>(number_of_nodes * 0.65 * core_factor);
+        if (flush)
         {
             log << " [flush " << number_of_contracted_nodes << " nodes] ";
 
@@ -7,6 +7,7 @@
 #include "partition/files.hpp"
 #include "partition/multi_level_partition.hpp"
 
+#include "storage/manifest.hpp"
 #include "storage/shared_memory_ownership.hpp"
 
 #include "updater/updater.hpp"
@@ -14,6 +15,12 @@
 #include "util/log.hpp"
 #include "util/timing_util.hpp"
 
+#include <boost/filesystem/operations.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
 namespace osrm
 {
 namespace customizer
@@ -93,6 +100,39 @@ auto LoadAndUpdateEdgeExpandedGraph(const CustomizationConfig &config,
     return edge_based_graph;
 }
 
+// The .osrm.cells file contains the customization of the .osrm.mldgr graph written by the last
+// run. In that case only cells that contain changed edges need to be customized again.
+CellCustomizer::CellMask GetCellsToCustomize(const CustomizationConfig &config,
+                                             const partition::MultiLevelPartition &mlp,
+                                             const CellCustomizer &customizer,
+                                             const MultiLevelEdgeBasedGraph &graph)
+{
+    if (!config.incremental || !boost::filesystem::exists(config.mld_graph_path))
+    {
+        return customizer.MakeCellMask(true);
+    }
+
+    MultiLevelEdgeBasedGraph previous_graph;
+    partition::files::readGraph(config.mld_graph_path, previous_graph);
+    if (previous_graph.GetNumberOfNodes() != graph.GetNumberOfNodes())
+    {
+        util::Log(logWARNING) << "Graph of the last customization does not match, customizing "
+                                 "all cells.";
+        return customizer.MakeCellMask(true);
+    }
+
+    auto cell_mask = customizer.GetChangedCells(graph, previous_graph);
+    for (std::size_t level = 1; level < mlp.GetNumberOfLevels(); ++level)
+    {
+        const auto &level_mask = cell_mask[level - 1];
+        util::Log() << "Level " << level << ": customizing "
+                    << std::count(level_mask.begin(), level_mask.end(), true) << " of "
+                    << level_mask.size() << " cells";
+    }
+
+    return cell_mask;
+}
+
 int Customizer::Run(const CustomizationConfig &config)
 {
     TIMER_START(loading_data);
@@ -109,7 +149,8 @@ int Customizer::Run(const CustomizationConfig &config)
 
     TIMER_START(cell_customize);
     CellCustomizer customizer(mlp);
-    customizer.Customize(*edge_based_graph, storage);
+    const auto cell_mask = GetCellsToCustomize(config, mlp, customizer, *edge_based_graph);
+    customizer.Customize(*edge_based_graph, storage, cell_mask);
     TIMER_STOP(cell_customize);
     util::Log() << "Cells customization took " << TIMER_SEC(cell_customize) << " seconds";
 
@@ -123,6 +164,13 @@ int Customizer::Run(const CustomizationConfig &config)
     TIMER_STOP(writing_graph);
     util::Log() << "Graph writing took " << TIMER_SEC(writing_graph) << " seconds";
 
+    std::vector<std::string> written_suffixes{".cells", ".mldgr"};
+    written_suffixes.insert(written_suffixes.end(),
+                            storage::manifest::UPDATED_FILE_SUFFIXES.begin(),
+                            storage::manifest::UPDATED_FILE_SUFFIXES.end());
+    storage::manifest::updateManifest(
+        config.updater_config.osrm_input_path, written_suffixes, true);
+
     CellStorageStatistics(*edge_based_graph, mlp, storage);
 
     return 0;
@@ -1,5 +1,6 @@
 #include "engine/api/json_factory.hpp"
 
+#include "engine/compact_hint.hpp"
 #include "engine/hint.hpp"
 #include "engine/polyline_compressor.hpp"
 #include "util/integer_range.hpp"
@@ -307,6 +308,14 @@ util::json::Object makeWaypoint(const util::Coordinate location, std::string nam
     return waypoint;
 }
 
+util::json::Object
+makeWaypoint(const util::Coordinate location, std::string name, const CompactHint &hint)
+{
+    auto waypoint = makeWaypoint(location, name);
+    waypoint.values["hint"] = hint.ToBase64();
+    return waypoint;
+}
+
 util::json::Object makeRouteLeg(guidance::RouteLeg leg, util::json::Array steps)
 {
     util::json::Object route_leg;
@@ -0,0 +1,159 @@
+#include "engine/compact_hint.hpp"
+#include "engine/base64.hpp"
+#include "engine/datafacade/datafacade_base.hpp"
+#include "util/coordinate_calculation.hpp"
+
+#include <boost/assert.hpp>
+#include <boost/functional/hash.hpp>
+
+#include <algorithm>
+#include <ostream>
+#include <tuple>
+
+namespace osrm
+{
+namespace engine
+{
+
+namespace
+{
+std::uint32_t getSegmentChecksum(const datafacade::BaseDataFacade &facade,
+                                 const NodeID u,
+                                 const NodeID v)
+{
+    const auto source = facade.GetCoordinateOfNode(u);
+    const auto target = facade.GetCoordinateOfNode(v);
+
+    std::size_t seed = 0;
+    boost::hash_combine(seed, static_cast<std::uint32_t>(u));
+    boost::hash_combine(seed, static_cast<std::uint32_t>(v));
+    boost::hash_combine(seed, static_cast<std::int32_t>(source.lon));
+    boost::hash_combine(seed, static_cast<std::int32_t>(source.lat));
+    boost::hash_combine(seed, static_cast<std::int32_t>(target.lon));
+    boost::hash_combine(seed, static_cast<std::int32_t>(target.lat));
+    return static_cast<std::uint32_t>(seed ^ (static_cast<std::uint64_t>(seed) >> 32));
+}
+
+std::uint16_t getCoordinateFingerprint(const util::Coordinate coordinate)
+{
+    std::size_t seed = 0;
+    boost::hash_combine(seed, static_cast<std::int32_t>(coordinate.lon));
+    boost::hash_combine(seed, static_cast<std::int32_t>(coordinate.lat));
+    const auto folded = static_cast<std::uint64_t>(seed);
+    return static_cast<std::uint16_t>(folded ^ (folded >> 16) ^ (folded >> 32) ^ (folded >> 48));
+}
+}
+
+CompactHint CompactHint::FromPhantomNode(const PhantomNode &phantom,
+                                         const datafacade::BaseDataFacade &facade)
+{
+    const auto geometry_id = facade.GetGeometryIndex(phantom.forward_segment_id.id).id;
+    const auto geometry = facade.GetUncompressedForwardGeometry(geometry_id);
+    BOOST_ASSERT(phantom.fwd_segment_position + 1u < geometry.size());
+    const auto u = geometry[phantom.fwd_segment_position];
+    const auto v = geometry[phantom.fwd_segment_position + 1];
+
+    CompactHint hint;
+    hint.forward_segment_id = phantom.forward_segment_id;
+    hint.reverse_segment_id = phantom.reverse_segment_id;
+    hint.fwd_segment_position = phantom.fwd_segment_position;
+    hint.coordinate_fingerprint = getCoordinateFingerprint(phantom.input_location);
+    hint.segment_checksum = getSegmentChecksum(facade, u, v);
+    return hint;
+}
+
+boost::optional<PhantomNode>
+CompactHint::ToPhantomNode(const util::Coordinate input_coordinate,
+                           const double max_distance,
+                           const datafacade::BaseDataFacade &facade) const
+{
+    // hints are user input, so every id needs to be checked before it is used
+    const auto number_of_nodes = facade.GetNumberOfEdgeBasedNodes();
+    if (!(forward_segment_id.enabled || reverse_segment_id.enabled) ||
+        forward_segment_id.id >= number_of_nodes ||
+        (reverse_segment_id.enabled && reverse_segment_id.id >= number_of_nodes))
+    {
+        return boost::none;
+    }
+
+    const auto geometry_id = facade.GetGeometryIndex(forward_segment_id.id).id;
+    if (reverse_segment_id.enabled &&
+        facade.GetGeometryIndex(reverse_segment_id.id).id != geometry_id)
+    {
+        return boost::none;
+    }
+
+    const auto geometry = facade.GetUncompressedForwardGeometry(geometry_id);
+    if (fwd_segment_position + 1u >= geometry.size())
+    {
+        return boost::none;
+    }
+    const auto u = geometry[fwd_segment_position];
+    const auto v = geometry[fwd_segment_position + 1];
+
+    if (getSegmentChecksum(facade, u, v) != segment_checksum ||
+        getCoordinateFingerprint(input_coordinate) != coordinate_fingerprint)
+    {
+        return boost::none;
+    }
+
+    const auto phantom = facade.NearestPhantomNodeOnSegment(
+        input_coordinate,
+        datafacade::BaseDataFacade::RTreeLeaf{
+            forward_segment_id, reverse_segment_id, u, v, fwd_segment_position});
+
+    // the fingerprint only has 16 bits, a colliding coordinate is usually far from the segment
+    if (util::coordinate_calculation::haversineDistance(input_coordinate, phantom.location) >
+        max_distance)
+    {
+        return boost::none;
+    }
+
+    return phantom;
+}
+
+std::string CompactHint::ToBase64() const
+{
+    auto base64 = encodeBase64Bytewise(*this);
+
+    // Make safe for usage as GET parameter in URLs
+    std::replace(begin(base64), end(base64), '+', '-');
+    std::replace(begin(base64), end(base64), '/', '_');
+
+    return base64;
+}
+
+CompactHint CompactHint::FromBase64(const std::string &base64Hint)
+{
+    BOOST_ASSERT_MSG(base64Hint.size() == ENCODED_COMPACT_HINT_SIZE, "Hint has invalid size");
+
+    auto encoded = base64Hint;
+
+    // Reverses above encoding we need for GET parameters in URL
+    std::replace(begin(encoded), end(encoded), '-', '+');
+    std::replace(begin(encoded), end(encoded), '_', '/');
+
+    return decodeBase64Bytewise<CompactHint>(encoded);
+}
+
+bool operator==(const CompactHint &lhs, const CompactHint &rhs)
+{
+    const auto tie = [](const CompactHint &hint) {
+        return std::make_tuple(static_cast<NodeID>(hint.forward_segment_id.id),
+                               static_cast<bool>(hint.forward_segment_id.enabled),
+                               static_cast<NodeID>(hint.reverse_segment_id.id),
+                               static_cast<bool>(hint.reverse_segment_id.enabled),
+                               hint.fwd_segment_position,
+                               hint.coordinate_fingerprint,
+                               hint.segment_checksum);
+    };
+    return tie(lhs) == tie(rhs);
+}
+
+std::ostream &operator<<(std::ostream &out, const CompactHint &hint)
+{
+    return out << hint.ToBase64();
+}
+
+} // ns engine
+} // ns osrm
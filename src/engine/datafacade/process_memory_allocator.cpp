@@ -25,6 +25,15 @@ ProcessMemoryAllocator::ProcessMemoryAllocator(const storage::StorageConfig &con
 
 ProcessMemoryAllocator::~ProcessMemoryAllocator() {}
 
+std::uint64_t ProcessMemoryAllocator::GetRequiredMemory(const storage::StorageConfig &config)
+{
+    storage::Storage storage(config);
+
+    storage::DataLayout layout;
+    storage.PopulateLayout(layout);
+    return sizeof(storage::DataLayout) + layout.GetSizeOfLayout();
+}
+
 storage::DataLayout &ProcessMemoryAllocator::GetLayout() { return *internal_layout.get(); }
 char *ProcessMemoryAllocator::GetMemory() { return internal_memory.get(); }
 
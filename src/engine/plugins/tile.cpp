@@ -882,6 +882,11 @@ void encodeVectorTile(const datafacade::ContiguousInternalMemoryDataFacadeBase &
 }
 }
 
+TilePlugin::TilePlugin(std::size_t max_cache_size)
+    : cache(max_cache_size > 0 ? std::make_unique<TileCache>(max_cache_size) : nullptr)
+{
+}
+
 Status TilePlugin::HandleRequest(const datafacade::ContiguousInternalMemoryDataFacadeBase &facade,
                                  const RoutingAlgorithmsInterface &algorithms,
                                  const api::TileParameters &parameters,
@@ -889,6 +894,13 @@ Status TilePlugin::HandleRequest(const datafacade::ContiguousInternalMemoryDataF
 {
     BOOST_ASSERT(parameters.IsValid());
 
+    const TileCache::Key cache_key{
+        facade.GetDataVersion(), parameters.z, parameters.x, parameters.y};
+    if (cache && cache->Get(cache_key, pbf_buffer))
+    {
+        return Status::Ok;
+    }
+
     auto edges = getEdges(facade, parameters.x, parameters.y, parameters.z);
 
     auto edge_index = getEdgeIndex(edges);
@@ -905,6 +917,11 @@ Status TilePlugin::HandleRequest(const datafacade::ContiguousInternalMemoryDataF
     encodeVectorTile(
         facade, parameters.x, parameters.y, parameters.z, edges, edge_index, turns, pbf_buffer);
 
+    if (cache)
+    {
+        cache->Put(cache_key, pbf_buffer);
+    }
+
     return Status::Ok;
 }
 }
@@ -4,6 +4,7 @@
 #include "engine/api/trip_parameters.hpp"
 #include "engine/trip/trip_brute_force.hpp"
 #include "engine/trip/trip_farthest_insertion.hpp"
+#include "engine/trip/trip_local_search.hpp"
 #include "engine/trip/trip_nearest_neighbour.hpp"
 #include "util/dist_table_wrapper.hpp" // to access the dist table more easily
 #include "util/json_container.hpp"
@@ -11,6 +12,7 @@
 #include <boost/assert.hpp>
 
 #include <algorithm>
+#include <chrono>
 #include <cstdlib>
 #include <iterator>
 #include <limits>
@@ -222,6 +224,8 @@ Status TripPlugin::HandleRequest(const datafacade::ContiguousInternalMemoryDataF
     }
 
     const constexpr std::size_t BF_MAX_FEASABLE = 10;
+    // farthest insertion is O(n^3), larger trips start from a nearest neighbour tour
+    const constexpr std::size_t FI_MAX_FEASABLE = 100;
     BOOST_ASSERT_MSG(result_table.size() == number_of_locations * number_of_locations,
                      "Distance Table has wrong size");
 
@@ -242,10 +246,19 @@ Status TripPlugin::HandleRequest(const datafacade::ContiguousInternalMemoryDataF
     {
         trip = trip::BruteForceTrip(number_of_locations, result_table);
     }
-    else
+    else if (max_trip_optimization_time <= 0)
     {
         trip = trip::FarthestInsertionTrip(number_of_locations, result_table);
     }
+    else
+    {
+        trip = number_of_locations <= FI_MAX_FEASABLE
+                   ? trip::FarthestInsertionTrip(number_of_locations, result_table)
+                   : trip::NearestNeighbourTour(number_of_locations, result_table);
+        trip = trip::LocalSearchTrip(std::move(trip),
+                                     result_table,
+                                     std::chrono::milliseconds(max_trip_optimization_time));
+    }
 
     // rotate result such that roundtrip starts at node with index 0
     // thist first if covers scenarios: !fixed_end || fixed_start || (fixed_start && fixed_end)
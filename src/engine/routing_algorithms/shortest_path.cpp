@@ -4,6 +4,11 @@
 
 #include <boost/assert.hpp>
 #include <boost/optional.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
 #include <memory>
 
 namespace osrm
@@ -207,6 +212,242 @@ void unpackLegs(const datafacade::ContiguousInternalMemoryDataFacade<Algorithm>
              phantom_nodes_vector[current_leg].target_phantom.forward_segment_id.id));
     }
 }
+
+// searches the shortest paths of one leg that continue the paths to the source nodes
+template <typename Algorithm>
+void searchLeg(SearchEngineData<Algorithm> &engine_working_data,
+               const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+               typename SearchEngineData<Algorithm>::QueryHeap &forward_heap,
+               typename SearchEngineData<Algorithm>::QueryHeap &reverse_heap,
+               const bool allow_uturn_at_waypoint,
+               const bool search_from_forward_node,
+               const bool search_from_reverse_node,
+               const PhantomNode &source_phantom,
+               const PhantomNode &target_phantom,
+               const int total_weight_to_forward,
+               const int total_weight_to_reverse,
+               int &new_total_weight_to_forward,
+               int &new_total_weight_to_reverse,
+               std::vector<NodeID> &packed_leg_to_forward,
+               std::vector<NodeID> &packed_leg_to_reverse)
+{
+    bool search_to_forward_node = target_phantom.IsValidForwardTarget();
+    bool search_to_reverse_node = target_phantom.IsValidReverseTarget();
+
+    BOOST_ASSERT(!search_from_forward_node || source_phantom.IsValidForwardSource());
+    BOOST_ASSERT(!search_from_reverse_node || source_phantom.IsValidReverseSource());
+
+    if (search_to_reverse_node || search_to_forward_node)
+    {
+        if (allow_uturn_at_waypoint)
+        {
+            searchWithUTurn(engine_working_data,
+                            facade,
+                            forward_heap,
+                            reverse_heap,
+                            search_from_forward_node,
+                            search_from_reverse_node,
+                            search_to_forward_node,
+                            search_to_reverse_node,
+                            source_phantom,
+                            target_phantom,
+                            total_weight_to_forward,
+                            total_weight_to_reverse,
+                            new_total_weight_to_forward,
+                            packed_leg_to_forward);
+            // if only the reverse node is valid (e.g. when using the match plugin) we
+            // actually need to move
+            if (!target_phantom.IsValidForwardTarget())
+            {
+                BOOST_ASSERT(target_phantom.IsValidReverseTarget());
+                new_total_weight_to_reverse = new_total_weight_to_forward;
+                packed_leg_to_reverse = std::move(packed_leg_to_forward);
+                new_total_weight_to_forward = INVALID_EDGE_WEIGHT;
+
+                // (*)
+                //
+                //   Below we have to check if new_total_weight_to_forward is invalid.
+                //   This prevents use-after-move on packed_leg_to_forward.
+            }
+            else if (target_phantom.IsValidReverseTarget())
+            {
+                new_total_weight_to_reverse = new_total_weight_to_forward;
+                packed_leg_to_reverse = packed_leg_to_forward;
+            }
+        }
+        else
+        {
+            search(engine_working_data,
+                   facade,
+                   forward_heap,
+                   reverse_heap,
+                   search_from_forward_node,
+                   search_from_reverse_node,
+                   search_to_forward_node,
+                   search_to_reverse_node,
+                   source_phantom,
+                   target_phantom,
+                   total_weight_to_forward,
+                   total_weight_to_reverse,
+                   new_total_weight_to_forward,
+                   new_total_weight_to_reverse,
+                   packed_leg_to_forward,
+                   packed_leg_to_reverse);
+        }
+    }
+}
+
+const static constexpr std::size_t FORWARD_SOURCE = 0;
+const static constexpr std::size_t REVERSE_SOURCE = 1;
+
+// Weights and packed paths of a leg that do not depend on the previous legs. With u-turns all
+// source nodes are searched at once and only the first entry is used, otherwise every source
+// node is searched on its own, so that the paths to the source nodes can be continued later.
+struct LegSearchResult
+{
+    // source nodes of the search with u-turns, which only matches the sequential search if the
+    // previous leg reached the same target nodes
+    bool search_from_forward_node = false;
+    bool search_from_reverse_node = false;
+    int weight_to_forward[2] = {INVALID_EDGE_WEIGHT, INVALID_EDGE_WEIGHT};
+    int weight_to_reverse[2] = {INVALID_EDGE_WEIGHT, INVALID_EDGE_WEIGHT};
+    std::vector<NodeID> packed_leg_to_forward[2];
+    std::vector<NodeID> packed_leg_to_reverse[2];
+};
+
+// Searches all legs up front on at most max_parallel_legs threads. Every task uses the heaps of
+// its thread, so legs do not share heaps.
+template <typename Algorithm>
+std::vector<LegSearchResult>
+searchLegsInParallel(SearchEngineData<Algorithm> &engine_working_data,
+                     const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
+                     const std::vector<PhantomNodes> &phantom_nodes_vector,
+                     const bool allow_uturn_at_waypoint,
+                     const std::size_t max_parallel_legs)
+{
+    std::vector<LegSearchResult> leg_results(phantom_nodes_vector.size());
+
+    // the source nodes only depend on the phantom nodes, they are set before the searches so
+    // that the tasks searching the same leg only write their own results
+    for (const auto leg : util::irange<std::size_t>(0, leg_results.size()))
+    {
+        const auto &source_phantom = phantom_nodes_vector[leg].source_phantom;
+        // the previous leg can only end on valid target nodes
+        leg_results[leg].search_from_forward_node =
+            source_phantom.IsValidForwardSource() &&
+            (leg == 0 || phantom_nodes_vector[leg - 1].target_phantom.IsValidForwardTarget());
+        leg_results[leg].search_from_reverse_node =
+            source_phantom.IsValidReverseSource() &&
+            (leg == 0 || phantom_nodes_vector[leg - 1].target_phantom.IsValidReverseTarget());
+    }
+
+    const std::size_t searches_per_leg = allow_uturn_at_waypoint ? 1 : 2;
+    const auto number_of_searches = leg_results.size() * searches_per_leg;
+    const auto number_of_tasks = std::min(max_parallel_legs, number_of_searches);
+
+    tbb::parallel_for(
+        tbb::blocked_range<std::size_t>(0, number_of_tasks, 1),
+        [&](const tbb::blocked_range<std::size_t> &range) {
+            engine_working_data.InitializeOrClearFirstThreadLocalStorage(
+                facade.GetNumberOfNodes());
+            auto &forward_heap = *engine_working_data.forward_heap_1;
+            auto &reverse_heap = *engine_working_data.reverse_heap_1;
+
+            for (auto task = range.begin(); task != range.end(); ++task)
+            {
+                for (auto search = task; search < number_of_searches; search += number_of_tasks)
+                {
+                    const auto leg = search / searches_per_leg;
+                    const auto source = search % searches_per_leg;
+                    const auto &source_phantom = phantom_nodes_vector[leg].source_phantom;
+                    const auto &target_phantom = phantom_nodes_vector[leg].target_phantom;
+                    auto &result = leg_results[leg];
+
+                    auto search_from_forward_node = result.search_from_forward_node;
+                    auto search_from_reverse_node = result.search_from_reverse_node;
+                    if (!allow_uturn_at_waypoint)
+                    {
+                        search_from_forward_node &= source == FORWARD_SOURCE;
+                        search_from_reverse_node &= source == REVERSE_SOURCE;
+                    }
+                    if (!search_from_forward_node && !search_from_reverse_node)
+                        continue;
+
+                    searchLeg(engine_working_data,
+                              facade,
+                              forward_heap,
+                              reverse_heap,
+                              allow_uturn_at_waypoint,
+                              search_from_forward_node,
+                              search_from_reverse_node,
+                              source_phantom,
+                              target_phantom,
+                              0,
+                              0,
+                              result.weight_to_forward[source],
+                              result.weight_to_reverse[source],
+                              result.packed_leg_to_forward[source],
+                              result.packed_leg_to_reverse[source]);
+                }
+            }
+        });
+
+    return leg_results;
+}
+
+// Continues the paths to the source nodes with a leg that was searched up front, this gives
+// the same weights as searchLeg
+void combineLegResults(const LegSearchResult &result,
+                       const bool allow_uturn_at_waypoint,
+                       const bool search_from_forward_node,
+                       const bool search_from_reverse_node,
+                       const int total_weight_to_forward,
+                       const int total_weight_to_reverse,
+                       int &new_total_weight_to_forward,
+                       int &new_total_weight_to_reverse,
+                       std::vector<NodeID> &packed_leg_to_forward,
+                       std::vector<NodeID> &packed_leg_to_reverse)
+{
+    if (allow_uturn_at_waypoint)
+    {
+        // the search from all source nodes only depends on the previous legs by this offset
+        const auto offset = std::min(total_weight_to_forward, total_weight_to_reverse);
+        if (result.weight_to_forward[0] != INVALID_EDGE_WEIGHT)
+        {
+            new_total_weight_to_forward = result.weight_to_forward[0] + offset;
+            packed_leg_to_forward = result.packed_leg_to_forward[0];
+        }
+        if (result.weight_to_reverse[0] != INVALID_EDGE_WEIGHT)
+        {
+            new_total_weight_to_reverse = result.weight_to_reverse[0] + offset;
+            packed_leg_to_reverse = result.packed_leg_to_reverse[0];
+        }
+        return;
+    }
+
+    for (const auto source : {FORWARD_SOURCE, REVERSE_SOURCE})
+    {
+        const auto search_from_node =
+            source == FORWARD_SOURCE ? search_from_forward_node : search_from_reverse_node;
+        const auto total_weight =
+            source == FORWARD_SOURCE ? total_weight_to_forward : total_weight_to_reverse;
+        if (!search_from_node)
+            continue;
+
+        if (result.weight_to_forward[source] != INVALID_EDGE_WEIGHT &&
+            total_weight + result.weight_to_forward[source] < new_total_weight_to_forward)
+        {
+            new_total_weight_to_forward = total_weight + result.weight_to_forward[source];
+            packed_leg_to_forward = result.packed_leg_to_forward[source];
+        }
+        if (result.weight_to_reverse[source] != INVALID_EDGE_WEIGHT &&
+            total_weight + result.weight_to_reverse[source] < new_total_weight_to_reverse)
+        {
+            new_total_weight_to_reverse = total_weight + result.weight_to_reverse[source];
+            packed_leg_to_reverse = result.packed_leg_to_reverse[source];
+        }
+    }
+}
 }
 
 template <typename Algorithm>
@@ -214,7 +455,8 @@ InternalRouteResult
 shortestPathSearch(SearchEngineData<Algorithm> &engine_working_data,
                    const datafacade::ContiguousInternalMemoryDataFacade<Algorithm> &facade,
                    const std::vector<PhantomNodes> &phantom_nodes_vector,
-                   const boost::optional<bool> continue_straight_at_waypoint)
+                   const boost::optional<bool> continue_straight_at_waypoint,
+                   const std::size_t max_parallel_legs)
 {
     InternalRouteResult raw_route_data;
     raw_route_data.segment_end_coordinates = phantom_nodes_vector;
@@ -242,6 +484,19 @@ shortestPathSearch(SearchEngineData<Algorithm> &engine_working_data,
     std::vector<NodeID> total_packed_path_to_reverse;
     std::vector<std::size_t> packed_leg_to_reverse_begin;
 
+    // The legs only depend on each other by the weights to their source nodes, so they can be
+    // searched up front on several threads. Without u-turns every leg is searched from each
+    // source node on its own, which is twice the work of searching them one after another.
+    std::vector<LegSearchResult> leg_results;
+    if (max_parallel_legs > 1 && phantom_nodes_vector.size() > 1)
+    {
+        leg_results = searchLegsInParallel(engine_working_data,
+                                           facade,
+                                           phantom_nodes_vector,
+                                           allow_uturn_at_waypoint,
+                                           max_parallel_legs);
+    }
+
     std::size_t current_leg = 0;
     // this implements a dynamic program that finds the shortest route through
     // a list of vias
@@ -256,69 +511,39 @@ shortestPathSearch(SearchEngineData<Algorithm> &engine_working_data,
         const auto &source_phantom = phantom_node_pair.source_phantom;
         const auto &target_phantom = phantom_node_pair.target_phantom;
 
-        bool search_to_forward_node = target_phantom.IsValidForwardTarget();
-        bool search_to_reverse_node = target_phantom.IsValidReverseTarget();
-
-        BOOST_ASSERT(!search_from_forward_node || source_phantom.IsValidForwardSource());
-        BOOST_ASSERT(!search_from_reverse_node || source_phantom.IsValidReverseSource());
-
-        if (search_to_reverse_node || search_to_forward_node)
+        if (!leg_results.empty() &&
+            (!allow_uturn_at_waypoint ||
+             (leg_results[current_leg].search_from_forward_node == search_from_forward_node &&
+              leg_results[current_leg].search_from_reverse_node == search_from_reverse_node)))
         {
-            if (allow_uturn_at_waypoint)
-            {
-                searchWithUTurn(engine_working_data,
-                                facade,
-                                forward_heap,
-                                reverse_heap,
-                                search_from_forward_node,
-                                search_from_reverse_node,
-                                search_to_forward_node,
-                                search_to_reverse_node,
-                                source_phantom,
-                                target_phantom,
-                                total_weight_to_forward,
-                                total_weight_to_reverse,
-                                new_total_weight_to_forward,
-                                packed_leg_to_forward);
-                // if only the reverse node is valid (e.g. when using the match plugin) we
-                // actually need to move
-                if (!target_phantom.IsValidForwardTarget())
-                {
-                    BOOST_ASSERT(target_phantom.IsValidReverseTarget());
-                    new_total_weight_to_reverse = new_total_weight_to_forward;
-                    packed_leg_to_reverse = std::move(packed_leg_to_forward);
-                    new_total_weight_to_forward = INVALID_EDGE_WEIGHT;
-
-                    // (*)
-                    //
-                    //   Below we have to check if new_total_weight_to_forward is invalid.
-                    //   This prevents use-after-move on packed_leg_to_forward.
-                }
-                else if (target_phantom.IsValidReverseTarget())
-                {
-                    new_total_weight_to_reverse = new_total_weight_to_forward;
-                    packed_leg_to_reverse = packed_leg_to_forward;
-                }
-            }
-            else
-            {
-                search(engine_working_data,
-                       facade,
-                       forward_heap,
-                       reverse_heap,
-                       search_from_forward_node,
-                       search_from_reverse_node,
-                       search_to_forward_node,
-                       search_to_reverse_node,
-                       source_phantom,
-                       target_phantom,
-                       total_weight_to_forward,
-                       total_weight_to_reverse,
-                       new_total_weight_to_forward,
-                       new_total_weight_to_reverse,
-                       packed_leg_to_forward,
-                       packed_leg_to_reverse);
-            }
+            combineLegResults(leg_results[current_leg],
+                              allow_uturn_at_waypoint,
+                              search_from_forward_node,
+                              search_from_reverse_node,
+                              total_weight_to_forward,
+                              total_weight_to_reverse,
+                              new_total_weight_to_forward,
+                              new_total_weight_to_reverse,
+                              packed_leg_to_forward,
+                              packed_leg_to_reverse);
+        }
+        else
+        {
+            searchLeg(engine_working_data,
+                      facade,
+                      forward_heap,
+                      reverse_heap,
+                      allow_uturn_at_waypoint,
+                      search_from_forward_node,
+                      search_from_reverse_node,
+                      source_phantom,
+                      target_phantom,
+                      total_weight_to_forward,
+                      total_weight_to_reverse,
+                      new_total_weight_to_forward,
+                      new_total_weight_to_reverse,
+                      packed_leg_to_forward,
+                      packed_leg_to_reverse);
         }
 
         // Note: To make sure we do not access the moved-from packed_leg_to_forward
@@ -461,19 +686,22 @@ template InternalRouteResult
 shortestPathSearch(SearchEngineData<ch::Algorithm> &engine_working_data,
                    const datafacade::ContiguousInternalMemoryDataFacade<ch::Algorithm> &facade,
                    const std::vector<PhantomNodes> &phantom_nodes_vector,
-                   const boost::optional<bool> continue_straight_at_waypoint);
+                   const boost::optional<bool> continue_straight_at_waypoint,
+                   const std::size_t max_parallel_legs);
 
 template InternalRouteResult
 shortestPathSearch(SearchEngineData<corech::Algorithm> &engine_working_data,
                    const datafacade::ContiguousInternalMemoryDataFacade<corech::Algorithm> &facade,
                    const std::vector<PhantomNodes> &phantom_nodes_vector,
-                   const boost::optional<bool> continue_straight_at_waypoint);
+                   const boost::optional<bool> continue_straight_at_waypoint,
+                   const std::size_t max_parallel_legs);
 
 template InternalRouteResult
 shortestPathSearch(SearchEngineData<mld::Algorithm> &engine_working_data,
                    const datafacade::ContiguousInternalMemoryDataFacade<mld::Algorithm> &facade,
                    const std::vector<PhantomNodes> &phantom_nodes_vector,
-                   const boost::optional<bool> continue_straight_at_waypoint);
+                   const boost::optional<bool> continue_straight_at_waypoint,
+                   const std::size_t max_parallel_legs);
 
 } // namespace routing_algorithms
 } // namespace engine
@@ -0,0 +1,72 @@
+#include "engine/tile_cache.hpp"
+
+#include "util/std_hash.hpp"
+
+#include <boost/assert.hpp>
+
+namespace osrm
+{
+namespace engine
+{
+
+TileCache::TileCache(std::size_t max_size) : max_size(max_size) {}
+
+std::size_t TileCache::KeyHash::operator()(const Key &key) const
+{
+    return hash_val(key.data_version, key.z, key.x, key.y);
+}
+
+bool TileCache::Get(const Key &key, std::string &tile)
+{
+    std::shared_ptr<const std::string> cached_tile;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const auto entry = index.find(key);
+        if (entry == index.end())
+            return false;
+
+        entries.splice(entries.begin(), entries, entry->second);
+        cached_tile = entry->second->second;
+    }
+
+    // copy outside of the lock, the entry can be evicted meanwhile
+    tile = *cached_tile;
+    return true;
+}
+
+void TileCache::Put(const Key &key, const std::string &tile)
+{
+    if (tile.size() > max_size)
+        return;
+
+    auto cached_tile = std::make_shared<const std::string>(tile);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto existing = index.find(key);
+    if (existing != index.end())
+    {
+        // rendered by another thread in the meantime
+        entries.splice(entries.begin(), entries, existing->second);
+        return;
+    }
+
+    while (size + tile.size() > max_size)
+    {
+        BOOST_ASSERT(!entries.empty());
+        size -= entries.back().second->size();
+        index.erase(entries.back().first);
+        entries.pop_back();
+    }
+
+    entries.emplace_front(key, std::move(cached_tile));
+    index.emplace(key, entries.begin());
+    size += tile.size();
+}
+
+std::size_t TileCache::GetSize() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return size;
+}
+}
+}
@@ -0,0 +1,178 @@
+#include "engine/warmup.hpp"
+
+#include "storage/shared_datatype.hpp"
+#include "util/coordinate.hpp"
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+#include "util/log.hpp"
+
+#include <boost/algorithm/string/split.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace osrm
+{
+namespace engine
+{
+
+namespace
+{
+const constexpr storage::DataLayout::BlockID HOT_BLOCKS[] = {
+    storage::DataLayout::CH_GRAPH_NODE_LIST,
+    storage::DataLayout::CH_GRAPH_EDGE_LIST,
+    storage::DataLayout::CH_CORE_MARKER,
+    storage::DataLayout::MLD_PARTITION,
+    storage::DataLayout::MLD_CELL_WEIGHTS,
+    storage::DataLayout::MLD_CELL_SOURCE_BOUNDARY,
+    storage::DataLayout::MLD_CELL_DESTINATION_BOUNDARY,
+    storage::DataLayout::MLD_CELLS,
+    storage::DataLayout::MLD_GRAPH_NODE_LIST,
+    storage::DataLayout::MLD_GRAPH_EDGE_LIST,
+    storage::DataLayout::MLD_GRAPH_NODE_TO_OFFSET,
+    storage::DataLayout::R_SEARCH_TREE,
+    storage::DataLayout::COORDINATE_LIST,
+    storage::DataLayout::COORDINATE_BLOCKS,
+    storage::DataLayout::GEOMETRIES_INDEX,
+    storage::DataLayout::GEOMETRIES_NODE_LIST,
+    storage::DataLayout::GEOMETRIES_FWD_WEIGHT_LIST,
+    storage::DataLayout::GEOMETRIES_REV_WEIGHT_LIST,
+    storage::DataLayout::GEOMETRIES_FWD_DURATION_LIST,
+    storage::DataLayout::GEOMETRIES_REV_DURATION_LIST,
+    storage::DataLayout::GEOMETRY_ID_LIST,
+    storage::DataLayout::COMPONENT_ID_LIST};
+
+std::size_t getPageSize()
+{
+#ifndef _WIN32
+    return sysconf(_SC_PAGESIZE);
+#else
+    return 4096;
+#endif
+}
+
+bool parseCoordinates(const std::string &query, std::vector<util::Coordinate> &coordinates)
+{
+    // strip the query string and the service prefix of request paths
+    auto end = query.find('?');
+    if (end == std::string::npos)
+        end = query.size();
+    const auto begin = query.rfind('/', end);
+    const auto coordinate_list =
+        query.substr(begin == std::string::npos ? 0 : begin + 1,
+                     end - (begin == std::string::npos ? 0 : begin + 1));
+
+    std::vector<std::string> locations;
+    boost::algorithm::split(locations, coordinate_list, [](const char c) { return c == ';'; });
+    for (const auto &location : locations)
+    {
+        const auto separator = location.find(',');
+        if (separator == std::string::npos)
+            return false;
+
+        try
+        {
+            const auto lon = std::stod(location.substr(0, separator));
+            const auto lat = std::stod(location.substr(separator + 1));
+            const util::Coordinate coordinate{util::FloatLongitude{lon}, util::FloatLatitude{lat}};
+            if (!coordinate.IsValid())
+                return false;
+            coordinates.push_back(coordinate);
+        }
+        catch (const std::logic_error &)
+        {
+            return false;
+        }
+    }
+
+    return coordinates.size() >= 2;
+}
+}
+
+void prefaultHotBlocks(datafacade::ContiguousBlockAllocator &allocator)
+{
+    const auto &layout = allocator.GetLayout();
+    const auto page_size = getPageSize();
+
+    std::uint64_t prefaulted_bytes = 0;
+    for (const auto block_id : HOT_BLOCKS)
+    {
+        const auto size = layout.GetBlockSize(block_id);
+        if (size == 0)
+            continue;
+
+        const auto begin = layout.GetBlockPtr<char>(allocator.GetMemory(), block_id);
+        const auto aligned_begin = reinterpret_cast<char *>(
+            reinterpret_cast<std::uintptr_t>(begin) & ~(std::uintptr_t(page_size) - 1));
+        const auto end = begin + size;
+
+#ifndef _WIN32
+        // Asynchronously reads in pages that are not resident yet
+        ::madvise(aligned_begin, end - aligned_begin, MADV_WILLNEED);
+#endif
+
+        // Touching every page creates the page table entries for this mapping
+        volatile char sink = 0;
+        for (auto page = aligned_begin; page < end; page += page_size)
+        {
+            sink += *std::max(page, begin);
+        }
+        (void)sink;
+
+        prefaulted_bytes += size;
+    }
+
+    util::Log() << "Prefaulted " << (prefaulted_bytes >> 20) << " MiB of hot data";
+}
+
+std::vector<api::RouteParameters> loadWarmupQueries(const boost::filesystem::path &path,
+                                                    const std::size_t max_queries)
+{
+    boost::filesystem::ifstream stream(path);
+    if (!stream)
+    {
+        throw util::exception("Could not open warm-up queries " + path.string() + SOURCE_REF);
+    }
+
+    std::vector<std::vector<util::Coordinate>> recorded_queries;
+    std::size_t invalid_queries = 0;
+    std::string line;
+    while (std::getline(stream, line))
+    {
+        if (line.empty())
+            continue;
+
+        std::vector<util::Coordinate> coordinates;
+        if (parseCoordinates(line, coordinates))
+            recorded_queries.push_back(std::move(coordinates));
+        else
+            invalid_queries++;
+    }
+
+    if (invalid_queries > 0)
+    {
+        util::Log(logWARNING) << "Skipped " << invalid_queries << " invalid warm-up queries in "
+                              << path.string();
+    }
+
+    const auto num_queries = std::min(max_queries, recorded_queries.size());
+    std::vector<api::RouteParameters> queries(num_queries);
+    for (std::size_t index = 0; index < num_queries; ++index)
+    {
+        // evenly spaced sample, so we don't only replay the start of a recording
+        auto &coordinates = recorded_queries[index * recorded_queries.size() / num_queries];
+        queries[index].coordinates = std::move(coordinates);
+    }
+
+    util::Log() << "Loaded " << queries.size() << " warm-up queries from " << path.string();
+    return queries;
+}
+}
+}
@@ -430,6 +430,10 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
                 if (buffer->nodes_processed == 0)
                     return buffer;
 
+                // The penalties of all turns of the range are computed in one batch,
+                // edges start with the weight and duration of their source segment
+                std::vector<ExtractionTurn> turns;
+
                 for (auto node_at_center_of_intersection = intersection_node_range.begin(),
                           end = intersection_node_range.end();
                      node_at_center_of_intersection < end;
@@ -534,45 +538,27 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
                                  util::guidance::TurnBearing(intersection[0].bearing),
                                  util::guidance::TurnBearing(turn.bearing)});
 
-                            // compute weight and duration penalties
+                            // collect the turn for computing weight and duration penalties
                             auto is_traffic_light =
                                 m_traffic_lights.count(node_at_center_of_intersection);
-                            ExtractionTurn extracted_turn(turn, is_traffic_light);
-                            extracted_turn.source_restricted = edge_data1.restricted;
-                            extracted_turn.target_restricted = edge_data2.restricted;
-                            scripting_environment.ProcessTurn(extracted_turn);
-
-                            // turn penalties are limited to [-2^15, 2^15) which roughly
-                            // translates to 54 minutes and fits signed 16bit deci-seconds
-                            auto weight_penalty = boost::numeric_cast<TurnPenalty>(
-                                extracted_turn.weight * weight_multiplier);
-                            auto duration_penalty =
-                                boost::numeric_cast<TurnPenalty>(extracted_turn.duration * 10.);
+                            turns.emplace_back(turn, is_traffic_light);
+                            turns.back().source_restricted = edge_data1.restricted;
+                            turns.back().target_restricted = edge_data2.restricted;
 
                             BOOST_ASSERT(SPECIAL_NODEID != edge_data1.edge_id);
                             BOOST_ASSERT(SPECIAL_NODEID != edge_data2.edge_id);
 
                             // auto turn_id = m_edge_based_edge_list.size();
-                            auto weight =
-                                boost::numeric_cast<EdgeWeight>(edge_data1.weight + weight_penalty);
-                            auto duration = boost::numeric_cast<EdgeWeight>(edge_data1.duration +
-                                                                            duration_penalty);
                             buffer->edges_list.emplace_back(
                                 edge_data1.edge_id,
                                 edge_data2.edge_id,
                                 SPECIAL_NODEID, // This will be updated once the main loop
                                                 // completes!
-                                weight,
-                                duration,
+                                edge_data1.weight,
+                                edge_data1.duration,
                                 true,
                                 false);
-
-                            BOOST_ASSERT(buffer->turn_weight_penalties.size() ==
-                                         buffer->edges_list.size() - 1);
-                            buffer->turn_weight_penalties.push_back(weight_penalty);
-                            BOOST_ASSERT(buffer->turn_duration_penalties.size() ==
-                                         buffer->edges_list.size() - 1);
-                            buffer->turn_duration_penalties.push_back(duration_penalty);
+                            BOOST_ASSERT(turns.size() == buffer->edges_list.size());
 
                             // We write out the mapping between the edge-expanded edges and the
                             // original nodes. Since each edge represents a possible maneuver,
@@ -601,6 +587,28 @@ void EdgeBasedGraphFactory::GenerateEdgeExpandedEdges(
                     }
                 }
 
+                scripting_environment.ProcessTurns(turns);
+
+                buffer->turn_weight_penalties.reserve(turns.size());
+                buffer->turn_duration_penalties.reserve(turns.size());
+                for (const auto index : util::irange<std::size_t>(0, turns.size()))
+                {
+                    // turn penalties are limited to [-2^15, 2^15) which roughly
+                    // translates to 54 minutes and fits signed 16bit deci-seconds
+                    auto weight_penalty =
+                        boost::numeric_cast<TurnPenalty>(turns[index].weight * weight_multiplier);
+                    auto duration_penalty =
+                        boost::numeric_cast<TurnPenalty>(turns[index].duration * 10.);
+
+                    auto &edge = buffer->edges_list[index].data;
+                    edge.weight = boost::numeric_cast<EdgeWeight>(edge.weight + weight_penalty);
+                    edge.duration =
+                        boost::numeric_cast<EdgeWeight>(edge.duration + duration_penalty);
+
+                    buffer->turn_weight_penalties.push_back(weight_penalty);
+                    buffer->turn_duration_penalties.push_back(duration_penalty);
+                }
+
                 return buffer;
             });
 
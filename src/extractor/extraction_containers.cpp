@@ -9,8 +9,11 @@
 #include "util/exception.hpp"
 #include "util/exception_utils.hpp"
 #include "util/fingerprint.hpp"
+#include "util/hilbert_value.hpp"
+#include "util/integer_range.hpp"
 #include "util/log.hpp"
 #include "util/name_table.hpp"
+#include "util/radix_sort.hpp"
 #include "util/timing_util.hpp"
 
 #include "storage/io.hpp"
@@ -108,6 +111,46 @@ struct CmpEdgeByInternalSourceTargetAndName
     const oe::ExtractionContainers::STXXLNameCharData &name_data;
     const oe::ExtractionContainers::STXXLNameOffsets &name_offsets;
 };
+
+// Sorts the vector by the 64 bit key with an in-memory radix sort if the copy of the data and
+// the buffer of the radix sort fit into sort_memory, otherwise stxxl sorts it in external memory.
+// Writes the time of each phase of the sort to the log.
+template <typename VectorT, typename KeyT, typename CompareT>
+void sortByKey(VectorT &vector,
+               const KeyT &key,
+               CompareT compare,
+               const std::uint64_t sort_memory,
+               const unsigned stxxl_memory,
+               osrm::util::UnbufferedLog &log)
+{
+    using ValueT = typename VectorT::value_type;
+
+    const auto required_memory = std::uint64_t{2} * vector.size() * sizeof(ValueT);
+    if (required_memory > sort_memory)
+    {
+        TIMER_START(external_sort);
+        stxxl::sort(vector.begin(), vector.end(), compare, stxxl_memory);
+        TIMER_STOP(external_sort);
+        log << "ok, after " << TIMER_SEC(external_sort) << "s (external memory)";
+        return;
+    }
+
+    TIMER_START(read);
+    std::vector<ValueT> values(vector.cbegin(), vector.cend());
+    TIMER_STOP(read);
+
+    TIMER_START(radix_sort);
+    osrm::util::radixSort(values, key);
+    TIMER_STOP(radix_sort);
+
+    TIMER_START(write);
+    std::copy(values.begin(), values.end(), vector.begin());
+    TIMER_STOP(write);
+
+    log << "ok, after " << (TIMER_SEC(read) + TIMER_SEC(radix_sort) + TIMER_SEC(write))
+        << "s (in memory: read " << TIMER_SEC(read) << "s, radix sort " << TIMER_SEC(radix_sort)
+        << "s, write " << TIMER_SEC(write) << "s)";
+}
 }
 
 namespace osrm
@@ -115,7 +158,8 @@ namespace osrm
 namespace extractor
 {
 
-ExtractionContainers::ExtractionContainers()
+ExtractionContainers::ExtractionContainers(const std::uint64_t sort_memory_)
+    : sort_memory(sort_memory_)
 {
     // Check if stxxl can be instantiated
     stxxl::vector<unsigned> dummy_vector;
@@ -161,6 +205,7 @@ void ExtractionContainers::PrepareData(ScriptingEnvironment &scripting_environme
 
     PrepareNodes();
     WriteNodes(file_out);
+    used_nodes_list.clear();
     PrepareEdges(scripting_environment);
     WriteEdges(file_out);
 
@@ -188,11 +233,12 @@ void ExtractionContainers::PrepareNodes()
     {
         util::UnbufferedLog log;
         log << "Sorting used nodes        ... " << std::flush;
-        TIMER_START(sorting_used_nodes);
-        stxxl::sort(
-            used_node_id_list.begin(), used_node_id_list.end(), OSMNodeIDSTXXLLess(), stxxl_memory);
-        TIMER_STOP(sorting_used_nodes);
-        log << "ok, after " << TIMER_SEC(sorting_used_nodes) << "s";
+        sortByKey(used_node_id_list,
+                  [](const OSMNodeID id) { return static_cast<std::uint64_t>(id); },
+                  OSMNodeIDSTXXLLess(),
+                  sort_memory,
+                  stxxl_memory,
+                  log);
     }
 
     {
@@ -208,19 +254,20 @@ void ExtractionContainers::PrepareNodes()
     {
         util::UnbufferedLog log;
         log << "Sorting all nodes         ... " << std::flush;
-        TIMER_START(sorting_nodes);
-        stxxl::sort(all_nodes_list.begin(),
-                    all_nodes_list.end(),
-                    ExternalMemoryNodeSTXXLCompare(),
-                    stxxl_memory);
-        TIMER_STOP(sorting_nodes);
-        log << "ok, after " << TIMER_SEC(sorting_nodes) << "s";
+        sortByKey(all_nodes_list,
+                  [](const ExternalMemoryNode &node) {
+                      return static_cast<std::uint64_t>(node.node_id);
+                  },
+                  ExternalMemoryNodeSTXXLCompare(),
+                  sort_memory,
+                  stxxl_memory,
+                  log);
     }
 
     {
         util::UnbufferedLog log;
-        log << "Building node id map      ... " << std::flush;
-        TIMER_START(id_map);
+        log << "Collecting used nodes     ... " << std::flush;
+        TIMER_START(used_nodes);
         external_to_internal_node_id_map.reserve(used_node_id_list.size());
         auto node_iter = all_nodes_list.begin();
         auto ref_iter = used_node_id_list.begin();
@@ -246,7 +293,10 @@ void ExtractionContainers::PrepareNodes()
                 continue;
             }
             BOOST_ASSERT(node_iter->node_id == *ref_iter);
-            external_to_internal_node_id_map[*ref_iter] = static_cast<NodeID>(internal_id++);
+            used_nodes_list.push_back(
+                {util::GetHilbertCode(util::Coordinate{node_iter->lon, node_iter->lat}),
+                 *node_iter});
+            internal_id++;
             node_iter++;
             ref_iter++;
         }
@@ -257,8 +307,35 @@ void ExtractionContainers::PrepareNodes()
                                   std::to_string(internal_id) + SOURCE_REF);
         }
         max_internal_node_id = boost::numeric_cast<std::uint64_t>(internal_id);
-        TIMER_STOP(id_map);
-        log << "ok, after " << TIMER_SEC(id_map) << "s";
+        TIMER_STOP(used_nodes);
+        log << "ok, after " << TIMER_SEC(used_nodes) << "s";
+    }
+
+    {
+        util::UnbufferedLog log;
+        log << "Sorting nodes spatially   ... " << std::flush;
+        // All ids derived from node ids (edge-based nodes, geometries, the graphs) follow the
+        // order of the nodes. Nodes that are close to each other get close ids, so a query that
+        // moves through a region touches fewer pages and cache lines.
+        sortByKey(used_nodes_list,
+                  [](const HilbertOrderedNode &entry) { return entry.hilbert_code; },
+                  HilbertOrderedNodeSTXXLCompare(),
+                  sort_memory,
+                  stxxl_memory,
+                  log);
+    }
+
+    {
+        util::UnbufferedLog log;
+        log << "Numbering nodes           ... " << std::flush;
+        TIMER_START(numbering);
+        NodeID internal_id = 0;
+        for (const auto &entry : used_nodes_list)
+        {
+            external_to_internal_node_id_map[entry.node.node_id] = internal_id++;
+        }
+        TIMER_STOP(numbering);
+        log << "ok, after " << TIMER_SEC(numbering) << "s";
     }
 }
 
@@ -268,11 +345,14 @@ void ExtractionContainers::PrepareEdges(ScriptingEnvironment &scripting_environm
     {
         util::UnbufferedLog log;
         log << "Sorting edges by start    ... " << std::flush;
-        TIMER_START(sort_edges_by_start);
-        stxxl::sort(
-            all_edges_list.begin(), all_edges_list.end(), CmpEdgeByOSMStartID(), stxxl_memory);
-        TIMER_STOP(sort_edges_by_start);
-        log << "ok, after " << TIMER_SEC(sort_edges_by_start) << "s";
+        sortByKey(all_edges_list,
+                  [](const InternalExtractorEdge &edge) {
+                      return static_cast<std::uint64_t>(edge.result.osm_source_id);
+                  },
+                  CmpEdgeByOSMStartID(),
+                  sort_memory,
+                  stxxl_memory,
+                  log);
     }
 
     {
@@ -339,11 +419,14 @@ void ExtractionContainers::PrepareEdges(ScriptingEnvironment &scripting_environm
         // Sort Edges by target
         util::UnbufferedLog log;
         log << "Sorting edges by target   ... " << std::flush;
-        TIMER_START(sort_edges_by_target);
-        stxxl::sort(
-            all_edges_list.begin(), all_edges_list.end(), CmpEdgeByOSMTargetID(), stxxl_memory);
-        TIMER_STOP(sort_edges_by_target);
-        log << "ok, after " << TIMER_SEC(sort_edges_by_target) << "s";
+        sortByKey(all_edges_list,
+                  [](const InternalExtractorEdge &edge) {
+                      return static_cast<std::uint64_t>(edge.result.osm_target_id);
+                  },
+                  CmpEdgeByOSMTargetID(),
+                  sort_memory,
+                  stxxl_memory,
+                  log);
     }
 
     {
@@ -359,6 +442,25 @@ void ExtractionContainers::PrepareEdges(ScriptingEnvironment &scripting_environm
         const auto weight_multiplier =
             scripting_environment.GetProfileProperties().GetWeightMultiplier();
 
+        // segments are passed to the profile in batches
+        const constexpr std::size_t SEGMENT_BATCH_SIZE = 1024;
+        std::vector<ExtractionSegment> segments;
+        std::vector<STXXLEdgeVector::iterator> segment_edges;
+        segments.reserve(SEGMENT_BATCH_SIZE);
+        segment_edges.reserve(SEGMENT_BATCH_SIZE);
+        const auto processSegments = [&] {
+            scripting_environment.ProcessSegments(segments);
+            for (const auto index : util::irange<std::size_t>(0, segments.size()))
+            {
+                auto &edge = segment_edges[index]->result;
+                edge.weight =
+                    std::max<EdgeWeight>(1, std::round(segments[index].weight * weight_multiplier));
+                edge.duration = std::max<EdgeWeight>(1, std::round(segments[index].duration * 10.));
+            }
+            segments.clear();
+            segment_edges.clear();
+        };
+
         while (edge_iterator != all_edges_list_end_ && node_iterator != all_nodes_list_end_)
         {
             // skip all invalid edges
@@ -400,12 +502,10 @@ void ExtractionContainers::PrepareEdges(ScriptingEnvironment &scripting_environm
             const auto weight = edge_iterator->weight_data(distance);
             const auto duration = edge_iterator->duration_data(distance);
 
-            ExtractionSegment segment(source_coord, target_coord, distance, weight, duration);
-            scripting_environment.ProcessSegment(segment);
+            segments.emplace_back(source_coord, target_coord, distance, weight, duration);
+            segment_edges.push_back(edge_iterator);
 
             auto &edge = edge_iterator->result;
-            edge.weight = std::max<EdgeWeight>(1, std::round(segment.weight * weight_multiplier));
-            edge.duration = std::max<EdgeWeight>(1, std::round(segment.duration * 10.));
 
             // assign new node id
             auto id_iter = external_to_internal_node_id_map.find(node_iterator->node_id);
@@ -424,7 +524,11 @@ void ExtractionContainers::PrepareEdges(ScriptingEnvironment &scripting_environm
                 edge.backward = temp;
             }
             ++edge_iterator;
+
+            if (segments.size() == SEGMENT_BATCH_SIZE)
+                processSegments();
         }
+        processSegments();
 
         // Remove all remaining edges. They are invalid because there are no corresponding nodes for
         // them. This happens when using osmosis with bbox or polygon to extract smaller areas.
@@ -593,32 +697,12 @@ void ExtractionContainers::WriteNodes(storage::io::FileWriter &file_out) const
 
     {
         util::UnbufferedLog log;
-        log << "Confirming/Writing used nodes     ... ";
+        log << "Writing used nodes        ... ";
         TIMER_START(write_nodes);
-        // identify all used nodes by a merging step of two sorted lists
-        auto node_iterator = all_nodes_list.begin();
-        auto node_id_iterator = used_node_id_list.begin();
-        const auto used_node_id_list_end = used_node_id_list.end();
-        const auto all_nodes_list_end = all_nodes_list.end();
-
-        while (node_id_iterator != used_node_id_list_end && node_iterator != all_nodes_list_end)
+        BOOST_ASSERT(used_nodes_list.size() == max_internal_node_id);
+        for (const auto &entry : used_nodes_list)
         {
-            if (*node_id_iterator < node_iterator->node_id)
-            {
-                ++node_id_iterator;
-                continue;
-            }
-            if (*node_id_iterator > node_iterator->node_id)
-            {
-                ++node_iterator;
-                continue;
-            }
-            BOOST_ASSERT(*node_id_iterator == node_iterator->node_id);
-
-            file_out.WriteOne((*node_iterator));
-
-            ++node_id_iterator;
-            ++node_iterator;
+            file_out.WriteOne(entry.node);
         }
         TIMER_STOP(write_nodes);
         log << "ok, after " << TIMER_SEC(write_nodes) << "s";
@@ -670,13 +754,14 @@ void ExtractionContainers::PrepareRestrictions()
     {
         util::UnbufferedLog log;
         log << "Sorting used ways         ... ";
-        TIMER_START(sort_ways);
-        stxxl::sort(way_start_end_id_list.begin(),
-                    way_start_end_id_list.end(),
-                    FirstAndLastSegmentOfWayStxxlCompare(),
-                    stxxl_memory);
-        TIMER_STOP(sort_ways);
-        log << "ok, after " << TIMER_SEC(sort_ways) << "s";
+        sortByKey(way_start_end_id_list,
+                  [](const FirstAndLastSegmentOfWay &way) {
+                      return static_cast<std::uint64_t>(way.way_id);
+                  },
+                  FirstAndLastSegmentOfWayStxxlCompare(),
+                  sort_memory,
+                  stxxl_memory,
+                  log);
     }
 
     {
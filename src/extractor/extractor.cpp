@@ -11,12 +11,14 @@
 #include "extractor/scripting_environment.hpp"
 
 #include "storage/io.hpp"
+#include "storage/manifest.hpp"
 
 #include "util/exception.hpp"
 #include "util/exception_utils.hpp"
 #include "util/graph_loader.hpp"
 #include "util/integer_range.hpp"
 #include "util/log.hpp"
+#include "util/mmap_file.hpp"
 #include "util/name_table.hpp"
 #include "util/range_table.hpp"
 #include "util/timing_util.hpp"
@@ -33,6 +35,7 @@
 
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/fstream.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
 #include <boost/iterator/function_input_iterator.hpp>
 #include <boost/optional/optional.hpp>
 #include <boost/scope_exit.hpp>
@@ -160,6 +163,29 @@ int Extractor::run(ScriptingEnvironment &scripting_environment)
 
     util::Log() << "Processed " << edge_based_edge_list.size() << " edges";
 
+    if (config.parse_conditionals)
+    {
+        util::Log() << "Indexing turns of conditional restrictions ...";
+        TIMER_START(index_conditional_turns);
+        std::vector<TurnRestriction> conditional_turns;
+        {
+            storage::io::FileReader reader(config.restriction_file_name,
+                                           storage::io::FileReader::VerifyFingerprint);
+            serialization::read(reader, conditional_turns);
+        }
+        boost::iostreams::mapped_file_source turn_index_region;
+        const auto turn_index = util::mmapFile<lookup::TurnIndexBlock>(
+            config.turn_penalties_index_path, turn_index_region);
+        const auto conditional_turn_index =
+            buildConditionalTurnIndex(conditional_turns, turn_index);
+        files::writeConditionalTurnIndex(config.restriction_turns_file_name,
+                                         conditional_turn_index);
+        TIMER_STOP(index_conditional_turns);
+        util::Log() << "ok, " << conditional_turn_index.turns.size() << " turns of "
+                    << conditional_turns.size() << " restrictions after "
+                    << TIMER_SEC(index_conditional_turns) << "s";
+    }
+
     const auto nodes_per_second =
         static_cast<std::uint64_t>(number_of_node_based_nodes / TIMER_SEC(expansion));
     const auto edges_per_second =
@@ -167,6 +193,25 @@ int Extractor::run(ScriptingEnvironment &scripting_environment)
 
     util::Log() << "Expansion: " << nodes_per_second << " nodes/sec and " << edges_per_second
                 << " edges/sec";
+
+    util::Log() << "Writing dataset manifest ...";
+    storage::manifest::updateManifest(config.output_file_name,
+                                      {".ramIndex",
+                                       ".fileIndex",
+                                       ".nbg_nodes",
+                                       ".ebg_nodes",
+                                       ".edges",
+                                       ".geometry",
+                                       ".timestamp",
+                                       ".turn_weight_penalties",
+                                       ".turn_duration_penalties",
+                                       ".names",
+                                       ".properties",
+                                       ".icd",
+                                       ".tld",
+                                       ".tls"},
+                                      false);
+
     util::Log() << "To prepare the data for routing, run: "
                 << "./osrm-contract " << config.output_file_name;
 
@@ -200,7 +245,7 @@ Extractor::ParseOSMData(ScriptingEnvironment &scripting_environment,
     util::Log() << "Parsing in progress..";
     TIMER_START(parsing);
 
-    ExtractionContainers extraction_containers;
+    ExtractionContainers extraction_containers(std::uint64_t{config.sort_memory} << 20);
     auto extractor_callbacks = std::make_unique<ExtractorCallbacks>(
         extraction_containers, scripting_environment.GetProfileProperties());
 
@@ -234,20 +279,27 @@ Extractor::ParseOSMData(ScriptingEnvironment &scripting_environment,
         config.parse_conditionals,
         restrictions);
 
-    std::mutex process_mutex;
-
     using SharedBuffer = std::shared_ptr<const osmium::memory::Buffer>;
     struct ParsedBuffer
     {
-        SharedBuffer buffer;
-        std::vector<std::pair<const osmium::Node &, ExtractionNode>> resulting_nodes;
-        std::vector<std::pair<const osmium::Way &, ExtractionWay>> resulting_ways;
-        std::vector<boost::optional<InputRestrictionContainer>> resulting_restrictions;
+        ExtractionBuffer extracted;
+        std::size_t number_of_nodes = 0;
+        std::size_t number_of_ways = 0;
+        std::size_t number_of_relations = 0;
     };
 
+    // Time spent in each pipeline stage, the transform stage is summed over all threads
+    using Clock = std::chrono::steady_clock;
+    Clock::duration read_time{0};
+    Clock::duration store_time{0};
+    std::atomic<std::uint64_t> transform_nanoseconds{0};
+
     tbb::filter_t<void, SharedBuffer> buffer_reader(
         tbb::filter::serial_in_order, [&](tbb::flow_control &fc) {
-            if (auto buffer = reader.read())
+            const auto start = Clock::now();
+            auto buffer = reader.read();
+            read_time += Clock::now() - start;
+            if (buffer)
             {
                 return std::make_shared<const osmium::memory::Buffer>(std::move(buffer));
             }
@@ -262,36 +314,53 @@ Extractor::ParseOSMData(ScriptingEnvironment &scripting_environment,
             if (!buffer)
                 return std::shared_ptr<ParsedBuffer>{};
 
-            auto parsed_buffer = std::make_shared<ParsedBuffer>();
-            parsed_buffer->buffer = buffer;
+            const auto start = Clock::now();
+            std::vector<std::pair<const osmium::Node &, ExtractionNode>> resulting_nodes;
+            std::vector<std::pair<const osmium::Way &, ExtractionWay>> resulting_ways;
+            std::vector<boost::optional<InputRestrictionContainer>> resulting_restrictions;
             scripting_environment.ProcessElements(*buffer,
                                                   restriction_parser,
-                                                  parsed_buffer->resulting_nodes,
-                                                  parsed_buffer->resulting_ways,
-                                                  parsed_buffer->resulting_restrictions);
-            return parsed_buffer;
-        });
-    tbb::filter_t<std::shared_ptr<ParsedBuffer>, void> buffer_storage(
-        tbb::filter::serial_in_order, [&](const std::shared_ptr<ParsedBuffer> parsed_buffer) {
-            if (!parsed_buffer)
-                return;
+                                                  resulting_nodes,
+                                                  resulting_ways,
+                                                  resulting_restrictions);
 
-            number_of_nodes += parsed_buffer->resulting_nodes.size();
-            // put parsed objects thru extractor callbacks
-            for (const auto &result : parsed_buffer->resulting_nodes)
+            // put parsed objects thru extractor callbacks, this only touches the local buffer
+            auto parsed_buffer = std::make_shared<ParsedBuffer>();
+            auto &extracted = parsed_buffer->extracted;
+            parsed_buffer->number_of_nodes = resulting_nodes.size();
+            extracted.nodes.reserve(resulting_nodes.size());
+            for (const auto &result : resulting_nodes)
             {
-                extractor_callbacks->ProcessNode(result.first, result.second);
+                extractor_callbacks->ProcessNode(result.first, result.second, extracted);
             }
-            number_of_ways += parsed_buffer->resulting_ways.size();
-            for (const auto &result : parsed_buffer->resulting_ways)
+            parsed_buffer->number_of_ways = resulting_ways.size();
+            for (const auto &result : resulting_ways)
             {
-                extractor_callbacks->ProcessWay(result.first, result.second);
+                extractor_callbacks->ProcessWay(result.first, result.second, extracted);
             }
-            number_of_relations += parsed_buffer->resulting_restrictions.size();
-            for (const auto &result : parsed_buffer->resulting_restrictions)
+            parsed_buffer->number_of_relations = resulting_restrictions.size();
+            for (const auto &result : resulting_restrictions)
             {
-                extractor_callbacks->ProcessRestriction(result);
+                extractor_callbacks->ProcessRestriction(result, extracted);
             }
+
+            transform_nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         Clock::now() - start)
+                                         .count();
+            return parsed_buffer;
+        });
+    // Only assigns global name ids and appends the buffers in the order of the input
+    tbb::filter_t<std::shared_ptr<ParsedBuffer>, void> buffer_storage(
+        tbb::filter::serial_in_order, [&](const std::shared_ptr<ParsedBuffer> parsed_buffer) {
+            if (!parsed_buffer)
+                return;
+
+            const auto start = Clock::now();
+            number_of_nodes += parsed_buffer->number_of_nodes;
+            number_of_ways += parsed_buffer->number_of_ways;
+            number_of_relations += parsed_buffer->number_of_relations;
+            extractor_callbacks->StoreBuffer(parsed_buffer->extracted);
+            store_time += Clock::now() - start;
         });
 
     // Number of pipeline tokens that yielded the best speedup was about 1.5 * num_cores
@@ -301,6 +370,21 @@ Extractor::ParseOSMData(ScriptingEnvironment &scripting_environment,
     TIMER_STOP(parsing);
     util::Log() << "Parsing finished after " << TIMER_SEC(parsing) << " seconds";
 
+    const auto number_of_objects =
+        static_cast<double>(number_of_nodes) + number_of_ways + number_of_relations;
+    const auto objects_per_second = [number_of_objects](const double seconds) {
+        return static_cast<std::uint64_t>(seconds > 0 ? number_of_objects / seconds : 0);
+    };
+    const auto read_seconds = std::chrono::duration<double>(read_time).count();
+    const auto transform_seconds = transform_nanoseconds / 1e9;
+    const auto store_seconds = std::chrono::duration<double>(store_time).count();
+    util::Log() << "Reading: " << read_seconds << "s, " << objects_per_second(read_seconds)
+                << " objects/sec";
+    util::Log() << "Processing: " << transform_seconds << "s summed over threads, "
+                << objects_per_second(transform_seconds) << " objects/sec per thread";
+    util::Log() << "Storing: " << store_seconds << "s, " << objects_per_second(store_seconds)
+                << " objects/sec";
+
     util::Log() << "Raw input contains " << number_of_nodes << " nodes, " << number_of_ways
                 << " ways, and " << number_of_relations << " relations";
 
@@ -9,6 +9,7 @@
 
 #include "util/for_each_pair.hpp"
 #include "util/guidance/turn_lanes.hpp"
+#include "util/integer_range.hpp"
 #include "util/log.hpp"
 
 #include <boost/numeric/conversion/cast.hpp>
@@ -46,14 +47,13 @@ ExtractorCallbacks::ExtractorCallbacks(ExtractionContainers &extraction_containe
 
 /**
  * Takes the node position from osmium and the filtered properties from the lua
- * profile and saves them to external memory.
- *
- * warning: caller needs to take care of synchronization!
+ * profile and saves them to the buffer.
  */
 void ExtractorCallbacks::ProcessNode(const osmium::Node &input_node,
-                                     const ExtractionNode &result_node)
+                                     const ExtractionNode &result_node,
+                                     ExtractionBuffer &buffer) const
 {
-    external_memory.all_nodes_list.push_back(
+    buffer.nodes.push_back(
         {util::toFixed(util::UnsafeFloatLongitude{input_node.location().lon()}),
          util::toFixed(util::UnsafeFloatLatitude{input_node.location().lat()}),
          OSMNodeID{static_cast<std::uint64_t>(input_node.id())},
@@ -62,11 +62,11 @@ void ExtractorCallbacks::ProcessNode(const osmium::Node &input_node,
 }
 
 void ExtractorCallbacks::ProcessRestriction(
-    const boost::optional<InputRestrictionContainer> &restriction)
+    const boost::optional<InputRestrictionContainer> &restriction, ExtractionBuffer &buffer) const
 {
     if (restriction)
     {
-        external_memory.restrictions_list.push_back(restriction.get());
+        buffer.restrictions.push_back(restriction.get());
         // util::Log() << "from: " << restriction.get().restriction.from.node <<
         //                           ",via: " << restriction.get().restriction.via.node <<
         //                           ", to: " << restriction.get().restriction.to.node <<
@@ -80,10 +80,10 @@ void ExtractorCallbacks::ProcessRestriction(
  *
  * Depending on the forward/backwards weights the edges are split into forward
  * and backward edges.
- *
- * warning: caller needs to take care of synchronization!
  */
-void ExtractorCallbacks::ProcessWay(const osmium::Way &input_way, const ExtractionWay &parsed_way)
+void ExtractorCallbacks::ProcessWay(const osmium::Way &input_way,
+                                    const ExtractionWay &parsed_way,
+                                    ExtractionBuffer &buffer) const
 {
     if ((parsed_way.forward_travel_mode == TRAVEL_MODE_INACCESSIBLE ||
          parsed_way.forward_speed <= 0) &&
@@ -244,64 +244,34 @@ void ExtractorCallbacks::ProcessWay(const osmium::Way &input_way, const Extracti
         return lane_description;
     };
 
-    // convert the lane description into an ID and, if necessary, remember the description in the
-    // description_map
+    // convert the lane description into an ID local to the buffer and, if necessary, remember
+    // the description in the buffer
     const auto requestId = [&](const std::string &lane_string) {
         if (lane_string.empty())
             return INVALID_LANE_DESCRIPTIONID;
         TurnLaneDescription lane_description = laneStringToDescription(std::move(lane_string));
 
-        return lane_description_map.ConcurrentFindOrAdd(lane_description);
+        const auto local_id =
+            static_cast<LaneDescriptionID>(buffer.lane_descriptions.size());
+        const auto inserted = buffer.lane_description_ids.emplace(lane_description, local_id);
+        if (inserted.second)
+            buffer.lane_descriptions.push_back(std::move(lane_description));
+        return inserted.first->second;
     };
 
-    // Deduplicates street names, refs, destinations, pronunciation based on the string_map.
-    // In case we do not already store the key, inserts (key, id) tuple and return id.
-    // Otherwise fetches the id based on the name and returns it without insertion.
     const auto turn_lane_id_forward = requestId(parsed_way.turn_lanes_forward);
     const auto turn_lane_id_backward = requestId(parsed_way.turn_lanes_backward);
 
     const auto road_classification = parsed_way.road_classification;
 
-    // Get the unique identifier for the street name, destination, and ref
-    const auto name_iterator = string_map.find(
-        MapKey(parsed_way.name, parsed_way.destinations, parsed_way.ref, parsed_way.pronunciation));
-    NameID name_id = EMPTY_NAMEID;
-    if (string_map.end() == name_iterator)
-    {
-        // name_offsets has a sentinel element with the total name data size
-        // take the sentinels index as the name id of the new name data pack
-        // (name [name_id], destination [+1], pronunciation [+2], ref [+3])
-        name_id = external_memory.name_offsets.size() - 1;
-
-        std::copy(parsed_way.name.begin(),
-                  parsed_way.name.end(),
-                  std::back_inserter(external_memory.name_char_data));
-        external_memory.name_offsets.push_back(external_memory.name_char_data.size());
-
-        std::copy(parsed_way.destinations.begin(),
-                  parsed_way.destinations.end(),
-                  std::back_inserter(external_memory.name_char_data));
-        external_memory.name_offsets.push_back(external_memory.name_char_data.size());
-
-        std::copy(parsed_way.pronunciation.begin(),
-                  parsed_way.pronunciation.end(),
-                  std::back_inserter(external_memory.name_char_data));
-        external_memory.name_offsets.push_back(external_memory.name_char_data.size());
-
-        std::copy(parsed_way.ref.begin(),
-                  parsed_way.ref.end(),
-                  std::back_inserter(external_memory.name_char_data));
-        external_memory.name_offsets.push_back(external_memory.name_char_data.size());
-
-        auto k = MapKey{
-            parsed_way.name, parsed_way.destinations, parsed_way.ref, parsed_way.pronunciation};
-        auto v = MapVal{name_id};
-        string_map.emplace(std::move(k), std::move(v));
-    }
-    else
-    {
-        name_id = name_iterator->second;
-    }
+    // Deduplicates street names, refs, destinations, pronunciation inside of the buffer,
+    // StoreBuffer translates the local id into the global name id.
+    auto name_key =
+        MapKey(parsed_way.name, parsed_way.destinations, parsed_way.ref, parsed_way.pronunciation);
+    const auto name_inserted = buffer.name_ids.emplace(name_key, buffer.names.size());
+    if (name_inserted.second)
+        buffer.names.push_back(std::move(name_key));
+    const NameID name_id = name_inserted.first->second;
 
     const bool in_forward_direction =
         (parsed_way.forward_speed > 0 || parsed_way.forward_rate > 0 || parsed_way.duration > 0 ||
@@ -327,7 +297,7 @@ void ExtractorCallbacks::ProcessWay(const osmium::Way &input_way, const Extracti
             nodes.cbegin(),
             nodes.cend(),
             [&](const osmium::NodeRef &first_node, const osmium::NodeRef &last_node) {
-                external_memory.all_edges_list.push_back(
+                buffer.edges.push_back(
                     InternalExtractorEdge(OSMNodeID{static_cast<std::uint64_t>(first_node.ref())},
                                           OSMNodeID{static_cast<std::uint64_t>(last_node.ref())},
                                           name_id,
@@ -353,7 +323,7 @@ void ExtractorCallbacks::ProcessWay(const osmium::Way &input_way, const Extracti
             nodes.cbegin(),
             nodes.cend(),
             [&](const osmium::NodeRef &first_node, const osmium::NodeRef &last_node) {
-                external_memory.all_edges_list.push_back(
+                buffer.edges.push_back(
                     InternalExtractorEdge(OSMNodeID{static_cast<std::uint64_t>(first_node.ref())},
                                           OSMNodeID{static_cast<std::uint64_t>(last_node.ref())},
                                           name_id,
@@ -375,12 +345,12 @@ void ExtractorCallbacks::ProcessWay(const osmium::Way &input_way, const Extracti
 
     std::transform(nodes.begin(),
                    nodes.end(),
-                   std::back_inserter(external_memory.used_node_id_list),
+                   std::back_inserter(buffer.used_node_ids),
                    [](const osmium::NodeRef &ref) {
                        return OSMNodeID{static_cast<std::uint64_t>(ref.ref())};
                    });
 
-    external_memory.way_start_end_id_list.push_back(
+    buffer.way_start_end_ids.push_back(
         {OSMWayID{static_cast<std::uint32_t>(input_way.id())},
          OSMNodeID{static_cast<std::uint64_t>(nodes[0].ref())},
          OSMNodeID{static_cast<std::uint64_t>(nodes[1].ref())},
@@ -388,6 +358,82 @@ void ExtractorCallbacks::ProcessWay(const osmium::Way &input_way, const Extracti
          OSMNodeID{static_cast<std::uint64_t>(nodes.back().ref())}});
 }
 
+/**
+ * Assigns the global name and turn lane description ids to the data of the buffer
+ * and appends it to external memory.
+ *
+ * warning: caller needs to take care of synchronization!
+ */
+void ExtractorCallbacks::StoreBuffer(ExtractionBuffer &buffer)
+{
+    std::vector<NameID> name_ids(buffer.names.size());
+    for (const auto local_id : util::irange<std::size_t>(0, buffer.names.size()))
+    {
+        auto &key = buffer.names[local_id];
+
+        // Deduplicates street names, refs, destinations, pronunciation based on the string_map.
+        // In case we do not already store the key, inserts (key, id) tuple and return id.
+        // Otherwise fetches the id based on the name and returns it without insertion.
+        const auto name_iterator = string_map.find(key);
+        if (string_map.end() != name_iterator)
+        {
+            name_ids[local_id] = name_iterator->second;
+            continue;
+        }
+
+        // name_offsets has a sentinel element with the total name data size
+        // take the sentinels index as the name id of the new name data pack
+        // (name [name_id], destination [+1], pronunciation [+2], ref [+3])
+        const NameID name_id = external_memory.name_offsets.size() - 1;
+
+        const auto append = [this](const std::string &value) {
+            std::copy(
+                value.begin(), value.end(), std::back_inserter(external_memory.name_char_data));
+            external_memory.name_offsets.push_back(external_memory.name_char_data.size());
+        };
+        append(std::get<0>(key)); // name
+        append(std::get<1>(key)); // destinations
+        append(std::get<3>(key)); // pronunciation
+        append(std::get<2>(key)); // ref
+
+        string_map.emplace(std::move(key), MapVal{name_id});
+        name_ids[local_id] = name_id;
+    }
+
+    std::vector<LaneDescriptionID> lane_description_ids(buffer.lane_descriptions.size());
+    for (const auto local_id : util::irange<std::size_t>(0, buffer.lane_descriptions.size()))
+    {
+        lane_description_ids[local_id] =
+            lane_description_map.ConcurrentFindOrAdd(buffer.lane_descriptions[local_id]);
+    }
+
+    for (auto &edge : buffer.edges)
+    {
+        edge.result.name_id = name_ids[edge.result.name_id];
+        if (edge.result.lane_description_id != INVALID_LANE_DESCRIPTIONID)
+        {
+            edge.result.lane_description_id =
+                lane_description_ids[edge.result.lane_description_id];
+        }
+    }
+
+    std::copy(buffer.nodes.begin(),
+              buffer.nodes.end(),
+              std::back_inserter(external_memory.all_nodes_list));
+    std::copy(buffer.used_node_ids.begin(),
+              buffer.used_node_ids.end(),
+              std::back_inserter(external_memory.used_node_id_list));
+    std::copy(buffer.edges.begin(),
+              buffer.edges.end(),
+              std::back_inserter(external_memory.all_edges_list));
+    std::copy(buffer.way_start_end_ids.begin(),
+              buffer.way_start_end_ids.end(),
+              std::back_inserter(external_memory.way_start_end_id_list));
+    std::copy(buffer.restrictions.begin(),
+              buffer.restrictions.end(),
+              std::back_inserter(external_memory.restrictions_list));
+}
+
 guidance::LaneDescriptionMap &&ExtractorCallbacks::moveOutLaneDescriptionMap()
 {
     return std::move(lane_description_map);
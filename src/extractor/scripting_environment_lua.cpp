@@ -456,6 +456,52 @@ void Sol2ScriptingEnvironment::InitContext(LuaScriptingContext &context)
                               " are supported." + SOURCE_REF);
     }
 
+    // Batch functions and the turn penalty table are only supported from API version 1
+    context.has_turns_function = false;
+    context.has_segments_function = false;
+    if (context.api_version >= 1)
+    {
+        context.turns_function = context.state["process_turns"];
+        context.segments_function = context.state["process_segments"];
+        context.has_turns_function = context.turns_function.valid();
+        context.has_segments_function = context.segments_function.valid();
+
+        auto maybe_table = context.state.get<sol::optional<sol::table>>("turn_penalty_table");
+        if (maybe_table)
+        {
+            const auto readArray = [](const sol::optional<sol::table> &array) {
+                std::vector<double> values;
+                for (std::size_t index = 1; array && index <= array->size(); ++index)
+                {
+                    values.push_back(array->get<double>(index));
+                }
+                return values;
+            };
+
+            TurnPenaltyTable table;
+            table.angles = readArray(maybe_table->get<sol::optional<sol::table>>("angles"));
+            table.durations = readArray(maybe_table->get<sol::optional<sol::table>>("durations"));
+            table.u_turn_penalty =
+                maybe_table->get<sol::optional<double>>("u_turn_penalty").value_or(0.);
+            table.traffic_light_penalty =
+                maybe_table->get<sol::optional<double>>("traffic_light_penalty").value_or(0.);
+            if (!table.IsValid())
+            {
+                throw util::exception("turn_penalty_table needs the same number of durations as "
+                                      "angles and the angles need to be ascending." +
+                                      SOURCE_REF);
+            }
+            // The table only yields durations, other weights can't be derived from them
+            if (context.properties.GetWeightName() != "duration")
+            {
+                throw util::exception("turn_penalty_table needs the profile to use the duration "
+                                      "as weight, but its weight is " +
+                                      context.properties.GetWeightName() + SOURCE_REF);
+            }
+            context.turn_penalty_table = std::move(table);
+        }
+    }
+
     // Assert that version-dependent properties were not changed by profile
     switch (context.api_version)
     {
@@ -585,35 +631,122 @@ void Sol2ScriptingEnvironment::SetupSources()
 }
 
 void Sol2ScriptingEnvironment::ProcessTurn(ExtractionTurn &turn)
+{
+    GetSol2Context().ProcessTurn(turn);
+}
+
+void Sol2ScriptingEnvironment::ProcessSegment(ExtractionSegment &segment)
+{
+    GetSol2Context().ProcessSegment(segment);
+}
+
+void Sol2ScriptingEnvironment::ProcessTurns(std::vector<ExtractionTurn> &turns)
 {
     auto &context = GetSol2Context();
 
-    switch (context.api_version)
+    // the turn penalty table takes precedence over all lua functions
+    if (context.has_turns_function && !context.turn_penalty_table)
+    {
+        BOOST_ASSERT(context.api_version >= 1);
+
+        // the turns are passed by reference, so the profile modifies them in place
+        sol::table batch = context.state.create_table(static_cast<int>(turns.size()), 0);
+        for (std::size_t index = 0; index < turns.size(); ++index)
+        {
+            batch[index + 1] = &turns[index];
+        }
+        context.turns_function(batch);
+
+        // Turn weight falls back to the duration value in deciseconds
+        // or uses the extracted unit-less weight value
+        if (context.properties.fallback_to_duration)
+        {
+            for (auto &turn : turns)
+            {
+                turn.weight = turn.duration;
+            }
+        }
+    }
+    else
+    {
+        for (auto &turn : turns)
+        {
+            context.ProcessTurn(turn);
+        }
+    }
+}
+
+void Sol2ScriptingEnvironment::ProcessSegments(std::vector<ExtractionSegment> &segments)
+{
+    auto &context = GetSol2Context();
+
+    if (context.has_segments_function)
+    {
+        BOOST_ASSERT(context.api_version >= 1);
+
+        sol::table batch = context.state.create_table(static_cast<int>(segments.size()), 0);
+        for (std::size_t index = 0; index < segments.size(); ++index)
+        {
+            batch[index + 1] = &segments[index];
+        }
+        context.segments_function(batch);
+    }
+    else
+    {
+        for (auto &segment : segments)
+        {
+            context.ProcessSegment(segment);
+        }
+    }
+}
+
+void LuaScriptingContext::ProcessNode(const osmium::Node &node, ExtractionNode &result)
+{
+    BOOST_ASSERT(state.lua_state() != nullptr);
+
+    node_function(node, result);
+}
+
+void LuaScriptingContext::ProcessWay(const osmium::Way &way, ExtractionWay &result)
+{
+    BOOST_ASSERT(state.lua_state() != nullptr);
+
+    way_function(way, result);
+}
+void LuaScriptingContext::ProcessTurn(ExtractionTurn &turn)
+{
+    if (turn_penalty_table)
+    {
+        turn_penalty_table->Apply(turn);
+        return;
+    }
+
+    switch (api_version)
     {
     case 1:
-        if (context.has_turn_penalty_function)
+        if (has_turn_penalty_function)
         {
-            context.turn_function(turn);
+            turn_function(turn);
 
             // Turn weight falls back to the duration value in deciseconds
             // or uses the extracted unit-less weight value
-            if (context.properties.fallback_to_duration)
+            if (properties.fallback_to_duration)
                 turn.weight = turn.duration;
         }
 
         break;
     case 0:
-        if (context.has_turn_penalty_function)
+        if (has_turn_penalty_function)
         {
             if (turn.turn_type != guidance::TurnType::NoTurn)
             {
                 // Get turn duration and convert deci-seconds to seconds
-                turn.duration = static_cast<double>(context.turn_function(turn.angle)) / 10.;
+                turn.duration = static_cast<double>(turn_function(turn.angle)) / 10.;
                 BOOST_ASSERT(turn.weight == 0);
 
                 // add U-turn penalty
                 if (turn.direction_modifier == guidance::DirectionModifier::UTurn)
-                    turn.duration += context.properties.GetUturnPenalty();
+                    turn.duration += properties.GetUturnPenalty();
             }
             else
             {
@@ -625,7 +758,7 @@ void Sol2ScriptingEnvironment::ProcessTurn(ExtractionTurn &turn)
 
         // Add traffic light penalty, back-compatibility of api_version=0
         if (turn.has_traffic_light)
-            turn.duration += context.properties.GetTrafficSignalPenalty();
+            turn.duration += properties.GetTrafficSignalPenalty();
 
         // Turn weight falls back to the duration value in deciseconds
         turn.weight = turn.duration;
@@ -633,38 +766,21 @@ void Sol2ScriptingEnvironment::ProcessTurn(ExtractionTurn &turn)
     }
 }
 
-void Sol2ScriptingEnvironment::ProcessSegment(ExtractionSegment &segment)
+void LuaScriptingContext::ProcessSegment(ExtractionSegment &segment)
 {
-    auto &context = GetSol2Context();
-
-    if (context.has_segment_function)
+    if (has_segment_function)
     {
-        switch (context.api_version)
+        switch (api_version)
         {
         case 1:
-            context.segment_function(segment);
+            segment_function(segment);
             break;
         case 0:
-            context.segment_function(
-                segment.source, segment.target, segment.distance, segment.duration);
+            segment_function(segment.source, segment.target, segment.distance, segment.duration);
             segment.weight = segment.duration; // back-compatibility fallback to duration
             break;
         }
     }
 }
-
-void LuaScriptingContext::ProcessNode(const osmium::Node &node, ExtractionNode &result)
-{
-    BOOST_ASSERT(state.lua_state() != nullptr);
-
-    node_function(node, result);
-}
-
-void LuaScriptingContext::ProcessWay(const osmium::Way &way, ExtractionWay &result)
-{
-    BOOST_ASSERT(state.lua_state() != nullptr);
-
-    way_function(way, result);
-}
 }
 }
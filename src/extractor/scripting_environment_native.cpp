@@ -0,0 +1,513 @@
+#include "extractor/scripting_environment_native.hpp"
+
+#include "extractor/extraction_node.hpp"
+#include "extractor/extraction_segment.hpp"
+#include "extractor/extraction_turn.hpp"
+#include "extractor/extraction_way.hpp"
+#include "extractor/restriction_parser.hpp"
+#include "extractor/travel_mode.hpp"
+#include "util/coordinate.hpp"
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+#include "util/log.hpp"
+
+#include <osmium/osm.hpp>
+
+#include <boost/assert.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include <algorithm>
+#include <iterator>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+namespace osrm
+{
+namespace extractor
+{
+
+static_assert(TRAVEL_MODE_FERRY == OSRM_MODE_FERRY, "travel modes of the C interface differ");
+static_assert(guidance::RoadPriorityClass::CONNECTIVITY == OSRM_ROAD_PRIORITY_CONNECTIVITY,
+              "road priority classes of the C interface differ");
+static_assert(guidance::TurnType::NoTurn == OSRM_TURN_TYPE_NO_TURN,
+              "turn types of the C interface differ");
+static_assert(guidance::DirectionModifier::SharpLeft == OSRM_DIRECTION_MODIFIER_SHARP_LEFT,
+              "direction modifiers of the C interface differ");
+static_assert(sizeof(osrm_profile_properties::weight_name) ==
+                  ProfileProperties::MAX_WEIGHT_NAME_LENGTH + 1,
+              "weight name length of the C interface differs");
+
+struct NativeProfileLibrary
+{
+    explicit NativeProfileLibrary(const std::string &file_name) : file_name(file_name)
+    {
+#ifdef _WIN32
+        handle = LoadLibraryA(file_name.c_str());
+        if (!handle)
+        {
+            throw util::exception("Can't load profile library " + file_name + SOURCE_REF);
+        }
+#else
+        handle = dlopen(file_name.c_str(), RTLD_NOW | RTLD_LOCAL);
+        if (!handle)
+        {
+            throw util::exception("Can't load profile library " + file_name + ": " + dlerror() +
+                                  SOURCE_REF);
+        }
+#endif
+
+        api_version = Get<osrm_profile_api_version_fn>("osrm_profile_api_version", true);
+        setup = Get<osrm_profile_setup_fn>("osrm_profile_setup", true);
+        create_context = Get<osrm_profile_create_context_fn>("osrm_profile_create_context", true);
+        destroy_context =
+            Get<osrm_profile_destroy_context_fn>("osrm_profile_destroy_context", true);
+        process_nodes = Get<osrm_profile_process_nodes_fn>("osrm_profile_process_nodes", true);
+        process_ways = Get<osrm_profile_process_ways_fn>("osrm_profile_process_ways", true);
+        process_turns = Get<osrm_profile_process_turns_fn>("osrm_profile_process_turns", false);
+        process_segments =
+            Get<osrm_profile_process_segments_fn>("osrm_profile_process_segments", false);
+        name_suffixes = Get<osrm_profile_string_list_fn>("osrm_profile_name_suffixes", false);
+        restrictions = Get<osrm_profile_string_list_fn>("osrm_profile_restrictions", false);
+    }
+
+    ~NativeProfileLibrary()
+    {
+#ifdef _WIN32
+        FreeLibrary(handle);
+#else
+        dlclose(handle);
+#endif
+    }
+
+    template <typename FunctionT> FunctionT Get(const char *symbol, const bool required) const
+    {
+#ifdef _WIN32
+        auto function = reinterpret_cast<FunctionT>(GetProcAddress(handle, symbol));
+#else
+        auto function = reinterpret_cast<FunctionT>(dlsym(handle, symbol));
+#endif
+        if (!function && required)
+        {
+            throw util::exception("Profile library " + file_name + " does not export " +
+                                  std::string(symbol) + SOURCE_REF);
+        }
+        return function;
+    }
+
+    std::string file_name;
+#ifdef _WIN32
+    HMODULE handle;
+#else
+    void *handle;
+#endif
+
+    osrm_profile_api_version_fn api_version;
+    osrm_profile_setup_fn setup;
+    osrm_profile_create_context_fn create_context;
+    osrm_profile_destroy_context_fn destroy_context;
+    osrm_profile_process_nodes_fn process_nodes;
+    osrm_profile_process_ways_fn process_ways;
+    osrm_profile_process_turns_fn process_turns;
+    osrm_profile_process_segments_fn process_segments;
+    osrm_profile_string_list_fn name_suffixes;
+    osrm_profile_string_list_fn restrictions;
+};
+
+namespace
+{
+osrm_profile_properties toNative(const ProfileProperties &properties)
+{
+    osrm_profile_properties result;
+    std::copy_n(properties.weight_name, sizeof(result.weight_name), result.weight_name);
+    result.weight_precision = properties.weight_precision;
+    result.traffic_signal_penalty = properties.GetTrafficSignalPenalty();
+    result.u_turn_penalty = properties.GetUturnPenalty();
+    result.max_speed_for_map_matching = properties.GetMaxSpeedForMapMatching();
+    result.continue_straight_at_waypoint = properties.continue_straight_at_waypoint;
+    result.use_turn_restrictions = properties.use_turn_restrictions;
+    result.left_hand_driving = properties.left_hand_driving;
+    result.force_split_edges = properties.force_split_edges;
+    result.call_tagless_node_function = properties.call_tagless_node_function;
+    result.max_turn_weight = properties.GetMaxTurnWeight();
+    return result;
+}
+
+ProfileProperties fromNative(osrm_profile_properties properties)
+{
+    ProfileProperties result;
+    properties.weight_name[sizeof(properties.weight_name) - 1] = '\0';
+    result.SetWeightName(properties.weight_name);
+    result.weight_precision = properties.weight_precision;
+    result.SetTrafficSignalPenalty(properties.traffic_signal_penalty);
+    result.SetUturnPenalty(properties.u_turn_penalty);
+    result.SetMaxSpeedForMapMatching(properties.max_speed_for_map_matching);
+    result.continue_straight_at_waypoint = properties.continue_straight_at_waypoint != 0;
+    result.use_turn_restrictions = properties.use_turn_restrictions != 0;
+    result.left_hand_driving = properties.left_hand_driving != 0;
+    result.force_split_edges = properties.force_split_edges != 0;
+    result.call_tagless_node_function = properties.call_tagless_node_function != 0;
+    return result;
+}
+
+std::vector<std::string> toStrings(const osrm_profile_string_list_fn list)
+{
+    std::vector<std::string> result;
+    if (list)
+    {
+        for (auto entry = list(); entry && *entry; ++entry)
+        {
+            result.emplace_back(*entry);
+        }
+    }
+    return result;
+}
+
+// Appends the tags of an object, tags with empty values are skipped like in Lua profiles
+template <typename T> std::uint32_t addTags(const T &object, std::vector<osrm_tag> &tags)
+{
+    std::uint32_t count = 0;
+    for (const auto &tag : object.tags())
+    {
+        if (*tag.value())
+        {
+            tags.push_back(osrm_tag{tag.key(), tag.value()});
+            ++count;
+        }
+    }
+    return count;
+}
+
+osrm_way makeWay(const osmium::Way &way, const std::uint32_t num_tags)
+{
+    const ExtractionWay defaults;
+
+    osrm_way result;
+    result.id = way.id();
+    result.tags = nullptr;
+    result.num_tags = num_tags;
+    result.num_nodes = static_cast<std::uint32_t>(way.nodes().size());
+    result.forward_speed = defaults.forward_speed;
+    result.backward_speed = defaults.backward_speed;
+    result.forward_rate = defaults.forward_rate;
+    result.backward_rate = defaults.backward_rate;
+    result.duration = defaults.duration;
+    result.weight = defaults.weight;
+    result.forward_mode = defaults.forward_travel_mode;
+    result.backward_mode = defaults.backward_travel_mode;
+    result.roundabout = defaults.roundabout;
+    result.circular = defaults.circular;
+    result.is_startpoint = defaults.is_startpoint;
+    result.forward_restricted = defaults.forward_restricted;
+    result.backward_restricted = defaults.backward_restricted;
+    result.name = nullptr;
+    result.ref = nullptr;
+    result.pronunciation = nullptr;
+    result.destinations = nullptr;
+    result.turn_lanes_forward = nullptr;
+    result.turn_lanes_backward = nullptr;
+    result.motorway_class = defaults.road_classification.IsMotorwayClass();
+    result.link_class = defaults.road_classification.IsLinkClass();
+    result.may_be_ignored = defaults.road_classification.IsLowPriorityRoadClass();
+    result.road_priority_class = defaults.road_classification.GetClass();
+    result.num_lanes = defaults.road_classification.GetNumberOfLanes();
+    return result;
+}
+
+ExtractionWay fromNative(const osrm_way &way)
+{
+    ExtractionWay result;
+    result.forward_speed = way.forward_speed;
+    result.backward_speed = way.backward_speed;
+    result.forward_rate = way.forward_rate;
+    result.backward_rate = way.backward_rate;
+    result.duration = way.duration;
+    result.weight = way.weight;
+    result.forward_travel_mode = way.forward_mode;
+    result.backward_travel_mode = way.backward_mode;
+    result.roundabout = way.roundabout != 0;
+    result.circular = way.circular != 0;
+    result.is_startpoint = way.is_startpoint != 0;
+    result.forward_restricted = way.forward_restricted != 0;
+    result.backward_restricted = way.backward_restricted != 0;
+    result.SetName(way.name);
+    result.SetRef(way.ref);
+    result.SetPronunciation(way.pronunciation);
+    result.SetDestinations(way.destinations);
+    result.SetTurnLanesForward(way.turn_lanes_forward);
+    result.SetTurnLanesBackward(way.turn_lanes_backward);
+    result.road_classification.SetMotorwayFlag(way.motorway_class != 0);
+    result.road_classification.SetLinkClass(way.link_class != 0);
+    result.road_classification.SetLowPriorityFlag(way.may_be_ignored != 0);
+    result.road_classification.SetClass(way.road_priority_class);
+    result.road_classification.SetNumberOfLanes(way.num_lanes);
+    return result;
+}
+}
+
+NativeScriptingContext::NativeScriptingContext(const NativeProfileLibrary &library,
+                                               const osrm_profile_properties &properties)
+    : library(library), handle(library.create_context(&properties))
+{
+}
+
+NativeScriptingContext::~NativeScriptingContext() { library.destroy_context(handle); }
+
+NativeScriptingEnvironment::NativeScriptingEnvironment(const std::string &file_name)
+    : library(std::make_unique<NativeProfileLibrary>(file_name))
+{
+    util::Log() << "Using native profile " << file_name;
+
+    const auto api_version = library->api_version();
+    if (api_version != OSRM_NATIVE_PROFILE_API_VERSION)
+    {
+        throw util::exception("Invalid native profile API version " +
+                              std::to_string(api_version) + " only version " +
+                              std::to_string(OSRM_NATIVE_PROFILE_API_VERSION) +
+                              " is supported" + SOURCE_REF);
+    }
+
+    native_properties = toNative(ProfileProperties());
+    library->setup(&native_properties);
+    properties = fromNative(native_properties);
+    // the profile sees the derived values of the final properties
+    native_properties = toNative(properties);
+}
+
+NativeScriptingEnvironment::~NativeScriptingEnvironment()
+{
+    // contexts have to be destroyed while the library is still loaded
+    contexts.clear();
+}
+
+bool NativeScriptingEnvironment::IsNativeProfile(const std::string &file_name)
+{
+    const auto extension = boost::filesystem::path(file_name).extension();
+    return extension == ".so" || extension == ".dylib" || extension == ".dll";
+}
+
+const ProfileProperties &NativeScriptingEnvironment::GetProfileProperties() { return properties; }
+
+NativeScriptingContext &NativeScriptingEnvironment::GetContext()
+{
+    bool initialized = false;
+    auto &ref = contexts.local(initialized);
+    if (!initialized)
+    {
+        ref = std::make_unique<NativeScriptingContext>(*library, native_properties);
+    }
+
+    return *ref;
+}
+
+std::vector<std::string> NativeScriptingEnvironment::GetNameSuffixList()
+{
+    return toStrings(library->name_suffixes);
+}
+
+std::vector<std::string> NativeScriptingEnvironment::GetRestrictions()
+{
+    return toStrings(library->restrictions);
+}
+
+void NativeScriptingEnvironment::SetupSources()
+{
+    // raster sources are only available to Lua profiles
+}
+
+void NativeScriptingEnvironment::ProcessElements(
+    const osmium::memory::Buffer &buffer,
+    const RestrictionParser &restriction_parser,
+    std::vector<std::pair<const osmium::Node &, ExtractionNode>> &resulting_nodes,
+    std::vector<std::pair<const osmium::Way &, ExtractionWay>> &resulting_ways,
+    std::vector<boost::optional<InputRestrictionContainer>> &resulting_restrictions)
+{
+    auto &context = GetContext();
+    context.tags.clear();
+    context.nodes.clear();
+    context.ways.clear();
+
+    // nodes without tags are only passed to the profile if it asks for them
+    const auto process_node = [this](const osmium::Node &node) {
+        return !node.tags().empty() || properties.call_tagless_node_function;
+    };
+
+    // collect the batches, tags are referenced by offset until the tag vector is complete
+    std::vector<std::size_t> node_tag_offsets;
+    std::vector<std::size_t> way_tag_offsets;
+    for (auto entity = buffer.cbegin(), end = buffer.cend(); entity != end; ++entity)
+    {
+        switch (entity->type())
+        {
+        case osmium::item_type::node:
+        {
+            const auto &node = static_cast<const osmium::Node &>(*entity);
+            if (process_node(node))
+            {
+                node_tag_offsets.push_back(context.tags.size());
+                const auto num_tags = addTags(node, context.tags);
+                const auto location = node.location();
+                context.nodes.push_back(osrm_node{node.id(),
+                                                  location.valid() ? location.lon() : 0.,
+                                                  location.valid() ? location.lat() : 0.,
+                                                  nullptr,
+                                                  num_tags,
+                                                  0,
+                                                  0});
+            }
+            break;
+        }
+        case osmium::item_type::way:
+        {
+            const auto &way = static_cast<const osmium::Way &>(*entity);
+            way_tag_offsets.push_back(context.tags.size());
+            const auto num_tags = addTags(way, context.tags);
+            context.ways.push_back(makeWay(way, num_tags));
+            break;
+        }
+        case osmium::item_type::relation:
+            for (const auto &restriction :
+                 restriction_parser.TryParse(static_cast<const osmium::Relation &>(*entity)))
+            {
+                resulting_restrictions.push_back(restriction);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    for (std::size_t index = 0; index < context.nodes.size(); ++index)
+    {
+        context.nodes[index].tags = context.tags.data() + node_tag_offsets[index];
+    }
+    for (std::size_t index = 0; index < context.ways.size(); ++index)
+    {
+        context.ways[index].tags = context.tags.data() + way_tag_offsets[index];
+    }
+
+    if (!context.nodes.empty())
+    {
+        library->process_nodes(context.handle, context.nodes.data(), context.nodes.size());
+    }
+    if (!context.ways.empty())
+    {
+        library->process_ways(context.handle, context.ways.data(), context.ways.size());
+    }
+
+    // hand out the results in the order of the buffer
+    auto native_node = context.nodes.begin();
+    auto native_way = context.ways.begin();
+    ExtractionNode result_node;
+    for (auto entity = buffer.cbegin(), end = buffer.cend(); entity != end; ++entity)
+    {
+        switch (entity->type())
+        {
+        case osmium::item_type::node:
+        {
+            const auto &node = static_cast<const osmium::Node &>(*entity);
+            result_node.clear();
+            if (process_node(node))
+            {
+                BOOST_ASSERT(native_node != context.nodes.end());
+                result_node.barrier = native_node->barrier != 0;
+                result_node.traffic_lights = native_node->traffic_lights != 0;
+                ++native_node;
+            }
+            resulting_nodes.push_back(
+                std::pair<const osmium::Node &, ExtractionNode>(node, result_node));
+            break;
+        }
+        case osmium::item_type::way:
+            BOOST_ASSERT(native_way != context.ways.end());
+            resulting_ways.push_back(std::pair<const osmium::Way &, ExtractionWay>(
+                static_cast<const osmium::Way &>(*entity), fromNative(*native_way)));
+            ++native_way;
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+void NativeScriptingEnvironment::ProcessTurn(ExtractionTurn &turn) { ProcessTurns(&turn, 1); }
+
+void NativeScriptingEnvironment::ProcessSegment(ExtractionSegment &segment)
+{
+    ProcessSegments(&segment, 1);
+}
+
+void NativeScriptingEnvironment::ProcessTurns(std::vector<ExtractionTurn> &turns)
+{
+    ProcessTurns(turns.data(), turns.size());
+}
+
+void NativeScriptingEnvironment::ProcessSegments(std::vector<ExtractionSegment> &segments)
+{
+    ProcessSegments(segments.data(), segments.size());
+}
+
+void NativeScriptingEnvironment::ProcessTurns(ExtractionTurn *turns, const std::size_t count)
+{
+    if (!library->process_turns || count == 0)
+        return;
+
+    auto &context = GetContext();
+    context.turns.clear();
+    std::transform(turns, turns + count, std::back_inserter(context.turns), [](const auto &turn) {
+        return osrm_turn{turn.angle,
+                         turn.turn_type,
+                         turn.direction_modifier,
+                         turn.has_traffic_light,
+                         turn.source_restricted,
+                         turn.target_restricted,
+                         turn.weight,
+                         turn.duration};
+    });
+
+    library->process_turns(context.handle, context.turns.data(), count);
+
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        turns[index].weight = context.turns[index].weight;
+        turns[index].duration = context.turns[index].duration;
+
+        // Turn weight falls back to the duration value in deciseconds
+        // or uses the extracted unit-less weight value
+        if (properties.fallback_to_duration)
+            turns[index].weight = turns[index].duration;
+    }
+}
+
+void NativeScriptingEnvironment::ProcessSegments(ExtractionSegment *segments,
+                                                 const std::size_t count)
+{
+    if (!library->process_segments || count == 0)
+        return;
+
+    auto &context = GetContext();
+    context.segments.clear();
+    std::transform(
+        segments, segments + count, std::back_inserter(context.segments), [](const auto &segment) {
+            return osrm_segment{static_cast<double>(util::toFloating(segment.source.lon)),
+                                static_cast<double>(util::toFloating(segment.source.lat)),
+                                static_cast<double>(util::toFloating(segment.target.lon)),
+                                static_cast<double>(util::toFloating(segment.target.lat)),
+                                segment.distance,
+                                segment.weight,
+                                segment.duration};
+        });
+
+    library->process_segments(context.handle, context.segments.data(), count);
+
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        segments[index].weight = context.segments[index].weight;
+        segments[index].duration = context.segments[index].duration;
+    }
+}
+}
+}
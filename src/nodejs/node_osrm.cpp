@@ -11,6 +11,7 @@
 #include <exception>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "nodejs/node_osrm.hpp"
 #include "nodejs/node_osrm_support.hpp"
@@ -18,7 +19,11 @@
 namespace node_osrm
 {
 
-Engine::Engine(osrm::EngineConfig &config) : Base(), this_(std::make_shared<osrm::OSRM>(config)) {}
+Engine::Engine(osrm::EngineConfig &config, const WorkerPoolConfig &pool_config)
+    : Base(), this_(std::make_shared<osrm::OSRM>(config)),
+      pool(WorkerPool::Create(pool_config.num_threads, pool_config.max_queue_size))
+{
+}
 
 Nan::Persistent<v8::Function> &Engine::constructor()
 {
@@ -72,6 +77,10 @@ NAN_MODULE_INIT(Engine::Init)
  * @param {Boolean} [options.shared_memory] Connects to the persistent shared memory datastore.
  *        This requires you to run `osrm-datastore` prior to creating an `OSRM` object.
  * @param {String} [options.path] The path to the `.osrm` files. This is mutually exclusive with setting {options.shared_memory} to true.
+ * @param {Number} [options.threads] The number of threads that run the requests of this object, separate from the libuv thread pool.
+ *        Defaults to the number of cores.
+ * @param {Number} [options.max_queue_size=0] The maximum number of requests that wait for a thread. Requests beyond it fail with an error
+ *        in their callback, `0` does not limit the queue.
  *
  * @class OSRM
  *
@@ -87,7 +96,11 @@ NAN_METHOD(Engine::New)
             if (!config)
                 return;
 
-            auto *const self = new Engine(*config);
+            auto pool_config = argumentsToWorkerPoolConfig(info);
+            if (!pool_config)
+                return;
+
+            auto *const self = new Engine(*config, *pool_config);
             self->Wrap(info.This());
         }
         catch (const std::exception &ex)
@@ -116,6 +129,10 @@ inline void async(const Nan::FunctionCallbackInfo<v8::Value> &info,
 
     BOOST_ASSERT(params->IsValid());
 
+    PluginParameters plugin_params;
+    if (!argumentsToPluginParameters(info, plugin_params))
+        return;
+
     if (!info[info.Length() - 1]->IsFunction())
         return Nan::ThrowTypeError("last argument must be a callback function");
 
@@ -129,16 +146,24 @@ inline void async(const Nan::FunctionCallbackInfo<v8::Value> &info,
         Worker(std::shared_ptr<osrm::OSRM> osrm_,
                ParamPtr params_,
                ServiceMemFn service,
-               Nan::Callback *callback)
+               Nan::Callback *callback,
+               PluginParameters plugin_params_)
             : Base(callback), osrm{std::move(osrm_)}, service{std::move(service)},
-              params{std::move(params_)}
+              params{std::move(params_)}, plugin_params{std::move(plugin_params_)}
         {
         }
 
+        // for requests that are rejected before they are executed
+        using Base::SetErrorMessage;
+
         void Execute() override try
         {
             const auto status = ((*osrm).*(service))(*params, result);
             ParseResult(status, result);
+
+            // Serializing here keeps large results from blocking the event loop
+            if (plugin_params.renderJSONToBuffer)
+                renderToBuffer(result, buffer);
         }
         catch (const std::exception &e)
         {
@@ -150,7 +175,10 @@ inline void async(const Nan::FunctionCallbackInfo<v8::Value> &info,
             Nan::HandleScope scope;
 
             const constexpr auto argc = 2u;
-            v8::Local<v8::Value> argv[argc] = {Nan::Null(), render(result)};
+            v8::Local<v8::Value> argv[argc] = {Nan::Null(),
+                                               plugin_params.renderJSONToBuffer
+                                                   ? renderBuffer(std::move(buffer))
+                                                   : render(result)};
 
             callback->Call(argc, argv);
         }
@@ -159,6 +187,7 @@ inline void async(const Nan::FunctionCallbackInfo<v8::Value> &info,
         std::shared_ptr<osrm::OSRM> osrm;
         ServiceMemFn service;
         const ParamPtr params;
+        const PluginParameters plugin_params;
 
         // All services return json::Object .. except for Tile!
         using ObjectOrString =
@@ -167,10 +196,17 @@ inline void async(const Nan::FunctionCallbackInfo<v8::Value> &info,
                                       osrm::json::Object>::type;
 
         ObjectOrString result;
+        std::vector<char> buffer;
     };
 
     auto *callback = new Nan::Callback{info[info.Length() - 1].As<v8::Function>()};
-    Nan::AsyncQueueWorker(new Worker{self->this_, std::move(params), service, callback});
+    auto *const worker =
+        new Worker{self->this_, std::move(params), service, callback, plugin_params};
+    if (!self->pool->Queue(worker))
+    {
+        worker->SetErrorMessage("Too many queued requests, max_queue_size exceeded");
+        self->pool->Complete(worker);
+    }
 }
 
 // clang-format off
@@ -185,6 +221,7 @@ inline void async(const Nan::FunctionCallbackInfo<v8::Value> &info,
  *                                   Can be `null` or an array of `[{value},{range}]` with `integer 0 .. 360,integer 0 .. 180`.
  * @param {Array} [options.radiuses] Limits the coordinate snapping to streets in the given radius in meters. Can be `null` (unlimited, default) or `double >= 0`.
  * @param {Array} [options.hints] Hints for the coordinate snapping. Array of base64 encoded strings.
+ * @param {String} [options.hint_format=full] Format of the returned hints, `compact` hints stay valid across traffic updates.
  * @param {Boolean} [options.alternatives=false] Search for alternative routes and return as well.
  * *Please note that even if an alternative route is requested, a result cannot be guaranteed.*
  * @param {Boolean} [options.steps=false] Return route steps for each route leg.
@@ -193,6 +230,9 @@ inline void async(const Nan::FunctionCallbackInfo<v8::Value> &info,
  * @param {String} [options.overview=simplified] Add overview geometry either `full`, `simplified` according to highest zoom level it could be display on, or not at all (`false`).
  * @param {Boolean} [options.continue_straight] Forces the route to keep going straight at waypoints and don't do a uturn even if it would be faster. Default value depends on the profile.
  *                  `null`/`true`/`false`
+ * @param {Object} [plugin_config] - Plugin configuration.
+ * @param {String} [plugin_config.format=object] The format of the result. `json_buffer` returns the response serialized to JSON in a Buffer,
+ *        which does not block the event loop for large responses.
  * @param {Function} callback
  *
  * @returns {Object} An array of [Waypoint](#waypoint) objects representing all waypoints in order AND an array of [`Route`](#route) objects ordered by descending recommendation rank.
@@ -225,8 +265,12 @@ NAN_METHOD(Engine::route) //
  *                                   Can be `null` or an array of `[{value},{range}]` with `integer 0 .. 360,integer 0 .. 180`.
  * @param {Array} [options.radiuses] Limits the coordinate snapping to streets in the given radius in meters. Can be `null` (unlimited, default) or `double >= 0`.
  * @param {Array} [options.hints] Hints for the coordinate snapping. Array of base64 encoded strings.
+ * @param {String} [options.hint_format=full] Format of the returned hints, `compact` hints stay valid across traffic updates.
  * @param {Number} [options.number=1] Number of nearest segments that should be returned.
  * Must be an integer greater than or equal to `1`.
+ * @param {Object} [plugin_config] - Plugin configuration.
+ * @param {String} [plugin_config.format=object] The format of the result. `json_buffer` returns the response serialized to JSON in a Buffer,
+ *        which does not block the event loop for large responses.
  * @param {Function} callback
  *
  * @returns {Object} containing `waypoints`.
@@ -263,11 +307,15 @@ NAN_METHOD(Engine::nearest) //
  *                                   Can be `null` or an array of `[{value},{range}]` with `integer 0 .. 360,integer 0 .. 180`.
  * @param {Array} [options.radiuses] Limits the coordinate snapping to streets in the given radius in meters. Can be `null` (unlimited, default) or `double >= 0`.
  * @param {Array} [options.hints] Hints for the coordinate snapping. Array of base64 encoded strings.
+ * @param {String} [options.hint_format=full] Format of the returned hints, `compact` hints stay valid across traffic updates.
  * @param {Array} [options.sources] An array of `index` elements (`0 <= integer < #coordinates`) to
  * use
  * location with given index as source. Default is to use all.
  * @param {Array} [options.destinations] An array of `index` elements (`0 <= integer <
  * #coordinates`) to use location with given index as destination. Default is to use all.
+ * @param {Object} [plugin_config] - Plugin configuration.
+ * @param {String} [plugin_config.format=object] The format of the result. `json_buffer` returns the response serialized to JSON in a Buffer,
+ *        which does not block the event loop for large responses.
  * @param {Function} callback
  *
  * @returns {Object} containing `durations`, `sources`, and `destinations`.
@@ -343,12 +391,16 @@ NAN_METHOD(Engine::tile)
  * @param {Array} [options.bearings] Limits the search to segments with given bearing in degrees towards true north in clockwise direction.
  *                                   Can be `null` or an array of `[{value},{range}]` with `integer 0 .. 360,integer 0 .. 180`.
  * @param {Array} [options.hints] Hints for the coordinate snapping. Array of base64 encoded strings.
+ * @param {String} [options.hint_format=full] Format of the returned hints, `compact` hints stay valid across traffic updates.
  * @param {Boolean} [options.steps=false] Return route steps for each route.
  * @param {Array|Boolean} [options.annotations=false] An array with strings of `duration`, `nodes`, `distance`, `weight`, `datasources`, `speed` or boolean for enabling/disabling all.
  * @param {String} [options.geometries=polyline] Returned route geometry format (influences overview and per step). Can also be `geojson`.
  * @param {String} [options.overview=simplified] Add overview geometry either `full`, `simplified` according to highest zoom level it could be display on, or not at all (`false`).
  * @param {Array<Number>} [options.timestamps] Timestamp of the input location (integers, UNIX-like timestamp).
  * @param {Array} [options.radiuses] Standard deviation of GPS precision used for map matching. If applicable use GPS accuracy. Can be `null` for default value `5` meters or `double >= 0`.
+ * @param {Object} [plugin_config] - Plugin configuration.
+ * @param {String} [plugin_config.format=object] The format of the result. `json_buffer` returns the response serialized to JSON in a Buffer,
+ *        which does not block the event loop for large responses.
  * @param {Function} callback
  *
  * @returns {Object} containing `tracepoints` and `matchings`.
@@ -409,10 +461,14 @@ NAN_METHOD(Engine::match) //
  *                                   Can be `null` or an array of `[{value},{range}]` with `integer 0 .. 360,integer 0 .. 180`.
  * @param {Array} [options.radiuses] Limits the coordinate snapping to streets in the given radius in meters. Can be `double >= 0` or `null` (unlimited, default).
  * @param {Array} [options.hints] Hints for the coordinate snapping. Array of base64 encoded strings.
+ * @param {String} [options.hint_format=full] Format of the returned hints, `compact` hints stay valid across traffic updates.
  * @param {Boolean} [options.steps=false] Return route steps for each route.
  * @param {Array|Boolean} [options.annotations=false] An array with strings of `duration`, `nodes`, `distance`, `weight`, `datasources`, `speed` or boolean for enabling/disabling all.
  * @param {String} [options.geometries=polyline] Returned route geometry format (influences overview and per step). Can also be `geojson`.
  * @param {String} [options.overview=simplified] Add overview geometry either `full`, `simplified`
+ * @param {Object} [plugin_config] - Plugin configuration.
+ * @param {String} [plugin_config.format=object] The format of the result. `json_buffer` returns the response serialized to JSON in a Buffer,
+ *        which does not block the event loop for large responses.
  * @param {Function} callback
  * @param {Boolean} [options.roundtrip=true] Return route is a roundtrip.
  * @param {String} [options.source=any] Return route starts at `any` or `first` coordinate.
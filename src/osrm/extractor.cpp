@@ -2,6 +2,7 @@
 #include "extractor/extractor.hpp"
 #include "extractor/extractor_config.hpp"
 #include "extractor/scripting_environment_lua.hpp"
+#include "extractor/scripting_environment_native.hpp"
 
 namespace osrm
 {
@@ -10,8 +11,17 @@ namespace osrm
 
 void extract(const extractor::ExtractorConfig &config)
 {
-    extractor::Sol2ScriptingEnvironment scripting_environment(config.profile_path.string().c_str());
-    extractor::Extractor(config).run(scripting_environment);
+    const auto profile_path = config.profile_path.string();
+    if (extractor::NativeScriptingEnvironment::IsNativeProfile(profile_path))
+    {
+        extractor::NativeScriptingEnvironment scripting_environment(profile_path);
+        extractor::Extractor(config).run(scripting_environment);
+    }
+    else
+    {
+        extractor::Sol2ScriptingEnvironment scripting_environment(profile_path.c_str());
+        extractor::Extractor(config).run(scripting_environment);
+    }
 }
 
 } // ns osrm
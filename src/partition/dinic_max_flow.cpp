@@ -7,6 +7,7 @@
 #include <queue>
 #include <set>
 #include <stack>
+#include <utility>
 
 namespace osrm
 {
@@ -31,6 +32,82 @@ auto makeHasNeighborNotInCheck(const DinicMaxFlow::SourceSinkNodes &set, const G
 
 } // end namespace
 
+DinicMaxFlow::FlowEdges::FlowEdges(const GraphView &view)
+{
+    const auto number_of_nodes = view.NumberOfNodes();
+    first_edge.reserve(number_of_nodes + 1);
+    first_edge.push_back(0);
+    for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+        first_edge.push_back(first_edge.back() + std::distance(view.BeginEdges(node),
+                                                               view.EndEdges(node)));
+
+    // positions of the edges of each node sorted by their target
+    std::vector<EdgeID> sorted_edges(first_edge.back());
+    std::iota(sorted_edges.begin(), sorted_edges.end(), 0);
+    const auto target = [&](const NodeID node, const EdgeID edge) {
+        return (view.BeginEdges(node) + (edge - first_edge[node]))->target;
+    };
+    for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+    {
+        std::sort(sorted_edges.begin() + first_edge[node],
+                  sorted_edges.begin() + first_edge[node + 1],
+                  [&](const EdgeID lhs, const EdgeID rhs) {
+                      return std::make_pair(target(node, lhs), lhs) <
+                             std::make_pair(target(node, rhs), rhs);
+                  });
+    }
+
+    // parallel edges use the flow of the first of them
+    flow_id.resize(first_edge.back());
+    for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+    {
+        for (auto index = first_edge[node]; index < first_edge[node + 1]; ++index)
+        {
+            const auto edge = sorted_edges[index];
+            const auto is_parallel = index > first_edge[node] &&
+                                     target(node, edge) == target(node, sorted_edges[index - 1]);
+            flow_id[edge] = is_parallel ? flow_id[sorted_edges[index - 1]] : edge;
+        }
+    }
+
+    // The graph is undirected, but we don't rely on it: edges without an opposite edge
+    // get a new flow id for their opposite direction, appended behind the edge ids and
+    // mapping back to the edge.
+    reverse.resize(first_edge.back());
+    for (const auto node : util::irange<NodeID>(0, number_of_nodes))
+    {
+        for (auto index = first_edge[node]; index < first_edge[node + 1]; ++index)
+        {
+            const auto edge = sorted_edges[index];
+            if (flow_id[edge] != edge)
+            {
+                reverse[edge] = reverse[flow_id[edge]];
+                continue;
+            }
+
+            const auto other = target(node, edge);
+            const auto begin = sorted_edges.begin() + first_edge[other];
+            const auto end = sorted_edges.begin() + first_edge[other + 1];
+            const auto opposite = std::lower_bound(
+                begin, end, node, [&](const EdgeID other_edge, const NodeID value) {
+                    return target(other, other_edge) < value;
+                });
+            if (opposite != end && target(other, *opposite) == node)
+            {
+                reverse[edge] = flow_id[*opposite];
+            }
+            else
+            {
+                const EdgeID opposite_flow_id = reverse.size();
+                reverse.push_back(edge);
+                reverse[edge] = opposite_flow_id;
+            }
+        }
+    }
+
+    flow.resize(reverse.size(), false);
+}
+
 DinicMaxFlow::MinCut DinicMaxFlow::operator()(const GraphView &view,
                                               const SourceSinkNodes &source_nodes,
                                               const SourceSinkNodes &sink_nodes) const
@@ -63,12 +140,19 @@ DinicMaxFlow::MinCut DinicMaxFlow::operator()(const GraphView &view,
     // from `t` to `s`, we can remove `(s,t)` from the flow, if we send flow back the first time,
     // and insert `(t,s)` only if we send flow again.
 
+    NodeFlags is_source(view.NumberOfNodes(), false);
+    for (const auto node : source_nodes)
+        is_source[node] = true;
+    NodeFlags is_sink(view.NumberOfNodes(), false);
+    for (const auto node : sink_nodes)
+        is_sink[node] = true;
+
     // allocate storage for the flow
-    FlowEdges flow(view.NumberOfNodes());
+    FlowEdges flow(view);
     std::size_t flow_value = 0;
     do
     {
-        auto levels = ComputeLevelGraph(view, border_source_nodes, source_nodes, sink_nodes, flow);
+        auto levels = ComputeLevelGraph(view, border_source_nodes, is_source, is_sink, flow);
 
         // check if the sink can be reached from the source, it's enough to check the border
         const auto separated = std::find_if(border_sink_nodes.begin(),
@@ -79,7 +163,7 @@ DinicMaxFlow::MinCut DinicMaxFlow::operator()(const GraphView &view,
 
         if (!separated)
         {
-            flow_value += BlockingFlow(flow, levels, view, source_nodes, border_sink_nodes);
+            flow_value += BlockingFlow(flow, levels, view, is_source, border_sink_nodes);
         }
         else
         {
@@ -114,8 +198,8 @@ DinicMaxFlow::MinCut DinicMaxFlow::MakeCut(const GraphView &view,
 DinicMaxFlow::LevelGraph
 DinicMaxFlow::ComputeLevelGraph(const GraphView &view,
                                 const std::vector<NodeID> &border_source_nodes,
-                                const SourceSinkNodes &source_nodes,
-                                const SourceSinkNodes &sink_nodes,
+                                const NodeFlags &is_source,
+                                const NodeFlags &is_sink,
                                 const FlowEdges &flow) const
 {
     LevelGraph levels(view.NumberOfNodes(), INVALID_LEVEL);
@@ -129,26 +213,22 @@ DinicMaxFlow::ComputeLevelGraph(const GraphView &view,
         levels[node_id] = 0;
         level_queue.push(node_id);
         for (const auto &edge : view.Edges(node_id))
-            if (source_nodes.count(edge.target))
+            if (is_source[edge.target])
                 levels[edge.target] = 0;
     }
-    // check if there is flow present on an edge
-    const auto has_flow = [&](const NodeID from, const NodeID to) {
-        return flow[from].find(to) != flow[from].end();
-    };
-
     // perform a relaxation step in the BFS algorithm
     const auto relax_node = [&](const NodeID node_id) {
         // don't relax sink nodes
-        if (sink_nodes.count(node_id))
+        if (is_sink[node_id])
             return;
 
         const auto level = levels[node_id] + 1;
-        for (const auto &edge : view.Edges(node_id))
+        for (auto edge = view.BeginEdges(node_id), end = view.EndEdges(node_id); edge != end;
+             ++edge)
         {
-            const auto target = edge.target;
+            const auto target = edge->target;
             // don't relax edges with flow on them
-            if (has_flow(node_id, target))
+            if (flow.HasFlow(flow.GetEdge(node_id, edge, view)))
                 continue;
 
             // don't go back, only follow edges to new nodes
@@ -173,31 +253,17 @@ DinicMaxFlow::ComputeLevelGraph(const GraphView &view,
 std::size_t DinicMaxFlow::BlockingFlow(FlowEdges &flow,
                                        LevelGraph &levels,
                                        const GraphView &view,
-                                       const SourceSinkNodes &source_nodes,
+                                       const NodeFlags &is_source,
                                        const std::vector<NodeID> &border_sink_nodes) const
 {
     // track the number of augmenting paths (which in sum will equal the number of unique border
     // edges) (since our graph is undirected)
     std::size_t flow_increase = 0;
 
-    // augment the flow along a path in the level graph
-    const auto augment_flow = [&flow, &view](const std::vector<NodeID> &path) {
-
-        // add/remove flow edges from the current residual graph
-        const auto augment_one = [&flow, &view](const NodeID from, const NodeID to) {
-            // check if there is flow in the opposite direction
-            auto existing_edge = flow[to].find(from);
-            if (existing_edge != flow[to].end())
-                flow[to].erase(existing_edge); // remove flow from reverse edges first
-            else
-                flow[from].insert(to); // only add flow if no opposite flow exists
-
-            // do augmentation on all pairs, never stop early:
-            return false;
-        };
-
-        // augment all adjacent edges
-        std::adjacent_find(path.begin(), path.end(), augment_one);
+    // augment the flow along a path in the level graph, removing flow from reverse edges first
+    const auto augment_flow = [&flow](const std::vector<EdgeID> &path) {
+        for (const auto edge : path)
+            flow.Augment(edge);
     };
 
     const auto augment_all_paths = [&](const NodeID sink_node_id) {
@@ -208,7 +274,7 @@ std::size_t DinicMaxFlow::BlockingFlow(FlowEdges &flow,
         while (true)
         {
             // as long as there are augmenting paths from the sink, add them
-            const auto path = GetAugmentingPath(levels, sink_node_id, view, flow, source_nodes);
+            const auto path = GetAugmentingPath(levels, sink_node_id, view, flow, is_source);
             if (path.empty())
                 break;
             else
@@ -226,14 +292,16 @@ std::size_t DinicMaxFlow::BlockingFlow(FlowEdges &flow,
 
 // performs a dfs in the level graph, by adjusting levels that don't offer any further paths to
 // INVALID_LEVEL and by following the level graph, this looks at every edge at most `c` times (O(E))
-std::vector<NodeID> DinicMaxFlow::GetAugmentingPath(LevelGraph &levels,
+std::vector<EdgeID> DinicMaxFlow::GetAugmentingPath(LevelGraph &levels,
                                                     const NodeID node_id,
                                                     const GraphView &view,
                                                     const FlowEdges &flow,
-                                                    const SourceSinkNodes &source_nodes) const
+                                                    const NodeFlags &is_source) const
 {
     std::vector<NodeID> path;
-    BOOST_ASSERT(source_nodes.find(node_id) == source_nodes.end());
+    // flow ids of the edges between the nodes of the path, in the direction of the flow
+    std::vector<EdgeID> path_edges;
+    BOOST_ASSERT(!is_source[node_id]);
 
     // Keeps the local state of the DFS in forms of the iterators
     struct DFSState
@@ -255,25 +323,29 @@ std::vector<NodeID> DinicMaxFlow::GetAugmentingPath(LevelGraph &levels,
         while (dfs_stack.top().edge_iterator != dfs_stack.top().end_iterator)
         {
             const auto target = dfs_stack.top().edge_iterator->target;
+            // the flow goes from the target to the current node (last in path)
+            const auto edge = flow.Reverse(
+                flow.GetEdge(path.back(), dfs_stack.top().edge_iterator, view));
 
             // look at every edge only once, so advance the state of the current node (last in
             // path)
             dfs_stack.top().edge_iterator++;
 
             // check if the edge is valid
-            const auto has_capacity = flow[target].count(path.back()) == 0;
+            const auto has_capacity = !flow.HasFlow(edge);
             const auto descends_level_graph = levels[target] + 1 == levels[path.back()];
 
             if (has_capacity && descends_level_graph)
             {
                 // recurse
                 path.push_back(target);
+                path_edges.push_back(edge);
 
                 // termination
-                if (source_nodes.find(target) != source_nodes.end())
+                if (is_source[target])
                 {
-                    std::reverse(path.begin(), path.end());
-                    return path;
+                    std::reverse(path_edges.begin(), path_edges.end());
+                    return path_edges;
                 }
 
                 // start next iteration
@@ -284,10 +356,13 @@ std::vector<NodeID> DinicMaxFlow::GetAugmentingPath(LevelGraph &levels,
         // backtrack - mark that there is no way to the target
         levels[path.back()] = -1;
         path.pop_back();
+        if (!path_edges.empty())
+            path_edges.pop_back();
         dfs_stack.pop();
     }
     BOOST_ASSERT(path.empty());
-    return path;
+    BOOST_ASSERT(path_edges.empty());
+    return path_edges;
 }
 
 bool DinicMaxFlow::Validate(const GraphView &view,
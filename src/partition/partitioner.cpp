@@ -10,6 +10,8 @@
 #include "partition/remove_unconnected.hpp"
 #include "partition/renumber.hpp"
 
+#include "storage/manifest.hpp"
+
 #include "extractor/files.hpp"
 
 #include "util/coordinate.hpp"
@@ -198,6 +200,13 @@ int Partitioner::Run(const PartitionConfig &config)
                                  "osrm-contract after osrm-partition.";
         boost::filesystem::remove(config.hsgr_path);
     }
+    if (boost::filesystem::exists(config.mld_graph_path))
+    {
+        // osrm-customize would otherwise only update the cells that changed against this graph
+        util::Log(logWARNING) << "Found existing .osrm.mldgr file, removing. You need to re-run "
+                                 "osrm-customize after osrm-partition.";
+        boost::filesystem::remove(config.mld_graph_path);
+    }
     TIMER_STOP(renumber);
     util::Log() << "Renumbered data in " << TIMER_SEC(renumber) << " seconds";
 
@@ -217,6 +226,10 @@ int Partitioner::Run(const PartitionConfig &config)
     extractor::files::writeEdgeBasedGraph(config.edge_based_graph_path,
                                           edge_based_graph.GetNumberOfNodes() - 1,
                                           graphToEdges(edge_based_graph));
+    storage::manifest::updateManifest(
+        boost::filesystem::path{config.partition_path}.replace_extension(),
+        {".fileIndex", ".ebg_nodes", ".partition", ".cells"},
+        false);
     TIMER_STOP(writing_mld_data);
     util::Log() << "MLD data writing took " << TIMER_SEC(writing_mld_data) << " seconds";
 
@@ -4,6 +4,7 @@
 #include "partition/graph_view.hpp"
 #include "partition/recursive_bisection_state.hpp"
 
+#include "util/integer_range.hpp"
 #include "util/log.hpp"
 #include "util/timing_util.hpp"
 
@@ -13,6 +14,7 @@
 #include <climits> // for CHAR_BIT
 #include <cstddef>
 #include <iterator>
+#include <mutex>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -66,12 +68,37 @@ RecursiveBisection::RecursiveBisection(BisectionGraph &bisection_graph_,
 
     using Feeder = tbb::parallel_do_feeder<TreeNode>;
 
+    // Summary of all cuts on the same depth of the bisection trees
+    struct LevelStatistics
+    {
+        std::size_t num_cuts = 0;
+        std::size_t num_nodes = 0;
+        std::size_t num_cut_edges = 0;
+        double cut_seconds = 0;
+    };
+    std::vector<LevelStatistics> level_statistics;
+    std::mutex level_statistics_lock;
+
     TIMER_START(bisection);
 
     // Bisect graph into two parts. Get partition point and recurse left and right in parallel.
     tbb::parallel_do(begin(forest), end(forest), [&](const TreeNode &node, Feeder &feeder) {
+        TIMER_START(cut);
         const auto cut =
             computeInertialFlowCut(node.graph, num_optimizing_cuts, balance, boundary_factor);
+        TIMER_STOP(cut);
+
+        {
+            std::lock_guard<std::mutex> guard{level_statistics_lock};
+            if (level_statistics.size() <= node.depth)
+                level_statistics.resize(node.depth + 1);
+            auto &statistics = level_statistics[node.depth];
+            statistics.num_cuts++;
+            statistics.num_nodes += node.graph.NumberOfNodes();
+            statistics.num_cut_edges += cut.num_edges;
+            statistics.cut_seconds += TIMER_SEC(cut);
+        }
+
         const auto center = internal_state.ApplyBisection(
             node.graph.Begin(), node.graph.End(), node.depth, cut.flags);
 
@@ -97,6 +124,17 @@ RecursiveBisection::RecursiveBisection(BisectionGraph &bisection_graph_,
 
     TIMER_STOP(bisection);
 
+    for (const auto depth : util::irange<std::size_t>(0, level_statistics.size()))
+    {
+        const auto &statistics = level_statistics[depth];
+        if (statistics.num_cuts == 0)
+            continue;
+
+        util::Log() << "Bisection depth " << depth << ": " << statistics.num_cuts << " cuts of "
+                    << statistics.num_nodes << " nodes with " << statistics.num_cut_edges
+                    << " cut edges in " << statistics.cut_seconds << "s (summed over threads)";
+    }
+
     util::Log() << "Full bisection done in " << TIMER_SEC(bisection) << "s";
 }
 
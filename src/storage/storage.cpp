@@ -33,6 +33,7 @@
 #include "util/exception_utils.hpp"
 #include "util/fingerprint.hpp"
 #include "util/log.hpp"
+#include "util/packed_coordinate_vector.hpp"
 #include "util/packed_vector.hpp"
 #include "util/range_table.hpp"
 #include "util/static_graph.hpp"
@@ -70,32 +71,44 @@ using EdgeBasedGraph = util::StaticGraph<extractor::EdgeBasedEdge::EdgeData>;
 
 using Monitor = SharedMonitor<SharedDataTimestamp>;
 
-Storage::Storage(StorageConfig config_) : config(std::move(config_)) {}
-
-int Storage::Run(int max_wait)
+namespace
 {
-    BOOST_ASSERT_MSG(config.IsValid(), "Invalid storage config");
-
-    util::LogPolicy::GetInstance().Unmute();
-
-    boost::filesystem::path lock_path =
-        boost::filesystem::temp_directory_path() / "osrm-datastore.lock";
-    if (!boost::filesystem::exists(lock_path))
+// Serializes all processes that write to shared memory regions
+class DatastoreLock
+{
+  public:
+    DatastoreLock()
+        : lock_path(createLockFile()), file_lock(lock_path.c_str()),
+          datastore_lock(file_lock, boost::interprocess::defer_lock)
     {
-        boost::filesystem::ofstream ofs(lock_path);
+        if (!datastore_lock.try_lock())
+        {
+            util::UnbufferedLog(logWARNING)
+                << "Data update in progress, waiting until it finishes... ";
+            datastore_lock.lock();
+            util::UnbufferedLog(logWARNING) << "ok.";
+        }
     }
 
-    boost::interprocess::file_lock file_lock(lock_path.string().c_str());
-    boost::interprocess::scoped_lock<boost::interprocess::file_lock> datastore_lock(
-        file_lock, boost::interprocess::defer_lock);
-
-    if (!datastore_lock.try_lock())
+  private:
+    static std::string createLockFile()
     {
-        util::UnbufferedLog(logWARNING) << "Data update in progress, waiting until it finishes... ";
-        datastore_lock.lock();
-        util::UnbufferedLog(logWARNING) << "ok.";
+        boost::filesystem::path lock_path =
+            boost::filesystem::temp_directory_path() / "osrm-datastore.lock";
+        if (!boost::filesystem::exists(lock_path))
+        {
+            boost::filesystem::ofstream ofs(lock_path);
+        }
+        return lock_path.string();
     }
 
+    const std::string lock_path;
+    boost::interprocess::file_lock file_lock;
+    boost::interprocess::scoped_lock<boost::interprocess::file_lock> datastore_lock;
+};
+
+void lockMemory()
+{
 #ifdef __linux__
     // try to disable swapping on Linux
     const bool lock_flags = MCL_CURRENT | MCL_FUTURE;
@@ -104,12 +117,10 @@ int Storage::Run(int max_wait)
         util::Log(logWARNING) << "Could not request RAM lock";
     }
 #endif
+}
 
-    // Get the next region ID and time stamp without locking shared barriers.
-    // Because of datastore_lock the only write operation can occur sequentially later.
-    Monitor monitor(SharedDataTimestamp{REGION_NONE, 0});
-    auto in_use_region = monitor.data().region;
-    auto next_timestamp = monitor.data().timestamp + 1;
+SharedDataType getNextRegion(const SharedDataType in_use_region)
+{
     auto next_region =
         in_use_region == REGION_2 || in_use_region == REGION_NONE ? REGION_1 : REGION_2;
 
@@ -125,22 +136,16 @@ int Storage::Run(int max_wait)
         util::UnbufferedLog() << "ok.";
     }
 
-    util::Log() << "Loading data into " << regionToString(next_region);
-
-    // Populate a memory layout into stack memory
-    DataLayout layout;
-    PopulateLayout(layout);
-
-    // Allocate shared memory block
-    auto regions_size = sizeof(layout) + layout.GetSizeOfLayout();
-    util::Log() << "Allocating shared memory of " << regions_size << " bytes";
-    auto data_memory = makeSharedMemory(next_region, regions_size);
-
-    // Copy memory layout to shared memory and populate data
-    char *shared_memory_ptr = static_cast<char *>(data_memory->Ptr());
-    memcpy(shared_memory_ptr, &layout, sizeof(layout));
-    PopulateData(layout, shared_memory_ptr + sizeof(layout));
+    return next_region;
+}
 
+// Switches all clients to the next region and removes the region that was in use
+void publishRegion(Monitor &monitor,
+                   SharedDataType in_use_region,
+                   const SharedDataType next_region,
+                   const unsigned next_timestamp,
+                   const int max_wait)
+{
     { // Lock for write access shared region mutex
         boost::interprocess::scoped_lock<Monitor::mutex_type> lock(monitor.get_mutex(),
                                                                    boost::interprocess::defer_lock);
@@ -193,6 +198,84 @@ int Storage::Run(int max_wait)
     }
 
     util::Log() << "All clients switched.";
+}
+}
+
+Storage::Storage(StorageConfig config_) : config(std::move(config_)) {}
+
+int Storage::Run(int max_wait)
+{
+    BOOST_ASSERT_MSG(config.IsValid(), "Invalid storage config");
+
+    util::LogPolicy::GetInstance().Unmute();
+
+    DatastoreLock datastore_lock;
+
+    lockMemory();
+
+    // Get the next region ID and time stamp without locking shared barriers.
+    // Because of datastore_lock the only write operation can occur sequentially later.
+    Monitor monitor(SharedDataTimestamp{REGION_NONE, 0});
+    auto in_use_region = monitor.data().region;
+    auto next_timestamp = monitor.data().timestamp + 1;
+    auto next_region = getNextRegion(in_use_region);
+
+    util::Log() << "Loading data into " << regionToString(next_region);
+
+    // Populate a memory layout into stack memory
+    DataLayout layout;
+    PopulateLayout(layout);
+
+    // Allocate shared memory block
+    auto regions_size = sizeof(layout) + layout.GetSizeOfLayout();
+    util::Log() << "Allocating shared memory of " << regions_size << " bytes";
+    auto data_memory = makeSharedMemory(next_region, regions_size);
+
+    // Copy memory layout to shared memory and populate data
+    char *shared_memory_ptr = static_cast<char *>(data_memory->Ptr());
+    memcpy(shared_memory_ptr, &layout, sizeof(layout));
+    PopulateData(layout, shared_memory_ptr + sizeof(layout));
+
+    publishRegion(monitor, in_use_region, next_region, next_timestamp, max_wait);
+
+    return EXIT_SUCCESS;
+}
+
+int Storage::Update(int max_wait, const UpdateFunction &update)
+{
+    util::LogPolicy::GetInstance().Unmute();
+
+    DatastoreLock datastore_lock;
+
+    lockMemory();
+
+    Monitor monitor(SharedDataTimestamp{REGION_NONE, 0});
+    auto in_use_region = monitor.data().region;
+    auto next_timestamp = monitor.data().timestamp + 1;
+    if (in_use_region == REGION_NONE || !storage::SharedMemory::RegionExists(in_use_region))
+    {
+        throw util::exception("No data loaded into shared memory, run osrm-datastore first" +
+                              SOURCE_REF);
+    }
+    auto next_region = getNextRegion(in_use_region);
+
+    // Clients only read the region in use, so it can be copied while they are attached
+    auto in_use_memory = makeSharedMemory(in_use_region);
+    const auto in_use_ptr = static_cast<const char *>(in_use_memory->Ptr());
+    DataLayout layout;
+    memcpy(&layout, in_use_ptr, sizeof(layout));
+
+    auto regions_size = sizeof(layout) + layout.GetSizeOfLayout();
+    util::Log() << "Copying " << regions_size << " bytes from " << regionToString(in_use_region)
+                << " into " << regionToString(next_region);
+    auto data_memory = makeSharedMemory(next_region, regions_size);
+    char *shared_memory_ptr = static_cast<char *>(data_memory->Ptr());
+    memcpy(shared_memory_ptr, in_use_ptr, regions_size);
+    in_use_memory.reset();
+
+    update(layout, shared_memory_ptr + sizeof(layout));
+
+    publishRegion(monitor, in_use_region, next_region, next_timestamp, max_wait);
 
     return EXIT_SUCCESS;
 }
@@ -332,9 +415,14 @@ void Storage::PopulateLayout(DataLayout &layout)
     {
         io::FileReader node_file(config.node_based_nodes_data_path,
                                  io::FileReader::VerifyFingerprint);
-        const auto coordinate_list_size = node_file.ReadElementCount64();
-        layout.SetBlockSize<util::Coordinate>(DataLayout::COORDINATE_LIST, coordinate_list_size);
-        node_file.Skip<util::Coordinate>(coordinate_list_size);
+        const auto num_coordinate_blocks =
+            node_file.ReadVectorSize<util::PackedCoordinateVectorView::BlockHeader>();
+        const auto num_coordinate_words =
+            node_file.ReadVectorSize<util::PackedCoordinateVectorView::block_type>();
+        layout.SetBlockSize<util::PackedCoordinateVectorView::BlockHeader>(
+            DataLayout::COORDINATE_BLOCKS, num_coordinate_blocks);
+        layout.SetBlockSize<util::PackedCoordinateVectorView::block_type>(
+            DataLayout::COORDINATE_LIST, num_coordinate_words);
         // skip number of elements
         node_file.Skip<std::uint64_t>(1);
         const auto num_id_blocks = node_file.ReadElementCount64();
@@ -729,17 +817,25 @@ void Storage::PopulateData(const DataLayout &layout, char *memory_ptr)
 
     // Loading list of coordinates
     {
-        const auto coordinates_ptr =
-            layout.GetBlockPtr<util::Coordinate, true>(memory_ptr, DataLayout::COORDINATE_LIST);
+        const auto coordinate_blocks_ptr =
+            layout.GetBlockPtr<util::PackedCoordinateVectorView::BlockHeader, true>(
+                memory_ptr, DataLayout::COORDINATE_BLOCKS);
+        const auto coordinate_words_ptr =
+            layout.GetBlockPtr<util::PackedCoordinateVectorView::block_type, true>(
+                memory_ptr, DataLayout::COORDINATE_LIST);
         const auto osmnodeid_ptr =
             layout.GetBlockPtr<extractor::PackedOSMIDsView::block_type, true>(
                 memory_ptr, DataLayout::OSM_NODE_ID_LIST);
-        util::vector_view<util::Coordinate> coordinates(
-            coordinates_ptr, layout.num_entries[DataLayout::COORDINATE_LIST]);
+        util::PackedCoordinateVectorView coordinates(
+            util::vector_view<util::PackedCoordinateVectorView::BlockHeader>(
+                coordinate_blocks_ptr, layout.num_entries[DataLayout::COORDINATE_BLOCKS]),
+            util::vector_view<util::PackedCoordinateVectorView::block_type>(
+                coordinate_words_ptr, layout.num_entries[DataLayout::COORDINATE_LIST]));
+        // the number of ids is read from the file
         extractor::PackedOSMIDsView osm_node_ids(
             util::vector_view<extractor::PackedOSMIDsView::block_type>(
                 osmnodeid_ptr, layout.num_entries[DataLayout::OSM_NODE_ID_LIST]),
-            layout.num_entries[DataLayout::COORDINATE_LIST]);
+            0);
 
         extractor::files::readNodes(config.node_based_nodes_data_path, coordinates, osm_node_ids);
     }
@@ -1,4 +1,5 @@
 #include "storage/storage_config.hpp"
+#include "storage/manifest.hpp"
 #include "util/log.hpp"
 
 #include <boost/filesystem/operations.hpp>
@@ -38,7 +39,7 @@ StorageConfig::StorageConfig(const boost::filesystem::path &base)
       intersection_class_path{base.string() + ".icd"}, turn_lane_data_path{base.string() + ".tld"},
       turn_lane_description_path{base.string() + ".tls"},
       mld_partition_path{base.string() + ".partition"}, mld_storage_path{base.string() + ".cells"},
-      mld_graph_path{base.string() + ".mldgr"}
+      mld_graph_path{base.string() + ".mldgr"}, manifest_path{base.string() + ".manifest"}
 {
 }
 
@@ -62,6 +63,14 @@ bool StorageConfig::IsValid() const
         return false;
     }
 
+    // Detects files that were replaced without re-running the pipeline tools
+    if (boost::filesystem::exists(manifest_path) &&
+        !manifest::checkManifest(boost::filesystem::path{manifest_path}.replace_extension(),
+                                 manifest::readManifest(manifest_path)))
+    {
+        return false;
+    }
+
     return true;
 }
 }
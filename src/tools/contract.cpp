@@ -58,6 +58,15 @@ return_code parseArguments(int argc, char *argv[], contractor::ContractorConfig
         boost::program_options::value<bool>(&contractor_config.use_cached_priority)
             ->default_value(false),
         "Use .level file to retain the contaction level for each node from the last run.")(
+        "customizable",
+        boost::program_options::bool_switch(&contractor_config.customizable)->default_value(false),
+        "Contract the graph into a metric-independent hierarchy that is stored in the .cch file. "
+        "Following runs only recompute the shortcut weights from the updated edge weights.")(
+        "memory-bounded",
+        boost::program_options::bool_switch(&contractor_config.memory_bounded)
+            ->default_value(false),
+        "Compact the remaining graph repeatedly during contraction to lower the peak memory "
+        "usage.")(
         "edge-weight-updates-over-factor",
         boost::program_options::value<double>(
             &contractor_config.updater_config.log_edge_updates_factor)
@@ -36,6 +36,12 @@ parseArguments(int argc, char *argv[], customizer::CustomizationConfig &customiz
          boost::program_options::value<unsigned int>(&customization_config.requested_num_threads)
              ->default_value(tbb::task_scheduler_init::default_num_threads()),
          "Number of threads to use")(
+            "incremental",
+            boost::program_options::value<bool>(&customization_config.incremental)
+                ->implicit_value(true)
+                ->default_value(true),
+            "Only customize cells that contain edges whose weight changed since the last run "
+            "of osrm-customize")(
             "segment-speed-file",
             boost::program_options::value<std::vector<std::string>>(
                 &customization_config.updater_config.segment_speed_lookup_paths)
@@ -36,7 +36,7 @@ return_code parseArguments(int argc, char *argv[], extractor::ExtractorConfig &e
         "profile,p",
         boost::program_options::value<boost::filesystem::path>(&extractor_config.profile_path)
             ->default_value("profiles/car.lua"),
-        "Path to LUA routing profile")(
+        "Path to LUA routing profile or compiled profile library (.so, .dylib, .dll)")(
         "threads,t",
         boost::program_options::value<unsigned int>(&extractor_config.requested_num_threads)
             ->default_value(tbb::task_scheduler_init::default_num_threads()),
@@ -46,6 +46,11 @@ return_code parseArguments(int argc, char *argv[], extractor::ExtractorConfig &e
             ->default_value(1000),
         "Number of nodes required before a strongly-connected-componennt is considered big "
         "(affects nearest neighbor snapping)")(
+        "sort-memory",
+        boost::program_options::value<unsigned int>(&extractor_config.sort_memory)
+            ->default_value(4096),
+        "Memory in MiB for sorting the parsed data in memory, larger data is sorted "
+        "in external memory with stxxl")(
         "with-osm-metadata",
         boost::program_options::bool_switch(&extractor_config.use_metadata)
             ->implicit_value(true)
@@ -0,0 +1,332 @@
+#include "util/coordinate.hpp"
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+#include "util/log.hpp"
+#include "util/timing_util.hpp"
+#include "util/version.hpp"
+#include "util/web_mercator.hpp"
+
+#include "osrm/engine_config.hpp"
+#include "osrm/osrm.hpp"
+#include "osrm/status.hpp"
+#include "osrm/storage_config.hpp"
+#include "osrm/tile_parameters.hpp"
+
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/program_options.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_scheduler_init.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace osrm;
+
+namespace
+{
+
+enum class return_code : unsigned
+{
+    ok,
+    fail,
+    exit
+};
+
+struct RenderConfig
+{
+    boost::filesystem::path base_path;
+    boost::filesystem::path output_path;
+    std::string algorithm;
+    std::string bbox;
+    unsigned min_zoom;
+    unsigned max_zoom;
+    unsigned requested_num_threads;
+
+    double min_lon, min_lat, max_lon, max_lat;
+};
+
+struct Tile
+{
+    unsigned x, y, z;
+};
+
+return_code parseArguments(int argc, char *argv[], RenderConfig &config)
+{
+    // declare a group of options that will be allowed only on command line
+    boost::program_options::options_description generic_options("Options");
+    generic_options.add_options()("version,v", "Show version")("help,h", "Show this help message");
+
+    // declare a group of options that will be allowed both on command line
+    boost::program_options::options_description config_options("Configuration");
+    config_options.add_options()
+        //
+        ("bbox",
+         boost::program_options::value<std::string>(&config.bbox),
+         "Area to render as min_lon,min_lat,max_lon,max_lat")(
+            "min-zoom",
+            boost::program_options::value<unsigned>(&config.min_zoom)->default_value(14),
+            "Lowest zoom level to render")(
+            "max-zoom",
+            boost::program_options::value<unsigned>(&config.max_zoom)->default_value(18),
+            "Highest zoom level to render")(
+            "output,o",
+            boost::program_options::value<boost::filesystem::path>(&config.output_path),
+            "Directory the tiles are written to as {z}/{x}/{y}.pbf")(
+            "algorithm,a",
+            boost::program_options::value<std::string>(&config.algorithm)->default_value("CH"),
+            "Algorithm the dataset was prepared for. Can be CH, CoreCH, MLD.")(
+            "threads,t",
+            boost::program_options::value<unsigned>(&config.requested_num_threads)
+                ->default_value(tbb::task_scheduler_init::default_num_threads()),
+            "Number of threads to use");
+
+    // hidden options, will be allowed on command line, but will not be shown to the user
+    boost::program_options::options_description hidden_options("Hidden options");
+    hidden_options.add_options()(
+        "input,i",
+        boost::program_options::value<boost::filesystem::path>(&config.base_path),
+        "Input file in .osrm format");
+
+    // positional option
+    boost::program_options::positional_options_description positional_options;
+    positional_options.add("input", 1);
+
+    // combine above options for parsing
+    boost::program_options::options_description cmdline_options;
+    cmdline_options.add(generic_options).add(config_options).add(hidden_options);
+
+    const auto *executable = argv[0];
+    boost::program_options::options_description visible_options(
+        boost::filesystem::path(executable).filename().string() + " <input.osrm> [options]");
+    visible_options.add(generic_options).add(config_options);
+
+    // parse command line options
+    boost::program_options::variables_map option_variables;
+    try
+    {
+        boost::program_options::store(boost::program_options::command_line_parser(argc, argv)
+                                          .options(cmdline_options)
+                                          .positional(positional_options)
+                                          .run(),
+                                      option_variables);
+    }
+    catch (const boost::program_options::error &e)
+    {
+        util::Log(logERROR) << e.what();
+        return return_code::fail;
+    }
+
+    if (option_variables.count("version"))
+    {
+        std::cout << OSRM_VERSION << std::endl;
+        return return_code::exit;
+    }
+
+    if (option_variables.count("help"))
+    {
+        std::cout << visible_options;
+        return return_code::exit;
+    }
+
+    boost::program_options::notify(option_variables);
+
+    if (!option_variables.count("input") || !option_variables.count("output") ||
+        !option_variables.count("bbox"))
+    {
+        std::cout << visible_options;
+        return return_code::fail;
+    }
+
+    std::vector<std::string> bbox;
+    boost::split(bbox, config.bbox, boost::is_any_of(","));
+    try
+    {
+        if (bbox.size() != 4)
+            throw std::invalid_argument(config.bbox);
+        config.min_lon = std::stod(bbox[0]);
+        config.min_lat = std::stod(bbox[1]);
+        config.max_lon = std::stod(bbox[2]);
+        config.max_lat = std::stod(bbox[3]);
+    }
+    catch (const std::logic_error &)
+    {
+        util::Log(logERROR) << "Invalid bounding box " << config.bbox
+                            << ", expected min_lon,min_lat,max_lon,max_lat";
+        return return_code::fail;
+    }
+
+    if (config.min_lon > config.max_lon || config.min_lat > config.max_lat)
+    {
+        util::Log(logERROR) << "Invalid bounding box " << config.bbox;
+        return return_code::fail;
+    }
+
+    // the limits of the tile service
+    if (config.min_zoom < 12 || config.max_zoom > 19 || config.min_zoom > config.max_zoom)
+    {
+        util::Log(logERROR) << "Zoom levels must be between 12 and 19";
+        return return_code::fail;
+    }
+
+    return return_code::ok;
+}
+
+EngineConfig::Algorithm stringToAlgorithm(const std::string &algorithm)
+{
+    if (algorithm == "CH")
+        return EngineConfig::Algorithm::CH;
+    if (algorithm == "CoreCH")
+        return EngineConfig::Algorithm::CoreCH;
+    if (algorithm == "MLD")
+        return EngineConfig::Algorithm::MLD;
+    throw util::exception("Unknown algorithm " + algorithm + SOURCE_REF);
+}
+
+// All tiles that intersect the bounding box on the given zoom levels
+std::vector<Tile> getTiles(const RenderConfig &config)
+{
+    const auto toTile = [](const double pixel, const unsigned z) {
+        const auto max_tile = (1u << z) - 1;
+        const auto tile = std::floor(pixel / util::web_mercator::TILE_SIZE);
+        return static_cast<unsigned>(std::max(0., std::min<double>(tile, max_tile)));
+    };
+
+    std::vector<Tile> tiles;
+    for (auto z = config.min_zoom; z <= config.max_zoom; ++z)
+    {
+        const auto min_x = toTile(
+            util::web_mercator::degreeToPixel(util::FloatLongitude{config.min_lon}, z), z);
+        const auto max_x = toTile(
+            util::web_mercator::degreeToPixel(util::FloatLongitude{config.max_lon}, z), z);
+        // pixel coordinates grow towards the south
+        const auto min_y = toTile(
+            util::web_mercator::degreeToPixel(util::FloatLatitude{config.max_lat}, z), z);
+        const auto max_y = toTile(
+            util::web_mercator::degreeToPixel(util::FloatLatitude{config.min_lat}, z), z);
+
+        for (auto x = min_x; x <= max_x; ++x)
+            for (auto y = min_y; y <= max_y; ++y)
+                tiles.push_back(Tile{x, y, z});
+    }
+    return tiles;
+}
+
+// Metadata like the metadata table of MBTiles, so the tree can be imported with mb-util
+void writeMetadata(const RenderConfig &config)
+{
+    boost::filesystem::ofstream metadata(config.output_path / "metadata.json");
+    metadata << "{\"name\":\"" << config.base_path.filename().string() << "\","
+             << "\"format\":\"pbf\","
+             << "\"bounds\":\"" << config.min_lon << "," << config.min_lat << ","
+             << config.max_lon << "," << config.max_lat << "\","
+             << "\"minzoom\":\"" << config.min_zoom << "\","
+             << "\"maxzoom\":\"" << config.max_zoom << "\","
+             << "\"version\":\"" << OSRM_VERSION << "\"}\n";
+    metadata.close();
+    if (!metadata)
+    {
+        throw util::exception("Failed to write " + (config.output_path / "metadata.json").string() +
+                              SOURCE_REF);
+    }
+}
+}
+
+int main(int argc, char *argv[]) try
+{
+    util::LogPolicy::GetInstance().Unmute();
+    RenderConfig config;
+
+    const auto result = parseArguments(argc, argv, config);
+
+    if (return_code::fail == result)
+    {
+        return EXIT_FAILURE;
+    }
+
+    if (return_code::exit == result)
+    {
+        return EXIT_SUCCESS;
+    }
+
+    EngineConfig engine_config;
+    engine_config.storage_config = storage::StorageConfig(config.base_path);
+    engine_config.use_shared_memory = false;
+    engine_config.algorithm = stringToAlgorithm(config.algorithm);
+    if (!engine_config.storage_config.IsValid())
+    {
+        util::Log(logERROR) << "Required files are missing, cannot continue";
+        return EXIT_FAILURE;
+    }
+
+    tbb::task_scheduler_init init(config.requested_num_threads);
+    const OSRM osrm(engine_config);
+
+    const auto tiles = getTiles(config);
+    util::Log() << "Rendering " << tiles.size() << " tiles of zoom levels " << config.min_zoom
+                << " to " << config.max_zoom << " with " << config.requested_num_threads
+                << " threads";
+
+    // create the directories upfront, so the threads only write files
+    for (const auto &tile : tiles)
+    {
+        boost::filesystem::create_directories(config.output_path / std::to_string(tile.z) /
+                                              std::to_string(tile.x));
+    }
+
+    TIMER_START(render);
+    std::atomic<std::size_t> num_bytes{0};
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, tiles.size()),
+                      [&](const tbb::blocked_range<std::size_t> &range) {
+                          std::string pbf_buffer;
+                          for (auto index = range.begin(); index < range.end(); ++index)
+                          {
+                              const auto &tile = tiles[index];
+                              pbf_buffer.clear();
+                              if (osrm.Tile({tile.x, tile.y, tile.z}, pbf_buffer) != Status::Ok)
+                              {
+                                  throw util::exception("Failed to render tile " +
+                                                        std::to_string(tile.z) + "/" +
+                                                        std::to_string(tile.x) + "/" +
+                                                        std::to_string(tile.y) + SOURCE_REF);
+                              }
+
+                              const auto tile_path = config.output_path /
+                                                     std::to_string(tile.z) /
+                                                     std::to_string(tile.x) /
+                                                     (std::to_string(tile.y) + ".pbf");
+                              boost::filesystem::ofstream out(tile_path, std::ios::binary);
+                              out.write(pbf_buffer.data(), pbf_buffer.size());
+                              out.close();
+                              if (!out)
+                              {
+                                  throw util::exception("Failed to write tile " +
+                                                        tile_path.string() + SOURCE_REF);
+                              }
+                              num_bytes += pbf_buffer.size();
+                          }
+                      });
+    TIMER_STOP(render);
+
+    writeMetadata(config);
+
+    util::Log() << "Rendered " << tiles.size() << " tiles with " << (num_bytes >> 10)
+                << " KiB in " << TIMER_SEC(render) << "s ("
+                << tiles.size() / std::max(TIMER_SEC(render), 0.001) << " tiles/s)";
+
+    return EXIT_SUCCESS;
+}
+catch (const std::exception &e)
+{
+    util::Log(logERROR) << "[exception] " << e.what();
+    return EXIT_FAILURE;
+}
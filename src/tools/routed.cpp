@@ -1,4 +1,5 @@
 #include "server/server.hpp"
+#include "storage/manifest.hpp"
 #include "util/exception_utils.hpp"
 #include "util/log.hpp"
 #include "util/meminfo.hpp"
@@ -17,6 +18,7 @@
 
 #include <signal.h>
 
+#include <atomic>
 #include <chrono>
 #include <exception>
 #include <future>
@@ -72,11 +74,19 @@ inline unsigned generateServerProgramOptions(const int argc,
                                              bool &use_shared_memory,
                                              std::string &algorithm,
                                              bool &trial,
+                                             bool &verify_checksums,
                                              int &max_locations_trip,
                                              int &max_locations_viaroute,
                                              int &max_locations_distance_table,
                                              int &max_locations_map_matching,
-                                             int &max_results_nearest)
+                                             int &max_results_nearest,
+                                             boost::filesystem::path &warmup_queries_path,
+                                             int &max_warmup_queries,
+                                             bool &reload_on_change,
+                                             int &max_reload_memory,
+                                             int &max_tile_cache_memory,
+                                             int &max_trip_optimization_time,
+                                             int &max_parallel_legs)
 {
     using boost::program_options::value;
     using boost::filesystem::path;
@@ -102,6 +112,9 @@ inline unsigned generateServerProgramOptions(const int argc,
         ("shared-memory,s",
          value<bool>(&use_shared_memory)->implicit_value(true)->default_value(false),
          "Load data from shared memory") //
+        ("verify-checksums",
+         value<bool>(&verify_checksums)->implicit_value(true)->default_value(false),
+         "Verify the checksums of the dataset manifest in the background") //
         ("algorithm,a",
          value<std::string>(&algorithm)->default_value("CH"),
          "Algorithm to use for the data. Can be CH, CoreCH, MLD.") //
@@ -119,7 +132,30 @@ inline unsigned generateServerProgramOptions(const int argc,
          "Max. locations supported in map matching query") //
         ("max-nearest-size",
          value<int>(&max_results_nearest)->default_value(100),
-         "Max. results supported in nearest query");
+         "Max. results supported in nearest query") //
+        ("warmup-queries",
+         value<boost::filesystem::path>(&warmup_queries_path),
+         "File with recorded route queries (one per line) that are replayed against a new "
+         "shared memory dataset before it is used") //
+        ("max-warmup-queries",
+         value<int>(&max_warmup_queries)->default_value(100),
+         "Max. number of recorded queries replayed on a data update") //
+        ("reload-on-change",
+         value<bool>(&reload_on_change)->implicit_value(true)->default_value(false),
+         "Reload the dataset in the background when the pre-processing tools completed it") //
+        ("max-reload-memory",
+         value<int>(&max_reload_memory)->default_value(-1),
+         "Max. memory in MiB for holding the old and the new dataset during a reload, "
+         "reloads that need more are skipped, -1 for unlimited") //
+        ("max-tile-cache-memory",
+         value<int>(&max_tile_cache_memory)->default_value(64),
+         "Max. memory in MiB for caching rendered debug tiles, 0 disables the cache") //
+        ("max-trip-optimization-time",
+         value<int>(&max_trip_optimization_time)->default_value(200),
+         "Max. time in ms to optimize the order of a trip, 0 disables the local search") //
+        ("max-parallel-legs",
+         value<int>(&max_parallel_legs)->default_value(1),
+         "Max. number of legs of a via route that are searched in parallel");
 
     // hidden options, will be allowed on command line, but will not be shown to the user
     boost::program_options::options_description hidden_options("Hidden options");
@@ -191,6 +227,7 @@ int main(int argc, const char *argv[]) try
     util::LogPolicy::GetInstance().Unmute();
 
     bool trial_run = false;
+    bool verify_checksums = false;
     std::string ip_address;
     int ip_port, requested_thread_num;
 
@@ -206,11 +243,19 @@ int main(int argc, const char *argv[]) try
                                                               config.use_shared_memory,
                                                               algorithm,
                                                               trial_run,
+                                                              verify_checksums,
                                                               config.max_locations_trip,
                                                               config.max_locations_viaroute,
                                                               config.max_locations_distance_table,
                                                               config.max_locations_map_matching,
-                                                              config.max_results_nearest);
+                                                              config.max_results_nearest,
+                                                              config.warmup_queries_path,
+                                                              config.max_warmup_queries,
+                                                              config.reload_on_change,
+                                                              config.max_reload_memory,
+                                                              config.max_tile_cache_memory,
+                                                              config.max_trip_optimization_time,
+                                                              config.max_parallel_legs);
     if (init_result == INIT_OK_DO_NOT_START_ENGINE)
     {
         return EXIT_SUCCESS;
@@ -257,6 +302,40 @@ int main(int argc, const char *argv[]) try
     pthread_sigmask(SIG_BLOCK, &new_mask, &old_mask);
 #endif
 
+    // Full verification reads the whole dataset, so don't delay serving requests
+    std::atomic<bool> stop_verification{false};
+    std::thread verification_thread;
+    if (verify_checksums && !config.use_shared_memory)
+    {
+        verification_thread = std::thread([&] {
+            const auto &manifest_path = config.storage_config.manifest_path;
+            if (!boost::filesystem::exists(manifest_path))
+            {
+                util::Log(logWARNING) << "No dataset manifest found, skipping verification";
+                return;
+            }
+
+            try
+            {
+                const auto manifest = storage::manifest::readManifest(manifest_path);
+                if (!storage::manifest::verifyManifest(base_path, manifest, &stop_verification))
+                {
+                    util::Log(logERROR) << "Dataset checksum verification failed";
+                }
+                else if (!stop_verification)
+                {
+                    util::Log() << "Dataset checksums verified";
+                }
+            }
+            // reading the files can also throw boost or standard library exceptions, any of them
+            // escaping this thread would terminate the server
+            catch (const std::exception &e)
+            {
+                util::Log(logERROR) << "Dataset checksum verification failed: " << e.what();
+            }
+        });
+    }
+
     auto routing_server = server::Server::CreateServer(ip_address, ip_port, requested_thread_num);
     auto service_handler = std::make_unique<server::ServiceHandler>(config);
 
@@ -313,6 +392,12 @@ int main(int argc, const char *argv[]) try
         }
     }
 
+    if (verification_thread.joinable())
+    {
+        stop_verification = true;
+        verification_thread.join();
+    }
+
     util::Log() << "freeing objects";
     routing_server.reset();
     util::Log() << "shutdown completed";
@@ -1,6 +1,9 @@
+#include "storage/manifest.hpp"
 #include "storage/shared_memory.hpp"
 #include "storage/shared_monitor.hpp"
 #include "storage/storage.hpp"
+#include "updater/csv_source.hpp"
+#include "updater/live_updater.hpp"
 #include "osrm/exception.hpp"
 #include "util/log.hpp"
 #include "util/meminfo.hpp"
@@ -12,6 +15,8 @@
 
 #include <csignal>
 #include <cstdlib>
+#include <string>
+#include <vector>
 
 using namespace osrm;
 
@@ -53,7 +58,9 @@ void springClean()
 bool generateDataStoreOptions(const int argc,
                               const char *argv[],
                               boost::filesystem::path &base_path,
-                              int &max_wait)
+                              int &max_wait,
+                              bool &verify_checksums,
+                              std::vector<std::string> &segment_speed_paths)
 {
     // declare a group of options that will be allowed only on command line
     boost::program_options::options_description generic_options("Options");
@@ -67,7 +74,16 @@ bool generateDataStoreOptions(const int argc,
     config_options.add_options()("max-wait",
                                  boost::program_options::value<int>(&max_wait)->default_value(-1),
                                  "Maximum number of seconds to wait on a running data update "
-                                 "before aquiring the lock by force.");
+                                 "before aquiring the lock by force.")(
+        "verify-checksums",
+        boost::program_options::value<bool>(&verify_checksums)
+            ->implicit_value(true)
+            ->default_value(false),
+        "Verify the checksums of all files in the dataset manifest before loading")(
+        "segment-speed-file",
+        boost::program_options::value<std::vector<std::string>>(&segment_speed_paths)->composing(),
+        "Instead of loading a dataset, apply segment speeds from CSV or binary files to the MLD "
+        "dataset in shared memory and customize the changed cells");
 
     // hidden options, will be allowed on command line but will not be shown to the user
     boost::program_options::options_description hidden_options("Hidden options");
@@ -159,16 +175,47 @@ int main(const int argc, const char *argv[]) try
 
     boost::filesystem::path base_path;
     int max_wait = -1;
-    if (!generateDataStoreOptions(argc, argv, base_path, max_wait))
+    bool verify_checksums = false;
+    std::vector<std::string> segment_speed_paths;
+    if (!generateDataStoreOptions(
+            argc, argv, base_path, max_wait, verify_checksums, segment_speed_paths))
     {
         return EXIT_SUCCESS;
     }
+
+    // Live updates change a copy of the dataset that is in use, so no files are loaded
+    if (!segment_speed_paths.empty())
+    {
+        const auto segment_speed_lookup = updater::csv::readSegmentValues(segment_speed_paths);
+        return storage::Storage::Update(
+            max_wait, [&](const storage::DataLayout &layout, char *memory_ptr) {
+                updater::applySegmentSpeeds(segment_speed_lookup, layout, memory_ptr);
+            });
+    }
+
     storage::StorageConfig config(base_path);
     if (!config.IsValid())
     {
         util::Log(logERROR) << "Config contains invalid file paths. Exiting!";
         return EXIT_FAILURE;
     }
+    if (verify_checksums)
+    {
+        if (!boost::filesystem::exists(config.manifest_path))
+        {
+            util::Log(logERROR) << "No dataset manifest found at " << config.manifest_path.string()
+                                << ", re-run the pipeline tools to create one.";
+            return EXIT_FAILURE;
+        }
+
+        util::Log() << "Verifying dataset checksums ...";
+        const auto manifest = storage::manifest::readManifest(config.manifest_path);
+        if (!storage::manifest::verifyManifest(base_path, manifest))
+        {
+            util::Log(logERROR) << "Dataset is corrupted. Exiting!";
+            return EXIT_FAILURE;
+        }
+    }
     storage::Storage storage(std::move(config));
 
     return storage.Run(max_wait);
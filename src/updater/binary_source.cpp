@@ -0,0 +1,202 @@
+#include "updater/binary_source.hpp"
+
+#include "storage/io.hpp"
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+#include "util/log.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/format.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace osrm
+{
+namespace updater
+{
+namespace binary
+{
+
+namespace
+{
+const constexpr std::uint32_t VERSION = 1;
+const constexpr char SEGMENT_SPEED_MAGIC[8] = {'O', 'S', 'R', 'M', 'S', 'E', 'G', 'S'};
+const constexpr char TURN_PENALTY_MAGIC[8] = {'O', 'S', 'R', 'M', 'T', 'U', 'R', 'N'};
+
+template <typename Record> struct RecordTraits;
+
+template <> struct RecordTraits<SegmentSpeedRecord>
+{
+    using Key = Segment;
+    using Value = SpeedSource;
+    static constexpr const char *magic = SEGMENT_SPEED_MAGIC;
+
+    static Key key(const SegmentSpeedRecord &record) { return {record.from, record.to}; }
+
+    static std::pair<Key, Value> unpack(const SegmentSpeedRecord &record,
+                                        const std::uint8_t source)
+    {
+        Value value;
+        value.speed = record.speed;
+        value.rate = record.rate;
+        value.source = source;
+        return {key(record), value};
+    }
+
+    static SegmentSpeedRecord pack(const std::pair<Key, Value> &entry)
+    {
+        return {entry.first.from, entry.first.to, entry.second.rate, entry.second.speed, 0};
+    }
+};
+
+template <> struct RecordTraits<TurnPenaltyRecord>
+{
+    using Key = Turn;
+    using Value = PenaltySource;
+    static constexpr const char *magic = TURN_PENALTY_MAGIC;
+
+    static Key key(const TurnPenaltyRecord &record) { return {record.from, record.via, record.to}; }
+
+    static std::pair<Key, Value> unpack(const TurnPenaltyRecord &record,
+                                        const std::uint8_t source)
+    {
+        Value value;
+        value.duration = record.duration;
+        value.weight = record.weight;
+        value.source = source;
+        return {key(record), value};
+    }
+
+    static TurnPenaltyRecord pack(const std::pair<Key, Value> &entry)
+    {
+        return {entry.first.from,
+                entry.first.via,
+                entry.first.to,
+                entry.second.duration,
+                entry.second.weight};
+    }
+};
+
+template <typename Record>
+void readRecords(const std::string &path,
+                 const std::uint8_t source,
+                 std::vector<std::pair<typename RecordTraits<Record>::Key,
+                                       typename RecordTraits<Record>::Value>> &values)
+{
+    using Traits = RecordTraits<Record>;
+
+    boost::iostreams::mapped_file_source region;
+    try
+    {
+        region.open(path);
+    }
+    catch (const std::exception &exception)
+    {
+        throw util::exception("Could not map " + path + ": " + exception.what() + SOURCE_REF);
+    }
+
+    Header header;
+    if (region.size() < sizeof(header))
+        throw util::exception(path + " is too small for a binary header" + SOURCE_REF);
+    std::memcpy(&header, region.data(), sizeof(header));
+
+    if (std::memcmp(header.magic, Traits::magic, sizeof(header.magic)) != 0)
+        throw util::exception(path + " has the wrong kind of values" + SOURCE_REF);
+    if (header.version != VERSION || header.record_size != sizeof(Record))
+        throw util::exception(
+            (boost::format("%1% has version %2% with %3% byte records, expected version %4% "
+                           "with %5% byte records") %
+             path % header.version % header.record_size % VERSION % sizeof(Record))
+                .str() +
+            SOURCE_REF);
+    if (region.size() != sizeof(header) + header.num_records * sizeof(Record))
+        throw util::exception(path + " is truncated" + SOURCE_REF);
+
+    const auto records = reinterpret_cast<const Record *>(region.data() + sizeof(header));
+    const auto num_records = static_cast<std::size_t>(header.num_records);
+
+    // lookups depend on the order, so reject files that were not written by writeValues
+    const auto unsorted = std::adjacent_find(
+        records, records + num_records, [](const Record &lhs, const Record &rhs) {
+            return !(Traits::key(lhs) < Traits::key(rhs));
+        });
+    if (unsorted != records + num_records)
+        throw util::exception(path + " is not sorted by key or has duplicates at record " +
+                              std::to_string(unsorted - records) + SOURCE_REF);
+
+    values.resize(num_records);
+    tbb::parallel_for(std::size_t{0}, num_records, [&](const std::size_t index) {
+        values[index] = Traits::unpack(records[index], source);
+    });
+
+    util::Log() << "Loaded " << path << " with " << num_records << " values";
+}
+
+template <typename Record>
+void writeRecords(const std::string &path,
+                  const std::vector<std::pair<typename RecordTraits<Record>::Key,
+                                              typename RecordTraits<Record>::Value>> &values)
+{
+    using Traits = RecordTraits<Record>;
+
+    Header header;
+    std::memcpy(header.magic, Traits::magic, sizeof(header.magic));
+    header.version = VERSION;
+    header.record_size = sizeof(Record);
+    header.num_records = values.size();
+
+    std::vector<Record> records(values.size());
+    std::transform(values.begin(), values.end(), records.begin(), Traits::pack);
+    BOOST_ASSERT(std::is_sorted(values.begin(), values.end(), [](const auto &lhs, const auto &rhs) {
+        return lhs.first < rhs.first;
+    }));
+
+    storage::io::FileWriter writer(path, storage::io::FileWriter::HasNoFingerprint);
+    writer.WriteOne(header);
+    writer.WriteFrom(records);
+}
+}
+
+bool isBinaryFile(const std::string &path)
+{
+    char magic[sizeof(Header::magic)];
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream.read(magic, sizeof(magic)))
+        return false;
+
+    return std::memcmp(magic, SEGMENT_SPEED_MAGIC, sizeof(magic)) == 0 ||
+           std::memcmp(magic, TURN_PENALTY_MAGIC, sizeof(magic)) == 0;
+}
+
+void readValues(const std::string &path,
+                const std::uint8_t source,
+                std::vector<std::pair<Segment, SpeedSource>> &values)
+{
+    readRecords<SegmentSpeedRecord>(path, source, values);
+}
+
+void readValues(const std::string &path,
+                const std::uint8_t source,
+                std::vector<std::pair<Turn, PenaltySource>> &values)
+{
+    readRecords<TurnPenaltyRecord>(path, source, values);
+}
+
+void writeValues(const std::string &path,
+                 const std::vector<std::pair<Segment, SpeedSource>> &values)
+{
+    writeRecords<SegmentSpeedRecord>(path, values);
+}
+
+void writeValues(const std::string &path, const std::vector<std::pair<Turn, PenaltySource>> &values)
+{
+    writeRecords<TurnPenaltyRecord>(path, values);
+}
+}
+}
+}
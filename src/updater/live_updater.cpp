@@ -0,0 +1,371 @@
+#include "updater/live_updater.hpp"
+#include "updater/conversion.hpp"
+
+#include "customizer/cell_customizer.hpp"
+#include "customizer/edge_based_graph.hpp"
+
+#include "extractor/datasources.hpp"
+#include "extractor/packed_osm_ids.hpp"
+#include "extractor/profile_properties.hpp"
+#include "extractor/segment_data_container.hpp"
+
+#include "partition/cell_storage.hpp"
+#include "partition/multi_level_partition.hpp"
+
+#include "util/coordinate_calculation.hpp"
+#include "util/exception.hpp"
+#include "util/exception_utils.hpp"
+#include "util/integer_range.hpp"
+#include "util/log.hpp"
+#include "util/packed_coordinate_vector.hpp"
+#include "util/timing_util.hpp"
+#include "util/vector_view.hpp"
+
+#include <boost/range/adaptor/reversed.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/concurrent_vector.h>
+#include <tbb/parallel_for.h>
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+namespace osrm
+{
+namespace updater
+{
+
+namespace
+{
+using storage::DataLayout;
+using DirectionalGeometryID = extractor::SegmentDataView::DirectionalGeometryID;
+
+const constexpr char *LIVE_SOURCE_NAME = "live";
+
+struct SegmentUpdate
+{
+    DirectionalGeometryID geometry_id;
+    bool forward;
+    std::uint32_t offset;
+    SegmentWeight weight;
+    SegmentDuration duration;
+};
+
+struct GeometryWeight
+{
+    EdgeWeight weight;
+    EdgeWeight duration;
+    bool closed;
+};
+
+std::uint64_t geometryKey(const DirectionalGeometryID geometry_id, const bool forward)
+{
+    return static_cast<std::uint64_t>(geometry_id) << 1 | forward;
+}
+
+// Sums up the segments of a geometry like the updater computes the weight of an edge-based node
+GeometryWeight getGeometryWeight(const extractor::SegmentDataView &segment_data,
+                                 const DirectionalGeometryID geometry_id,
+                                 const bool forward)
+{
+    GeometryWeight result{0, 0, false};
+    const auto add = [&result](const auto &weights, const auto &durations) {
+        for (const auto weight : weights)
+        {
+            result.closed |= weight == INVALID_SEGMENT_WEIGHT;
+            result.weight += weight;
+        }
+        for (const auto duration : durations)
+            result.duration += duration;
+    };
+
+    if (forward)
+        add(segment_data.GetForwardWeights(geometry_id),
+            segment_data.GetForwardDurations(geometry_id));
+    else
+        add(segment_data.GetReverseWeights(geometry_id),
+            segment_data.GetReverseDurations(geometry_id));
+
+    return result;
+}
+
+// All live updates share one data source, it gets the first unused name
+DatasourceID getLiveDatasource(extractor::Datasources &datasources)
+{
+    for (DatasourceID source = 1; source < std::numeric_limits<DatasourceID>::max(); ++source)
+    {
+        const auto name = datasources.GetSourceName(source);
+        if (name.empty())
+        {
+            datasources.SetSourceName(source, LIVE_SOURCE_NAME);
+            return source;
+        }
+        if (name == util::StringView(LIVE_SOURCE_NAME))
+            return source;
+    }
+
+    throw util::exception("No data source left for live updates" + SOURCE_REF);
+}
+
+extractor::SegmentDataView makeSegmentDataView(const DataLayout &layout, char *memory_ptr)
+{
+    using WeightBlock = extractor::SegmentDataView::SegmentWeightVector::block_type;
+    using DurationBlock = extractor::SegmentDataView::SegmentDurationVector::block_type;
+
+    const auto num_entries = layout.num_entries[DataLayout::GEOMETRIES_NODE_LIST];
+    const auto weights = [&](const DataLayout::BlockID block) {
+        return extractor::SegmentDataView::SegmentWeightVector(
+            util::vector_view<WeightBlock>(layout.GetBlockPtr<WeightBlock>(memory_ptr, block),
+                                           layout.num_entries[block]),
+            num_entries);
+    };
+    const auto durations = [&](const DataLayout::BlockID block) {
+        return extractor::SegmentDataView::SegmentDurationVector(
+            util::vector_view<DurationBlock>(layout.GetBlockPtr<DurationBlock>(memory_ptr, block),
+                                             layout.num_entries[block]),
+            num_entries);
+    };
+
+    return extractor::SegmentDataView{
+        util::vector_view<unsigned>(
+            layout.GetBlockPtr<unsigned>(memory_ptr, DataLayout::GEOMETRIES_INDEX),
+            layout.num_entries[DataLayout::GEOMETRIES_INDEX]),
+        util::vector_view<NodeID>(
+            layout.GetBlockPtr<NodeID>(memory_ptr, DataLayout::GEOMETRIES_NODE_LIST), num_entries),
+        weights(DataLayout::GEOMETRIES_FWD_WEIGHT_LIST),
+        weights(DataLayout::GEOMETRIES_REV_WEIGHT_LIST),
+        durations(DataLayout::GEOMETRIES_FWD_DURATION_LIST),
+        durations(DataLayout::GEOMETRIES_REV_DURATION_LIST),
+        util::vector_view<DatasourceID>(
+            layout.GetBlockPtr<DatasourceID>(memory_ptr, DataLayout::DATASOURCES_LIST),
+            layout.num_entries[DataLayout::DATASOURCES_LIST])};
+}
+
+partition::MultiLevelPartitionView makePartitionView(const DataLayout &layout, char *memory_ptr)
+{
+    return partition::MultiLevelPartitionView{
+        layout.GetBlockPtr<partition::MultiLevelPartitionView::LevelData>(
+            memory_ptr, DataLayout::MLD_LEVEL_DATA),
+        util::vector_view<PartitionID>(
+            layout.GetBlockPtr<PartitionID>(memory_ptr, DataLayout::MLD_PARTITION),
+            layout.num_entries[DataLayout::MLD_PARTITION]),
+        util::vector_view<CellID>(
+            layout.GetBlockPtr<CellID>(memory_ptr, DataLayout::MLD_CELL_TO_CHILDREN),
+            layout.num_entries[DataLayout::MLD_CELL_TO_CHILDREN])};
+}
+
+partition::CellStorageView makeCellStorageView(const DataLayout &layout, char *memory_ptr)
+{
+    return partition::CellStorageView{
+        util::vector_view<EdgeWeight>(
+            layout.GetBlockPtr<EdgeWeight>(memory_ptr, DataLayout::MLD_CELL_WEIGHTS),
+            layout.num_entries[DataLayout::MLD_CELL_WEIGHTS]),
+        util::vector_view<NodeID>(
+            layout.GetBlockPtr<NodeID>(memory_ptr, DataLayout::MLD_CELL_SOURCE_BOUNDARY),
+            layout.num_entries[DataLayout::MLD_CELL_SOURCE_BOUNDARY]),
+        util::vector_view<NodeID>(
+            layout.GetBlockPtr<NodeID>(memory_ptr, DataLayout::MLD_CELL_DESTINATION_BOUNDARY),
+            layout.num_entries[DataLayout::MLD_CELL_DESTINATION_BOUNDARY]),
+        util::vector_view<partition::CellStorageView::CellData>(
+            layout.GetBlockPtr<partition::CellStorageView::CellData>(memory_ptr,
+                                                                     DataLayout::MLD_CELLS),
+            layout.num_entries[DataLayout::MLD_CELLS]),
+        util::vector_view<std::uint64_t>(
+            layout.GetBlockPtr<std::uint64_t>(memory_ptr, DataLayout::MLD_CELL_LEVEL_OFFSETS),
+            layout.num_entries[DataLayout::MLD_CELL_LEVEL_OFFSETS])};
+}
+
+customizer::MultiLevelEdgeBasedGraphView makeGraphView(const DataLayout &layout, char *memory_ptr)
+{
+    using GraphView = customizer::MultiLevelEdgeBasedGraphView;
+    return GraphView{
+        util::vector_view<GraphView::NodeArrayEntry>(
+            layout.GetBlockPtr<GraphView::NodeArrayEntry>(memory_ptr,
+                                                          DataLayout::MLD_GRAPH_NODE_LIST),
+            layout.num_entries[DataLayout::MLD_GRAPH_NODE_LIST]),
+        util::vector_view<GraphView::EdgeArrayEntry>(
+            layout.GetBlockPtr<GraphView::EdgeArrayEntry>(memory_ptr,
+                                                          DataLayout::MLD_GRAPH_EDGE_LIST),
+            layout.num_entries[DataLayout::MLD_GRAPH_EDGE_LIST]),
+        util::vector_view<GraphView::EdgeOffset>(
+            layout.GetBlockPtr<GraphView::EdgeOffset>(memory_ptr,
+                                                      DataLayout::MLD_GRAPH_NODE_TO_OFFSET),
+            layout.num_entries[DataLayout::MLD_GRAPH_NODE_TO_OFFSET])};
+}
+}
+
+void applySegmentSpeeds(const SegmentLookupTable &segment_speed_lookup,
+                        const DataLayout &layout,
+                        char *memory_ptr)
+{
+    if (layout.GetBlockSize(DataLayout::MLD_GRAPH_EDGE_LIST) == 0 ||
+        layout.GetBlockSize(DataLayout::MLD_CELLS) == 0)
+    {
+        throw util::exception("Live updates need a dataset that was customized for MLD" +
+                              SOURCE_REF);
+    }
+
+    TIMER_START(segments);
+    auto segment_data = makeSegmentDataView(layout, memory_ptr);
+
+    const util::PackedCoordinateVectorView coordinates(
+        util::vector_view<util::PackedCoordinateVectorView::BlockHeader>(
+            layout.GetBlockPtr<util::PackedCoordinateVectorView::BlockHeader>(
+                memory_ptr, DataLayout::COORDINATE_BLOCKS),
+            layout.num_entries[DataLayout::COORDINATE_BLOCKS]),
+        util::vector_view<util::PackedCoordinateVectorView::block_type>(
+            layout.GetBlockPtr<util::PackedCoordinateVectorView::block_type>(
+                memory_ptr, DataLayout::COORDINATE_LIST),
+            layout.num_entries[DataLayout::COORDINATE_LIST]));
+    // there is one id per coordinate
+    const extractor::PackedOSMIDsView osm_node_ids(
+        util::vector_view<extractor::PackedOSMIDsView::block_type>(
+            layout.GetBlockPtr<extractor::PackedOSMIDsView::block_type>(
+                memory_ptr, DataLayout::OSM_NODE_ID_LIST),
+            layout.num_entries[DataLayout::OSM_NODE_ID_LIST]),
+        coordinates.size());
+
+    const auto &profile_properties =
+        *layout.GetBlockPtr<extractor::ProfileProperties>(memory_ptr, DataLayout::PROPERTIES);
+    const auto weight_multiplier = profile_properties.GetWeightMultiplier();
+    const auto live_source = getLiveDatasource(
+        *layout.GetBlockPtr<extractor::Datasources>(memory_ptr, DataLayout::DATASOURCES_NAMES));
+
+    // Lookups run in parallel, but neighbouring segments share the words of the packed
+    // vectors so the new values are written afterwards
+    tbb::concurrent_vector<SegmentUpdate> segment_updates;
+    tbb::parallel_for(
+        tbb::blocked_range<DirectionalGeometryID>(0, segment_data.GetNumberOfGeometries()),
+        [&](const tbb::blocked_range<DirectionalGeometryID> &range) {
+            for (auto geometry_id = range.begin(); geometry_id < range.end(); ++geometry_id)
+            {
+                const auto nodes = segment_data.GetForwardGeometry(geometry_id);
+                for (const auto offset : util::irange<std::uint32_t>(0, nodes.size() - 1))
+                {
+                    const auto u = osm_node_ids[nodes[offset]];
+                    const auto v = osm_node_ids[nodes[offset + 1]];
+                    const auto forward_value = segment_speed_lookup({u, v});
+                    const auto reverse_value = segment_speed_lookup({v, u});
+                    if (!forward_value && !reverse_value)
+                        continue;
+
+                    const auto length = util::coordinate_calculation::greatCircleDistance(
+                        coordinates[nodes[offset]], coordinates[nodes[offset + 1]]);
+                    if (forward_value)
+                        segment_updates.push_back(
+                            {geometry_id,
+                             true,
+                             offset,
+                             convertToWeight(*forward_value, length, weight_multiplier),
+                             convertToDuration(forward_value->speed, length)});
+                    if (reverse_value)
+                        segment_updates.push_back(
+                            {geometry_id,
+                             false,
+                             offset,
+                             convertToWeight(*reverse_value, length, weight_multiplier),
+                             convertToDuration(reverse_value->speed, length)});
+                }
+            }
+        });
+
+    std::unordered_map<std::uint64_t, GeometryWeight> old_geometry_weights;
+    for (const auto &update : segment_updates)
+    {
+        old_geometry_weights.emplace(
+            geometryKey(update.geometry_id, update.forward),
+            getGeometryWeight(segment_data, update.geometry_id, update.forward));
+    }
+
+    for (const auto &update : segment_updates)
+    {
+        if (update.forward)
+        {
+            segment_data.GetForwardWeights(update.geometry_id)[update.offset] = update.weight;
+            segment_data.GetForwardDurations(update.geometry_id)[update.offset] = update.duration;
+            segment_data.GetForwardDatasources(update.geometry_id)[update.offset] = live_source;
+        }
+        else
+        {
+            // In this case we want it oriented from in forward directions
+            boost::adaptors::reverse(
+                segment_data.GetReverseWeights(update.geometry_id))[update.offset] = update.weight;
+            boost::adaptors::reverse(segment_data.GetReverseDurations(
+                update.geometry_id))[update.offset] = update.duration;
+            boost::adaptors::reverse(segment_data.GetReverseDatasources(
+                update.geometry_id))[update.offset] = live_source;
+        }
+    }
+
+    // Edges of nodes that were closed when the dataset was built were removed from the graph
+    std::size_t num_closed_geometries = 0;
+    std::unordered_map<std::uint64_t, NodeWeightUpdate> geometry_updates;
+    for (const auto &old_weight : old_geometry_weights)
+    {
+        if (old_weight.second.closed)
+        {
+            ++num_closed_geometries;
+            continue;
+        }
+
+        const auto geometry_id = static_cast<DirectionalGeometryID>(old_weight.first >> 1);
+        const auto new_weight = getGeometryWeight(segment_data, geometry_id, old_weight.first & 1);
+        geometry_updates[old_weight.first] = {new_weight.weight - old_weight.second.weight,
+                                              new_weight.duration - old_weight.second.duration,
+                                              new_weight.closed};
+    }
+    TIMER_STOP(segments);
+    util::Log() << "Updated " << segment_updates.size() << " segments of "
+                << old_geometry_weights.size() << " geometries in " << TIMER_MSEC(segments)
+                << "ms";
+    if (num_closed_geometries > 0)
+    {
+        util::Log(logWARNING) << num_closed_geometries
+                              << " geometries were closed when the dataset was built and can "
+                                 "only be opened by osrm-customize";
+    }
+
+    TIMER_START(edges);
+    const util::vector_view<GeometryID> geometry_ids(
+        layout.GetBlockPtr<GeometryID>(memory_ptr, DataLayout::GEOMETRY_ID_LIST),
+        layout.num_entries[DataLayout::GEOMETRY_ID_LIST]);
+    tbb::concurrent_vector<std::pair<NodeID, NodeWeightUpdate>> changed_nodes;
+    tbb::parallel_for(tbb::blocked_range<NodeID>(0, geometry_ids.size()),
+                      [&](const tbb::blocked_range<NodeID> &range) {
+                          for (auto node = range.begin(); node < range.end(); ++node)
+                          {
+                              const auto geometry_id = geometry_ids[node];
+                              const auto update = geometry_updates.find(
+                                  geometryKey(geometry_id.id, geometry_id.forward));
+                              if (update != geometry_updates.end())
+                                  changed_nodes.push_back({node, update->second});
+                          }
+                      });
+    const NodeWeightUpdates node_updates(changed_nodes.begin(), changed_nodes.end());
+
+    const auto partition = makePartitionView(layout, memory_ptr);
+    auto cell_storage = makeCellStorageView(layout, memory_ptr);
+    auto graph = makeGraphView(layout, memory_ptr);
+
+    customizer::CellCustomizerView customizer(partition);
+    auto cell_mask = customizer.MakeCellMask(false);
+    const auto num_changed_edges = updateEdgeWeights(graph, customizer, node_updates, cell_mask);
+    TIMER_STOP(edges);
+    util::Log() << "Updated " << num_changed_edges << " edges of " << node_updates.size()
+                << " nodes in " << TIMER_MSEC(edges) << "ms";
+
+    TIMER_START(customize);
+    customizer.Customize(graph, cell_storage, cell_mask);
+    TIMER_STOP(customize);
+    for (std::size_t level = 1; level < partition.GetNumberOfLevels(); ++level)
+    {
+        const auto &level_mask = cell_mask[level - 1];
+        util::Log() << "Level " << level << ": customized "
+                    << std::count(level_mask.begin(), level_mask.end(), true) << " of "
+                    << level_mask.size() << " cells";
+    }
+    util::Log() << "Cells customization took " << TIMER_MSEC(customize) << "ms";
+}
+}
+}
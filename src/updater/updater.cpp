@@ -1,7 +1,9 @@
 #include "updater/updater.hpp"
+#include "updater/conversion.hpp"
 #include "updater/csv_source.hpp"
 
 #include "extractor/compressed_edge_container.hpp"
+#include "extractor/conditional_turn_index.hpp"
 #include "extractor/edge_based_graph_factory.hpp"
 #include "extractor/files.hpp"
 #include "extractor/node_based_edge.hpp"
@@ -48,25 +50,6 @@
 #include <tuple>
 #include <vector>
 
-namespace std
-{
-template <typename T1, typename T2, typename T3> struct hash<std::tuple<T1, T2, T3>>
-{
-    size_t operator()(const std::tuple<T1, T2, T3> &t) const
-    {
-        return hash_val(std::get<0>(t), std::get<1>(t), std::get<2>(t));
-    }
-};
-
-template <typename T1, typename T2> struct hash<std::tuple<T1, T2>>
-{
-    size_t operator()(const std::tuple<T1, T2> &t) const
-    {
-        return hash_val(std::get<0>(t), std::get<1>(t));
-    }
-};
-}
-
 namespace osrm
 {
 namespace updater
@@ -80,25 +63,6 @@ template <typename T> inline bool is_aligned(const void *pointer)
     return reinterpret_cast<uintptr_t>(pointer) % alignof(T) == 0;
 }
 
-// Returns duration in deci-seconds
-inline SegmentDuration convertToDuration(double speed_in_kmh, double distance_in_meters)
-{
-    if (speed_in_kmh <= 0.)
-        return INVALID_SEGMENT_DURATION;
-
-    const auto speed_in_ms = speed_in_kmh / 3.6;
-    const auto duration = distance_in_meters / speed_in_ms;
-    auto segment_duration = std::max<SegmentDuration>(
-        1, boost::numeric_cast<SegmentDuration>(std::round(duration * 10.)));
-    if (segment_duration >= INVALID_SEGMENT_DURATION)
-    {
-        util::Log(logWARNING) << "Clamping segment duration " << segment_duration << " to "
-                              << MAX_SEGMENT_DURATION;
-        segment_duration = MAX_SEGMENT_DURATION;
-    }
-    return segment_duration;
-}
-
 #if !defined(NDEBUG)
 void checkWeightsConsistency(
     const UpdaterConfig &config,
@@ -162,27 +126,13 @@ updateSegmentData(const UpdaterConfig &config,
     std::atomic<std::uint32_t> fallbacks_to_duration{0};
     auto convertToWeight = [&profile_properties, &fallbacks_to_duration](
         const SpeedSource &value, double distance_in_meters) {
-        double rate = value.rate;
-        if (!std::isfinite(rate))
+        if (!std::isfinite(value.rate))
         { // use speed value in meters per second as the rate
             ++fallbacks_to_duration;
-            rate = value.speed / 3.6;
         }
 
-        if (rate <= 0.)
-            return INVALID_SEGMENT_WEIGHT;
-
-        const auto weight_multiplier = profile_properties.GetWeightMultiplier();
-        const auto weight = distance_in_meters / rate;
-        auto segment_weight = std::max<SegmentWeight>(
-            1, boost::numeric_cast<SegmentWeight>(std::round(weight * weight_multiplier)));
-        if (segment_weight >= INVALID_SEGMENT_WEIGHT)
-        {
-            util::Log(logWARNING) << "Clamping segment weight " << segment_weight << " to "
-                                  << MAX_SEGMENT_WEIGHT;
-            segment_weight = MAX_SEGMENT_WEIGHT;
-        }
-        return segment_weight;
+        return updater::convertToWeight(
+            value, distance_in_meters, profile_properties.GetWeightMultiplier());
     };
 
     // The check here is enabled by the `--edge-weight-updates-over-factor` flag it logs a
@@ -487,61 +437,65 @@ updateConditionalTurns(const UpdaterConfig &config,
                        extractor::PackedOSMIDs &osm_node_ids,
                        Timezoner time_zone_handler)
 {
-    // Mapped file pointer for turn indices
-    boost::iostreams::mapped_file_source turn_index_region;
-    auto turn_index_blocks = util::mmapFile<extractor::lookup::TurnIndexBlock>(
-        config.turn_penalties_index_path, turn_index_region);
-
     std::vector<std::uint64_t> updated_turns;
     if (conditional_turns.size() == 0)
         return updated_turns;
 
-    // TODO make this into a function
-    LookupTable<std::tuple<NodeID, NodeID>, NodeID> is_only_lookup;
-    std::unordered_set<std::tuple<NodeID, NodeID, NodeID>,
-                       std::hash<std::tuple<NodeID, NodeID, NodeID>>>
-        is_no_set;
-    for (const auto &c : conditional_turns)
+    // osrm-extract stores the turns of every restriction, older datasets need to scan the
+    // turn index on every update
+    TIMER_START(index);
+    extractor::ConditionalTurnIndex turn_index;
+    if (boost::filesystem::exists(config.restriction_turns_path))
     {
-        // only add restrictions to the lookups if the restriction is valid now
-        if (!IsRestrictionValid(time_zone_handler, c, coordinates, osm_node_ids))
-            continue;
-        if (c.flags.is_only)
-        {
-            is_only_lookup.lookup.push_back({std::make_tuple(c.from.node, c.via.node), c.to.node});
-        }
-        else
-        {
-            is_no_set.insert({std::make_tuple(c.from.node, c.via.node, c.to.node)});
-        }
+        extractor::files::readConditionalTurnIndex(config.restriction_turns_path, turn_index);
+    }
+    if (turn_index.GetNumberOfRestrictions() != conditional_turns.size())
+    {
+        util::Log(logWARNING) << "No turns of conditional restrictions in "
+                              << config.restriction_turns_path
+                              << ", re-run osrm-extract to speed up updates";
+
+        boost::iostreams::mapped_file_source turn_index_region;
+        auto turn_index_blocks = util::mmapFile<extractor::lookup::TurnIndexBlock>(
+            config.turn_penalties_index_path, turn_index_region);
+        turn_index = extractor::buildConditionalTurnIndex(conditional_turns, turn_index_blocks);
     }
+    TIMER_STOP(index);
 
-    for (std::uint64_t edge_index = 0; edge_index < turn_weight_penalties.size(); ++edge_index)
+    TIMER_START(evaluate);
+    std::vector<std::uint8_t> is_valid(conditional_turns.size());
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, conditional_turns.size()),
+                      [&](const tbb::blocked_range<std::size_t> &range) {
+                          for (auto index = range.begin(); index < range.end(); ++index)
+                          {
+                              is_valid[index] = IsRestrictionValid(time_zone_handler,
+                                                                   conditional_turns[index],
+                                                                   coordinates,
+                                                                   osm_node_ids);
+                          }
+                      });
+
+    for (const auto restriction : util::irange<std::size_t>(0, conditional_turns.size()))
     {
-        const extractor::lookup::TurnIndexBlock internal_turn = turn_index_blocks[edge_index];
+        if (!is_valid[restriction])
+            continue;
 
-        const auto is_no_tuple =
-            std::make_tuple(internal_turn.from_id, internal_turn.via_id, internal_turn.to_id);
-        const auto is_only_tuple = std::make_tuple(internal_turn.from_id, internal_turn.via_id);
-        // turn has a no_* restriction
-        if (is_no_set.find(is_no_tuple) != is_no_set.end())
+        for (const auto turn : turn_index.GetTurns(restriction))
         {
-            util::Log(logDEBUG) << "Conditional penalty set on edge: " << edge_index;
-            turn_weight_penalties[edge_index] = INVALID_TURN_PENALTY;
-            updated_turns.push_back(edge_index);
-        }
-        // turn has an only_* restriction
-        else if (is_only_lookup(is_only_tuple))
-        {
-            // with only_* restrictions, the turn on which the restriction is tagged is valid
-            if (*is_only_lookup(is_only_tuple) == internal_turn.to_id)
-                continue;
-
-            util::Log(logDEBUG) << "Conditional penalty set on edge: " << edge_index;
-            turn_weight_penalties[edge_index] = INVALID_TURN_PENALTY;
-            updated_turns.push_back(edge_index);
+            util::Log(logDEBUG) << "Conditional penalty set on edge: " << turn;
+            turn_weight_penalties[turn] = INVALID_TURN_PENALTY;
+            updated_turns.push_back(turn);
         }
     }
+    std::sort(updated_turns.begin(), updated_turns.end());
+    updated_turns.erase(std::unique(updated_turns.begin(), updated_turns.end()),
+                        updated_turns.end());
+    TIMER_STOP(evaluate);
+
+    util::Log() << "Conditional restrictions: " << std::count(is_valid.begin(), is_valid.end(), 1)
+                << " of " << conditional_turns.size() << " are valid and restrict "
+                << updated_turns.size() << " turns. Indexing took " << TIMER_MSEC(index)
+                << "ms, evaluation " << TIMER_MSEC(evaluate) << "ms.";
 
     return updated_turns;
 }
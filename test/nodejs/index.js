@@ -98,6 +98,44 @@ test('constructor: throws if data doesn\'t match algorithm', function(assert) {
     assert.throws(function() { new OSRM({algorithm: 'MLD', path: monaco_path}); });
 });
 
+test('constructor: takes a threads and max_queue_size option', function(assert) {
+    assert.plan(1);
+    var osrm = new OSRM({path: monaco_path, threads: 2, max_queue_size: 100});
+    assert.ok(osrm);
+});
+
+test('constructor: throws if given invalid worker pool options', function(assert) {
+    assert.plan(3);
+    assert.throws(function() { new OSRM({path: monaco_path, threads: 0}); },
+        /threads option must be a positive integer/);
+    assert.throws(function() { new OSRM({path: monaco_path, threads: 'a'}); },
+        /threads option must be a positive integer/);
+    assert.throws(function() { new OSRM({path: monaco_path, max_queue_size: -1}); },
+        /max_queue_size option must be an unsigned integer/);
+});
+
+test('constructor: rejects requests beyond max_queue_size', function(assert) {
+    var osrm = new OSRM({path: monaco_path, threads: 1, max_queue_size: 1});
+    var options = {coordinates: require('./constants').two_test_coordinates};
+    var num_requests = 5;
+    var num_rejected = 0;
+    assert.plan(num_requests + 1);
+    for (var i = 0; i < num_requests; ++i) {
+        osrm.route(options, function(err, route) {
+            if (err) {
+                assert.ok(/max_queue_size exceeded/.test(err.message), 'rejected by full queue');
+                ++num_rejected;
+            } else {
+                assert.ok(route.routes.length > 0, 'route of queued request');
+            }
+            if (--num_requests == 0) {
+                // one request runs and one waits, the others are rejected
+                assert.ok(num_rejected >= 3);
+            }
+        });
+    }
+});
+
 require('./route.js');
 require('./trip.js');
 require('./match.js');
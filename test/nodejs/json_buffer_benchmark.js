@@ -0,0 +1,53 @@
+// Compares how long the event loop is blocked by rendering large table responses
+// to JavaScript objects and by handing them over as JSON buffers.
+//
+//     node test/nodejs/json_buffer_benchmark.js [number of coordinates] [number of requests]
+
+var OSRM = require('../../');
+var data_path = require('./constants').data_path;
+
+var num_coordinates = parseInt(process.argv[2] || '500');
+var num_requests = parseInt(process.argv[3] || '20');
+
+// Somewhere in Monaco
+var coordinates = [];
+for (var i = 0; i < num_coordinates; ++i) {
+    coordinates.push([7.41337 + Math.random() * 0.012, 43.72956 + Math.random() * 0.012]);
+}
+
+var osrm = new OSRM(data_path);
+
+// Measures the longest delay of a 1ms timer while all requests run
+function measure(format, done) {
+    var max_lag = 0;
+    var total_lag = 0;
+    var last = process.hrtime();
+    var timer = setInterval(function() {
+        var elapsed = process.hrtime(last);
+        var lag = Math.max(elapsed[0] * 1e3 + elapsed[1] / 1e6 - 1, 0);
+        max_lag = Math.max(max_lag, lag);
+        total_lag += lag;
+        last = process.hrtime();
+    }, 1);
+
+    var start = process.hrtime();
+    var pending = num_requests;
+    for (var i = 0; i < num_requests; ++i) {
+        osrm.table({coordinates: coordinates}, {format: format}, function(err, result) {
+            if (err) throw err;
+            if (--pending > 0) return;
+
+            clearInterval(timer);
+            var elapsed = process.hrtime(start);
+            console.log(format + ': ' + (elapsed[0] * 1e3 + elapsed[1] / 1e6).toFixed(1) +
+                        'ms total, event loop blocked ' + total_lag.toFixed(1) + 'ms (max ' +
+                        max_lag.toFixed(1) + 'ms)');
+            done();
+        });
+    }
+}
+
+console.log(num_requests + ' tables of ' + num_coordinates + 'x' + num_coordinates);
+measure('object', function() {
+    measure('json_buffer', function() {});
+});
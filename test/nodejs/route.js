@@ -542,4 +542,23 @@ test('route: throws on bad approaches', function(assert) {
         approaches: [10, 15]
     }, function(err, route) {}) },
         /Approach must be a string: \[curb, unrestricted\] or null/);
-});
\ No newline at end of file
+});
+test('route: returns the same route as JSON buffer', function(assert) {
+    assert.plan(6);
+    var osrm = new OSRM(monaco_path);
+    var options = {
+        coordinates: two_test_coordinates,
+        steps: true
+    };
+    osrm.route(options, function(err, route) {
+        assert.ifError(err);
+        osrm.route(options, {format: 'json_buffer'}, function(err, buffer) {
+            assert.ifError(err);
+            assert.ok(Buffer.isBuffer(buffer), 'result must be a buffer');
+            var parsed = JSON.parse(buffer.toString());
+            assert.equal(parsed.waypoints.length, route.waypoints.length);
+            assert.equal(parsed.routes[0].legs[0].steps.length, route.routes[0].legs[0].steps.length);
+            assert.ok(Math.abs(parsed.routes[0].distance - route.routes[0].distance) < 0.1);
+        });
+    });
+});
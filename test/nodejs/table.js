@@ -166,3 +166,30 @@ test('table: distance table in Monaco without hints', function(assert) {
         table.destinations.map(assertHasNoHints);
     });
 });
+
+test('table: returns a JSON buffer with format json_buffer', function(assert) {
+    assert.plan(4);
+    var osrm = new OSRM(data_path);
+    var options = {
+        coordinates: three_test_coordinates
+    };
+    osrm.table(options, {format: 'json_buffer'}, function(err, table) {
+        assert.ifError(err);
+        assert.ok(Buffer.isBuffer(table), 'result must be a buffer');
+        var parsed = JSON.parse(table.toString());
+        assert.equal(parsed.durations.length, three_test_coordinates.length);
+        assert.notOk(parsed.code, 'code is removed like for objects');
+    });
+});
+
+test('table: throws on invalid format', function(assert) {
+    assert.plan(2);
+    var osrm = new OSRM(data_path);
+    var options = {
+        coordinates: three_test_coordinates
+    };
+    assert.throws(function() { osrm.table(options, {format: 'xml'}, function(err, table) {}); },
+        /format must be a string: "object" or "json_buffer"/);
+    assert.throws(function() { osrm.table(options, {format: 3}, function(err, table) {}); },
+        /format must be a string: "object" or "json_buffer"/);
+});
@@ -0,0 +1,135 @@
+#include <boost/test/unit_test.hpp>
+
+#include "contractor/customizable_hierarchy.hpp"
+#include "contractor/reference_dijkstra.hpp"
+#include "util/exception.hpp"
+#include "util/integer_range.hpp"
+
+#include <algorithm>
+#include <random>
+
+using namespace osrm;
+using namespace osrm::contractor;
+using namespace osrm::util;
+
+namespace
+{
+// shortest path weights between all pairs of nodes in the original graph
+std::vector<std::vector<EdgeWeight>>
+plainDistances(const NodeID number_of_nodes, const std::vector<extractor::EdgeBasedEdge> &edges)
+{
+    const auto adjacency = makeAdjacency(number_of_nodes, edges);
+
+    std::vector<std::vector<EdgeWeight>> distances;
+    for (const auto source : irange<NodeID>(0, number_of_nodes))
+        distances.push_back(dijkstra(adjacency, source));
+    return distances;
+}
+
+// shortest path weights between all pairs of nodes by meeting of two upward searches
+std::vector<std::vector<EdgeWeight>> hierarchyDistances(const NodeID number_of_nodes,
+                                                        const DeallocatingVector<QueryEdge> &edges)
+{
+    const auto forward = makeUpwardAdjacency(number_of_nodes, edges, true);
+    const auto backward = makeUpwardAdjacency(number_of_nodes, edges, false);
+
+    std::vector<std::vector<EdgeWeight>> forward_weights, backward_weights;
+    for (const auto node : irange<NodeID>(0, number_of_nodes))
+    {
+        forward_weights.push_back(dijkstra(forward, node));
+        backward_weights.push_back(dijkstra(backward, node));
+    }
+
+    std::vector<std::vector<EdgeWeight>> distances(
+        number_of_nodes, std::vector<EdgeWeight>(number_of_nodes, INVALID_EDGE_WEIGHT));
+    for (const auto source : irange<NodeID>(0, number_of_nodes))
+        for (const auto target : irange<NodeID>(0, number_of_nodes))
+            for (const auto middle : irange<NodeID>(0, number_of_nodes))
+            {
+                const auto to_middle = forward_weights[source][middle];
+                const auto from_middle = backward_weights[target][middle];
+                if (to_middle != INVALID_EDGE_WEIGHT && from_middle != INVALID_EDGE_WEIGHT)
+                    distances[source][target] =
+                        std::min(distances[source][target], to_middle + from_middle);
+            }
+    return distances;
+}
+
+std::vector<extractor::EdgeBasedEdge> makeRandomEdges(std::mt19937 &generator,
+                                                      const NodeID number_of_nodes,
+                                                      const std::size_t number_of_edges)
+{
+    std::uniform_int_distribution<NodeID> node(0, number_of_nodes - 1);
+    std::uniform_int_distribution<EdgeWeight> weight(1, 100);
+    std::bernoulli_distribution both_directions(0.3);
+
+    std::vector<extractor::EdgeBasedEdge> edges;
+    for (const auto id : irange<NodeID>(0, number_of_edges))
+    {
+        const auto source = node(generator);
+        const auto target = node(generator);
+        const auto edge_weight = weight(generator);
+        edges.emplace_back(
+            source, target, id, edge_weight, edge_weight, true, both_directions(generator));
+    }
+    return edges;
+}
+}
+
+BOOST_AUTO_TEST_SUITE(customizable_hierarchy)
+
+BOOST_AUTO_TEST_CASE(customized_distances_test)
+{
+    std::mt19937 generator(42);
+    const NodeID number_of_nodes = 60;
+    auto edges = makeRandomEdges(generator, number_of_nodes, 150);
+
+    std::uniform_int_distribution<std::uint8_t> priority(0, 2);
+    std::vector<std::uint8_t> node_priorities(number_of_nodes);
+    std::generate(
+        node_priorities.begin(), node_priorities.end(), [&] { return priority(generator); });
+
+    for (const auto &priorities : {std::vector<std::uint8_t>{}, node_priorities})
+    {
+        const CustomizableHierarchy hierarchy(number_of_nodes, edges, priorities);
+        BOOST_CHECK_EQUAL(hierarchy.GetNumberOfNodes(), number_of_nodes);
+
+        const auto query_edges = hierarchy.Customize(edges, {});
+        const auto expected = plainDistances(number_of_nodes, edges);
+        const auto actual = hierarchyDistances(number_of_nodes, query_edges);
+        for (const auto source : irange<NodeID>(0, number_of_nodes))
+            for (const auto target : irange<NodeID>(0, number_of_nodes))
+                BOOST_CHECK_EQUAL(actual[source][target], expected[source][target]);
+
+        // new weights for the same topology don't need a new hierarchy
+        auto changed_edges = edges;
+        std::uniform_int_distribution<EdgeWeight> weight(1, 1000);
+        for (auto &edge : changed_edges)
+            edge.data.weight = weight(generator);
+        changed_edges[0].data.weight = INVALID_EDGE_WEIGHT;
+
+        const auto changed_query_edges = hierarchy.Customize(changed_edges, {});
+        changed_edges.erase(changed_edges.begin());
+        const auto changed_expected = plainDistances(number_of_nodes, changed_edges);
+        const auto changed_actual = hierarchyDistances(number_of_nodes, changed_query_edges);
+        for (const auto source : irange<NodeID>(0, number_of_nodes))
+            for (const auto target : irange<NodeID>(0, number_of_nodes))
+                BOOST_CHECK_EQUAL(changed_actual[source][target],
+                                  changed_expected[source][target]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(mismatching_topology_test)
+{
+    // a path 0 - 1 - 2 - 3 needs no shortcuts
+    std::vector<extractor::EdgeBasedEdge> edges;
+    for (const auto node : irange<NodeID>(0, 3))
+        edges.emplace_back(node, node + 1, node, 1, 1, true, true);
+    const CustomizableHierarchy hierarchy(4, edges, {});
+
+    // the edge 0 -> 3 has no arc in the hierarchy
+    edges.emplace_back(0, 3, 3, 1, 1, true, false);
+    BOOST_CHECK_THROW(hierarchy.Customize(edges, {}), util::exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
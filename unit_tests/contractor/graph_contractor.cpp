@@ -0,0 +1,135 @@
+#include <boost/test/unit_test.hpp>
+
+#include "contractor/graph_contractor.hpp"
+#include "contractor/graph_contractor_adaptors.hpp"
+#include "contractor/reference_dijkstra.hpp"
+#include "extractor/edge_based_edge.hpp"
+#include "util/integer_range.hpp"
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace osrm;
+using namespace osrm::contractor;
+using namespace osrm::util;
+
+namespace
+{
+// Shortest path weight of the meeting point of two upward searches
+EdgeWeight hierarchyDistance(const std::vector<EdgeWeight> &forward_weights,
+                             const std::vector<EdgeWeight> &backward_weights)
+{
+    EdgeWeight distance = INVALID_EDGE_WEIGHT;
+    for (std::size_t middle = 0; middle < forward_weights.size(); ++middle)
+    {
+        if (forward_weights[middle] != INVALID_EDGE_WEIGHT &&
+            backward_weights[middle] != INVALID_EDGE_WEIGHT)
+            distance = std::min(distance, forward_weights[middle] + backward_weights[middle]);
+    }
+    return distance;
+}
+
+// Every shortcut has to be unpackable into the arcs to and from its middle node. A middle node
+// id that is not translated back to the original id on a flush points to an unrelated node.
+template <typename EdgeContainerT> void checkShortcutMiddleNodes(const EdgeContainerT &edges)
+{
+    std::map<std::pair<NodeID, NodeID>, EdgeWeight> arcs;
+    const auto add_arc = [&arcs](const NodeID from, const NodeID to, const EdgeWeight weight) {
+        const auto inserted = arcs.emplace(std::make_pair(from, to), weight);
+        if (!inserted.second)
+            inserted.first->second = std::min(inserted.first->second, weight);
+    };
+    for (const auto &edge : edges)
+    {
+        if (edge.data.forward)
+            add_arc(edge.source, edge.target, edge.data.weight);
+        if (edge.data.backward)
+            add_arc(edge.target, edge.source, edge.data.weight);
+    }
+
+    const auto check_shortcut = [&arcs](
+        const NodeID from, const NodeID middle, const NodeID to, const EdgeWeight weight) {
+        const auto to_middle = arcs.find(std::make_pair(from, middle));
+        const auto from_middle = arcs.find(std::make_pair(middle, to));
+        BOOST_REQUIRE(to_middle != arcs.end());
+        BOOST_REQUIRE(from_middle != arcs.end());
+        BOOST_CHECK_LE(to_middle->second + from_middle->second, weight);
+    };
+    for (const auto &edge : edges)
+    {
+        if (!edge.data.shortcut)
+            continue;
+        if (edge.data.forward)
+            check_shortcut(edge.source, edge.data.turn_id, edge.target, edge.data.weight);
+        if (edge.data.backward)
+            check_shortcut(edge.target, edge.data.turn_id, edge.source, edge.data.weight);
+    }
+}
+
+// grid with random weights where some of the edges are one-way
+std::vector<extractor::EdgeBasedEdge>
+makeRandomGridEdges(std::mt19937 &generator, const NodeID rows, const NodeID columns)
+{
+    std::uniform_int_distribution<EdgeWeight> weight(1, 100);
+    std::bernoulli_distribution oneway(0.2);
+
+    std::vector<extractor::EdgeBasedEdge> edges;
+    const auto add_edge = [&](const NodeID source, const NodeID target) {
+        const auto edge_weight = weight(generator);
+        edges.emplace_back(
+            source, target, edges.size(), edge_weight, edge_weight, true, !oneway(generator));
+    };
+    for (const auto row : irange<NodeID>(0, rows))
+        for (const auto column : irange<NodeID>(0, columns))
+        {
+            const auto node = row * columns + column;
+            if (column + 1 < columns)
+                add_edge(node, node + 1);
+            if (row + 1 < rows)
+                add_edge(node + columns, node);
+        }
+    return edges;
+}
+}
+
+BOOST_AUTO_TEST_SUITE(graph_contractor)
+
+BOOST_AUTO_TEST_CASE(memory_bounded_contraction_test)
+{
+    // the grid is large enough that the memory bounded mode flushes more than once
+    std::mt19937 generator(1337);
+    const NodeID number_of_nodes = 120 * 120;
+    const auto edges = makeRandomGridEdges(generator, 120, 120);
+    const auto graph = makeAdjacency(number_of_nodes, edges);
+
+    std::uniform_int_distribution<NodeID> node(0, number_of_nodes - 1);
+    std::vector<std::pair<NodeID, NodeID>> queries;
+    for (int query = 0; query < 20; ++query)
+        queries.emplace_back(node(generator), node(generator));
+
+    for (const bool memory_bounded : {false, true})
+    {
+        GraphContractor graph_contractor(number_of_nodes,
+                                         adaptToContractorInput(edges),
+                                         {},
+                                         std::vector<EdgeWeight>(number_of_nodes, 0));
+        graph_contractor.Run(1.0, memory_bounded);
+        const auto query_edges = graph_contractor.GetEdges<QueryEdge>();
+        checkShortcutMiddleNodes(query_edges);
+
+        const auto forward = makeUpwardAdjacency(number_of_nodes, query_edges, true);
+        const auto backward = makeUpwardAdjacency(number_of_nodes, query_edges, false);
+        for (const auto &query : queries)
+        {
+            const auto expected = dijkstra(graph, query.first)[query.second];
+            BOOST_CHECK_EQUAL(hierarchyDistance(dijkstra(forward, query.first),
+                                                dijkstra(backward, query.second)),
+                              expected);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
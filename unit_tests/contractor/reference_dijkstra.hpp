@@ -0,0 +1,71 @@
+#ifndef OSRM_UNIT_TEST_CONTRACTOR_REFERENCE_DIJKSTRA_HPP
+#define OSRM_UNIT_TEST_CONTRACTOR_REFERENCE_DIJKSTRA_HPP
+
+#include "util/typedefs.hpp"
+
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+using namespace osrm::util;
+
+using Adjacency = std::vector<std::vector<std::pair<NodeID, EdgeWeight>>>;
+
+// Plain Dijkstra from a single source, the reference for shortest path weights in the tests
+inline std::vector<EdgeWeight> dijkstra(const Adjacency &adjacency, const NodeID source)
+{
+    using QueueEntry = std::pair<EdgeWeight, NodeID>;
+    std::vector<EdgeWeight> weights(adjacency.size(), INVALID_EDGE_WEIGHT);
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+    weights[source] = 0;
+    queue.emplace(0, source);
+    while (!queue.empty())
+    {
+        const auto weight = queue.top().first;
+        const auto node = queue.top().second;
+        queue.pop();
+        if (weight > weights[node])
+            continue;
+        for (const auto &edge : adjacency[node])
+        {
+            if (weight + edge.second < weights[edge.first])
+            {
+                weights[edge.first] = weight + edge.second;
+                queue.emplace(weights[edge.first], edge.first);
+            }
+        }
+    }
+    return weights;
+}
+
+// Adjacency of the original graph, edges have a forward and backward flag like the input edges
+template <typename EdgeContainerT>
+inline Adjacency makeAdjacency(const NodeID number_of_nodes, const EdgeContainerT &edges)
+{
+    Adjacency adjacency(number_of_nodes);
+    for (const auto &edge : edges)
+    {
+        if (edge.data.forward)
+            adjacency[edge.source].emplace_back(edge.target, edge.data.weight);
+        if (edge.data.backward)
+            adjacency[edge.target].emplace_back(edge.source, edge.data.weight);
+    }
+    return adjacency;
+}
+
+// Adjacency of the upward search space of a hierarchy in forward or backward direction
+template <typename EdgeContainerT>
+inline Adjacency
+makeUpwardAdjacency(const NodeID number_of_nodes, const EdgeContainerT &edges, const bool forward)
+{
+    Adjacency adjacency(number_of_nodes);
+    for (const auto &edge : edges)
+    {
+        if (forward ? edge.data.forward : edge.data.backward)
+            adjacency[edge.source].emplace_back(edge.target, edge.data.weight);
+    }
+    return adjacency;
+}
+
+#endif // OSRM_UNIT_TEST_CONTRACTOR_REFERENCE_DIJKSTRA_HPP
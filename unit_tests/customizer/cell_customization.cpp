@@ -6,6 +6,8 @@
 #include "partition/multi_level_partition.hpp"
 #include "util/static_graph.hpp"
 
+#include <random>
+
 using namespace osrm;
 using namespace osrm::customizer;
 using namespace osrm::partition;
@@ -263,4 +265,134 @@ BOOST_AUTO_TEST_CASE(four_levels_test)
     CHECK_EQUAL_COLLECTIONS(cell_2_1.GetInWeight(12), storage_rec.GetCell(2, 1).GetInWeight(12));
 }
 
+BOOST_AUTO_TEST_CASE(incremental_customization_test)
+{
+    // node:                0  1  2  3  4  5  6  7  8  9 10 11 12 13 14 15
+    std::vector<CellID> l1{{0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3}};
+    std::vector<CellID> l2{{0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1}};
+    std::vector<CellID> l3{{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}};
+    MultiLevelPartition mlp{{l1, l2, l3}, {4, 2, 1}};
+
+    std::vector<MockEdge> edges = {
+        {0, 1, 1}, {0, 2, 1}, {3, 1, 1},   {3, 2, 1},  {4, 5, 1},  {4, 6, 1},  {4, 7, 1},
+        {5, 4, 1}, {5, 6, 1}, {5, 7, 1},   {6, 4, 1},  {6, 5, 1},  {6, 7, 1},  {7, 4, 1},
+        {7, 5, 1}, {7, 6, 1}, {9, 11, 1},  {10, 8, 1}, {11, 10, 1}, {13, 12, 10}, {15, 14, 1},
+        {2, 4, 1}, {5, 12, 1}, {8, 3, 1},  {9, 3, 1},  {12, 5, 1}, {13, 7, 1}, {14, 9, 1},
+        {14, 11, 1}};
+
+    auto previous_graph = makeGraph(mlp, edges);
+    CellStorage storage(mlp, previous_graph);
+    CellCustomizer customizer(mlp);
+    customizer.Customize(previous_graph, storage);
+
+    // edge inside of cell (2, 1, 0)
+    edges[16].weight = 5;
+    // edge between cells (0, 0, 0) -> (1, 0, 0)
+    edges[21].weight = 3;
+    auto graph = makeGraph(mlp, edges);
+
+    auto changed_cells = customizer.GetChangedCells(graph, previous_graph);
+    BOOST_REQUIRE_EQUAL(changed_cells.size(), 3);
+    const std::vector<bool> changed_level_1 = {false, false, true, false};
+    const std::vector<bool> changed_level_2 = {true, true};
+    const std::vector<bool> changed_level_3 = {true};
+    CHECK_EQUAL_COLLECTIONS(changed_cells[0], changed_level_1);
+    CHECK_EQUAL_COLLECTIONS(changed_cells[1], changed_level_2);
+    CHECK_EQUAL_COLLECTIONS(changed_cells[2], changed_level_3);
+
+    auto unchanged_cells = customizer.GetChangedCells(graph, graph);
+    BOOST_CHECK(std::none_of(unchanged_cells.begin(), unchanged_cells.end(), [](const auto &mask) {
+        return std::find(mask.begin(), mask.end(), true) != mask.end();
+    }));
+
+    customizer.Customize(graph, storage, changed_cells);
+
+    CellStorage storage_full(mlp, graph);
+    customizer.Customize(graph, storage_full);
+
+    const auto &const_storage = storage;
+    const auto &const_storage_full = storage_full;
+    for (LevelID level = 1; level < mlp.GetNumberOfLevels(); ++level)
+    {
+        for (CellID id = 0; id < mlp.GetNumberOfCells(level); ++id)
+        {
+            const auto cell = const_storage.GetCell(level, id);
+            const auto cell_full = const_storage_full.GetCell(level, id);
+            for (auto node : cell.GetSourceNodes())
+            {
+                CHECK_EQUAL_COLLECTIONS(cell.GetOutWeight(node), cell_full.GetOutWeight(node));
+            }
+        }
+    }
+
+    // the changed weight is visible in the updated cells
+    CHECK_EQUAL_RANGE(const_storage.GetCell(1, 2).GetOutWeight(9), 7, 5);
+}
+
+BOOST_AUTO_TEST_CASE(dense_kernel_test)
+{
+    const std::size_t num_cells = 8;
+    const std::size_t cell_size = 16;
+
+    std::vector<CellID> l1(num_cells * cell_size);
+    std::vector<CellID> l2(num_cells * cell_size);
+    for (NodeID node = 0; node < l1.size(); ++node)
+    {
+        l1[node] = node / cell_size;
+        l2[node] = node / (cell_size * num_cells / 2);
+    }
+    MultiLevelPartition mlp{{l1, l2}, {num_cells, 2}};
+
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<NodeID> cell_node(0, cell_size - 1);
+    std::uniform_int_distribution<NodeID> any_node(0, l1.size() - 1);
+    std::uniform_int_distribution<EdgeWeight> weight(1, 100);
+    std::vector<MockEdge> edges;
+    for (NodeID node = 0; node < l1.size(); ++node)
+    {
+        const NodeID cell_begin = node / cell_size * cell_size;
+        for (auto index = 0; index < 2; ++index)
+        {
+            const auto target = cell_begin + cell_node(generator);
+            if (target != node)
+                edges.push_back({node, target, weight(generator)});
+        }
+        if (node % 4 == 0)
+        {
+            const auto target = any_node(generator);
+            if (target != node)
+                edges.push_back({node, target, weight(generator)});
+        }
+    }
+    const auto graph = makeGraph(mlp, edges);
+
+    CellCustomizer customizer(mlp);
+    CellCustomizer::Heap heap(graph.GetNumberOfNodes());
+    CellCustomizer::DenseCell dense;
+
+    CellStorage storage_dijkstra(mlp, graph);
+    CellStorage storage_dense(mlp, graph);
+    for (CellID id = 0; id < num_cells; ++id)
+    {
+        customizer.Customize(graph, heap, storage_dijkstra, 1, id);
+        BOOST_REQUIRE(customizer.CustomizeDense(graph, dense, storage_dense, id));
+    }
+
+    const auto &const_storage_dijkstra = storage_dijkstra;
+    const auto &const_storage_dense = storage_dense;
+    for (CellID id = 0; id < num_cells; ++id)
+    {
+        const auto cell_dijkstra = const_storage_dijkstra.GetCell(1, id);
+        const auto cell_dense = const_storage_dense.GetCell(1, id);
+        for (auto node : cell_dijkstra.GetSourceNodes())
+        {
+            CHECK_EQUAL_COLLECTIONS(cell_dense.GetOutWeight(node),
+                                    cell_dijkstra.GetOutWeight(node));
+        }
+    }
+
+    // cells that are too large are left to the Dijkstra kernel
+    BOOST_CHECK(!customizer.CustomizeDense(graph, dense, storage_dense, 0, 1));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
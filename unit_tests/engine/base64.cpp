@@ -1,12 +1,15 @@
 #include "engine/base64.hpp"
 #include "mocks/mock_datafacade.hpp"
+#include "engine/compact_hint.hpp"
 #include "engine/hint.hpp"
 
+#include <boost/optional.hpp>
 #include <boost/test/test_case_template.hpp>
 #include <boost/test/unit_test.hpp>
 
 #include <algorithm>
 #include <iostream>
+#include <limits>
 
 // RFC 4648 "The Base16, Base32, and Base64 Data Encodings"
 BOOST_AUTO_TEST_SUITE(base64)
@@ -75,4 +78,140 @@ BOOST_AUTO_TEST_CASE(hint_encoding_decoding_roundtrip_bytewise)
                            reinterpret_cast<const unsigned char *>(&decoded)));
 }
 
+BOOST_AUTO_TEST_CASE(compact_hint_encoding_decoding_roundtrip)
+{
+    using namespace osrm::engine;
+
+    CompactHint hint;
+    hint.forward_segment_id = {12345, true};
+    hint.reverse_segment_id = {SPECIAL_SEGMENTID, false};
+    hint.fwd_segment_position = 7;
+    hint.coordinate_fingerprint = 65535;
+    hint.segment_checksum = 0xfbfbfbfb;
+
+    const auto base64 = hint.ToBase64();
+    BOOST_CHECK_EQUAL(base64.size(), ENCODED_COMPACT_HINT_SIZE);
+    BOOST_CHECK(0 == std::count(begin(base64), end(base64), '+'));
+    BOOST_CHECK(0 == std::count(begin(base64), end(base64), '/'));
+
+    BOOST_CHECK_EQUAL(hint, CompactHint::FromBase64(base64));
+}
+
+BOOST_AUTO_TEST_CASE(compact_hint_of_unknown_segment)
+{
+    using namespace osrm::engine;
+
+    // the mock facade has no edge-based nodes, so the hint needs to be snapped again
+    const osrm::test::MockDataFacade<osrm::engine::routing_algorithms::ch::Algorithm> facade{};
+    CompactHint hint;
+    hint.forward_segment_id = {0, true};
+    BOOST_CHECK(
+        !hint.ToPhantomNode(osrm::util::Coordinate{}, DEFAULT_COMPACT_HINT_MAX_DISTANCE, facade));
+}
+
+namespace
+{
+// A dataset with a single segment from (0, 0) to (target_lon, 0)
+class SegmentDataFacade final : public osrm::test::MockBaseDataFacade
+{
+  public:
+    explicit SegmentDataFacade(const int target_lon_) : target_lon(target_lon_) {}
+
+    osrm::util::Coordinate GetCoordinateOfNode(const NodeID id) const override
+    {
+        return {osrm::util::FixedLongitude{id == 0 ? 0 : target_lon},
+                osrm::util::FixedLatitude{0}};
+    }
+    GeometryID GetGeometryIndex(const NodeID /* id */) const override { return {0, true}; }
+    std::size_t GetNumberOfEdgeBasedNodes() const override { return 1; }
+    std::vector<NodeID> GetUncompressedForwardGeometry(const EdgeID /* id */) const override
+    {
+        return {0, 1};
+    }
+    osrm::engine::PhantomNode
+    NearestPhantomNodeOnSegment(const osrm::util::Coordinate input_coordinate,
+                                const RTreeLeaf &segment) const override
+    {
+        osrm::engine::PhantomNode phantom;
+        phantom.forward_segment_id = segment.forward_segment_id;
+        phantom.reverse_segment_id = segment.reverse_segment_id;
+        phantom.fwd_segment_position = segment.fwd_segment_position;
+        phantom.input_location = input_coordinate;
+        // the projection onto the segment is clamped to its end points
+        const auto lon = std::min(std::max(0, input_coordinate.lon.__value), target_lon);
+        phantom.location = {osrm::util::FixedLongitude{lon}, osrm::util::FixedLatitude{0}};
+        return phantom;
+    }
+
+  private:
+    const int target_lon;
+};
+}
+
+BOOST_AUTO_TEST_CASE(compact_hint_of_segment)
+{
+    using namespace osrm::engine;
+    using osrm::util::Coordinate;
+    using osrm::util::FixedLatitude;
+    using osrm::util::FixedLongitude;
+
+    const SegmentDataFacade facade{1000};
+    const Coordinate input{FixedLongitude{500}, FixedLatitude{10}};
+
+    PhantomNode phantom;
+    phantom.forward_segment_id = {0, true};
+    phantom.input_location = input;
+    const auto hint = CompactHint::FromPhantomNode(phantom, facade);
+
+    const auto snapped = hint.ToPhantomNode(input, DEFAULT_COMPACT_HINT_MAX_DISTANCE, facade);
+    BOOST_REQUIRE(snapped);
+    BOOST_CHECK_EQUAL(snapped->forward_segment_id.id, 0);
+    BOOST_CHECK_EQUAL(snapped->input_location, input);
+
+    // moved away from the segment or past its end, where the projection is clamped
+    const auto moved = [&](const int lon, const int lat) {
+        return hint.ToPhantomNode(Coordinate{FixedLongitude{lon}, FixedLatitude{lat}},
+                                  DEFAULT_COMPACT_HINT_MAX_DISTANCE,
+                                  facade);
+    };
+    BOOST_CHECK(!moved(500, 5000));
+    BOOST_CHECK(!moved(5000, 0));
+    BOOST_CHECK(!moved(501, 10));
+
+    // the end point of the segment moved in another dataset
+    const SegmentDataFacade changed_facade{2000};
+    BOOST_CHECK(!hint.ToPhantomNode(input, DEFAULT_COMPACT_HINT_MAX_DISTANCE, changed_facade));
+
+    // a coordinate further away than the radius is snapped again
+    BOOST_CHECK(!hint.ToPhantomNode(input, 0.5, facade));
+}
+
+BOOST_AUTO_TEST_CASE(compact_hint_of_colliding_coordinate)
+{
+    using namespace osrm::engine;
+    using osrm::util::Coordinate;
+    using osrm::util::FixedLatitude;
+    using osrm::util::FixedLongitude;
+
+    const SegmentDataFacade facade{1000};
+    const Coordinate input{FixedLongitude{500}, FixedLatitude{10}};
+
+    PhantomNode phantom;
+    phantom.forward_segment_id = {0, true};
+    phantom.input_location = input;
+    const auto hint = CompactHint::FromPhantomNode(phantom, facade);
+
+    // the fingerprint has 16 bits, so some coordinate far north of the segment collides with it
+    const auto unlimited = std::numeric_limits<double>::max();
+    boost::optional<Coordinate> colliding;
+    for (int lat = 1000000; !colliding && lat < 2000000; ++lat)
+    {
+        const Coordinate coordinate{FixedLongitude{500}, FixedLatitude{lat}};
+        if (hint.ToPhantomNode(coordinate, unlimited, facade))
+            colliding = coordinate;
+    }
+    BOOST_REQUIRE(colliding);
+    BOOST_CHECK(!hint.ToPhantomNode(*colliding, DEFAULT_COMPACT_HINT_MAX_DISTANCE, facade));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
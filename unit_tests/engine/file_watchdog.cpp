@@ -0,0 +1,235 @@
+#include "engine/file_watchdog.hpp"
+
+#include "storage/io.hpp"
+#include "storage/manifest.hpp"
+#include "storage/serialization.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(file_watchdog_test)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+namespace
+{
+struct MockFacade
+{
+    int generation;
+};
+
+using Watchdog = FileWatchdog<MockFacade>;
+
+const constexpr std::chrono::milliseconds POLL_INTERVAL{10};
+
+struct TemporaryDataset
+{
+    TemporaryDataset()
+        : directory(boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()),
+          base((directory / "test.osrm").string())
+    {
+        boost::filesystem::create_directory(directory);
+        WriteFile(".hsgr", 1000);
+        Publish(true);
+    }
+
+    ~TemporaryDataset() { boost::filesystem::remove_all(directory); }
+
+    void WriteFile(const std::string &suffix, const std::size_t num_elements)
+    {
+        std::vector<std::uint32_t> data(num_elements);
+        std::iota(data.begin(), data.end(), 0);
+        storage::io::FileWriter writer(base.string() + suffix,
+                                       storage::io::FileWriter::GenerateFingerprint);
+        storage::serialization::write(writer, data);
+    }
+
+    // writes the manifest like a pipeline tool, with a new modification time
+    void Publish(const bool complete)
+    {
+        storage::manifest::updateManifest(base, {".hsgr"}, complete);
+        Touch();
+    }
+
+    // like Publish, but within the resolution of the modification time
+    void PublishInSameSecond(const bool complete)
+    {
+        storage::manifest::updateManifest(base, {".hsgr"}, complete);
+        const auto manifest_path = storage::manifest::getManifestPath(base);
+        boost::filesystem::last_write_time(manifest_path, modification_time);
+    }
+
+    void Touch()
+    {
+        const auto manifest_path = storage::manifest::getManifestPath(base);
+        modification_time += 10;
+        boost::filesystem::last_write_time(manifest_path, modification_time);
+    }
+
+    boost::filesystem::path directory;
+    boost::filesystem::path base;
+    std::time_t modification_time = std::time(nullptr);
+};
+
+struct MockLoader
+{
+    Watchdog::LoadFunction Load()
+    {
+        return [this](const storage::StorageConfig &) {
+            const int generation = loads++;
+            if (fail && generation > 0)
+                throw std::runtime_error("out of memory");
+            return std::make_shared<const MockFacade>(MockFacade{generation});
+        };
+    }
+
+    Watchdog::MemoryFunction RequiredMemory()
+    {
+        return [this](const storage::StorageConfig &) { return required_memory.load(); };
+    }
+
+    std::atomic<int> loads{0};
+    std::atomic<bool> fail{false};
+    std::atomic<std::uint64_t> required_memory{1};
+};
+
+bool waitFor(const std::function<bool()> &condition)
+{
+    for (int tries = 0; tries < 500; ++tries)
+    {
+        if (condition())
+            return true;
+        std::this_thread::sleep_for(POLL_INTERVAL);
+    }
+    return false;
+}
+
+// gives the watchdog time to notice a change that should not be loaded
+void waitSomePolls() { std::this_thread::sleep_for(POLL_INTERVAL * 30); }
+}
+
+BOOST_AUTO_TEST_CASE(reload_completed_dataset)
+{
+    TemporaryDataset dataset;
+    MockLoader loader;
+    Watchdog watchdog(storage::StorageConfig{dataset.base},
+                      100,
+                      {},
+                      loader.Load(),
+                      loader.RequiredMemory(),
+                      POLL_INTERVAL);
+    BOOST_CHECK_EQUAL(watchdog.Get()->generation, 0);
+
+    dataset.WriteFile(".hsgr", 2000);
+    dataset.Publish(true);
+    BOOST_CHECK(waitFor([&] { return watchdog.Get()->generation >= 1; }));
+}
+
+BOOST_AUTO_TEST_CASE(skip_incomplete_datasets)
+{
+    TemporaryDataset dataset;
+    MockLoader loader;
+    Watchdog watchdog(storage::StorageConfig{dataset.base},
+                      100,
+                      {},
+                      loader.Load(),
+                      loader.RequiredMemory(),
+                      POLL_INTERVAL);
+
+    // osrm-extract finished, but osrm-contract did not run yet
+    dataset.WriteFile(".hsgr", 2000);
+    dataset.Publish(false);
+    waitSomePolls();
+    BOOST_CHECK_EQUAL(loader.loads, 1);
+
+    dataset.Publish(true);
+    BOOST_CHECK(waitFor([&] { return watchdog.Get()->generation >= 1; }));
+    waitSomePolls();
+    const int loads = loader.loads;
+    const auto generation = watchdog.Get()->generation;
+
+    // the next pipeline run rewrote a file of the completed dataset
+    dataset.WriteFile(".hsgr", 2000);
+    {
+        boost::filesystem::fstream file(dataset.base.string() + ".hsgr",
+                                        std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(100);
+        file.put(42);
+    }
+    dataset.Touch();
+    waitSomePolls();
+    BOOST_CHECK_EQUAL(loader.loads, loads);
+    BOOST_CHECK_EQUAL(watchdog.Get()->generation, generation);
+}
+
+BOOST_AUTO_TEST_CASE(reload_dataset_completed_in_same_second)
+{
+    TemporaryDataset dataset;
+    MockLoader loader;
+    Watchdog watchdog(storage::StorageConfig{dataset.base},
+                      100,
+                      {},
+                      loader.Load(),
+                      loader.RequiredMemory(),
+                      POLL_INTERVAL);
+
+    dataset.WriteFile(".hsgr", 2000);
+    dataset.Publish(false);
+    waitSomePolls();
+    BOOST_CHECK_EQUAL(loader.loads, 1);
+
+    // the last pipeline tool finished without changing the modification time
+    dataset.PublishInSameSecond(true);
+    BOOST_CHECK(waitFor([&] { return watchdog.Get()->generation >= 1; }));
+}
+
+BOOST_AUTO_TEST_CASE(keep_old_dataset_on_failed_reload)
+{
+    TemporaryDataset dataset;
+    MockLoader loader;
+    loader.fail = true;
+    Watchdog watchdog(storage::StorageConfig{dataset.base},
+                      100,
+                      {},
+                      loader.Load(),
+                      loader.RequiredMemory(),
+                      POLL_INTERVAL);
+
+    dataset.Publish(true);
+    BOOST_CHECK(waitFor([&] { return loader.loads >= 2; }));
+    BOOST_REQUIRE(watchdog.Get() != nullptr);
+    BOOST_CHECK_EQUAL(watchdog.Get()->generation, 0);
+}
+
+BOOST_AUTO_TEST_CASE(skip_reload_above_memory_limit)
+{
+    TemporaryDataset dataset;
+    MockLoader loader;
+    // the old and the new dataset do not fit into the memory limit together
+    loader.required_memory = 60;
+    Watchdog watchdog(storage::StorageConfig{dataset.base},
+                      100,
+                      {},
+                      loader.Load(),
+                      loader.RequiredMemory(),
+                      POLL_INTERVAL);
+
+    dataset.Publish(true);
+    waitSomePolls();
+    BOOST_CHECK_EQUAL(loader.loads, 1);
+    BOOST_REQUIRE(watchdog.Get() != nullptr);
+    BOOST_CHECK_EQUAL(watchdog.Get()->generation, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,50 @@
+#include "engine/tile_cache.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(tile_cache)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+BOOST_AUTO_TEST_CASE(get_cached_tiles)
+{
+    TileCache cache(100);
+    std::string tile;
+    BOOST_CHECK(!cache.Get({1, 14, 1, 2}, tile));
+
+    cache.Put({1, 14, 1, 2}, "tile");
+    BOOST_CHECK(cache.Get({1, 14, 1, 2}, tile));
+    BOOST_CHECK_EQUAL(tile, "tile");
+    BOOST_CHECK_EQUAL(cache.GetSize(), 4);
+
+    // same tile of an updated dataset
+    BOOST_CHECK(!cache.Get({2, 14, 1, 2}, tile));
+    BOOST_CHECK(!cache.Get({1, 14, 2, 1}, tile));
+}
+
+BOOST_AUTO_TEST_CASE(evict_least_recently_used_tiles)
+{
+    TileCache cache(10);
+    cache.Put({1, 14, 0, 0}, "aaaa");
+    cache.Put({1, 14, 0, 1}, "bbbb");
+
+    // makes 0/1 the least recently used tile
+    std::string tile;
+    BOOST_CHECK(cache.Get({1, 14, 0, 0}, tile));
+
+    cache.Put({1, 14, 0, 2}, "cccc");
+    BOOST_CHECK(cache.Get({1, 14, 0, 0}, tile));
+    BOOST_CHECK(!cache.Get({1, 14, 0, 1}, tile));
+    BOOST_CHECK(cache.Get({1, 14, 0, 2}, tile));
+    BOOST_CHECK_EQUAL(cache.GetSize(), 8);
+
+    // larger than the whole cache
+    cache.Put({1, 14, 0, 3}, std::string(11, 'd'));
+    BOOST_CHECK(!cache.Get({1, 14, 0, 3}, tile));
+    BOOST_CHECK_EQUAL(cache.GetSize(), 8);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,110 @@
+#include "engine/trip/trip_brute_force.hpp"
+#include "engine/trip/trip_local_search.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(trip_local_search)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+namespace
+{
+// Euclidean distances between random points, with an extra cost for going west so that the
+// table is asymmetric
+util::DistTableWrapper<EdgeWeight> makeTable(const std::size_t number_of_locations,
+                                             const unsigned seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> coordinate(0, 10000);
+    std::vector<double> x(number_of_locations), y(number_of_locations);
+    for (std::size_t index = 0; index < number_of_locations; ++index)
+    {
+        x[index] = coordinate(generator);
+        y[index] = coordinate(generator);
+    }
+
+    std::vector<EdgeWeight> table(number_of_locations * number_of_locations);
+    for (std::size_t from = 0; from < number_of_locations; ++from)
+    {
+        for (std::size_t to = 0; to < number_of_locations; ++to)
+        {
+            const auto distance = std::hypot(x[to] - x[from], y[to] - y[from]);
+            const auto westwards = std::max(0., x[from] - x[to]);
+            table[from * number_of_locations + to] =
+                static_cast<EdgeWeight>(distance + 0.1 * westwards);
+        }
+    }
+    return util::DistTableWrapper<EdgeWeight>(std::move(table), number_of_locations);
+}
+
+bool isPermutation(std::vector<NodeID> trip, const std::size_t number_of_locations)
+{
+    std::vector<NodeID> expected(number_of_locations);
+    std::iota(expected.begin(), expected.end(), 0);
+    std::sort(trip.begin(), trip.end());
+    return trip == expected;
+}
+}
+
+BOOST_AUTO_TEST_CASE(nearest_neighbour_tour)
+{
+    const auto table = makeTable(50, 1);
+    const auto trip = trip::NearestNeighbourTour(50, table);
+    BOOST_CHECK_EQUAL(trip.front(), 0);
+    BOOST_CHECK(isPermutation(trip, 50));
+}
+
+BOOST_AUTO_TEST_CASE(finds_optimal_small_trips)
+{
+    for (unsigned seed = 0; seed < 10; ++seed)
+    {
+        const auto table = makeTable(9, seed);
+        const auto optimal = trip::BruteForceTrip(9, table);
+        const auto trip = trip::LocalSearchTrip(
+            trip::NearestNeighbourTour(9, table), table, std::chrono::milliseconds(100));
+        BOOST_CHECK(isPermutation(trip, 9));
+        BOOST_CHECK_EQUAL(trip::GetTripCost(trip, table), trip::GetTripCost(optimal, table));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(improves_large_trips)
+{
+    const auto table = makeTable(500, 42);
+    const auto initial = trip::NearestNeighbourTour(500, table);
+    const auto trip = trip::LocalSearchTrip(initial, table, std::chrono::milliseconds(200));
+    BOOST_CHECK(isPermutation(trip, 500));
+    // nearest neighbour tours are about 25% longer than the optimum
+    BOOST_CHECK_LT(trip::GetTripCost(trip, table), 0.9 * trip::GetTripCost(initial, table));
+}
+
+BOOST_AUTO_TEST_CASE(avoids_invalid_legs)
+{
+    // a fixed start and end as set up by the trip plugin: 3 -> 0 is free, 0 -> 3 is invalid
+    // and 0 is only reachable from 3
+    auto table = makeTable(20, 7);
+    for (NodeID node = 0; node < 20; ++node)
+    {
+        table.SetValue(node, 0, INVALID_EDGE_WEIGHT);
+        table.SetValue(3, node, INVALID_EDGE_WEIGHT);
+    }
+    table.SetValue(3, 3, 0);
+    table.SetValue(0, 0, 0);
+    table.SetValue(3, 0, 0);
+    table.SetValue(0, 3, INVALID_EDGE_WEIGHT);
+
+    std::vector<NodeID> initial(20);
+    std::iota(initial.begin(), initial.end(), 0);
+    const auto trip = trip::LocalSearchTrip(initial, table, std::chrono::milliseconds(100));
+    BOOST_CHECK(isPermutation(trip, 20));
+    BOOST_CHECK_LT(trip::GetTripCost(trip, table), INVALID_EDGE_WEIGHT);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,58 @@
+#include "engine/warmup.hpp"
+
+#include "common/temporary_file.hpp"
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(warmup_test)
+
+using namespace osrm;
+using namespace osrm::engine;
+
+BOOST_AUTO_TEST_CASE(load_recorded_queries)
+{
+    TemporaryFile queries_file;
+    {
+        boost::filesystem::ofstream out(queries_file.path);
+        out << "/route/v1/driving/13.388860,52.517037;13.397634,52.529407?overview=false\n"
+            << "13.428555,52.523219;13.418555,52.523215;13.408555,52.523211\n"
+            << "\n"
+            << "/route/v1/driving/not,acoordinate;13.1,52.1\n"
+            << "/table/v1/driving/13.1,52.1\n";
+    }
+
+    const auto queries = loadWarmupQueries(queries_file.path, 10);
+    BOOST_REQUIRE_EQUAL(queries.size(), 2);
+
+    BOOST_REQUIRE_EQUAL(queries[0].coordinates.size(), 2);
+    BOOST_CHECK_EQUAL(queries[0].coordinates[0],
+                      util::Coordinate(util::FloatLongitude{13.388860},
+                                       util::FloatLatitude{52.517037}));
+    BOOST_CHECK_EQUAL(queries[1].coordinates.size(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(sample_recorded_queries)
+{
+    TemporaryFile queries_file;
+    {
+        boost::filesystem::ofstream out(queries_file.path);
+        for (int index = 0; index < 100; ++index)
+        {
+            out << "13." << index << ",52.5;13.4,52.5\n";
+        }
+    }
+
+    const auto queries = loadWarmupQueries(queries_file.path, 4);
+    BOOST_REQUIRE_EQUAL(queries.size(), 4);
+    // the sample is spread over the whole recording
+    BOOST_CHECK_EQUAL(queries[3].coordinates[0],
+                      util::Coordinate(util::FloatLongitude{13.75}, util::FloatLatitude{52.5}));
+}
+
+BOOST_AUTO_TEST_CASE(missing_queries_file)
+{
+    BOOST_CHECK_THROW(loadWarmupQueries("non_existent_warmup_queries.txt", 10), util::exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
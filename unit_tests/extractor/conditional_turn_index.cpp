@@ -0,0 +1,63 @@
+#include "extractor/conditional_turn_index.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(conditional_turn_index)
+
+using namespace osrm;
+using namespace osrm::extractor;
+
+namespace
+{
+struct TurnIndexBlock
+{
+    NodeID from_id;
+    NodeID via_id;
+    NodeID to_id;
+};
+
+TurnRestriction makeRestriction(NodeID from, NodeID via, NodeID to, bool is_only)
+{
+    TurnRestriction restriction(is_only);
+    restriction.from.node = from;
+    restriction.via.node = via;
+    restriction.to.node = to;
+    return restriction;
+}
+}
+
+BOOST_AUTO_TEST_CASE(index_restricted_turns)
+{
+    // turns at node 1 from 0 and 2, and at node 4 from 3
+    const std::vector<TurnIndexBlock> turns = {
+        {0, 1, 2}, {0, 1, 3}, {2, 1, 0}, {2, 1, 3}, {0, 1, 5}, {3, 4, 5}};
+    const std::vector<TurnRestriction> restrictions = {makeRestriction(0, 1, 3, true),
+                                                       makeRestriction(2, 1, 3, false),
+                                                       makeRestriction(3, 4, 6, false),
+                                                       makeRestriction(2, 1, 0, false)};
+
+    const auto index = buildConditionalTurnIndex(restrictions, turns);
+    BOOST_REQUIRE_EQUAL(index.GetNumberOfRestrictions(), 4);
+
+    // only_* forbids all other turns, no_* only the restricted turn
+    const std::vector<std::uint64_t> only_turns = {0, 4};
+    const std::vector<std::uint64_t> no_turns = {3};
+    const std::vector<std::uint64_t> unmatched_turns = {};
+    const std::vector<std::uint64_t> overlapping_turns = {2};
+    BOOST_CHECK_EQUAL_COLLECTIONS(index.GetTurns(0).begin(),
+                                  index.GetTurns(0).end(),
+                                  only_turns.begin(),
+                                  only_turns.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+        index.GetTurns(1).begin(), index.GetTurns(1).end(), no_turns.begin(), no_turns.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(index.GetTurns(2).begin(),
+                                  index.GetTurns(2).end(),
+                                  unmatched_turns.begin(),
+                                  unmatched_turns.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(index.GetTurns(3).begin(),
+                                  index.GetTurns(3).end(),
+                                  overlapping_turns.begin(),
+                                  overlapping_turns.end());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,87 @@
+#include "extractor/extractor_callbacks.hpp"
+#include "extractor/extraction_containers.hpp"
+#include "extractor/extraction_way.hpp"
+#include "extractor/profile_properties.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <osmium/builder/attr.hpp>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/osm.hpp>
+
+BOOST_AUTO_TEST_SUITE(extractor_callbacks)
+
+using namespace osrm;
+using namespace osrm::extractor;
+
+namespace
+{
+const osmium::Way &addWay(osmium::memory::Buffer &buffer,
+                          const osmium::object_id_type id,
+                          const std::initializer_list<osmium::object_id_type> nodes)
+{
+    using namespace osmium::builder::attr;
+    const auto offset = osmium::builder::add_way(buffer, _id(id), _nodes(nodes));
+    return buffer.get<osmium::Way>(offset);
+}
+
+ExtractionWay makeWay(const std::string &name, const std::string &turn_lanes)
+{
+    ExtractionWay way;
+    way.forward_speed = 30;
+    way.backward_speed = 30;
+    way.forward_travel_mode = TRAVEL_MODE_DRIVING;
+    way.backward_travel_mode = TRAVEL_MODE_DRIVING;
+    way.name = name;
+    way.turn_lanes_forward = turn_lanes;
+    way.turn_lanes_backward = turn_lanes;
+    return way;
+}
+}
+
+// Buffers are filled independently and only get their global ids when they are stored
+BOOST_AUTO_TEST_CASE(store_buffers_in_order)
+{
+    ExtractionContainers containers;
+    ProfileProperties properties;
+    properties.fallback_to_duration = true;
+    ExtractorCallbacks callbacks(containers, properties);
+
+    osmium::memory::Buffer osm_buffer(1024, osmium::memory::Buffer::auto_grow::yes);
+    const auto &first_way = addWay(osm_buffer, 1, {1, 2, 3});
+    const auto &second_way = addWay(osm_buffer, 2, {3, 4});
+    const auto &third_way = addWay(osm_buffer, 3, {4, 5});
+
+    ExtractionBuffer first_buffer;
+    ExtractionBuffer second_buffer;
+    callbacks.ProcessWay(second_way, makeWay("b", ""), second_buffer);
+    callbacks.ProcessWay(third_way, makeWay("a", "left|through"), second_buffer);
+    callbacks.ProcessWay(first_way, makeWay("a", "left|through"), first_buffer);
+
+    BOOST_CHECK_EQUAL(first_buffer.edges.size(), 2);
+    BOOST_CHECK_EQUAL(second_buffer.edges.size(), 2);
+    BOOST_CHECK_EQUAL(second_buffer.names.size(), 2);
+    BOOST_CHECK_EQUAL(containers.all_edges_list.size(), 0);
+
+    callbacks.StoreBuffer(first_buffer);
+    callbacks.StoreBuffer(second_buffer);
+
+    BOOST_REQUIRE_EQUAL(containers.all_edges_list.size(), 4);
+    BOOST_CHECK_EQUAL(containers.used_node_id_list.size(), 7);
+    BOOST_CHECK_EQUAL(containers.way_start_end_id_list.size(), 3);
+
+    // "a" is the first new name and "b" the second one, each takes four offsets
+    const auto &edges = containers.all_edges_list;
+    BOOST_CHECK_EQUAL(edges[0].result.name_id, 4);
+    BOOST_CHECK_EQUAL(edges[1].result.name_id, 4);
+    BOOST_CHECK_EQUAL(edges[2].result.name_id, 8);
+    BOOST_CHECK_EQUAL(edges[3].result.name_id, 4);
+    BOOST_CHECK_EQUAL(containers.name_offsets.size(), 13);
+
+    // the empty description has id 0, so "left|through" is 1 in both buffers
+    BOOST_CHECK_EQUAL(edges[0].result.lane_description_id, 1);
+    BOOST_CHECK_EQUAL(edges[2].result.lane_description_id, INVALID_LANE_DESCRIPTIONID);
+    BOOST_CHECK_EQUAL(edges[3].result.lane_description_id, 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,142 @@
+#include "extractor/extraction_node.hpp"
+#include "extractor/extraction_turn.hpp"
+#include "extractor/extraction_way.hpp"
+#include "extractor/restriction_parser.hpp"
+#include "extractor/scripting_environment_native.hpp"
+#include "util/exception.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <osmium/builder/attr.hpp>
+#include <osmium/memory/buffer.hpp>
+#include <osmium/osm.hpp>
+
+BOOST_AUTO_TEST_SUITE(native_profile)
+
+using namespace osrm;
+using namespace osrm::extractor;
+
+namespace
+{
+using Tags = std::initializer_list<std::pair<const char *, const char *>>;
+
+void addWay(osmium::memory::Buffer &buffer, const osmium::object_id_type id, const Tags tags)
+{
+    using namespace osmium::builder::attr;
+    osmium::builder::add_way(buffer, _id(id), _nodes({1, 2}), _tags(tags));
+}
+
+void addNode(osmium::memory::Buffer &buffer, const osmium::object_id_type id, const Tags tags)
+{
+    using namespace osmium::builder::attr;
+    osmium::builder::add_node(buffer, _id(id), _location(7.4, 43.7), _tags(tags));
+}
+}
+
+BOOST_AUTO_TEST_CASE(car_profile_properties)
+{
+    NativeScriptingEnvironment environment(OSRM_NATIVE_CAR_PROFILE);
+
+    const auto &properties = environment.GetProfileProperties();
+    BOOST_CHECK_EQUAL(properties.GetWeightName(), "routability");
+    BOOST_CHECK(properties.use_turn_restrictions);
+    BOOST_CHECK(!properties.call_tagless_node_function);
+    BOOST_CHECK(!properties.fallback_to_duration);
+
+    const std::vector<std::string> restrictions{"motorcar", "motor_vehicle", "vehicle"};
+    BOOST_CHECK(environment.GetRestrictions() == restrictions);
+    BOOST_CHECK_EQUAL(environment.GetNameSuffixList().size(), 12);
+
+    BOOST_CHECK(NativeScriptingEnvironment::IsNativeProfile(OSRM_NATIVE_CAR_PROFILE));
+    BOOST_CHECK(!NativeScriptingEnvironment::IsNativeProfile("profiles/car.lua"));
+    BOOST_CHECK_THROW(NativeScriptingEnvironment("does/not/exist.so"), util::exception);
+}
+
+BOOST_AUTO_TEST_CASE(car_profile_elements)
+{
+    NativeScriptingEnvironment environment(OSRM_NATIVE_CAR_PROFILE);
+    auto restrictions = environment.GetRestrictions();
+    RestrictionParser restriction_parser(false, false, restrictions);
+
+    osmium::memory::Buffer buffer(1024, osmium::memory::Buffer::auto_grow::yes);
+    addNode(buffer, 1, {});
+    addNode(buffer, 2, {{"barrier", "wall"}});
+    addNode(buffer, 3, {{"highway", "traffic_signals"}});
+    addWay(buffer, 1, {{"highway", "primary"}, {"name", "Main Street"}, {"ref", "B1;B2"}});
+    addWay(buffer, 2, {{"highway", "residential"}, {"oneway", "yes"}, {"maxspeed", "30 mph"}});
+    addWay(buffer, 3, {{"highway", "motorway"}, {"access", "no"}});
+    addWay(buffer, 4, {{"route", "ferry"}, {"duration", "00:30"}});
+    addWay(buffer, 5, {{"building", "yes"}});
+
+    std::vector<std::pair<const osmium::Node &, ExtractionNode>> nodes;
+    std::vector<std::pair<const osmium::Way &, ExtractionWay>> ways;
+    std::vector<boost::optional<InputRestrictionContainer>> resulting_restrictions;
+    environment.ProcessElements(buffer, restriction_parser, nodes, ways, resulting_restrictions);
+
+    BOOST_REQUIRE_EQUAL(nodes.size(), 3);
+    BOOST_CHECK(!nodes[0].second.barrier && !nodes[0].second.traffic_lights);
+    BOOST_CHECK(nodes[1].second.barrier);
+    BOOST_CHECK(nodes[2].second.traffic_lights);
+
+    BOOST_REQUIRE_EQUAL(ways.size(), 5);
+    const auto &primary = ways[0].second;
+    BOOST_CHECK_EQUAL(ways[0].first.id(), 1);
+    BOOST_CHECK_EQUAL(primary.forward_speed, 65);
+    BOOST_CHECK_EQUAL(primary.forward_rate, 65 / 3.6);
+    BOOST_CHECK_EQUAL(primary.forward_travel_mode, TRAVEL_MODE_DRIVING);
+    BOOST_CHECK_EQUAL(primary.backward_travel_mode, TRAVEL_MODE_DRIVING);
+    BOOST_CHECK_EQUAL(primary.name, "Main Street");
+    BOOST_CHECK_EQUAL(primary.ref, "B1; B2");
+    BOOST_CHECK_EQUAL(primary.road_classification.GetClass(),
+                      guidance::RoadPriorityClass::PRIMARY);
+
+    const auto &oneway = ways[1].second;
+    BOOST_CHECK_EQUAL(oneway.forward_travel_mode, TRAVEL_MODE_DRIVING);
+    BOOST_CHECK_EQUAL(oneway.backward_travel_mode, TRAVEL_MODE_INACCESSIBLE);
+    BOOST_CHECK_CLOSE(oneway.forward_speed, 30 * 1.609 * 0.8, 1e-6);
+
+    BOOST_CHECK_EQUAL(ways[2].second.forward_travel_mode, TRAVEL_MODE_INACCESSIBLE);
+    BOOST_CHECK_EQUAL(ways[2].second.backward_travel_mode, TRAVEL_MODE_INACCESSIBLE);
+
+    const auto &ferry = ways[3].second;
+    BOOST_CHECK_EQUAL(ferry.forward_travel_mode, TRAVEL_MODE_FERRY);
+    BOOST_CHECK_EQUAL(ferry.duration, 1800);
+    BOOST_CHECK_EQUAL(ferry.weight, 1800);
+
+    BOOST_CHECK_EQUAL(ways[4].second.forward_speed, -1);
+    BOOST_CHECK_EQUAL(ways[4].second.forward_travel_mode, TRAVEL_MODE_INACCESSIBLE);
+}
+
+BOOST_AUTO_TEST_CASE(car_profile_turns)
+{
+    NativeScriptingEnvironment environment(OSRM_NATIVE_CAR_PROFILE);
+
+    const auto make_turn = [](const double angle,
+                              const guidance::TurnType::Enum type,
+                              const guidance::DirectionModifier::Enum modifier,
+                              const bool has_traffic_light) {
+        const guidance::IntersectionViewData view({0, 0., 10.}, true, 180. - angle);
+        return ExtractionTurn({view, {type, modifier}, 0}, has_traffic_light);
+    };
+
+    using namespace guidance;
+    std::vector<ExtractionTurn> turns;
+    turns.push_back(make_turn(0., TurnType::NoTurn, DirectionModifier::Straight, true));
+    turns.push_back(make_turn(90., TurnType::Turn, DirectionModifier::Right, false));
+    turns.push_back(make_turn(180., TurnType::Continue, DirectionModifier::UTurn, false));
+    environment.ProcessTurns(turns);
+
+    BOOST_CHECK_EQUAL(turns[0].duration, 2.);
+    BOOST_CHECK_EQUAL(turns[0].weight, 0.);
+    BOOST_CHECK_GT(turns[1].duration, 0.);
+    BOOST_CHECK_LT(turns[1].duration, 7.5);
+    BOOST_CHECK_EQUAL(turns[1].weight, turns[1].duration);
+    BOOST_CHECK_GT(turns[2].duration, 20.);
+
+    auto restricted = make_turn(90., TurnType::Turn, DirectionModifier::Right, false);
+    restricted.target_restricted = true;
+    environment.ProcessTurn(restricted);
+    BOOST_CHECK_EQUAL(restricted.weight, environment.GetProfileProperties().GetMaxTurnWeight());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,79 @@
+#include "extractor/turn_penalty_table.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(turn_penalty_table)
+
+using namespace osrm;
+using namespace osrm::extractor;
+
+namespace
+{
+// the angle of an extracted turn is 180 - the angle of the road
+ExtractionTurn makeTurn(const double angle,
+                        const guidance::TurnType::Enum type,
+                        const guidance::DirectionModifier::Enum modifier,
+                        const bool has_traffic_light)
+{
+    const guidance::IntersectionViewData view({0, 0., 10.}, true, 180. - angle);
+    return ExtractionTurn({view, {type, modifier}, 0}, has_traffic_light);
+}
+
+TurnPenaltyTable makeTable()
+{
+    TurnPenaltyTable table;
+    table.angles = {-180., -90., 0., 90., 180.};
+    table.durations = {8., 2., 0., 6., 8.};
+    table.u_turn_penalty = 20.;
+    table.traffic_light_penalty = 2.;
+    return table;
+}
+}
+
+BOOST_AUTO_TEST_CASE(validity)
+{
+    auto table = makeTable();
+    BOOST_CHECK(table.IsValid());
+
+    table.durations.pop_back();
+    BOOST_CHECK(!table.IsValid());
+
+    table = makeTable();
+    table.angles[2] = -90.;
+    BOOST_CHECK(!table.IsValid());
+
+    BOOST_CHECK(!TurnPenaltyTable{}.IsValid());
+}
+
+BOOST_AUTO_TEST_CASE(interpolate_angles)
+{
+    const auto table = makeTable();
+    BOOST_CHECK_EQUAL(table.GetAngleDuration(0.), 0.);
+    BOOST_CHECK_EQUAL(table.GetAngleDuration(45.), 3.);
+    BOOST_CHECK_EQUAL(table.GetAngleDuration(-135.), 5.);
+    BOOST_CHECK_EQUAL(table.GetAngleDuration(180.), 8.);
+    BOOST_CHECK_EQUAL(table.GetAngleDuration(-200.), 8.);
+}
+
+BOOST_AUTO_TEST_CASE(apply_penalties)
+{
+    using namespace guidance;
+    const auto table = makeTable();
+
+    auto right_turn = makeTurn(90., TurnType::Turn, DirectionModifier::Right, false);
+    table.Apply(right_turn);
+    BOOST_CHECK_EQUAL(right_turn.duration, 6.);
+    BOOST_CHECK_EQUAL(right_turn.weight, 6.);
+
+    auto u_turn = makeTurn(180., TurnType::Continue, DirectionModifier::UTurn, true);
+    table.Apply(u_turn);
+    BOOST_CHECK_EQUAL(u_turn.duration, 30.);
+    BOOST_CHECK_EQUAL(u_turn.weight, 30.);
+
+    auto no_turn = makeTurn(90., TurnType::NoTurn, DirectionModifier::Right, true);
+    table.Apply(no_turn);
+    BOOST_CHECK_EQUAL(no_turn.duration, 2.);
+    BOOST_CHECK_EQUAL(no_turn.weight, 2.);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
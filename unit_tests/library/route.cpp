@@ -5,6 +5,7 @@
 #include "equal_json.hpp"
 #include "fixture.hpp"
 
+#include "osrm/bearing.hpp"
 #include "osrm/coordinate.hpp"
 #include "osrm/engine_config.hpp"
 #include "osrm/exception.hpp"
@@ -447,4 +448,91 @@ BOOST_AUTO_TEST_CASE(test_manual_setting_of_annotations_property)
     BOOST_CHECK_EQUAL(annotations.size(), 5);
 }
 
+BOOST_AUTO_TEST_CASE(test_route_parallel_legs_match_sequential_legs)
+{
+    using namespace osrm;
+
+    const auto makeOSRM = [](const std::string &base_path,
+                             const EngineConfig::Algorithm algorithm,
+                             const int max_parallel_legs) {
+        EngineConfig config;
+        config.storage_config = {base_path};
+        config.use_shared_memory = false;
+        config.algorithm = algorithm;
+        config.max_parallel_legs = max_parallel_legs;
+        return OSRM{config};
+    };
+
+    const auto route = [](const OSRM &osrm, const RouteParameters &params) {
+        json::Object result;
+        const auto rc = osrm.Route(params, result);
+        BOOST_REQUIRE(rc == Status::Ok);
+        return result.values.at("routes").get<json::Array>().values.at(0).get<json::Object>();
+    };
+
+    const auto checkEqualValues = [](const json::Object &lhs, const json::Object &rhs) {
+        for (const auto key : {"weight", "duration", "distance"})
+        {
+            BOOST_CHECK_EQUAL(lhs.values.at(key).get<json::Number>().value,
+                              rhs.values.at(key).get<json::Number>().value);
+        }
+    };
+
+    const auto big_component = get_locations_in_big_component();
+    const Locations locations = {big_component[0],
+                                 big_component[1],
+                                 get_dummy_location(),
+                                 big_component[2],
+                                 big_component[0]};
+
+    for (const auto &dataset : {std::make_pair(OSRM_TEST_DATA_DIR "/ch/monaco.osrm",
+                                               EngineConfig::Algorithm::CH),
+                                std::make_pair(OSRM_TEST_DATA_DIR "/mld/monaco.osrm",
+                                               EngineConfig::Algorithm::MLD)})
+    {
+        const auto sequential = makeOSRM(dataset.first, dataset.second, 1);
+        const auto parallel = makeOSRM(dataset.first, dataset.second, 4);
+
+        for (const bool continue_straight : {true, false})
+        {
+            // narrow bearings only allow one direction at each waypoint, like on a one-way street.
+            // Without radiuses the search continues until it finds a segment with a matching
+            // bearing in the big component, so every waypoint still snaps.
+            for (const bool one_way_waypoints : {false, true})
+            {
+                RouteParameters params;
+                params.coordinates = locations;
+                params.continue_straight = continue_straight;
+                if (one_way_waypoints)
+                {
+                    for (const auto index : {0, 1, 2, 3, 4})
+                    {
+                        params.bearings.push_back(
+                            engine::Bearing{static_cast<short>(index * 90 % 360), 45});
+                    }
+                }
+
+                const auto sequential_route = route(sequential, params);
+                const auto parallel_route = route(parallel, params);
+                checkEqualValues(sequential_route, parallel_route);
+
+                const auto &sequential_legs =
+                    sequential_route.values.at("legs").get<json::Array>().values;
+                const auto &parallel_legs =
+                    parallel_route.values.at("legs").get<json::Array>().values;
+                BOOST_REQUIRE_EQUAL(sequential_legs.size(), locations.size() - 1);
+                BOOST_REQUIRE_EQUAL(parallel_legs.size(), locations.size() - 1);
+                for (const auto index : {0, 1, 2, 3})
+                {
+                    checkEqualValues(sequential_legs[index].get<json::Object>(),
+                                     parallel_legs[index].get<json::Object>());
+                }
+                BOOST_CHECK_EQUAL(
+                    sequential_route.values.at("geometry").get<json::String>().value,
+                    parallel_route.values.at("geometry").get<json::String>().value);
+            }
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -38,6 +38,7 @@ class MockBaseDataFacade : public engine::datafacade::BaseDataFacade
     {
         return ComponentID{INVALID_COMPONENTID, false};
     }
+    std::size_t GetNumberOfEdgeBasedNodes() const override { return 0; }
     TurnPenalty GetWeightPenaltyForEdgeID(const unsigned /* id */) const override final
     {
         return 0;
@@ -189,6 +190,12 @@ class MockBaseDataFacade : public engine::datafacade::BaseDataFacade
         return {};
     }
 
+    engine::PhantomNode NearestPhantomNodeOnSegment(const util::Coordinate /*input_coordinate*/,
+                                                    const RTreeLeaf & /*segment*/) const override
+    {
+        return {};
+    }
+
     unsigned GetCheckSum() const override { return 0; }
 
     extractor::TravelMode GetTravelMode(const NodeID /* id */) const override
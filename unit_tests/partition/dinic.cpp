@@ -72,4 +72,56 @@ BOOST_AUTO_TEST_CASE(horizontal_cut_between_two_grids)
     BOOST_CHECK(cut.num_edges == 4);
 }
 
+BOOST_AUTO_TEST_CASE(parallel_edges_share_capacity)
+{
+    // 0 - 1 = 2 - 3 with two parallel edges between 1 and 2
+    std::vector<EdgeWithSomeAdditionalData> edges;
+    const auto connect = [&edges](const NodeID from, const NodeID to) {
+        edges.push_back({from, to, 1});
+        edges.push_back({to, from, 1});
+    };
+    connect(0, 1);
+    connect(1, 2);
+    connect(1, 2);
+    connect(2, 3);
+
+    groupEdgesBySource(edges.begin(), edges.end());
+    auto graph = makeBisectionGraph(makeGridCoordinates(1, 4, 0.01, 0, 0),
+                                    adaptToBisectionEdge(std::move(edges)));
+
+    RecursiveBisectionState bisection_state(graph);
+    GraphView view(graph);
+
+    DinicMaxFlow::SourceSinkNodes sources{0}, sinks{3};
+    const auto cut = DinicMaxFlow()(view, sources, sinks);
+    BOOST_CHECK_EQUAL(cut.num_edges, 1);
+}
+
+BOOST_AUTO_TEST_CASE(edges_without_opposite_edge)
+{
+    // 0 - 1 <- 2 - 3 and 0 - 4 -> 2, the search reaches 2 through 4 but the only path
+    // back to the source leads through 1, over the opposite direction of 2 -> 1
+    std::vector<EdgeWithSomeAdditionalData> edges;
+    const auto connect = [&edges](const NodeID from, const NodeID to) {
+        edges.push_back({from, to, 1});
+        edges.push_back({to, from, 1});
+    };
+    connect(0, 1);
+    connect(0, 4);
+    connect(2, 3);
+    edges.push_back({4, 2, 1});
+    edges.push_back({2, 1, 1});
+
+    groupEdgesBySource(edges.begin(), edges.end());
+    auto graph = makeBisectionGraph(makeGridCoordinates(1, 5, 0.01, 0, 0),
+                                    adaptToBisectionEdge(std::move(edges)));
+
+    RecursiveBisectionState bisection_state(graph);
+    GraphView view(graph);
+
+    DinicMaxFlow::SourceSinkNodes sources{0}, sinks{3};
+    const auto cut = DinicMaxFlow()(view, sources, sinks);
+    BOOST_CHECK_EQUAL(cut.num_edges, 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
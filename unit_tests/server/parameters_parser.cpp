@@ -331,6 +331,29 @@ BOOST_AUTO_TEST_CASE(valid_route_urls)
     auto result_13 = parseParameters<RouteParameters>("1,2;3,4");
     BOOST_CHECK(result_13);
     BOOST_CHECK_EQUAL(result_13->generate_hints, true);
+    BOOST_CHECK(result_13->hint_format == RouteParameters::HintFormat::Full);
+
+    // Compact hints can be mixed with full hints
+    engine::CompactHint compact_hint;
+    compact_hint.forward_segment_id = {42, true};
+    compact_hint.reverse_segment_id = {43, true};
+    compact_hint.fwd_segment_position = 2;
+    compact_hint.coordinate_fingerprint = 1000;
+    compact_hint.segment_checksum = 0xdeadbeef;
+    std::vector<boost::optional<engine::CompactHint>> compact_hints_13 = {
+        boost::none, compact_hint, boost::none, boost::none};
+    auto result_13b = parseParameters<RouteParameters>(
+        "1,2;3,4;5,6;7,8?hints=ZgYAgP___38EAAAAIAAAAD4AAAAdAAAABAAAACAAAAA-"
+        "AAAAHQAAABQAAABqaHEAt4KbAjtocQDLgpsCBQAPAJDIe3E=;" +
+        compact_hint.ToBase64() + ";;&hint_format=compact");
+    BOOST_CHECK(result_13b);
+    BOOST_CHECK_EQUAL(result_13b->hints.size(), 4);
+    BOOST_CHECK(result_13b->hints[0]);
+    BOOST_CHECK(!result_13b->hints[1]);
+    CHECK_EQUAL_RANGE(compact_hints_13, result_13b->compact_hints);
+    BOOST_CHECK(result_13b->hint_format == RouteParameters::HintFormat::Compact);
+    BOOST_CHECK_EQUAL(
+        testInvalidOptions<RouteParameters>("1,2;3,4?overview=false&hint_format=foo"), 35UL);
 
     // parse none annotations value correctly
     RouteParameters reference_14{};
@@ -0,0 +1,95 @@
+#include "updater/binary_source.hpp"
+#include "updater/csv_source.hpp"
+#include "util/exception.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <fstream>
+
+BOOST_AUTO_TEST_SUITE(binary_source)
+
+using namespace osrm;
+using namespace osrm::updater;
+
+namespace
+{
+struct TemporaryFile
+{
+    TemporaryFile() : path(boost::filesystem::unique_path().string()) {}
+    ~TemporaryFile() { boost::filesystem::remove(path); }
+
+    void write(const std::string &content) const { std::ofstream(path) << content; }
+
+    const std::string path;
+};
+}
+
+BOOST_AUTO_TEST_CASE(segment_speeds_round_trip)
+{
+    TemporaryFile csv, binary;
+    csv.write("3,4,20\n1,2,30,5.5\n3,4,25\n");
+
+    const auto from_csv = csv::readSegmentValues({csv.path});
+    BOOST_REQUIRE_EQUAL(from_csv.lookup.size(), 2);
+    binary::writeValues(binary.path, from_csv.lookup);
+
+    BOOST_CHECK(binary::isBinaryFile(binary.path));
+    BOOST_CHECK(!binary::isBinaryFile(csv.path));
+
+    const auto from_binary = csv::readSegmentValues({binary.path});
+    BOOST_REQUIRE_EQUAL(from_binary.lookup.size(), 2);
+
+    const auto first = from_binary({1, 2});
+    BOOST_REQUIRE(first);
+    BOOST_CHECK_EQUAL(first->speed, 30);
+    BOOST_CHECK_EQUAL(first->rate, 5.5);
+    BOOST_CHECK_EQUAL(first->source, 1);
+
+    // the last line of a file takes precedence
+    const auto second = from_binary({3, 4});
+    BOOST_REQUIRE(second);
+    BOOST_CHECK_EQUAL(second->speed, 25);
+    BOOST_CHECK(std::isnan(second->rate));
+
+    BOOST_CHECK(!from_binary({2, 1}));
+}
+
+BOOST_AUTO_TEST_CASE(turn_penalties_mixed_with_csv)
+{
+    TemporaryFile first_csv, binary, second_csv;
+    first_csv.write("1,2,3,10\n4,5,6,20,1.5\n");
+    binary::writeValues(binary.path, csv::readTurnValues({first_csv.path}).lookup);
+    second_csv.write("4,5,6,30\n7,8,9,40\n");
+
+    // files later in the list take precedence, independent of their format
+    const auto lookup = csv::readTurnValues({binary.path, second_csv.path});
+    BOOST_REQUIRE_EQUAL(lookup.lookup.size(), 3);
+    BOOST_CHECK_EQUAL(lookup({1, 2, 3})->duration, 10.);
+    BOOST_CHECK_EQUAL(lookup({1, 2, 3})->source, 1);
+    BOOST_CHECK_EQUAL(lookup({4, 5, 6})->duration, 30.);
+    BOOST_CHECK_EQUAL(lookup({4, 5, 6})->source, 2);
+    BOOST_CHECK_EQUAL(lookup({7, 8, 9})->duration, 40.);
+
+    const auto reversed = csv::readTurnValues({second_csv.path, binary.path});
+    BOOST_CHECK_EQUAL(reversed({4, 5, 6})->duration, 20.);
+    BOOST_CHECK_EQUAL(reversed({4, 5, 6})->weight, 1.5);
+    BOOST_CHECK_EQUAL(reversed({4, 5, 6})->source, 2);
+}
+
+BOOST_AUTO_TEST_CASE(invalid_binary_files)
+{
+    TemporaryFile segments, turns;
+    binary::writeValues(segments.path, std::vector<std::pair<Segment, SpeedSource>>(1));
+    binary::writeValues(turns.path, std::vector<std::pair<Turn, PenaltySource>>(1));
+
+    // segment speeds can not be read as turn penalties
+    BOOST_CHECK_THROW(csv::readTurnValues({segments.path}), util::exception);
+    BOOST_CHECK_NO_THROW(csv::readTurnValues({turns.path}));
+
+    boost::filesystem::resize_file(turns.path, boost::filesystem::file_size(turns.path) - 1);
+    BOOST_CHECK_THROW(csv::readTurnValues({turns.path}), util::exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,94 @@
+#include "updater/live_updater.hpp"
+
+#include "customizer/cell_customizer.hpp"
+#include "partition/multi_level_graph.hpp"
+#include "partition/multi_level_partition.hpp"
+#include "util/static_graph.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(live_updater)
+
+using namespace osrm;
+using namespace osrm::updater;
+
+namespace
+{
+struct EdgeData
+{
+    EdgeWeight weight;
+    EdgeWeight duration;
+    bool forward;
+    bool backward;
+};
+using Graph = partition::MultiLevelGraph<EdgeData, storage::Ownership::Container>;
+
+// Splits the edges like the customizer, the weight of an edge is the weight of its source
+Graph makeGraph(const partition::MultiLevelPartition &mlp,
+                const std::vector<std::pair<NodeID, NodeID>> &edges)
+{
+    using Edge = util::static_graph_details::SortableEdgeWithData<EdgeData>;
+    std::vector<Edge> directed;
+    NodeID max_id = 0;
+    for (const auto &edge : edges)
+    {
+        max_id = std::max(max_id, std::max(edge.first, edge.second));
+        directed.push_back(Edge{edge.first, edge.second, 10, 100, true, false});
+        directed.push_back(Edge{edge.second, edge.first, 10, 100, false, true});
+    }
+    std::sort(directed.begin(), directed.end());
+    return Graph(mlp, max_id + 1, directed);
+}
+
+const EdgeData &findEdge(const Graph &graph, const NodeID from, const NodeID to)
+{
+    const auto edge = graph.FindEdge(from, to);
+    BOOST_REQUIRE(edge != SPECIAL_EDGEID);
+    return graph.GetEdgeData(edge);
+}
+}
+
+BOOST_AUTO_TEST_CASE(update_edges_of_changed_nodes)
+{
+    // node:                                0  1  2  3
+    const std::vector<CellID> l1{{0, 0, 1, 1}};
+    const partition::MultiLevelPartition mlp{{l1}, {2}};
+    auto graph = makeGraph(mlp, {{0, 1}, {1, 2}, {2, 3}});
+
+    customizer::CellCustomizer customizer(mlp);
+    auto cell_mask = customizer.MakeCellMask(false);
+    BOOST_CHECK_EQUAL(updateEdgeWeights(graph, customizer, {{0, {5, 30, false}}}, cell_mask), 2);
+
+    // the edge from 0 to 1 and its reversed copy
+    BOOST_CHECK_EQUAL(findEdge(graph, 0, 1).weight, 15);
+    BOOST_CHECK_EQUAL(findEdge(graph, 0, 1).duration, 130);
+    BOOST_CHECK_EQUAL(findEdge(graph, 1, 0).weight, 15);
+    BOOST_CHECK_EQUAL(findEdge(graph, 1, 0).duration, 130);
+    BOOST_CHECK_EQUAL(findEdge(graph, 1, 2).weight, 10);
+    BOOST_CHECK_EQUAL(findEdge(graph, 2, 1).weight, 10);
+
+    BOOST_CHECK(cell_mask[0][0]);
+    BOOST_CHECK(!cell_mask[0][1]);
+}
+
+BOOST_AUTO_TEST_CASE(close_edges_of_changed_nodes)
+{
+    // node:                                0  1  2  3
+    const std::vector<CellID> l1{{0, 0, 1, 1}};
+    const partition::MultiLevelPartition mlp{{l1}, {2}};
+    auto graph = makeGraph(mlp, {{0, 1}, {1, 2}, {2, 3}});
+
+    customizer::CellCustomizer customizer(mlp);
+    auto cell_mask = customizer.MakeCellMask(false);
+    BOOST_CHECK_EQUAL(updateEdgeWeights(graph, customizer, {{2, {0, 0, true}}}, cell_mask), 2);
+
+    BOOST_CHECK(!findEdge(graph, 2, 3).forward);
+    BOOST_CHECK(!findEdge(graph, 3, 2).backward);
+    BOOST_CHECK(findEdge(graph, 1, 2).forward);
+    BOOST_CHECK(findEdge(graph, 2, 1).backward);
+
+    BOOST_CHECK(!cell_mask[0][0]);
+    BOOST_CHECK(cell_mask[0][1]);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,53 @@
+#include "updater/source.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(lookup_table)
+
+using namespace osrm;
+using namespace osrm::updater;
+
+BOOST_AUTO_TEST_CASE(hash_index_matches_binary_search)
+{
+    std::vector<std::pair<Segment, SpeedSource>> values;
+    for (std::uint64_t from = 0; from < 1000; ++from)
+    {
+        SpeedSource source;
+        source.speed = from % 100;
+        values.emplace_back(Segment{from, from + 1}, source);
+    }
+
+    SegmentLookupTable sorted;
+    sorted.lookup = values;
+    const SegmentLookupTable hashed(values);
+
+    for (std::uint64_t from = 0; from < 1000; ++from)
+    {
+        BOOST_REQUIRE(hashed({from, from + 1}));
+        BOOST_CHECK_EQUAL(hashed({from, from + 1})->speed, sorted({from, from + 1})->speed);
+        BOOST_CHECK(!hashed({from + 1, from}));
+        BOOST_CHECK(!sorted({from + 1, from}));
+    }
+    BOOST_CHECK(!SegmentLookupTable{}({1, 2}));
+}
+
+BOOST_AUTO_TEST_CASE(hash_index_on_unsorted_values)
+{
+    TurnLookupTable table;
+    PenaltySource penalty;
+    for (std::uint64_t via = 100; via > 0; --via)
+    {
+        penalty.duration = via;
+        table.lookup.emplace_back(Turn{1, via, 2}, penalty);
+    }
+    table.BuildIndex();
+
+    for (std::uint64_t via = 1; via <= 100; ++via)
+    {
+        BOOST_REQUIRE(table({1, via, 2}));
+        BOOST_CHECK_EQUAL(table({1, via, 2})->duration, via);
+    }
+    BOOST_CHECK(!table({1, 0, 2}));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
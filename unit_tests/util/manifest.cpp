@@ -0,0 +1,152 @@
+#include "storage/manifest.hpp"
+#include "storage/io.hpp"
+#include "storage/serialization.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <numeric>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(manifest_test)
+
+using namespace osrm;
+using namespace osrm::storage;
+
+namespace
+{
+struct TemporaryDataset
+{
+    TemporaryDataset()
+        : directory(boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()),
+          base((directory / "test.osrm").string())
+    {
+        boost::filesystem::create_directory(directory);
+    }
+
+    ~TemporaryDataset() { boost::filesystem::remove_all(directory); }
+
+    void WriteFile(const std::string &suffix, const std::size_t num_elements)
+    {
+        std::vector<std::uint32_t> data(num_elements);
+        std::iota(data.begin(), data.end(), 0);
+        io::FileWriter writer(base.string() + suffix, io::FileWriter::GenerateFingerprint);
+        serialization::write(writer, data);
+    }
+
+    boost::filesystem::path directory;
+    boost::filesystem::path base;
+};
+}
+
+BOOST_AUTO_TEST_CASE(write_read_manifest)
+{
+    TemporaryDataset dataset;
+    dataset.WriteFile(".hsgr", 1000);
+    dataset.WriteFile(".core", 0);
+    dataset.WriteFile(".names", 10);
+
+    manifest::updateManifest(dataset.base, {}, true);
+
+    const auto manifest = manifest::readManifest(manifest::getManifestPath(dataset.base));
+    BOOST_CHECK(manifest.HasCapability(Manifest::CH));
+    BOOST_CHECK(!manifest.HasCapability(Manifest::CORE_CH));
+    BOOST_CHECK(!manifest.HasCapability(Manifest::MLD));
+
+    BOOST_REQUIRE_EQUAL(manifest.files.size(), 3);
+    const auto hsgr = manifest.GetFile(".hsgr");
+    BOOST_REQUIRE(hsgr != nullptr);
+    BOOST_CHECK_EQUAL(hsgr->size, boost::filesystem::file_size(dataset.base.string() + ".hsgr"));
+    BOOST_CHECK_EQUAL(hsgr->checksums.size(), 1);
+    BOOST_CHECK(manifest.GetFile(".mldgr") == nullptr);
+
+    BOOST_CHECK(manifest::checkManifest(dataset.base, manifest));
+    BOOST_CHECK(manifest::verifyManifest(dataset.base, manifest));
+}
+
+BOOST_AUTO_TEST_CASE(detect_modified_files)
+{
+    TemporaryDataset dataset;
+    dataset.WriteFile(".hsgr", 1000);
+    dataset.WriteFile(".names", 10);
+
+    manifest::updateManifest(dataset.base, {}, true);
+    const auto manifest = manifest::readManifest(manifest::getManifestPath(dataset.base));
+
+    // same size, different content: only the full verification notices
+    {
+        boost::filesystem::fstream file(dataset.base.string() + ".hsgr",
+                                        std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(100);
+        file.put(42);
+    }
+    BOOST_CHECK(manifest::checkManifest(dataset.base, manifest));
+    BOOST_CHECK(!manifest::verifyManifest(dataset.base, manifest));
+
+    // different size
+    dataset.WriteFile(".names", 20);
+    BOOST_CHECK(!manifest::checkManifest(dataset.base, manifest));
+
+    // the pipeline tools refresh the manifest after writing, modification times only have
+    // a resolution of seconds so make sure the in-place change is noticed
+    const auto hsgr_path = dataset.base.string() + ".hsgr";
+    boost::filesystem::last_write_time(hsgr_path,
+                                       boost::filesystem::last_write_time(hsgr_path) + 1);
+    manifest::updateManifest(dataset.base, {}, true);
+    const auto updated = manifest::readManifest(manifest::getManifestPath(dataset.base));
+    BOOST_CHECK(manifest::verifyManifest(dataset.base, updated));
+}
+
+BOOST_AUTO_TEST_CASE(rechecksum_written_files)
+{
+    TemporaryDataset dataset;
+    dataset.WriteFile(".cells", 1000);
+    manifest::updateManifest(dataset.base, {".cells"}, true);
+
+    // a tool rewrites the file with the same size within the same second
+    const auto cells_path = dataset.base.string() + ".cells";
+    const auto modification_time = boost::filesystem::last_write_time(cells_path);
+    {
+        boost::filesystem::fstream file(cells_path,
+                                        std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(100);
+        file.put(42);
+    }
+    boost::filesystem::last_write_time(cells_path, modification_time);
+
+    manifest::updateManifest(dataset.base, {}, true);
+    const auto stale = manifest::readManifest(manifest::getManifestPath(dataset.base));
+    BOOST_CHECK(!manifest::verifyManifest(dataset.base, stale));
+
+    manifest::updateManifest(dataset.base, {".cells"}, true);
+    const auto updated = manifest::readManifest(manifest::getManifestPath(dataset.base));
+    BOOST_CHECK(manifest::verifyManifest(dataset.base, updated));
+}
+
+BOOST_AUTO_TEST_CASE(detect_incomplete_datasets)
+{
+    TemporaryDataset dataset;
+    BOOST_CHECK(!manifest::isDatasetComplete(dataset.base));
+
+    // osrm-extract wrote new files next to the .hsgr of the last run
+    dataset.WriteFile(".hsgr", 1000);
+    dataset.WriteFile(".names", 10);
+    manifest::updateManifest(dataset.base, {".names"}, false);
+    BOOST_CHECK(!manifest::isDatasetComplete(dataset.base));
+
+    // osrm-contract finished
+    manifest::updateManifest(dataset.base, {".hsgr"}, true);
+    BOOST_CHECK(manifest::isDatasetComplete(dataset.base));
+
+    // the next run of osrm-extract rewrites files before it updates the manifest
+    {
+        boost::filesystem::fstream file(dataset.base.string() + ".names",
+                                        std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(20);
+        file.put(42);
+    }
+    BOOST_CHECK(!manifest::isDatasetComplete(dataset.base));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,106 @@
+#include "util/packed_coordinate_vector.hpp"
+#include "util/coordinate.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(packed_coordinate_vector_test)
+
+using namespace osrm;
+using namespace osrm::util;
+
+namespace
+{
+void checkEqual(const std::vector<Coordinate> &coordinates,
+                const PackedCoordinateVector &packed_coordinates)
+{
+    BOOST_REQUIRE_EQUAL(coordinates.size(), packed_coordinates.size());
+    for (std::size_t index = 0; index < coordinates.size(); ++index)
+    {
+        BOOST_CHECK_EQUAL(coordinates[index], packed_coordinates[index]);
+    }
+}
+}
+
+BOOST_AUTO_TEST_CASE(empty_test)
+{
+    PackedCoordinateVector packed_coordinates{std::vector<Coordinate>{}};
+    BOOST_CHECK(packed_coordinates.empty());
+    BOOST_CHECK_EQUAL(packed_coordinates.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(local_coordinates_test)
+{
+    std::mt19937 rng;
+    rng.seed(1337);
+    std::uniform_int_distribution<std::int32_t> step(-500, 500);
+
+    // a random walk through Berlin, which is what node ids in a real extract look like
+    std::vector<Coordinate> coordinates;
+    std::int32_t lon = 13388860;
+    std::int32_t lat = 52517037;
+    for (std::size_t index = 0; index < 1000; ++index)
+    {
+        lon += step(rng);
+        lat += step(rng);
+        coordinates.push_back(Coordinate{FixedLongitude{lon}, FixedLatitude{lat}});
+    }
+
+    PackedCoordinateVector packed_coordinates{coordinates};
+    checkEqual(coordinates, packed_coordinates);
+
+    // the walk spans at most 64 * 500 per block, which needs at most 15 bits per component
+    BOOST_CHECK_LT(packed_coordinates.GetSizeInBytes(),
+                   coordinates.size() * sizeof(Coordinate) / 2);
+}
+
+BOOST_AUTO_TEST_CASE(global_coordinates_test)
+{
+    std::mt19937 rng;
+    rng.seed(42);
+    std::uniform_int_distribution<std::int32_t> lon_dist(-180 * COORDINATE_PRECISION,
+                                                         180 * COORDINATE_PRECISION);
+    std::uniform_int_distribution<std::int32_t> lat_dist(-90 * COORDINATE_PRECISION,
+                                                         90 * COORDINATE_PRECISION);
+
+    // 399 is not a multiple of the block size, so the last block is partial
+    std::vector<Coordinate> coordinates;
+    for (std::size_t index = 0; index < 399; ++index)
+    {
+        coordinates.push_back(
+            Coordinate{FixedLongitude{lon_dist(rng)}, FixedLatitude{lat_dist(rng)}});
+    }
+
+    PackedCoordinateVector packed_coordinates{coordinates};
+    checkEqual(coordinates, packed_coordinates);
+    BOOST_CHECK_THROW(packed_coordinates.at(coordinates.size()), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(extreme_values_test)
+{
+    const auto min = std::numeric_limits<std::int32_t>::min();
+    const auto max = std::numeric_limits<std::int32_t>::max();
+
+    std::vector<Coordinate> coordinates = {{FixedLongitude{min}, FixedLatitude{max}},
+                                           {FixedLongitude{max}, FixedLatitude{min}},
+                                           {FixedLongitude{0}, FixedLatitude{0}},
+                                           {FixedLongitude{max}, FixedLatitude{max}}};
+
+    PackedCoordinateVector packed_coordinates{coordinates};
+    checkEqual(coordinates, packed_coordinates);
+}
+
+BOOST_AUTO_TEST_CASE(identical_coordinates_test)
+{
+    // all offsets are zero, so blocks don't need any words at all
+    std::vector<Coordinate> coordinates(130,
+                                        Coordinate{FixedLongitude{7439000}, FixedLatitude{43737000}});
+    coordinates.push_back(Coordinate{FixedLongitude{7439001}, FixedLatitude{43737002}});
+
+    PackedCoordinateVector packed_coordinates{coordinates};
+    checkEqual(coordinates, packed_coordinates);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
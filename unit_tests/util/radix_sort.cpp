@@ -0,0 +1,62 @@
+#include "../common/range_tools.hpp"
+
+#include "util/radix_sort.hpp"
+
+#include <boost/test/test_case_template.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <random>
+
+BOOST_AUTO_TEST_SUITE(radix_sort_test)
+
+using namespace osrm;
+using namespace osrm::util;
+
+BOOST_AUTO_TEST_CASE(sort_random_keys)
+{
+    std::mt19937 generator(42);
+    // keys that only differ in the lower 34 bits, like OSM ids
+    std::uniform_int_distribution<std::uint64_t> distribution(1, std::uint64_t{1} << 34);
+
+    std::vector<std::uint64_t> values(300000);
+    std::generate(values.begin(), values.end(), [&] { return distribution(generator); });
+    auto reference = values;
+    std::sort(reference.begin(), reference.end());
+
+    radixSort(values, [](const std::uint64_t value) { return value; });
+
+    CHECK_EQUAL_COLLECTIONS(values, reference);
+}
+
+BOOST_AUTO_TEST_CASE(sort_is_stable)
+{
+    using Pair = std::pair<std::uint64_t, std::uint32_t>;
+    std::vector<Pair> values;
+    for (const auto index : util::irange<std::uint32_t>(0, 200000))
+    {
+        values.emplace_back((index * 7919u) % 1000 + (std::uint64_t{1} << 40), index);
+    }
+    auto reference = values;
+    std::stable_sort(reference.begin(), reference.end(), [](const Pair &lhs, const Pair &rhs) {
+        return lhs.first < rhs.first;
+    });
+
+    radixSort(values, [](const Pair &value) { return value.first; });
+
+    BOOST_CHECK(values == reference);
+}
+
+BOOST_AUTO_TEST_CASE(sort_small_inputs)
+{
+    std::vector<std::uint64_t> empty;
+    radixSort(empty, [](const std::uint64_t value) { return value; });
+    BOOST_CHECK(empty.empty());
+
+    std::vector<std::uint64_t> values{3, 3, 1};
+    radixSort(values, [](const std::uint64_t value) { return value; });
+    const std::vector<std::uint64_t> reference{1, 3, 3};
+    CHECK_EQUAL_COLLECTIONS(values, reference);
+}
+
+BOOST_AUTO_TEST_SUITE_END()